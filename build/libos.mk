@@ -11,8 +11,13 @@ OS_SOURCES := \
 	$(OS_SRC_DIR)/Path.cpp \
 	$(OS_SRC_DIR)/PathName.cpp \
 	$(OS_SRC_DIR)/Process.cpp \
+	$(OS_SRC_DIR)/Profiler.cpp \
 	$(OS_SRC_DIR)/SystemLoad.cpp
 
+ifeq ($(ALLOCATION_COUNTER),y)
+OS_SOURCES += $(OS_SRC_DIR)/AllocationCounter.cpp
+endif
+
 ifeq ($(HAVE_POSIX),y)
 OS_SOURCES += \
 	$(OS_SRC_DIR)/EventPipe.cpp
@@ -14,6 +14,7 @@ TERRAIN_SOURCES = \
 	$(SRC)/Terrain/HeightMatrix.cpp \
 	$(SRC)/Terrain/RasterRenderer.cpp \
 	$(SRC)/Terrain/TerrainRenderer.cpp \
+	$(SRC)/Terrain/TerrainTexture.cpp \
 	$(SRC)/Terrain/TerrainSettings.cpp
 
 TERRAIN_CPPFLAGS_INTERNAL = $(JASPER_CPPFLAGS) $(SCREEN_CPPFLAGS)
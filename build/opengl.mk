@@ -65,6 +65,13 @@ endif
 
 ifeq ($(GLSL),y)
 OPENGL_CPPFLAGS += -DUSE_GLSL
+
+# experimental: shade the terrain in a GLSL fragment shader instead
+# of RasterRenderer::GenerateImage(), see class TerrainTexture
+GLSL_TERRAIN ?= n
+ifeq ($(GLSL_TERRAIN),y)
+OPENGL_CPPFLAGS += -DENABLE_GLSL_TERRAIN
+endif
 endif
 
 # Needed for native VBO support
@@ -20,6 +20,12 @@ ifeq ($(STOP_WATCH),y)
 TARGET_CPPFLAGS += -DSTOP_WATCH
 endif
 
+# count heap allocations per profiler section?
+ALLOCATION_COUNTER ?= n
+ifeq ($(ALLOCATION_COUNTER),y)
+TARGET_CPPFLAGS += -DENABLE_ALLOCATION_COUNTER
+endif
+
 # compile without UI?
 HEADLESS ?= n
 
@@ -88,6 +88,9 @@ TEST_NAMES = \
 	test_task \
 	TestOverwritingRingBuffer \
 	TestDateTime TestRoughTime TestWrapClock \
+	TestProfiler \
+	TestAllocationCounter \
+	TestThinningCache \
 	TestMath \
 	TestMathTables \
 	TestAngle TestARange \
@@ -95,13 +98,16 @@ TEST_NAMES = \
 	TestValidity TestUTM TestProfile \
 	TestAllocatedGrid \
 	TestRadixTree TestGeoBounds TestGeoClip \
-	TestLogger TestGRecord TestDriver TestClimbAvCalc \
+	TestLogger TestAsyncLogWriter TestMD5 TestGRecord TestFlightIndex \
+	TestIGCFileIndex \
+	TestDriver TestClimbAvCalc \
 	TestWaypointReader TestThermalBase \
 	TestFlarmNet \
-	TestColorRamp TestGeoPoint TestDiffFilter \
+	TestTrafficList \
+	TestColorRamp TestPixelOperations TestGeoPoint TestDiffFilter \
 	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
 	test_replay_task TestProjection TestFlatPoint TestFlatLine TestFlatGeoPoint \
-	TestMacCready TestOrderedTask TestAATPoint \
+	TestMacCready TestMacCreadyTable TestOrderedTask TestAATPoint \
 	TestPlanes \
 	TestTaskPoint \
 	TestTaskWaypoint \
@@ -110,6 +116,7 @@ TEST_NAMES = \
 	TestAirspaceParser \
 	TestMETARParser \
 	TestIGCParser \
+	TestMappedIGCReader TestTraceArchive \
 	TestByteOrder \
 	TestByteOrder2 \
 	TestStrings TestUTF8 \
@@ -117,13 +124,24 @@ TEST_NAMES = \
 	TestUnitsFormatter \
 	TestGeoPointFormatter \
 	TestHexColorFormatter \
+	TestRasterRenderer \
 	TestByteSizeFormatter \
 	TestTimeFormatter \
 	TestIGCFilenameFormatter \
 	TestLXNToIGC \
 	TestLeastSquares \
-	TestThermalBand
-
+	TestThermalBand \
+	TestLockStepReplay \
+	TestContestDijkstra \
+	TestTraceResolution \
+	TestWorkerPool
+
+ifeq ($(GLSL_TERRAIN),y)
+ifeq ($(EGL),y)
+# needs a GPU (or Mesa's software renderer) with EGL_MESA_platform_surfaceless
+TEST_NAMES += TestTerrainTexture
+endif
+endif
 
 TESTS = $(call name-to-bin,$(TEST_NAMES))
 
@@ -162,6 +180,24 @@ TEST_IGC_PARSER_SOURCES = \
 TEST_IGC_PARSER_DEPENDS = MATH UTIL
 $(eval $(call link-program,TestIGCParser,TEST_IGC_PARSER))
 
+TEST_MAPPED_IGC_READER_SOURCES = \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/MappedIGCReader.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestMappedIGCReader.cpp
+TEST_MAPPED_IGC_READER_DEPENDS = IO OS MATH UTIL
+$(eval $(call link-program,TestMappedIGCReader,TEST_MAPPED_IGC_READER))
+
+TEST_TRACE_ARCHIVE_SOURCES = \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/MappedIGCReader.cpp \
+	$(SRC)/IGC/TraceArchive.cpp \
+	$(SRC)/IGC/TraceArchiveWriter.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTraceArchive.cpp
+TEST_TRACE_ARCHIVE_DEPENDS = IO OS GEO MATH TIME UTIL
+$(eval $(call link-program,TestTraceArchive,TEST_TRACE_ARCHIVE))
+
 TEST_BYTE_ORDER_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestByteOrder.cpp
@@ -215,6 +251,33 @@ TEST_WRAP_CLOCK_SOURCES = \
 TEST_WRAP_CLOCK_DEPENDS = MATH TIME
 $(eval $(call link-program,TestWrapClock,TEST_WRAP_CLOCK))
 
+TEST_PROFILER_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestProfiler.cpp
+TEST_PROFILER_DEPENDS = OS
+$(eval $(call link-program,TestProfiler,TEST_PROFILER))
+
+TEST_WORKER_POOL_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestWorkerPool.cpp
+TEST_WORKER_POOL_DEPENDS = THREAD UTIL
+$(eval $(call link-program,TestWorkerPool,TEST_WORKER_POOL))
+
+TEST_ALLOCATION_COUNTER_SOURCES = \
+	$(SRC)/OS/AllocationCounter.cpp \
+	$(SRC)/Computer/Wind/WindEKF.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAllocationCounter.cpp
+TEST_ALLOCATION_COUNTER_CPPFLAGS = -DENABLE_ALLOCATION_COUNTER
+$(eval $(call link-program,TestAllocationCounter,TEST_ALLOCATION_COUNTER))
+
+TEST_THINNING_CACHE_SOURCES = \
+	$(SRC)/Topography/ThinningCache.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestThinningCache.cpp
+TEST_THINNING_CACHE_DEPENDS = IO OS UTIL
+$(eval $(call link-program,TestThinningCache,TEST_THINNING_CACHE))
+
 TEST_PROFILE_SOURCES = \
 	$(SRC)/LocalPath.cpp \
 	$(SRC)/Profile/Profile.cpp \
@@ -231,6 +294,12 @@ TEST_MAC_CREADY_OBJS = $(call SRC_TO_OBJ,$(TEST_MAC_CREADY_SOURCES))
 TEST_MAC_CREADY_DEPENDS = GLIDE GEO MATH UTIL
 $(eval $(call link-program,TestMacCready,TEST_MAC_CREADY))
 
+TEST_MAC_CREADY_TABLE_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestMacCreadyTable.cpp
+TEST_MAC_CREADY_TABLE_DEPENDS = GLIDE GEO MATH UTIL
+$(eval $(call link-program,TestMacCreadyTable,TEST_MAC_CREADY_TABLE))
+
 TEST_ORDERED_TASK_SOURCES = \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/Engine/Util/Gradient.cpp \
@@ -323,6 +392,7 @@ $(eval $(call link-program,test_route,TEST_ROUTE))
 
 TEST_REPLAY_TASK_SOURCES = \
 	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/FLARM/List.cpp \
 	$(SRC)/NMEA/ExternalSettings.cpp \
 	$(SRC)/NMEA/Attitude.cpp \
 	$(SRC)/NMEA/Acceleration.cpp \
@@ -404,6 +474,18 @@ TEST_FLARM_NET_SOURCES = \
 TEST_FLARM_NET_DEPENDS = IO OS MATH UTIL
 $(eval $(call link-program,TestFlarmNet,TEST_FLARM_NET))
 
+TEST_TRAFFIC_LIST_SOURCES = \
+	$(SRC)/Device/Driver/FLARM/StaticParser.cpp \
+	$(SRC)/FLARM/List.cpp \
+	$(SRC)/FLARM/Traffic.cpp \
+	$(SRC)/FLARM/FlarmId.cpp \
+	$(SRC)/NMEA/InputLine.cpp \
+	$(SRC)/NMEA/Checksum.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTrafficList.cpp
+TEST_TRAFFIC_LIST_DEPENDS = IO GEO MATH UTIL
+$(eval $(call link-program,TestTrafficList,TEST_TRAFFIC_LIST))
+
 TEST_GEO_CLIP_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestGeoClip.cpp
@@ -580,6 +662,13 @@ TEST_COLOR_RAMP_SOURCES = \
 TEST_COLOR_RAMP_CPPFLAGS = $(SCREEN_CPPFLAGS)
 $(eval $(call link-program,TestColorRamp,TEST_COLOR_RAMP))
 
+TEST_PIXEL_OPERATIONS_SOURCES = \
+	$(SRC)/Screen/Memory/Export.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestPixelOperations.cpp
+TEST_PIXEL_OPERATIONS_CPPFLAGS = $(SCREEN_CPPFLAGS)
+$(eval $(call link-program,TestPixelOperations,TEST_PIXEL_OPERATIONS))
+
 TEST_SUN_EPHEMERIS_SOURCES = \
 	$(SRC)/Math/SunEphemeris.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -621,13 +710,23 @@ TEST_LOGGER_SOURCES = \
 	$(SRC)/Logger/GRecord.cpp \
 	$(SRC)/Logger/LoggerEPE.cpp \
 	$(SRC)/Logger/MD5.cpp \
+	$(SRC)/Logger/AsyncLogWriter.cpp \
 	$(SRC)/Version.cpp \
 	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestLogger.cpp
-TEST_LOGGER_DEPENDS = IO OS GEO MATH UTIL
+TEST_LOGGER_DEPENDS = IO OS THREAD GEO MATH UTIL
 $(eval $(call link-program,TestLogger,TEST_LOGGER))
 
+TEST_ASYNC_LOG_WRITER_SOURCES = \
+	$(SRC)/Logger/AsyncLogWriter.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAsyncLogWriter.cpp
+TEST_ASYNC_LOG_WRITER_DEPENDS = IO OS THREAD UTIL
+$(eval $(call link-program,TestAsyncLogWriter,TEST_ASYNC_LOG_WRITER))
+
 TEST_GRECORD_SOURCES = \
 	$(SRC)/Logger/GRecord.cpp \
 	$(SRC)/Logger/MD5.cpp \
@@ -637,6 +736,28 @@ TEST_GRECORD_SOURCES = \
 TEST_GRECORD_DEPENDS = IO OS UTIL
 $(eval $(call link-program,TestGRecord,TEST_GRECORD))
 
+TEST_MD5_SOURCES = \
+	$(SRC)/Logger/MD5.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestMD5.cpp
+$(eval $(call link-program,TestMD5,TEST_MD5))
+
+TEST_FLIGHT_INDEX_SOURCES = \
+	$(SRC)/Logger/FlightIndex.cpp \
+	$(SRC)/Logger/FlightParser.cpp \
+	$(SRC)/FlightInfo.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestFlightIndex.cpp
+TEST_FLIGHT_INDEX_DEPENDS = IO OS TIME UTIL
+$(eval $(call link-program,TestFlightIndex,TEST_FLIGHT_INDEX))
+
+TEST_IGC_FILE_INDEX_SOURCES = \
+	$(SRC)/Logger/IGCFileIndex.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestIGCFileIndex.cpp
+TEST_IGC_FILE_INDEX_DEPENDS = IO OS UTIL
+$(eval $(call link-program,TestIGCFileIndex,TEST_IGC_FILE_INDEX))
+
 TEST_DRIVER_SOURCES = \
 	$(SRC)/Device/Port/NullPort.cpp \
 	$(SRC)/Device/Port/Port.cpp \
@@ -696,6 +817,23 @@ TEST_WAY_POINT_FILE_SOURCES = \
 TEST_WAY_POINT_FILE_DEPENDS = WAYPOINT GEO MATH IO ZZIP OS THREAD UTIL
 $(eval $(call link-program,TestWaypointReader,TEST_WAY_POINT_FILE))
 
+TEST_CONTEST_DIJKSTRA_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(SRC)/Engine/Trace/Point.cpp \
+	$(SRC)/Engine/Trace/Trace.cpp \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(TEST_SRC_DIR)/TestContestDijkstra.cpp
+TEST_CONTEST_DIJKSTRA_DEPENDS = CONTEST IO OS GEO MATH TIME UTIL
+$(eval $(call link-program,TestContestDijkstra,TEST_CONTEST_DIJKSTRA))
+
+TEST_TRACE_RESOLUTION_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(SRC)/Engine/Trace/Point.cpp \
+	$(SRC)/Engine/Trace/Trace.cpp \
+	$(TEST_SRC_DIR)/TestTraceResolution.cpp
+TEST_TRACE_RESOLUTION_DEPENDS = GEO MATH UTIL
+$(eval $(call link-program,TestTraceResolution,TEST_TRACE_RESOLUTION))
+
 TEST_TRACE_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(SRC)/Engine/Trace/Point.cpp \
@@ -731,6 +869,10 @@ DEBUG_PROGRAM_NAMES = \
 	FlightPath \
 	BenchmarkProjection \
 	BenchmarkFAITriangleSector \
+	BenchmarkAATTarget \
+	BenchmarkLabelBlock \
+	BenchmarkIGCParser \
+	BenchmarkReplay \
 	DumpTextFile DumpTextZip DumpTextInflate WriteTextFile RunTextWriter \
 	DumpHexColor \
 	RunXMLParser \
@@ -772,6 +914,7 @@ DEBUG_PROGRAM_NAMES = \
 	RunProgressWindow \
 	RunJobDialog \
 	RunAnalysis \
+	RunLockStepReplay \
 	RunAirspaceWarningDialog \
 	RunProfileListDialog \
 	TestNotify \
@@ -792,6 +935,7 @@ DEBUG_PROGRAM_NAMES = \
 ifeq ($(TARGET),UNIX)
 DEBUG_PROGRAM_NAMES += \
 	AnalyseFlight \
+	BatchAnalyseFlights \
 	FeedFlyNetData
 endif
 
@@ -816,6 +960,10 @@ ifeq ($(LUA),y)
 DEBUG_PROGRAM_NAMES += RunLua
 endif
 
+ifeq ($(USE_MEMORY_CANVAS),y)
+DEBUG_PROGRAM_NAMES += BenchmarkCanvas
+endif
+
 DEBUG_PROGRAMS = $(call name-to-bin,$(DEBUG_PROGRAM_NAMES))
 
 ifeq ($(LUA),y)
@@ -836,6 +984,7 @@ DEBUG_REPLAY_SOURCES = \
 	$(SRC)/Device/Config.cpp \
 	$(SRC)/IGC/IGCParser.cpp \
 	$(SRC)/IGC/Generator.cpp \
+	$(SRC)/IGC/TraceArchive.cpp \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Units/System.cpp \
 	$(ENGINE_SRC_DIR)/Airspace/AirspaceWarningConfig.cpp \
@@ -883,6 +1032,7 @@ DEBUG_REPLAY_SOURCES = \
 	$(TEST_SRC_DIR)/FakeGeoid.cpp \
 	$(TEST_SRC_DIR)/DebugReplayIGC.cpp \
 	$(TEST_SRC_DIR)/DebugReplayNMEA.cpp \
+	$(TEST_SRC_DIR)/DebugReplayTraceArchive.cpp \
 	$(TEST_SRC_DIR)/DebugReplay.cpp
 DEBUG_REPLAY_LDADD = \
 	$(DRIVER_LDADD) \
@@ -904,6 +1054,66 @@ BENCHMARK_FAI_TRIANGLE_SECTOR_SOURCES = \
 BENCHMARK_FAI_TRIANGLE_SECTOR_DEPENDS = GEO MATH
 $(eval $(call link-program,BenchmarkFAITriangleSector,BENCHMARK_FAI_TRIANGLE_SECTOR))
 
+BENCHMARK_AAT_TARGET_SOURCES = \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAATTarget.cpp
+BENCHMARK_AAT_TARGET_DEPENDS = TASK ROUTE GLIDE WAYPOINT GEO TIME OS MATH UTIL
+$(eval $(call link-program,BenchmarkAATTarget,BENCHMARK_AAT_TARGET))
+
+BENCHMARK_LABEL_BLOCK_SOURCES = \
+	$(SRC)/Renderer/WaypointLabelList.cpp \
+	$(SRC)/Renderer/LabelBlock.cpp \
+	$(TEST_SRC_DIR)/BenchmarkLabelBlock.cpp
+BENCHMARK_LABEL_BLOCK_DEPENDS = OS UTIL
+BENCHMARK_LABEL_BLOCK_CPPFLAGS = $(SCREEN_CPPFLAGS)
+$(eval $(call link-program,BenchmarkLabelBlock,BENCHMARK_LABEL_BLOCK))
+
+BENCHMARK_IGC_PARSER_SOURCES = \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/MappedIGCReader.cpp \
+	$(TEST_SRC_DIR)/BenchmarkIGCParser.cpp
+BENCHMARK_IGC_PARSER_DEPENDS = IO OS MATH UTIL
+$(eval $(call link-program,BenchmarkIGCParser,BENCHMARK_IGC_PARSER))
+
+BENCHMARK_REPLAY_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/OS/AllocationCounter.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/JSON/Writer.cpp \
+	$(SRC)/Computer/CirclingComputer.cpp \
+	$(SRC)/Computer/ThermalLocator.cpp \
+	$(SRC)/Computer/TraceComputer.cpp \
+	$(SRC)/Computer/WaveComputer.cpp \
+	$(SRC)/Computer/Wind/WindEKF.cpp \
+	$(SRC)/Computer/Wind/WindEKFGlue.cpp \
+	$(SRC)/Computer/Wind/CirclingWind.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Vector.cpp \
+	$(ENGINE_SRC_DIR)/Util/Gradient.cpp \
+	$(SRC)/Task/Deserialiser.cpp \
+	$(SRC)/Task/LoadFile.cpp \
+	$(SRC)/XML/Node.cpp \
+	$(SRC)/XML/Parser.cpp \
+	$(SRC)/XML/Writer.cpp \
+	$(SRC)/XML/DataNode.cpp \
+	$(SRC)/XML/DataNodeXML.cpp \
+	$(TEST_SRC_DIR)/BenchmarkReplay.cpp
+BENCHMARK_REPLAY_LDADD = $(DEBUG_REPLAY_LDADD)
+BENCHMARK_REPLAY_DEPENDS = TASK ROUTE CONTEST WAYPOINT GLIDE GEO MATH UTIL IO TIME
+$(eval $(call link-program,BenchmarkReplay,BENCHMARK_REPLAY))
+
+BENCHMARK_REPLAY_CORPUS = \
+	$(topdir)/test/data/01lz1hq1.igc \
+	$(topdir)/test/data/0asljd01.igc \
+	$(topdir)/test/data/9crx3101.igc \
+	$(topdir)/test/data/apf-bug554.igc
+
+# replay the corpus and fail if a stage exceeds its budget
+benchmark-replay: $(call name-to-bin,BenchmarkReplay)
+	$(Q)$(call name-to-bin,BenchmarkReplay) --budget $(topdir)/test/data/replay-budget.txt $(BENCHMARK_REPLAY_CORPUS)
+
 DUMP_TEXT_FILE_SOURCES = \
 	$(TEST_SRC_DIR)/DumpTextFile.cpp
 DUMP_TEXT_FILE_DEPENDS = IO OS ZZIP UTIL
@@ -1003,6 +1213,7 @@ $(eval $(call link-program,RunWPASupplicant,RUN_WPA_SUPPLICANT))
 RUN_SL_TRACKING_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/FLARM/List.cpp \
 	$(SRC)/NMEA/ExternalSettings.cpp \
 	$(SRC)/NMEA/Attitude.cpp \
 	$(SRC)/NMEA/Acceleration.cpp \
@@ -1117,6 +1328,7 @@ LOAD_TOPOGRAPHY_SOURCES = \
 	$(SRC)/Topography/TopographyStore.cpp \
 	$(SRC)/Topography/TopographyFile.cpp \
 	$(SRC)/Topography/XShape.cpp \
+	$(SRC)/Topography/ThinningCache.cpp \
 	$(SRC)/Projection/Projection.cpp \
 	$(SRC)/Projection/WindowProjection.cpp \
 	$(SRC)/Operation/Operation.cpp \
@@ -1125,7 +1337,7 @@ ifeq ($(OPENGL),y)
 LOAD_TOPOGRAPHY_SOURCES += \
 	$(SCREEN_SRC_DIR)/OpenGL/Triangulate.cpp
 endif
-LOAD_TOPOGRAPHY_DEPENDS = RESOURCE GEO MATH THREAD IO UTIL SHAPELIB ZZIP
+LOAD_TOPOGRAPHY_DEPENDS = RESOURCE GEO MATH THREAD IO OS UTIL SHAPELIB ZZIP
 LOAD_TOPOGRAPHY_CPPFLAGS = $(SCREEN_CPPFLAGS)
 $(eval $(call link-program,LoadTopography,LOAD_TOPOGRAPHY))
 
@@ -1145,6 +1357,41 @@ RUN_HEIGHT_MATRIX_CPPFLAGS = $(SCREEN_CPPFLAGS)
 RUN_HEIGHT_MATRIX_DEPENDS = TERRAIN GEO MATH IO OS ZZIP UTIL
 $(eval $(call link-program,RunHeightMatrix,RUN_HEIGHT_MATRIX))
 
+TEST_RASTER_RENDERER_SOURCES = \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/Screen/Layout.cpp \
+	$(SRC)/Screen/Ramp.cpp \
+	$(SRC)/Screen/Memory/RawBitmap.cpp \
+	$(SRC)/Screen/Memory/Canvas.cpp \
+	$(SRC)/Screen/Util.cpp \
+	$(SRC)/Screen/Custom/Cache.cpp \
+	$(SRC)/Screen/FreeType/Font.cpp \
+	$(SRC)/Screen/FreeType/Init.cpp \
+	$(SRC)/Screen/Custom/Files.cpp \
+	$(SRC)/Screen/Debug.cpp \
+	$(SRC)/Hardware/DisplayDPI.cpp \
+	$(SRC)/Hardware/DisplaySize.cpp \
+	$(SRC)/Event/Idle.cpp \
+	$(SRC)/Hardware/CPU.cpp \
+	$(TEST_SRC_DIR)/FakeAsset.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestRasterRenderer.cpp
+TEST_RASTER_RENDERER_CPPFLAGS = $(SCREEN_CPPFLAGS)
+TEST_RASTER_RENDERER_DEPENDS = TERRAIN GEO MATH IO OS ZZIP THREAD UTIL FREETYPE
+$(eval $(call link-program,TestRasterRenderer,TEST_RASTER_RENDERER))
+
+TEST_TERRAIN_TEXTURE_SOURCES = \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTerrainTexture.cpp
+TEST_TERRAIN_TEXTURE_CPPFLAGS = $(SCREEN_CPPFLAGS)
+TEST_TERRAIN_TEXTURE_DEPENDS = TERRAIN SCREEN EVENT ASYNC GEO MATH IO OS ZZIP THREAD UTIL
+$(eval $(call link-program,TestTerrainTexture,TEST_TERRAIN_TEXTURE))
+
 RUN_INPUT_PARSER_SOURCES = \
 	$(SRC)/Input/InputKeys.cpp \
 	$(SRC)/Input/InputConfig.cpp \
@@ -1312,6 +1559,7 @@ RUN_DECLARE_SOURCES = \
 	$(SRC)/NMEA/Checksum.cpp \
 	$(SRC)/NMEA/ExternalSettings.cpp \
 	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/FLARM/List.cpp \
 	$(SRC)/NMEA/SwitchState.cpp \
 	$(SRC)/NMEA/Attitude.cpp \
 	$(SRC)/NMEA/Acceleration.cpp \
@@ -1347,6 +1595,7 @@ RUN_ENABLE_NMEA_SOURCES = \
 	$(SRC)/NMEA/Checksum.cpp \
 	$(SRC)/NMEA/ExternalSettings.cpp \
 	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/FLARM/List.cpp \
 	$(SRC)/NMEA/SwitchState.cpp \
 	$(SRC)/NMEA/Attitude.cpp \
 	$(SRC)/NMEA/Acceleration.cpp \
@@ -1437,6 +1686,7 @@ RUN_FLIGHT_LIST_SOURCES = \
 	$(SRC)/NMEA/Checksum.cpp \
 	$(SRC)/NMEA/ExternalSettings.cpp \
 	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/FLARM/List.cpp \
 	$(SRC)/NMEA/SwitchState.cpp \
 	$(SRC)/NMEA/Attitude.cpp \
 	$(SRC)/NMEA/Acceleration.cpp \
@@ -1470,6 +1720,7 @@ RUN_DOWNLOAD_FLIGHT_SOURCES = \
 	$(SRC)/NMEA/Checksum.cpp \
 	$(SRC)/NMEA/ExternalSettings.cpp \
 	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/FLARM/List.cpp \
 	$(SRC)/NMEA/SwitchState.cpp \
 	$(SRC)/NMEA/Attitude.cpp \
 	$(SRC)/NMEA/Acceleration.cpp \
@@ -1502,6 +1753,7 @@ CAI302_TOOL_SOURCES = \
 	$(SRC)/NMEA/Checksum.cpp \
 	$(SRC)/NMEA/ExternalSettings.cpp \
 	$(SRC)/NMEA/Info.cpp \
+	$(SRC)/FLARM/List.cpp \
 	$(SRC)/NMEA/SwitchState.cpp \
 	$(SRC)/NMEA/Attitude.cpp \
 	$(SRC)/NMEA/Acceleration.cpp \
@@ -1544,7 +1796,9 @@ RUN_IGC_WRITER_SOURCES = \
 	$(SRC)/Logger/GRecord.cpp \
 	$(SRC)/Logger/LoggerEPE.cpp \
 	$(SRC)/Logger/MD5.cpp \
+	$(SRC)/Logger/AsyncLogWriter.cpp \
 	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
 	$(TEST_SRC_DIR)/RunIGCWriter.cpp
 RUN_IGC_WRITER_LDADD = $(DEBUG_REPLAY_LDADD)
 RUN_IGC_WRITER_DEPENDS = GEO MATH UTIL TIME
@@ -1554,6 +1808,8 @@ RUN_FLIGHT_LOGGER_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/Computer/CirclingComputer.cpp \
 	$(SRC)/Logger/FlightLogger.cpp \
+	$(SRC)/Logger/FlightParser.cpp \
+	$(SRC)/Logger/FlightIndex.cpp \
 	$(TEST_SRC_DIR)/FakeLogFile.cpp \
 	$(TEST_SRC_DIR)/RunFlightLogger.cpp
 RUN_FLIGHT_LOGGER_LDADD = $(DEBUG_REPLAY_LDADD)
@@ -1696,11 +1952,33 @@ ANALYSE_FLIGHT_SOURCES = \
 	$(TEST_SRC_DIR)/ContestPrinting.cpp \
 	$(TEST_SRC_DIR)/FlightPhaseJSON.cpp \
 	$(TEST_SRC_DIR)/FlightPhaseDetector.cpp \
+	$(TEST_SRC_DIR)/FlightAnalysis.cpp \
 	$(TEST_SRC_DIR)/AnalyseFlight.cpp
 ANALYSE_FLIGHT_LDADD = $(DEBUG_REPLAY_LDADD)
 ANALYSE_FLIGHT_DEPENDS = CONTEST UTIL GEO MATH TIME
 $(eval $(call link-program,AnalyseFlight,ANALYSE_FLIGHT))
 
+BATCH_ANALYSE_FLIGHTS_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/JSON/Writer.cpp \
+	$(SRC)/Formatter/TimeFormatter.cpp \
+	$(SRC)/Computer/CirclingComputer.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalBand.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalSlice.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalEncounterBand.cpp \
+	$(ENGINE_SRC_DIR)/ThermalBand/ThermalEncounterCollection.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FlightPhaseJSON.cpp \
+	$(TEST_SRC_DIR)/FlightPhaseDetector.cpp \
+	$(TEST_SRC_DIR)/FlightAnalysis.cpp \
+	$(TEST_SRC_DIR)/BatchAnalyseFlights.cpp
+BATCH_ANALYSE_FLIGHTS_LDADD = $(DEBUG_REPLAY_LDADD)
+BATCH_ANALYSE_FLIGHTS_DEPENDS = CONTEST THREAD OS UTIL GEO MATH TIME
+$(eval $(call link-program,BatchAnalyseFlights,BATCH_ANALYSE_FLIGHTS))
+
 FLIGHT_PATH_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/IGC/IGCParser.cpp \
@@ -1745,6 +2023,15 @@ RUN_CANVAS_LDADD = $(FAKE_LIBS)
 RUN_CANVAS_DEPENDS = FORM SCREEN EVENT ASYNC OS THREAD MATH UTIL
 $(eval $(call link-program,RunCanvas,RUN_CANVAS))
 
+ifeq ($(USE_MEMORY_CANVAS),y)
+BENCHMARK_CANVAS_SOURCES = \
+	$(TEST_SRC_DIR)/FakeAsset.cpp \
+	$(TEST_SRC_DIR)/BenchmarkCanvas.cpp
+BENCHMARK_CANVAS_LDADD = $(FAKE_LIBS)
+BENCHMARK_CANVAS_DEPENDS = SCREEN OS THREAD MATH UTIL
+$(eval $(call link-program,BenchmarkCanvas,BENCHMARK_CANVAS))
+endif
+
 RUN_MAP_WINDOW_SOURCES = \
 	$(CONTEST_SRC_DIR)/Settings.cpp \
 	$(SRC)/Engine/Util/Gradient.cpp \
@@ -1783,6 +2070,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
 	$(SRC)/Renderer/GeoBitmapRenderer.cpp \
 	$(SRC)/Renderer/TransparentRendererCache.cpp \
+	$(SRC)/Renderer/LayerCache.cpp \
 	$(SRC)/Renderer/AirspaceRendererSettings.cpp \
 	$(SRC)/Renderer/BackgroundRenderer.cpp \
 	$(SRC)/LocalPath.cpp \
@@ -1815,6 +2103,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Renderer/AircraftRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRenderer.cpp \
 	$(SRC)/Renderer/AirspaceRendererGL.cpp \
+	$(SRC)/Renderer/AirspaceTriangleCache.cpp \
 	$(SRC)/Renderer/AirspaceRendererOther.cpp \
 	$(SRC)/Renderer/AirspaceLabelList.cpp \
 	$(SRC)/Renderer/AirspaceLabelRenderer.cpp \
@@ -1861,6 +2150,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Topography/TopographyRenderer.cpp \
 	$(SRC)/Topography/TopographyGlue.cpp \
 	$(SRC)/Topography/XShape.cpp \
+	$(SRC)/Topography/ThinningCache.cpp \
 	$(SRC)/Topography/CachedTopographyRenderer.cpp \
 	$(SRC)/Units/Units.cpp \
 	$(SRC)/Units/Settings.cpp \
@@ -2366,6 +2656,89 @@ RUN_ANALYSIS_DEPENDS = \
 	CONTEST TASK ROUTE GLIDE WAYPOINT ROUTE AIRSPACE ZZIP UTIL GEO MATH TIME
 $(eval $(call link-program,RunAnalysis,RUN_ANALYSIS))
 
+RUN_LOCK_STEP_REPLAY_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Engine/Trace/Point.cpp \
+	$(SRC)/Engine/Trace/Trace.cpp \
+	$(SRC)/Engine/Trace/Vector.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/ProtectedRoutePlanner.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(SRC)/Atmosphere/CuSonde.cpp \
+	$(SRC)/Computer/Wind/CirclingWind.cpp \
+	$(SRC)/Computer/Wind/Store.cpp \
+	$(SRC)/Computer/Wind/MeasurementList.cpp \
+	$(SRC)/Computer/Wind/WindEKF.cpp \
+	$(SRC)/Computer/Wind/WindEKFGlue.cpp \
+	$(SRC)/Computer/Wind/Computer.cpp \
+	$(SRC)/Computer/Wind/Settings.cpp \
+	$(SRC)/Computer/ThermalLocator.cpp \
+	$(SRC)/Computer/ThermalBase.cpp \
+	$(SRC)/Computer/ThermalBandComputer.cpp \
+	$(SRC)/Computer/GlideRatioCalculator.cpp \
+	$(SRC)/Computer/AutoQNH.cpp \
+	$(SRC)/Computer/CirclingComputer.cpp \
+	$(SRC)/Computer/ContestComputer.cpp \
+	$(SRC)/Computer/TraceComputer.cpp \
+	$(SRC)/Computer/WarningComputer.cpp \
+	$(SRC)/Computer/LiftDatabaseComputer.cpp \
+	$(SRC)/Computer/AverageVarioComputer.cpp \
+	$(SRC)/Computer/GlideRatioComputer.cpp \
+	$(SRC)/Computer/GlideComputer.cpp \
+	$(SRC)/Computer/GlideComputerBlackboard.cpp \
+	$(SRC)/Computer/TaskComputer.cpp \
+	$(SRC)/Computer/RouteComputer.cpp \
+	$(SRC)/Computer/GlideComputerAirData.cpp \
+	$(SRC)/Computer/WaveComputer.cpp \
+	$(SRC)/Computer/StatsComputer.cpp \
+	$(SRC)/Computer/GlideComputerInterface.cpp \
+	$(SRC)/Computer/LogComputer.cpp \
+	$(SRC)/Computer/CuComputer.cpp \
+	$(SRC)/Computer/Settings.cpp \
+	$(SRC)/Units/Units.cpp \
+	$(SRC)/Units/Settings.cpp \
+	$(SRC)/Formatter/TimeFormatter.cpp \
+	$(SRC)/Audio/Settings.cpp \
+	$(SRC)/Audio/VarioSettings.cpp \
+	$(SRC)/TeamCode/TeamCode.cpp \
+	$(SRC)/TeamCode/Settings.cpp \
+	$(SRC)/Logger/Settings.cpp \
+	$(SRC)/Tracking/TrackingSettings.cpp \
+	$(SRC)/Airspace/ActivePredicate.cpp \
+	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
+	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
+	$(SRC)/Math/SunEphemeris.cpp \
+	$(SRC)/Replay/LockStepReplay.cpp \
+	$(SRC)/Replay/IgcReplay.cpp \
+	$(SRC)/Replay/NmeaReplay.cpp \
+	$(SRC)/MergeThread.cpp \
+	$(SRC)/Blackboard/DeviceBlackboard.cpp \
+	$(SRC)/Simulator.cpp \
+	$(SRC)/Device/Simulator.cpp \
+	$(SRC)/FLARM/FlarmComputer.cpp \
+	$(SRC)/FLARM/FlarmCalculations.cpp \
+	$(SRC)/Computer/ClimbAverageCalculator.cpp \
+	$(SRC)/FlightStatistics.cpp \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/RunLockStepReplay.cpp
+RUN_LOCK_STEP_REPLAY_LDADD = $(DEBUG_REPLAY_LDADD)
+RUN_LOCK_STEP_REPLAY_DEPENDS = \
+	TERRAIN DRIVER \
+	OS THREAD IO \
+	CONTEST TASK ROUTE GLIDE WAYPOINT AIRSPACE UTIL GEO MATH TIME
+$(eval $(call link-program,RunLockStepReplay,RUN_LOCK_STEP_REPLAY))
+
+TEST_LOCK_STEP_REPLAY_SOURCES = \
+	$(filter-out $(TEST_SRC_DIR)/RunLockStepReplay.cpp,$(RUN_LOCK_STEP_REPLAY_SOURCES)) \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestLockStepReplay.cpp
+TEST_LOCK_STEP_REPLAY_LDADD = $(RUN_LOCK_STEP_REPLAY_LDADD)
+TEST_LOCK_STEP_REPLAY_DEPENDS = $(RUN_LOCK_STEP_REPLAY_DEPENDS)
+$(eval $(call link-program,TestLockStepReplay,TEST_LOCK_STEP_REPLAY))
+
 RUN_AIRSPACE_WARNING_DIALOG_SOURCES = \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/NMEA/FlyingState.cpp \
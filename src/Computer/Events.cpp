@@ -26,6 +26,7 @@ Copyright_License {
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
 #include "Settings.hpp"
+#include "LogFile.hpp"
 
 void
 GlideComputerEvents::Reset()
@@ -35,6 +36,7 @@ GlideComputerEvents::Reset()
   last_final_glide = false;
   last_traffic = 0;
   last_new_traffic.Clear();
+  last_traffic_overflow = false;
   last_teammate_in_sector = false;
 }
 
@@ -79,6 +81,13 @@ GlideComputerEvents::OnCalculatedUpdate(const MoreData &basic,
       last_new_traffic = flarm.traffic.new_traffic;
       InputEvents::processGlideComputer(GCE_FLARM_NEWTRAFFIC);
     }
+
+    const bool traffic_overflow = flarm.traffic.overflow;
+    if (traffic_overflow && !last_traffic_overflow)
+      LogFormat("FLARM traffic list full (%u targets), "
+                "discarding the least critical ones",
+                (unsigned)TrafficList::MAX_COUNT);
+    last_traffic_overflow = traffic_overflow;
   } else
     last_traffic = 0;
 
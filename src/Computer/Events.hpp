@@ -43,6 +43,11 @@ class GlideComputerEvents final : public NullBlackboardListener {
   unsigned last_traffic;
   Validity last_new_traffic;
 
+  /**
+   * Was the FLARM traffic list full?
+   */
+  bool last_traffic_overflow;
+
 public:
   GlideComputerEvents():enable_team(false) {}
 
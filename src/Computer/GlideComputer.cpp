@@ -27,8 +27,7 @@ Copyright_License {
 #include "ConditionMonitor/ConditionMonitors.hpp"
 #include "GlideComputerInterface.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
-
-static PeriodClock last_team_code_update;
+#include "OS/Profiler.hpp"
 
 GlideComputer::GlideComputer(const ComputerSettings &_settings,
                              const Waypoints &_way_points,
@@ -69,6 +68,15 @@ GlideComputer::Initialise()
   ResetFlight(true);
 }
 
+inline bool
+GlideComputer::CheckClock(PeriodClock &clock, GPSClock &fix_clock,
+                          unsigned interval_ms)
+{
+  return use_fix_clock
+    ? fix_clock.CheckAdvance(Basic().clock, interval_ms / 1000.)
+    : clock.CheckUpdate(interval_ms);
+}
+
 bool
 GlideComputer::ProcessGPS(bool force)
 {
@@ -78,6 +86,8 @@ GlideComputer::ProcessGPS(bool force)
 
   const bool last_flying = calculated.flight.flying;
 
+  ProfilerMarks marks(Profiler::Track::CALCULATION);
+
   if (basic.time_available) {
     /* use UTC offset to calculate local time */
     const int utc_offset_s = settings.utc_offset.AsSeconds();
@@ -96,10 +106,12 @@ GlideComputer::ProcessGPS(bool force)
   calculated.Expire(basic.clock);
 
   // Process basic information
+  marks.Mark("ProcessBasic");
   air_data_computer.ProcessBasic(Basic(), SetCalculated(),
                                  settings);
 
   // Process basic task information
+  marks.Mark("ProcessTask");
   const bool last_finished = calculated.ordered_task_stats.task_finished;
 
   task_computer.ProcessBasicTask(basic,
@@ -115,6 +127,7 @@ GlideComputer::ProcessGPS(bool force)
     OnFinishTask();
 
   // Check if everything is okay with the gps time and process it
+  marks.Mark("FlightTimes");
   air_data_computer.FlightTimes(Basic(), SetCalculated(),
                                 settings);
 
@@ -123,10 +136,12 @@ GlideComputer::ProcessGPS(bool force)
   task_computer.ProcessAutoTask(basic, calculated);
 
   // Process extended information
+  marks.Mark("ProcessVertical");
   air_data_computer.ProcessVertical(Basic(),
                                     SetCalculated(),
                                     settings);
 
+  marks.Mark("Statistics");
   stats_computer.ProcessClimbEvents(calculated);
 
   cu_computer.Compute(basic, calculated, settings);
@@ -150,9 +165,10 @@ GlideComputer::ProcessGPS(bool force)
   CalculateVarioScale();
 
   // Update the ConditionMonitors
+  marks.Mark("ConditionMonitors");
   ConditionMonitorsUpdate(Basic(), Calculated(), settings);
 
-  return idle_clock.CheckUpdate(500);
+  return CheckClock(idle_clock, idle_fix_clock, 500);
 }
 
 void
@@ -161,18 +177,24 @@ GlideComputer::ProcessIdle(bool exhaustive)
   const MoreData &basic = Basic();
   DerivedInfo &calculated = SetCalculated();
 
+  ProfilerMarks marks(Profiler::Track::CALCULATION);
+
   // Log GPS fixes for internal usage
   // (snail trail, stats, olc, ...)
+  marks.Mark("Logging");
   stats_computer.DoLogging(basic, calculated);
   log_computer.Run(basic, calculated, GetComputerSettings().logger);
 
+  marks.Mark("TaskIdle");
   task_computer.ProcessIdle(basic, calculated, GetComputerSettings(),
                             exhaustive);
 
+  marks.Mark("AirspaceWarnings");
   warning_computer.Update(GetComputerSettings(), basic,
                           calculated, calculated.airspace_warnings);
 
   // Calculate summary of flight
+  marks.Mark("Retrospective");
   if (basic.location_available)
     retrospective.UpdateSample(basic.location);
 }
@@ -205,7 +227,7 @@ GlideComputer::CalculateOwnTeamCode()
     return;
 
   // Only calculate every 10sec otherwise cancel calculation
-  if (!last_team_code_update.CheckUpdate(10000))
+  if (!CheckClock(team_code_clock, team_code_fix_clock, 10000))
     return;
 
   // Get bearing and distance to the reference waypoint
@@ -26,6 +26,7 @@ Copyright_License {
 
 #include "GlideComputerBlackboard.hpp"
 #include "Time/PeriodClock.hpp"
+#include "Time/GPSClock.hpp"
 #include "Time/DeltaTime.hpp"
 #include "GlideComputerAirData.hpp"
 #include "StatsComputer.hpp"
@@ -62,6 +63,19 @@ class GlideComputer : public GlideComputerBlackboard
   GeoPoint team_code_ref_location;
 
   PeriodClock idle_clock;
+  PeriodClock team_code_clock;
+
+  /**
+   * Replacements for #idle_clock and #team_code_clock which operate
+   * on NMEAInfo::clock; used if #use_fix_clock is set.
+   */
+  GPSClock idle_fix_clock, team_code_fix_clock;
+
+  /**
+   * Measure the idle and team code intervals in NMEAInfo::clock
+   * instead of wall-clock time?
+   */
+  bool use_fix_clock = false;
 
   /**
    * This object is used to check whether to update
@@ -69,6 +83,15 @@ class GlideComputer : public GlideComputerBlackboard
    */
   DeltaTime trace_history_time;
 
+  /**
+   * Check whether the given interval has passed since the last
+   * update of the clock, and update it if so.  Depending on
+   * #use_fix_clock, the wall-clock or the NMEAInfo::clock variant
+   * is used.
+   */
+  bool CheckClock(PeriodClock &clock, GPSClock &fix_clock,
+                  unsigned interval_ms);
+
 public:
   GlideComputer(const ComputerSettings &_settings,
                 const Waypoints &_way_points,
@@ -82,6 +105,17 @@ public:
     log_computer.SetLogger(logger);
   }
 
+  /**
+   * Measure the intervals of idle processing and of the team code
+   * update in NMEAInfo::clock (i.e. the time stamps of the replayed
+   * records) instead of wall-clock time.  This makes the results of
+   * #LockStepReplay independent of how fast the host processes the
+   * records.
+   */
+  void SetFixClock(bool _use_fix_clock) {
+    use_fix_clock = _use_fix_clock;
+  }
+
   /**
    * Resets the GlideComputer data
    * @param full Reset all data?
@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "TraceComputer.hpp"
+#include "Engine/Trace/Vector.hpp"
 #include "Settings.hpp"
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
@@ -74,6 +75,25 @@ TraceComputer::LockedCopyTo(TracePointVector &v, unsigned min_time,
   full.GetPoints(v, min_time, location, resolution);
 }
 
+bool
+TraceComputer::LockedSyncTo(TracePointVector &v, unsigned min_time,
+                            const GeoPoint &location, double resolution,
+                            Serial &modify_serial) const
+{
+  const ScopeLock lock(mutex);
+
+  if (!v.empty() && !full.empty() &&
+      modify_serial == full.GetModifySerial()) {
+    full.SyncPoints(v, location, resolution);
+    return true;
+  }
+
+  modify_serial = full.GetModifySerial();
+  v.clear();
+  full.GetPoints(v, min_time, location, resolution);
+  return false;
+}
+
 void
 TraceComputer::Update(const ComputerSettings &settings_computer,
                       const MoreData &basic, const DerivedInfo &calculated)
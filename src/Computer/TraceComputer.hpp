@@ -94,6 +94,22 @@ public:
   void LockedCopyTo(TracePointVector &v, unsigned min_time,
                             const GeoPoint &location, double resolution) const;
 
+  /**
+   * Update a vector which was filled by a previous call with the
+   * same resolution.  If the trace has only been appended to since
+   * then, only the new points are copied (see Trace::SyncPoints());
+   * otherwise the vector is filled again, just like LockedCopyTo().
+   * The trace is locked, and the method may be called from any
+   * thread.
+   *
+   * @param modify_serial the Trace::GetModifySerial() value of the
+   * previous call; will be updated
+   * @return false if the vector was filled again from scratch
+   */
+  bool LockedSyncTo(TracePointVector &v, unsigned min_time,
+                    const GeoPoint &location, double resolution,
+                    Serial &modify_serial) const;
+
   void Update(const ComputerSettings &settings_computer,
               const MoreData &basic, const DerivedInfo &calculated);
 };
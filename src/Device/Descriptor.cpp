@@ -40,6 +40,7 @@ Copyright_License {
 #include "Language/Language.hpp"
 #include "Operation/Operation.hpp"
 #include "OS/Path.hpp"
+#include "OS/AllocationCounter.hpp"
 #include "../Simulator.hpp"
 #include "Input/InputQueue.hpp"
 #include "LogFile.hpp"
@@ -731,6 +732,8 @@ DeviceDescriptor::ParseNMEA(const char *line, NMEAInfo &info)
 {
   assert(line != nullptr);
 
+  const ScopeAllocationCounter allocation_counter("ParseNMEA");
+
   /* restore the driver's ExternalSettings */
   const ExternalSettings old_settings = info.settings;
   info.settings = settings_received;
@@ -1201,6 +1204,8 @@ DeviceDescriptor::DataReceived(const void *data, size_t length)
 
   // Pass data directly to drivers that use binary data protocols
   if (driver != nullptr && device != nullptr && driver->UsesRawData()) {
+    const ScopeAllocationCounter allocation_counter("ParseRawData");
+
     ScopeLock protect(device_blackboard->mutex);
     NMEAInfo &basic = device_blackboard->SetRealState(index);
     basic.UpdateClock();
@@ -30,6 +30,8 @@ Copyright_License {
 #include "Util/Macros.hpp"
 #include "Util/StringAPI.hxx"
 
+#include <assert.h>
+
 void
 ParsePFLAE(NMEAInputLine &line, FlarmError &error, double clock)
 {
@@ -178,15 +180,14 @@ ParsePFLAA(NMEAInputLine &line, TrafficList &flarm, double clock)
   else
     traffic.type = (FlarmTraffic::AircraftType)type;
 
-  FlarmTraffic *flarm_slot = flarm.FindTraffic(traffic.id);
+  FlarmTraffic *flarm_slot = flarm.ModifyTraffic(traffic.id);
   if (flarm_slot == nullptr) {
-    flarm_slot = flarm.AllocateTraffic();
-    if (flarm_slot == nullptr)
-      // no more slots available
+    if (!flarm.MakeRoom(traffic, clock))
+      // the list is full of more critical targets
       return;
 
-    flarm_slot->Clear();
-    flarm_slot->id = traffic.id;
+    flarm_slot = flarm.AllocateTraffic(traffic.id);
+    assert(flarm_slot != nullptr);
 
     flarm.new_traffic.Update(clock);
   }
@@ -59,6 +59,17 @@ ContestManager::SetIncremental(bool incremental)
   net_coupe.SetIncremental(incremental);
 }
 
+void
+ContestManager::SetRepair(bool repair)
+{
+  olc_classic.SetRepair(repair);
+  dmst_quad.SetRepair(repair);
+  xcontest_free.SetRepair(repair);
+  dhv_xc_free.SetRepair(repair);
+  sis_at.SetRepair(repair);
+  net_coupe.SetRepair(repair);
+}
+
 void
 ContestManager::SetPredicted(const TracePoint &predicted)
 {
@@ -85,6 +85,11 @@ public:
 
   void SetIncremental(bool incremental);
 
+  /**
+   * @see ContestDijkstra::SetRepair()
+   */
+  void SetRepair(bool repair);
+
   /**
    * @see ContestDijkstra::SetPredicted()
    */
@@ -40,7 +40,8 @@ ContestDijkstra::ContestDijkstra(const Trace &_trace,
    NavDijkstra(n_legs + 1),
    TraceManager(_trace),
    continuous(_continuous),
-   incremental(false)
+   incremental(false),
+   repair(false)
 {
   assert(num_stages <= MAX_STAGES);
 
@@ -53,7 +54,14 @@ ContestDijkstra::UpdateTrace(bool force)
   if (IsMasterAppended()) return; /* unmodified */
 
   if (IsMasterUpdated(continuous)) {
-    UpdateTraceFull();
+    if (finished && repair) {
+      /* try to keep the previous search results */
+      if (UpdateTraceThinned(index_mapping)) {
+        RepairEdges(index_mapping);
+        return;
+      }
+    } else
+      UpdateTraceFull();
 
     trace_dirty = true;
     finished = false;
@@ -96,13 +104,16 @@ ContestDijkstra::Solve(bool exhaustive)
   }
 
   if (finished || dijkstra.IsEmpty()) {
+    const bool was_finished = finished;
     UpdateTrace(exhaustive);
 
     if (n_points < num_stages)
       return SolverResult::FAILED;
 
-    // don't re-start search unless we have had new data appear
-    if (!trace_dirty && !finished)
+    // don't re-start search unless we have had new data appear; a
+    // finished search which has new data (see AddIncrementalEdges()
+    // and RepairEdges()) is resumed right away
+    if (!trace_dirty && finished == was_finished)
       return SolverResult::FAILED;
   } else if (exhaustive || n_points < num_stages ||
              CheckMasterSerial()) {
@@ -220,6 +231,23 @@ ContestDijkstra::AddStartEdges()
   }
 }
 
+bool
+ContestDijkstra::IsLinkable(unsigned i, unsigned first,
+                            int min_altitude) const
+{
+  if (TraceManager::GetPoint(i).GetIntegerAltitude() >= min_altitude)
+    return true;
+
+  /* After excessive thinning, the exact TracePoint that matches the
+     required altitude difference may be gone, and the calculated
+     result becomes overly pessimistic.  This code path makes it
+     optimistic, by checking if the previous point matches. */
+
+  /* TODO: interpolate the distance */
+  return i > first &&
+    TraceManager::GetPoint(i - 1).GetIntegerAltitude() >= min_altitude;
+}
+
 void
 ContestDijkstra::AddEdges(const ScanTaskPoint origin,
                           const unsigned first_point)
@@ -239,27 +267,13 @@ ContestDijkstra::AddEdges(const ScanTaskPoint origin,
 
   const unsigned weight = GetStageWeight(origin.GetStageNumber());
 
-  bool previous_above = false;
+  const unsigned first = destination.GetPointIndex();
   for (const ScanTaskPoint end(destination.GetStageNumber(), n_points);
        destination != end; destination.IncrementPointIndex()) {
-    bool above = GetPoint(destination).GetIntegerAltitude() >= min_altitude;
-
-    if (above) {
-      const unsigned d = weight * CalcEdgeDistance(origin, destination);
-      Link(destination, origin, d);
-    } else if (previous_above) {
-      /* After excessive thinning, the exact TracePoint that matches
-         the required altitude difference may be gone, and the
-         calculated result becomes overly pessimistic.  This code path
-         makes it optimistic, by checking if the previous point
-         matches. */
-
-      /* TODO: interpolate the distance */
+    if (IsLinkable(destination.GetPointIndex(), first, min_altitude)) {
       const unsigned d = weight * CalcEdgeDistance(origin, destination);
       Link(destination, origin, d);
     }
-
-    previous_above = above;
   }
 
   if (IsFinal(destination) && predicted.IsDefined()) {
@@ -286,6 +300,12 @@ ContestDijkstra::AddIncrementalEdges(unsigned first_point)
   finished = false;
   first_finish_candidate = first_point;
 
+  LinkNewPoints(first_point);
+}
+
+void
+ContestDijkstra::LinkNewPoints(unsigned first_point)
+{
   /* we need a copy of the current edge map, because the following
      loop will modify it, invalidating the iterator */
 #if GCC_VERSION < 40800 || GCC_VERSION > 40802
@@ -314,10 +334,165 @@ ContestDijkstra::AddIncrementalEdges(unsigned first_point)
 
   /* see if new start points are possible now (due to relaxed start
      height constraints); duplicates will be ignored by the Dijkstra
-     class */
+     class; start nodes have no predecessor, so "seek" back to zero */
+  dijkstra.SetCurrentValue(0);
   AddStartEdges();
 }
 
+void
+ContestDijkstra::RepairEdges(const std::vector<unsigned> &mapping)
+{
+  assert(continuous);
+  assert(incremental);
+  assert(finished);
+  assert(n_points > 0);
+
+  const unsigned n_kept =
+    mapping.size() - std::count(mapping.begin(), mapping.end(),
+                                unsigned(REMOVED_INDEX));
+
+  /* continue as if the search had been restarted (see UpdateTrace()):
+     the last point is the only finish candidate, and start points
+     must be valid for it */
+  first_finish_candidate = n_points - 1;
+  const int max_start_altitude =
+    GetMaximumStartAltitude(TraceManager::GetPoint(n_points - 1));
+
+  const auto translate = [this, &mapping, max_start_altitude](ScanTaskPoint &p){
+    if (p.GetPointIndex() == predicted_index)
+      return true;
+
+    assert(p.GetPointIndex() < mapping.size());
+    const unsigned i = mapping[p.GetPointIndex()];
+    if (i == REMOVED_INDEX)
+      return false;
+
+    if (p.IsFirst()
+        ? TraceManager::GetPoint(i).GetIntegerAltitude() > max_start_altitude
+        : IsFinal(p) && i < first_finish_candidate)
+      return false;
+
+    p.SetPointIndex(i);
+    return true;
+  };
+
+  std::vector<ScanTaskPoint> unlinked;
+  dijkstra.Remap(translate,
+                 [&unlinked](ScanTaskPoint p){ unlinked.push_back(p); });
+
+  std::vector<ScanTaskPoint> queued;
+  dijkstra.VisitQueued([&queued](ScanTaskPoint p){ queued.push_back(p); });
+  std::sort(queued.begin(), queued.end());
+
+  /* the remaining nodes which have been linked to the next stage
+     already (i.e. which are not in the queue), sorted by stage and
+     point index */
+  struct Origin {
+    ScanTaskPoint node;
+    unsigned value;
+
+    /**
+     * The minimum altitude of a finish point linked from this node
+     * (see AddEdges()).
+     */
+    int min_altitude;
+  };
+
+  std::vector<Origin> origins;
+  for (const auto &i : dijkstra.GetEdgeMap()) {
+    const ScanTaskPoint node = i.first;
+    if (std::binary_search(queued.begin(), queued.end(), node))
+      continue;
+
+    if (IsFinal(node))
+      /* a restarted search would report this finish point again */
+      dijkstra.Requeue(node);
+    else
+      origins.push_back({node, i.second.value,
+                         IsFinal(node.GetStageNumber() + 1)
+                         ? GetMinimumFinishAltitude(GetPoint(FindStart(node)))
+                         : 0});
+  }
+
+  const auto compare = [](const Origin &o, const ScanTaskPoint p){
+    return o.node < p;
+  };
+
+  std::sort(origins.begin(), origins.end(),
+            [](const Origin &a, const Origin &b){
+              return a.node < b.node;
+            });
+
+  /* link each point which lost its path from the best of those
+     nodes in the previous stage, with the rules of AddEdges(); nodes
+     which are still in the queue will be linked by the resumed
+     search */
+  for (const ScanTaskPoint destination : unlinked) {
+    const unsigned stage = destination.GetStageNumber();
+    assert(stage > 0);
+
+    const unsigned index = destination.GetPointIndex();
+    const bool is_predicted = IsFinal(stage) && index == predicted_index;
+    if (is_predicted && !predicted.IsDefined())
+      continue;
+
+    /* the candidates: the nodes of the previous stage up to this
+       point (all of them for the prediction) */
+    const auto begin = std::lower_bound(origins.begin(), origins.end(),
+                                        ScanTaskPoint(stage - 1, 0),
+                                        compare);
+    const auto end = std::lower_bound(begin, origins.end(),
+                                      is_predicted
+                                      ? ScanTaskPoint(stage, 0)
+                                      : ScanTaskPoint(stage - 1, index + 1),
+                                      compare);
+
+    const unsigned weight = GetStageWeight(stage - 1);
+
+    const Origin *best = nullptr;
+    unsigned best_distance = 0, best_value = 0;
+    for (auto o = begin; o != end; ++o) {
+      unsigned distance;
+      if (is_predicted) {
+        distance = weight * GetPoint(o->node).FlatDistanceTo(predicted);
+      } else {
+        unsigned first = o->node.GetPointIndex();
+        if (IsFinal(stage))
+          first = std::max(first, first_finish_candidate);
+
+        if (index < first || !IsLinkable(index, first, o->min_altitude))
+          continue;
+
+        distance = weight * CalcEdgeDistance(o->node, destination);
+      }
+
+      /* the value which Link() would calculate */
+      const unsigned value = o->value + DIJKSTRA_MINMAX_OFFSET - distance;
+      if (best == nullptr || value < best_value) {
+        best = &*o;
+        best_distance = distance;
+        best_value = value;
+      }
+    }
+
+    if (best != nullptr) {
+      dijkstra.SetCurrentValue(best->value);
+      Link(destination, best->node, best_distance);
+    }
+  }
+
+  if (n_points > n_kept) {
+    /* new data from the master trace */
+    LinkNewPoints(n_kept);
+  } else {
+    dijkstra.SetCurrentValue(0);
+    AddStartEdges();
+  }
+
+  /* resume the search */
+  finished = false;
+}
+
 void
 ContestDijkstra::CopySolution(ContestTraceVector &result) const
 {
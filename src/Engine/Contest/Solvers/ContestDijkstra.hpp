@@ -53,6 +53,14 @@ class ContestDijkstra : public AbstractContest, protected NavDijkstra, public Tr
    */
   bool incremental;
 
+  /**
+   * Keep the finished Dijkstra search when points were removed from
+   * the trace (see RepairEdges())?  If not set (the default), the
+   * search is restarted instead.  Only useful for incremental
+   * continuous contests.
+   */
+  bool repair;
+
   /**
    * Did the last Dijkstra search finish (even if without a valid
    * solution)?  This means the Dijkstra object still contains valid
@@ -66,6 +74,12 @@ class ContestDijkstra : public AbstractContest, protected NavDijkstra, public Tr
    */
   ContestTraceVector solution;
 
+  /**
+   * Scratch buffer for UpdateTrace(), see
+   * TraceManager::UpdateTraceThinned().
+   */
+  std::vector<unsigned> index_mapping;
+
 protected:
   /**
    * The index of the first finish candidate.  During incremental
@@ -93,6 +107,13 @@ public:
     incremental = _incremental;
   }
 
+  /**
+   * @see #repair
+   */
+  void SetRepair(bool _repair) {
+    repair = _repair;
+  }
+
 protected:
   bool IsIncremental() const {
     return incremental;
@@ -103,6 +124,16 @@ protected:
     return TraceManager::GetPoint(sp.GetPointIndex());
   }
 
+  /**
+   * Shall AddEdges() link the given point?
+   *
+   * @param i the point index
+   * @param first the first point index considered by AddEdges()
+   * @param min_altitude the minimum altitude of the point
+   */
+  gcc_pure
+  bool IsLinkable(unsigned i, unsigned first, int min_altitude) const;
+
   void AddEdges(ScanTaskPoint origin, unsigned first_point);
 
   /**
@@ -113,6 +144,28 @@ protected:
    */
   void AddIncrementalEdges(unsigned first_point);
 
+  /**
+   * Link all nodes to the given new points, and add new start
+   * points.  Helper for AddIncrementalEdges() and RepairEdges().
+   *
+   * @param first_point the first point that was added
+   */
+  void LinkNewPoints(unsigned first_point);
+
+  /**
+   * Keep the finished Dijkstra search after points were removed from
+   * the trace (see TraceManager::UpdateTraceThinned()), and resume
+   * it with the finish and start candidates of a restarted search:
+   * translate the point indices, drop nodes whose path leads through
+   * a removed point, and link each point of those nodes again from
+   * the best node of the previous stage which has already been
+   * linked onwards.  The resumed search finds the same optimum as a
+   * restarted one.
+   *
+   * @param mapping the new index of each old point
+   */
+  void RepairEdges(const std::vector<unsigned> &mapping);
+
   /**
    * Retrieve weighting of specified leg
    * @param index Index of leg
@@ -97,6 +97,7 @@ TraceManager::ClearTrace()
   append_serial = modify_serial = Serial();
   trace_dirty = true;
   trace.clear();
+  keys.clear();
   n_points = 0;
   predicted = TracePoint::Invalid();
 }
@@ -108,6 +109,11 @@ TraceManager::UpdateTraceFull()
   trace_master.GetPoints(trace);
   n_points = trace.size();
 
+  keys.clear();
+  keys.reserve(n_points);
+  for (const TracePoint *point : trace)
+    keys.emplace_back(*point);
+
   if (n_points > 0 && predicted.IsDefined())
     predicted.Project(trace_master.GetProjection());
 
@@ -128,6 +134,9 @@ TraceManager::UpdateTraceTail()
     /* no new points */
     return false;
 
+  for (unsigned i = n_points; i < trace.size(); ++i)
+    keys.emplace_back(*trace[i]);
+
   n_points = trace.size();
 
   if (n_points > 0 && predicted.IsDefined())
@@ -137,6 +146,57 @@ TraceManager::UpdateTraceTail()
   return true;
 }
 
+bool
+TraceManager::UpdateTraceThinned(std::vector<unsigned> &mapping)
+{
+  const unsigned old_size = n_points;
+  mapping.assign(old_size, unsigned(REMOVED_INDEX));
+
+  /* both lists are sorted by time; every master point up to the end
+     of the old copy must be found in it, and the copy is compacted in
+     place (a point's new index is never larger than its old one) */
+  unsigned old_i = 0, i = 0;
+  for (const TracePoint &point : trace_master) {
+    const PointKey key(point);
+
+    if (old_size > 0 && key.time <= keys[old_size - 1].time) {
+      while (keys[old_i].time < key.time)
+        ++old_i;
+
+      if (!(keys[old_i] == key)) {
+        /* not a thinned copy */
+        UpdateTraceFull();
+        return false;
+      }
+
+      mapping[old_i++] = i;
+      trace[i] = &point;
+      keys[i] = key;
+    } else if (i < trace.size()) {
+      /* appended, in a slot which is not needed anymore */
+      trace[i] = &point;
+      keys[i] = key;
+    } else {
+      /* appended */
+      trace.push_back(&point);
+      keys.push_back(key);
+    }
+
+    ++i;
+  }
+
+  trace.resize(i);
+  keys.erase(keys.begin() + i, keys.end());
+  n_points = i;
+
+  if (n_points > 0 && predicted.IsDefined())
+    predicted.Project(trace_master.GetProjection());
+
+  append_serial = trace_master.GetAppendSerial();
+  modify_serial = trace_master.GetModifySerial();
+  return true;
+}
+
 void
 TraceManager::UpdateTrace(bool force)
 {
@@ -29,6 +29,8 @@ Copyright_License {
 #include "Trace/Vector.hpp"
 #include "Trace/Point.hpp"
 
+#include <vector>
+
 class TraceManager {
 protected:
   const Trace &trace_master;
@@ -48,7 +50,33 @@ private:
    */
   Serial modify_serial;
 
+  /**
+   * Identifies a #TracePoint across Trace::Thin(), after the pointer
+   * in #trace may have become invalid.  The time stamp is unique
+   * within a #Trace; the location is compared to detect points which
+   * were replaced (e.g. after a time warp).
+   */
+  struct PointKey {
+    unsigned time;
+    FlatGeoPoint location;
+
+    explicit PointKey(const TracePoint &point)
+      :time(point.GetTime()), location(point.GetFlatLocation()) {}
+
+    bool operator==(const PointKey &other) const {
+      return time == other.time && location == other.location;
+    }
+  };
+
+  /**
+   * A #PointKey for each element of #trace.
+   */
+  std::vector<PointKey> keys;
+
 protected:
+  /** Value for points in UpdateTraceThinned()'s mapping which are gone */
+  static constexpr unsigned REMOVED_INDEX = unsigned(-1);
+
   /**
    * Working trace for solver.  This contains pointers to trace_master
    * records, which get Invalidated when the trace gets thinned.  Be
@@ -98,6 +126,19 @@ protected:
    */
   bool UpdateTraceTail();
 
+  /**
+   * Update the #Trace copy after the master was modified, and
+   * determine where the points of the old copy are now.  This works
+   * if points were only removed (e.g. by Trace::Thin()) and appended;
+   * the copy is then compacted in place instead of being rebuilt.
+   *
+   * @param mapping receives the new index of each old point, or
+   * #REMOVED_INDEX
+   * @return false if the master was modified in another way; the
+   * new copy has been obtained with UpdateTraceFull() anyway
+   */
+  bool UpdateTraceThinned(std::vector<unsigned> &mapping);
+
   gcc_pure
   const TracePoint &GetPoint(unsigned i) const {
     assert(i < n_points);
@@ -31,9 +31,17 @@
 #include "Navigation/Aircraft.hpp"
 
 #include <algorithm>
+#include <atomic>
 
 #include <assert.h>
 
+/**
+ * The source for GlidePolar::serial.  This is global to make serials
+ * unique among all instances, even if they were modified
+ * independently.
+ */
+static std::atomic<unsigned> next_serial;
+
 GlidePolar::GlidePolar(const double _mc, const double _bugs, const double _ballast)
   :mc(_mc),
    bugs(_bugs),
@@ -46,7 +54,8 @@ GlidePolar::GlidePolar(const double _mc, const double _bugs, const double _balla
    ballast_ratio(0.3),
    reference_mass(300),
    dry_mass(reference_mass),
-   wing_area(0)
+   wing_area(0),
+   serial(0)
 {
   Update();
 
@@ -59,6 +68,8 @@ GlidePolar::Update()
 {
   assert(bugs > 0);
 
+  UpdateSerial();
+
   if (!ideal_polar.IsValid()) {
     Vmin = Vmax = 0;
     return;
@@ -77,6 +88,12 @@ GlidePolar::Update()
   UpdateSMin();
 }
 
+void
+GlidePolar::UpdateSerial()
+{
+  serial = ++next_serial;
+}
+
 void
 GlidePolar::UpdateSMax()
 {
@@ -112,6 +129,7 @@ void
 GlidePolar::SetMC(const double _mc)
 {
   mc = _mc;
+  UpdateSerial();
 
   if (mc > 0)
     inv_mc = 1. / mc;
@@ -472,6 +490,74 @@ GlidePolar::GetNextLegEqThermal(double current_wind, double next_wind) const
   return no_wind_thermal + (s_opt + no_wind_thermal) / v_opt * next_wind;
 }
 
+/**
+ * The number of Newton steps used by GlidePolar::SolveStraightBatch()
+ * to find the best glide speed with MC=0.
+ */
+static constexpr unsigned NEWTON_STEPS = 2;
+
+void
+GlidePolar::SolveStraightBatch(const SpeedVector wind, const unsigned n,
+                               const double *gcc_restrict distance,
+                               const Angle *gcc_restrict bearing,
+                               const double *gcc_restrict altitude_difference,
+                               double *gcc_restrict arrival) const
+{
+  assert(IsValid());
+
+  const double wind_speed = wind.IsNonZero() ? wind.norm : 0.;
+  const double wind_speed_squared = Square(wind_speed);
+  const double upwind = wind.bearing.Reciprocal().Native();
+  const double efficiency_squared = Square(cruise_efficiency);
+  const double v_mc = VbestLD;
+  const double optimise_glide = mc > 0 ? 0. : 1.;
+
+  for (unsigned i = 0; i < n; ++i) {
+    const double head_wind =
+      -wind_speed * cos(upwind - bearing[i].Native());
+    const double cross_wind_squared = wind_speed_squared - Square(head_wind);
+
+    /* with MC=0, fly the speed with the best glide ratio over ground
+       (see MacCready::OptimiseGlide()); start with the head wind
+       approximation of GetBestGlideRatioSpeed(), and refine it with a
+       fixed number of Newton steps on the derivative of
+       sink_rate/ground_speed, which also considers the cross wind and
+       the cruise efficiency */
+    const double s = Square(head_wind) +
+      (polar.c + polar.b * head_wind) / polar.a;
+    double v_glide = Clamp(head_wind + sqrt(std::max(s, 0.)), Vmin, Vmax);
+
+    for (unsigned j = 0; j < NEWTON_STEPS; ++j) {
+      const double sink_rate = SinkRate(v_glide);
+      const double d_sink_rate = 2 * polar.a * v_glide + polar.b;
+
+      const double air = sqrt(std::max(Square(v_glide) * efficiency_squared
+                                       - cross_wind_squared, 1e-6));
+      const double ground_speed = air - head_wind;
+      const double d_ground_speed = efficiency_squared * v_glide / air;
+      const double dd_ground_speed = -efficiency_squared *
+        cross_wind_squared / (air * air * air);
+
+      const double f = d_sink_rate * ground_speed -
+        sink_rate * d_ground_speed;
+      const double df = 2 * polar.a * ground_speed -
+        sink_rate * dd_ground_speed;
+      v_glide = Clamp(v_glide - f / std::max(df, 1e-6), Vmin, Vmax);
+    }
+
+    const double v = v_mc + optimise_glide * (v_glide - v_mc);
+    const double sink_rate = SinkRate(v);
+
+    /* see GlideState::CalcAverageSpeed() */
+    const double v_eff = v * cruise_efficiency;
+    const double q = Square(v_eff) - cross_wind_squared;
+    const double ground_speed = sqrt(std::max(q, 0.)) - head_wind;
+
+    arrival[i] = ground_speed > 0
+      ? altitude_difference[i] - distance[i] * sink_rate / ground_speed
+      : UNREACHABLE;
+  }
+}
 
 double GlidePolar::GetAverageSpeed() const
 {
@@ -100,6 +100,14 @@ class GlidePolar
   /** Reference wing area, m^2 */
   double wing_area;
 
+  /**
+   * Identifies the current set of polar parameters.  It is assigned
+   * a new process-wide unique value whenever a parameter which
+   * affects glide solutions is modified, and is shared by copies.
+   * Used to invalidate cached solutions (see #MacCreadyTable).
+   */
+  unsigned serial;
+
   friend class GlidePolarTest;
 
 public:
@@ -186,6 +194,7 @@ public:
     if (update) {
       UpdateSMax();
       UpdateSMin();
+      UpdateSerial();
     }
   }
 
@@ -261,6 +270,7 @@ public:
    */
   void SetCruiseEfficiency(const double _ce) {
     cruise_efficiency = _ce;
+    UpdateSerial();
   }
 
   /**
@@ -505,6 +515,37 @@ public:
   gcc_pure
   double GetNextLegEqThermal(double current_wind, double next_wind) const;
 
+  /**
+   * Value stored by SolveStraightBatch() for targets which cannot be
+   * reached because the wind is too strong.
+   */
+  static constexpr double UNREACHABLE = -1e9;
+
+  /**
+   * Calculate the arrival altitude of straight glides to many targets
+   * in one pass.  For each target, this is equivalent to
+   * GlideResult::pure_glide_altitude_difference as calculated by
+   * MacCready::SolveStraight(), but the input is a structure of
+   * arrays and the loop has no branches, so the compiler can
+   * vectorise it.
+   *
+   * With MC=0, the speed to fly is found with a fixed number of
+   * Newton steps instead of the search in MacCready::OptimiseGlide().
+   *
+   * @param wind the wind vector
+   * @param n the number of targets
+   * @param distance the distance to each target [m]
+   * @param bearing the bearing to each target
+   * @param altitude_difference the aircraft altitude minus the
+   * minimum arrival altitude of each target [m]
+   * @param arrival receives the altitude above the minimum arrival
+   * altitude of each target [m], or #UNREACHABLE
+   */
+  void SolveStraightBatch(SpeedVector wind, unsigned n,
+                          const double *distance, const Angle *bearing,
+                          const double *altitude_difference,
+                          double *arrival) const;
+
   /** Returns the wing area in m^2 */
   double GetWingArea() const {
     return wing_area;
@@ -575,7 +616,19 @@ public:
   /** Calculate average speed in still air */
   double GetAverageSpeed() const;
 
+  /**
+   * Returns a value which identifies the current polar parameters.
+   * Two #GlidePolar instances with the same serial yield the same
+   * glide solutions.
+   */
+  unsigned GetSerial() const {
+    return serial;
+  }
+
 private:
+  /** Assign a new serial after a parameter has been modified */
+  void UpdateSerial();
+
   /** Update sink rate at max. cruise speed */
   void UpdateSMax();
 
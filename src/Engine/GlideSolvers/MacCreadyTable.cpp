@@ -0,0 +1,219 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#include "MacCreadyTable.hpp"
+#include "MacCready.hpp"
+#include "GlidePolar.hpp"
+#include "GlideState.hpp"
+#include "GlideResult.hpp"
+
+#include <algorithm>
+
+#include <assert.h>
+
+/**
+ * The leg length used to fill the table.  The results are divided by
+ * this value.
+ */
+static constexpr double REFERENCE_DISTANCE = 1000;
+
+/**
+ * The maximum ratio between the time_elapsed values of neighbouring
+ * cells which may be interpolated.
+ */
+static constexpr double MAX_TIME_RATIO = 1.1;
+
+bool
+MacCreadyTable::IsValid(const GlidePolar &polar,
+                        const SpeedVector &_wind) const
+{
+  return defined && serial == polar.GetSerial() && SameWind(wind, _wind);
+}
+
+void
+MacCreadyTable::Update(const GlideSettings &settings,
+                       const GlidePolar &polar, const SpeedVector &_wind,
+                       unsigned n_solutions)
+{
+  if (IsValid(polar, _wind))
+    return;
+
+  defined = false;
+
+  if (pending_solutions == 0 || pending_serial != polar.GetSerial() ||
+      !SameWind(pending_wind, _wind)) {
+    pending_wind = _wind;
+    pending_serial = polar.GetSerial();
+    pending_solutions = 0;
+  }
+
+  pending_solutions += n_solutions;
+  if (pending_solutions >= N_CELLS)
+    Build(settings, polar, _wind);
+}
+
+void
+MacCreadyTable::Build(const GlideSettings &settings,
+                      const GlidePolar &polar, const SpeedVector &_wind)
+{
+  if (IsValid(polar, _wind))
+    return;
+
+  defined = false;
+  pending_solutions = 0;
+  if (!polar.IsValid())
+    return;
+
+  if (cells == nullptr)
+    cells.reset(new Cell[N_CELLS]);
+
+  wind = _wind;
+  serial = polar.GetSerial();
+
+  const MacCready mac_cready(settings, polar);
+  const Angle upwind = wind.bearing.Reciprocal();
+
+  for (unsigned i = 0; i < ANGLE_STEPS; ++i) {
+    /* choose the leg bearing so GlideState::effective_wind_angle
+       equals this row's angle */
+    const Angle bearing = upwind - Angle::Degrees(i * ANGLE_STEP);
+
+    for (unsigned j = 0; j < GRADIENT_STEPS; ++j) {
+      const double gradient = MIN_GRADIENT + j * GRADIENT_STEP;
+      const GlideState task(GeoVector(REFERENCE_DISTANCE, bearing),
+                            0, gradient * REFERENCE_DISTANCE, wind);
+      const GlideResult result = mac_cready.Solve(task);
+
+      Cell &cell = cells[i * GRADIENT_STEPS + j];
+      cell.valid = result.IsOk() &&
+        result.vector.distance >= REFERENCE_DISTANCE;
+      if (!cell.valid)
+        continue;
+
+      cell.time_elapsed = result.time_elapsed / REFERENCE_DISTANCE;
+      cell.time_virtual = result.time_virtual / REFERENCE_DISTANCE;
+      cell.height_climb = result.height_climb / REFERENCE_DISTANCE;
+      cell.height_glide = result.height_glide / REFERENCE_DISTANCE;
+      cell.pure_glide_height = result.pure_glide_height / REFERENCE_DISTANCE;
+      cell.v_opt = result.v_opt;
+      cell.effective_wind_speed = result.effective_wind_speed;
+      cell.final_glide = result.height_climb <= 0;
+    }
+  }
+
+  defined = true;
+}
+
+static constexpr double
+Interpolate(double a, double b, double c, double d, double x, double y)
+{
+  return (a * (1 - x) + b * x) * (1 - y) + (c * (1 - x) + d * x) * y;
+}
+
+bool
+MacCreadyTable::Lookup(const GlideState &task, GlideResult &result) const
+{
+  assert(defined);
+
+  if (task.vector.distance <= 0)
+    return false;
+
+  const double gradient = task.altitude_difference / task.vector.distance;
+  if (gradient < MIN_GRADIENT)
+    return false;
+
+  double x = wind.IsNonZero()
+    ? task.effective_wind_angle.AsDelta().Absolute().Degrees() / ANGLE_STEP
+    : 0.;
+  unsigned i = unsigned(x);
+  if (i > ANGLE_STEPS - 2)
+    i = ANGLE_STEPS - 2;
+  x -= i;
+
+  double y = (gradient - MIN_GRADIENT) / GRADIENT_STEP;
+  unsigned j = unsigned(y);
+  if (j > GRADIENT_STEPS - 2)
+    j = GRADIENT_STEPS - 2;
+  y -= j;
+
+  const Cell &a = GetCell(i, j), &b = GetCell(i + 1, j);
+  const Cell &c = GetCell(i, j + 1), &d = GetCell(i + 1, j + 1);
+  if (!a.valid || !b.valid || !c.valid || !d.valid)
+    return false;
+
+  /* don't interpolate across the boundary between final glide and
+     climb-cruise; the solution has a kink there */
+  if (a.final_glide != b.final_glide || a.final_glide != c.final_glide ||
+      a.final_glide != d.final_glide)
+    return false;
+
+  /* the solution becomes very non-linear when the wind speed comes
+     close to the achievable cross-country speed; interpolation is
+     not accurate enough there */
+  const double min_time = std::min({a.time_elapsed, b.time_elapsed,
+                                    c.time_elapsed, d.time_elapsed});
+  const double max_time = std::max({a.time_elapsed, b.time_elapsed,
+                                    c.time_elapsed, d.time_elapsed});
+  if (max_time > min_time * MAX_TIME_RATIO)
+    return false;
+
+  if (y > 1) {
+    /* above the table: the per-metre solution of a final glide does
+       not depend on the gradient, so the top row can be used */
+    if (!c.final_glide)
+      return false;
+
+    y = 1;
+  }
+
+#define INTERPOLATE(field) Interpolate(a.field, b.field, c.field, d.field, x, y)
+
+  const double distance = task.vector.distance;
+
+  result = GlideResult(task, INTERPOLATE(v_opt));
+  result.time_elapsed = INTERPOLATE(time_elapsed) * distance;
+  result.time_virtual = INTERPOLATE(time_virtual) * distance;
+  result.height_climb = a.final_glide
+    ? 0.
+    : INTERPOLATE(height_climb) * distance;
+  result.height_glide = INTERPOLATE(height_glide) * distance;
+  result.pure_glide_height = INTERPOLATE(pure_glide_height) * distance;
+  result.altitude_difference -= result.height_glide;
+  result.pure_glide_altitude_difference -= result.pure_glide_height;
+  result.effective_wind_speed = INTERPOLATE(effective_wind_speed);
+  result.validity = GlideResult::Validity::OK;
+
+#undef INTERPOLATE
+
+  return true;
+}
+
+GlideResult
+MacCreadyTable::Solve(const GlideSettings &settings, const GlidePolar &polar,
+                      const GlideState &task) const
+{
+  GlideResult result;
+  if (IsValid(polar, task.wind) && Lookup(task, result))
+    return result;
+
+  return MacCready::Solve(settings, polar, task);
+}
@@ -0,0 +1,185 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef MACCREADY_TABLE_HPP
+#define MACCREADY_TABLE_HPP
+
+#include "Geo/SpeedVector.hpp"
+#include "Compiler.h"
+
+#include <memory>
+
+class GlidePolar;
+struct GlideSettings;
+struct GlideState;
+struct GlideResult;
+
+/**
+ * A cache of MacCready solutions for one #GlidePolar and one wind
+ * vector.  It stores the solution for a leg of unit length as a
+ * function of the leg's direction relative to the wind and of its
+ * glide gradient (altitude difference divided by distance).  All
+ * MacCready solutions scale linearly with the leg length at a
+ * constant gradient, so every leg can be solved by bilinear
+ * interpolation between the table cells.
+ *
+ * Cells which straddle the boundary between final glide and
+ * climb-cruise, and legs outside of the table's range, are passed to
+ * the analytic solver (MacCready::Solve()).
+ *
+ * The table is bound to GlidePolar::GetSerial(); it needs to be
+ * rebuilt (see Update()) when the MacCready setting, bugs, ballast
+ * or the wind change.
+ *
+ * Building the table costs one MacCready::Solve() per cell (1221),
+ * while a lookup saves between nothing and 0.9 us compared to
+ * MacCready::Solve() (x86-64, -O2).  A table for a wind which changes
+ * on every fix would cost more than it saves, so Update() postpones
+ * the rebuild until the caller has requested as many solutions for
+ * the same polar and wind as the table has cells; until then,
+ * Solve() uses the analytic solver.  This limits the overhead to
+ * about twice the cost of solving directly.
+ */
+class MacCreadyTable
+{
+  /** Number of wind-relative directions, from 0 to 180 degrees */
+  static constexpr unsigned ANGLE_STEPS = 37;
+  static constexpr double ANGLE_STEP = 180. / (ANGLE_STEPS - 1);
+
+  /** Number of glide gradient rows */
+  static constexpr unsigned GRADIENT_STEPS = 33;
+  static constexpr double MIN_GRADIENT = -0.08;
+  static constexpr double MAX_GRADIENT = 0.08;
+  static constexpr double GRADIENT_STEP =
+    (MAX_GRADIENT - MIN_GRADIENT) / (GRADIENT_STEPS - 1);
+
+  /**
+   * The solution of a leg of unit length (per metre of distance).
+   */
+  struct Cell {
+    double time_elapsed;
+    double time_virtual;
+    double height_climb;
+    double height_glide;
+    double pure_glide_height;
+
+    /** Optimal speed to fly (m/s); not scaled */
+    double v_opt;
+
+    /** Effective wind speed (m/s); not scaled */
+    double effective_wind_speed;
+
+    /** Was the solution valid (GlideResult::Validity::OK)? */
+    bool valid;
+
+    /** Can the leg be flown without climbing? */
+    bool final_glide;
+  };
+
+  static constexpr unsigned N_CELLS = ANGLE_STEPS * GRADIENT_STEPS;
+
+  /**
+   * The cells, allocated by the first rebuild; row-major by angle.
+   */
+  std::unique_ptr<Cell[]> cells;
+
+  /** The wind vector this table was built for */
+  SpeedVector wind;
+
+  /** The GlidePolar::GetSerial() value this table was built for */
+  unsigned serial;
+
+  bool defined;
+
+  /** The polar and wind of the postponed rebuild, see Update() */
+  SpeedVector pending_wind;
+  unsigned pending_serial;
+
+  /**
+   * The number of solutions requested for #pending_wind and
+   * #pending_serial since they were last changed.
+   */
+  unsigned pending_solutions;
+
+public:
+  MacCreadyTable():defined(false), pending_solutions(0) {}
+
+  /**
+   * Discard the table contents.
+   */
+  void Clear() {
+    defined = false;
+    pending_solutions = 0;
+  }
+
+  /**
+   * Was this table built for the given polar and wind?
+   */
+  gcc_pure
+  bool IsValid(const GlidePolar &polar, const SpeedVector &_wind) const;
+
+  /**
+   * Rebuild the table if the polar or the wind has changed, and if
+   * enough solutions were requested for them to pay for the rebuild.
+   *
+   * @param n_solutions the number of solutions the caller is going to
+   * request with these parameters
+   */
+  void Update(const GlideSettings &settings, const GlidePolar &polar,
+              const SpeedVector &_wind, unsigned n_solutions);
+
+  /**
+   * Rebuild the table now if the polar or the wind has changed.
+   */
+  void Build(const GlideSettings &settings, const GlidePolar &polar,
+             const SpeedVector &_wind);
+
+  /**
+   * Calculate the glide solution for the given task.  This is a drop-in
+   * replacement for MacCready::Solve(), which is used if the table is
+   * not valid for the polar and wind, or if the task is outside of the
+   * table.
+   */
+  gcc_pure
+  GlideResult Solve(const GlideSettings &settings, const GlidePolar &polar,
+                    const GlideState &task) const;
+
+  /**
+   * Look up the task in the table.  The caller must check IsValid()
+   * first.
+   *
+   * @return false if the task could not be solved by interpolation
+   */
+  bool Lookup(const GlideState &task, GlideResult &result) const;
+
+private:
+  gcc_pure
+  static bool SameWind(const SpeedVector &a, const SpeedVector &b) {
+    return a.norm == b.norm && (a.IsZero() || a.bearing == b.bearing);
+  }
+
+  const Cell &GetCell(unsigned i, unsigned j) const {
+    return cells[i * GRADIENT_STEPS + j];
+  }
+};
+
+#endif
@@ -27,6 +27,11 @@ Copyright_License {
 #include "Util/ReservablePriorityQueue.hpp"
 #include "Compiler.h"
 
+#include <algorithm>
+#include <vector>
+
+#include <assert.h>
+
 #define DIJKSTRA_MINMAX_OFFSET 134217727
 
 /**
@@ -201,6 +206,94 @@ public:
     q.reserve(size);
   }
 
+  /**
+   * Translate all nodes, e.g. after their indices have changed.
+   * Nodes which cannot be translated are removed, and so are all
+   * nodes whose path leads through a removed node.  All other nodes
+   * keep their values, and the search queue is preserved.  This hack
+   * is needed for "continuous" search, see
+   * ContestDijkstra::RepairEdges().
+   *
+   * Each node must compare less than its children (Node::operator<),
+   * which allows checking the paths in one pass.
+   *
+   * @param translate a function which translates the given node in
+   * place and returns false if the node has been removed
+   * @param unlinked a function which is called with each
+   * (translated) node which still exists, but whose path has been
+   * removed
+   */
+  template<typename T, typename U>
+  void Remap(T &&translate, U &&unlinked) {
+    /* remember the nodes which are waiting in the queue, skipping
+       entries which have been superseded by a better link */
+    std::vector<Node> queued;
+    queued.reserve(q.size());
+    for (const auto &i : q.container())
+      if (i.iterator->second.value == i.edge_value)
+        queued.push_back(i.iterator->first);
+
+    q.clear();
+
+    /* parents first */
+    std::vector<std::pair<Node, Edge>> old_edges(edges.begin(), edges.end());
+    std::sort(old_edges.begin(), old_edges.end(),
+              [](const std::pair<Node, Edge> &a,
+                 const std::pair<Node, Edge> &b){
+                return a.first < b.first;
+              });
+
+    edges.clear();
+
+    for (const auto &i : old_edges) {
+      Node node = i.first;
+      if (!translate(node))
+        continue;
+
+      Node parent = i.second.parent;
+      if (parent == i.first)
+        /* a start node */
+        parent = node;
+      else if (!translate(parent) || edges.find(parent) == edges.end()) {
+        unlinked(node);
+        continue;
+      }
+
+      edges.insert(std::make_pair(node, Edge(parent, i.second.value)));
+    }
+
+    for (Node node : queued) {
+      if (!translate(node))
+        continue;
+
+      edge_iterator it = edges.find(node);
+      if (it != edges.end())
+        q.push(Value(it->second.value, it));
+    }
+  }
+
+  /**
+   * Call the given function with each node which is waiting in the
+   * queue.  This hack is needed for "continuous" search, see
+   * ContestDijkstra::RepairEdges().
+   */
+  template<typename F>
+  void VisitQueued(F &&f) const {
+    for (const auto &i : q.container())
+      if (i.iterator->second.value == i.edge_value)
+        f(i.iterator->first);
+  }
+
+  /**
+   * Put a known node back into the queue, e.g. a final node which
+   * shall be reported again.  It must not be in the queue already.
+   */
+  void Requeue(const Node node) {
+    edge_iterator it = edges.find(node);
+    assert(it != edges.end());
+    q.push(Value(it->second.value, it));
+  }
+
   /**
    * Clear the queue and re-insert all known links.
    */
@@ -233,6 +326,13 @@ private:
       // If the node was found and the new value is smaller
       // -> Replace the value with the new one
       it->second = Edge(parent, edge_value);
+    else if (it->second.value == edge_value && parent < it->second.parent) {
+      // If the node was found with the same value
+      // -> Prefer the lower parent, so the solution doesn't depend on
+      //    the order in which links were added
+      it->second.parent = parent;
+      return false;
+    }
     else
       // If the node was found but the new value is higher or equal
       // -> Don't use this new leg
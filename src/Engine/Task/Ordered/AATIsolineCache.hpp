@@ -0,0 +1,104 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+ */
+
+#ifndef AATISOLINE_CACHE_HPP
+#define AATISOLINE_CACHE_HPP
+
+#include "Geo/GeoPoint.hpp"
+#include "Compiler.h"
+
+#include <memory>
+
+class AATPoint;
+class AATIsolineSegment;
+class FlatProjection;
+
+/**
+ * Remembers the #AATIsolineSegment of the active #AATPoint and the
+ * last solution of the target optimiser (#TaskOptTarget) between
+ * calls.  Finding the end points of the segment is expensive, but
+ * the segment only changes when the observation zone, the previous
+ * or next leg, or the target (other than by moving along the
+ * isoline) changes.
+ *
+ * Call Clear() when the task geometry changes.
+ */
+class AATIsolineCache
+{
+  /** the point the segment was built for; nullptr if empty */
+  const AATPoint *point;
+
+  /** the foci of the isoline ellipse */
+  GeoPoint previous, next;
+
+  /**
+   * The target the segment was built for, and the target found by
+   * the last optimisation.  Both are on the isoline.
+   */
+  GeoPoint origin, solution;
+
+  std::unique_ptr<AATIsolineSegment> segment;
+
+  /** the isoline parameter of #solution */
+  double parameter;
+
+public:
+  AATIsolineCache();
+  ~AATIsolineCache();
+
+  void Clear() {
+    point = nullptr;
+  }
+
+  /**
+   * Return the isoline segment of the given point, and rebuild it if
+   * the cached one is not valid.
+   */
+  const AATIsolineSegment &Get(const AATPoint &ap,
+                               const FlatProjection &projection);
+
+  /**
+   * Returns the isoline parameter of the last solution, to be used
+   * as starting point of the next search; 0.5 (the middle of the
+   * segment) if no solution is known.
+   */
+  double GetParameter() const {
+    return parameter;
+  }
+
+  /**
+   * Store the result of a successful optimisation.
+   *
+   * @param p the isoline parameter
+   * @param target the new target location
+   */
+  void SetSolution(double p, const GeoPoint &target) {
+    parameter = p;
+    solution = target;
+  }
+
+private:
+  gcc_pure
+  bool IsValid(const AATPoint &ap) const;
+};
+
+#endif
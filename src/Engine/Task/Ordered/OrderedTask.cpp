@@ -25,6 +25,7 @@
 #include "Points/OrderedTaskPoint.hpp"
 #include "Points/StartPoint.hpp"
 #include "Points/FinishPoint.hpp"
+#include "Points/AATPoint.hpp"
 #include "Task/Solvers/TaskMacCreadyTravelled.hpp"
 #include "Task/Solvers/TaskMacCreadyRemaining.hpp"
 #include "Task/Solvers/TaskMacCreadyTotal.hpp"
@@ -153,6 +154,8 @@ OrderedTask::UpdateStatsGeometry()
 void
 OrderedTask::UpdateGeometry()
 {
+  isoline_cache.Clear();
+
   UpdateStatsGeometry();
 
   if (task_points.empty())
@@ -630,11 +633,18 @@ OrderedTask::UpdateIdle(const AircraftState &state,
     if (task_behaviour.optimise_targets_bearing &&
         task_points[active_task_point]->GetType() == TaskPointType::AAT) {
       AATPoint *ap = (AATPoint *)task_points[active_task_point];
+      const AATIsolineSegment &iso =
+        isoline_cache.Get(*ap, task_projection);
       // very nasty hack
       TaskOptTarget tot(task_points, active_task_point, state,
                         task_behaviour.glide, glide_polar,
-                        *ap, task_projection, taskpoint_start);
-      tot.search(0.5);
+                        *ap, iso, taskpoint_start);
+
+      /* start at the previous solution; if it is still optimal, the
+         search is done after three evaluations */
+      const double p = tot.search(isoline_cache.GetParameter());
+      if (p >= 0)
+        isoline_cache.SetSolution(p, ap->GetTargetLocation());
     }
     retval = true;
   }
@@ -725,6 +735,7 @@ OrderedTask::ScanStartFinish()
 inline void
 OrderedTask::ErasePoint(const unsigned index)
 {
+  isoline_cache.Clear();
   delete task_points[index];
   task_points.erase(task_points.begin() + index);
 }
@@ -848,6 +859,7 @@ OrderedTask::Replace(const OrderedTaskPoint &new_tp, const unsigned position)
       (position + 1 < task_points.size() && !new_tp.IsSuccessorAllowed()))
     return false;
 
+  isoline_cache.Clear();
   delete task_points[position];
   task_points[position] = new_tp.Clone(task_behaviour, ordered_settings);
 
@@ -1443,6 +1455,8 @@ OrderedTask::GetFactoryTypes(gcc_unused bool all) const
 void
 OrderedTask::RemoveAllPoints()
 {
+  isoline_cache.Clear();
+
   for (auto i : task_points)
     delete i;
 
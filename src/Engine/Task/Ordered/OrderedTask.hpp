@@ -26,6 +26,7 @@
 #include "Geo/Flat/TaskProjection.hpp"
 #include "Task/AbstractTask.hpp"
 #include "SmartTaskAdvance.hpp"
+#include "AATIsolineCache.hpp"
 #include "Waypoint/Ptr.hpp"
 #include "Util/DereferenceIterator.hpp"
 #include "Util/StaticString.hxx"
@@ -86,6 +87,9 @@ private:
   TaskDijkstraMin *dijkstra_min;
   TaskDijkstraMax *dijkstra_max;
 
+  /** Isoline of the active AATPoint, used by the target optimiser */
+  AATIsolineCache isoline_cache;
+
   StaticString<64> name;
 
 public:
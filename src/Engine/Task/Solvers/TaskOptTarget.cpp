@@ -32,7 +32,7 @@ TaskOptTarget::TaskOptTarget(const std::vector<OrderedTaskPoint*>& tps,
                              const GlideSettings &settings,
                              const GlidePolar &_gp,
                              AATPoint &_tp_current,
-                             const FlatProjection &projection,
+                             const AATIsolineSegment &_iso,
                              StartPoint *_ts)
   :ZeroFinder(0.02, 0.98, TOLERANCE_OPT_TARGET),
    tm(tps.cbegin(), tps.cend(), activeTaskPoint, settings, _gp,
@@ -41,7 +41,7 @@ TaskOptTarget::TaskOptTarget(const std::vector<OrderedTaskPoint*>& tps,
    aircraft(_aircraft),
    tp_start(_ts),
    tp_current(_tp_current),
-   iso(_tp_current, projection)
+   iso(_iso)
 {
 }
 
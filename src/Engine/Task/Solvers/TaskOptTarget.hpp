@@ -52,7 +52,7 @@ class TaskOptTarget final : public ZeroFinder
   /** Active AATPoint */
   AATPoint &tp_current;
   /** Isoline for active AATPoint target */
-  AATIsolineSegment iso;
+  const AATIsolineSegment &iso;
 
 public:
   /**
@@ -63,6 +63,8 @@ public:
    * @param _aircraft Current aircraft state
    * @param _gp Glide polar to copy for calculations
    * @param _tp_current Active AATPoint
+   * @param _iso Isoline segment of the active AATPoint (see
+   * AATIsolineCache)
    * @param _ts StartPoint of task (to initiate scans)
    */
   TaskOptTarget(const std::vector<OrderedTaskPoint*>& tps,
@@ -70,7 +72,7 @@ public:
                 const AircraftState &_aircraft,
                 const GlideSettings &settings, const GlidePolar &_gp,
                 AATPoint& _tp_current,
-                const FlatProjection &projection,
+                const AATIsolineSegment &_iso,
                 StartPoint *_ts);
 
   virtual double f(double p);
@@ -90,7 +92,9 @@ public:
    *
    * Running this adjusts the target values for the active task point.
    *
-   * @param p Default isoline value (0-1)
+   * @param p Initial isoline value (0-1); the search finishes
+   * quickly if this is already the optimum, e.g. the result of the
+   * previous search
    *
    * @return Isoline value for solution
    */
@@ -25,8 +25,8 @@
 #include "AlternateList.hpp"
 #include "Navigation/Aircraft.hpp"
 #include "Task/Visitors/TaskPointVisitor.hpp"
-#include "Task/Solvers/TaskSolution.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
+#include "GlideSolvers/GlideState.hpp"
 #include "Waypoint/Waypoints.hpp"
 #include "Waypoint/WaypointVisitor.hpp"
 #include "Util/ReservablePriorityQueue.hpp"
@@ -159,9 +159,9 @@ AbortTask::FillReachable(const AircraftState &state,
 
     auto wp = v->waypoint;
     UnorderedTaskPoint t(std::move(wp), task_behaviour);
-    GlideResult result =
-        TaskSolution::GlideSolutionRemaining(t, state,
-                                             task_behaviour.glide, polar);
+    const GlideResult result =
+      glide_table.Solve(task_behaviour.glide, polar,
+                        GlideState::Remaining(t, state, 0));
 
     if (IsReachable(result, final_glide)) {
       bool intersects = false;
@@ -271,6 +271,10 @@ AbortTask::UpdateSample(const AircraftState &state,
     return false;
   }
 
+  /* the candidates are scanned in up to three passes below */
+  glide_table.Update(task_behaviour.glide, glide_polar, state.wind,
+                     3 * approx_waypoints.size());
+
   // sort by arrival time
 
   // first try with final glide only
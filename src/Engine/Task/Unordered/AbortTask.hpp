@@ -25,6 +25,7 @@
 
 #include "UnorderedTask.hpp"
 #include "UnorderedTaskPoint.hpp"
+#include "GlideSolvers/MacCreadyTable.hpp"
 
 #include <vector>
 
@@ -80,6 +81,13 @@ private:
   unsigned active_waypoint;
   bool reachable_landable;
 
+  /**
+   * Cached glide solutions for the polar and wind of the current
+   * update; all candidate waypoints are solved with the same
+   * parameters.
+   */
+  MacCreadyTable glide_table;
+
 public:
   /** 
    * Base constructor.
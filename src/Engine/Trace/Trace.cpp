@@ -456,3 +456,31 @@ Trace::GetPoints(TracePointVector &v, unsigned min_time,
     i.NextSquareRange(sq_range, end);
   } while (i != end);
 }
+
+bool
+Trace::SyncPoints(TracePointVector &v,
+                  const GeoPoint &location, double min_distance) const
+{
+  assert(!v.empty());
+  assert(!empty());
+
+  /* find the last point which was copied; it is still there, because
+     nothing but appending has happened since */
+  const unsigned last_time = v.back().GetTime();
+  Trace::const_iterator i = end();
+  do {
+    assert(i != begin());
+    --i;
+  } while (i->GetTime() > last_time);
+
+  assert(i->GetTime() == last_time);
+
+  const size_t old_size = v.size();
+  const unsigned range = ProjectRange(location, min_distance);
+  const unsigned sq_range = range * range;
+  for (i.NextSquareRange(sq_range, end()); i != end();
+       i.NextSquareRange(sq_range, end()))
+    v.push_back(*i);
+
+  return v.size() > old_size;
+}
@@ -397,6 +397,17 @@ public:
   void GetPoints(TracePointVector &v, unsigned min_time,
                  const GeoPoint &location, double resolution) const;
 
+  /**
+   * Update a #TracePointVector which was filled by GetPoints() with
+   * the same resolution, after points were appended to this object:
+   * only the new points are filtered and appended.  This must not be
+   * called after thinning has occurred, see GetModifySerial().
+   *
+   * @return true if new points were added
+   */
+  bool SyncPoints(TracePointVector &v,
+                  const GeoPoint &location, double resolution) const;
+
   const TracePoint &front() const {
     assert(!empty());
 
@@ -499,8 +510,8 @@ public:
         if (*this == end)
           return *this;
 
-        const TraceDelta &td = (const TraceDelta &)**this;
-        if (td.point.FlatSquareDistanceTo(previous) >= sq_resolution)
+        const TracePoint &point = **this;
+        if (point.FlatSquareDistanceTo(previous) >= sq_resolution)
           return *this;
       }
     }
@@ -29,8 +29,6 @@ Copyright_License {
 #include "FLARM/Status.hpp"
 #include "FLARM/List.hpp"
 
-#include <type_traits>
-
 /**
  * A container for all data received by a FLARM.
  */
@@ -69,6 +67,4 @@ struct FlarmData {
   }
 };
 
-static_assert(std::is_trivial<FlarmData>::value, "type is not trivial");
-
 #endif
@@ -62,7 +62,11 @@ FlarmComputer::Process(FlarmData &flarm, const FlarmData &last_flarm,
   }
 
   // for each item in traffic
-  for (auto &traffic : flarm.traffic.list) {
+  if (flarm.traffic.IsEmpty())
+    /* don't allocate an array for nothing */
+    return;
+
+  for (auto &traffic : flarm.traffic.list.Modify()) {
     // if we don't know the target's name yet
     if (!traffic.HasName()) {
       // lookup the name of this target's id
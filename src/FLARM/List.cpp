@@ -23,6 +23,140 @@ Copyright_License {
 
 #include "List.hpp"
 
+#include <algorithm>
+
+#include <assert.h>
+
+std::vector<FlarmTraffic> &
+TrafficArray::Modify()
+{
+  if (buffer == nullptr)
+    buffer = new Buffer();
+  else if (buffer->references.load(std::memory_order_acquire) > 1) {
+    Buffer *copy = new Buffer(*buffer);
+    Unref();
+    buffer = copy;
+  }
+
+  return buffer->items;
+}
+
+/**
+ * Would FlarmTraffic::Refresh() expire this target?  Refresh() does
+ * not modify targets which are still valid, so the (possibly shared)
+ * array needs to be modified only if this returns true for one of
+ * them.
+ */
+gcc_pure
+static bool
+IsExpired(const FlarmTraffic &traffic, double clock)
+{
+  FlarmTraffic copy = traffic;
+  return !copy.Refresh(clock);
+}
+
+void
+TrafficList::Expire(double clock)
+{
+  modified.Expire(clock, 300);
+  new_traffic.Expire(clock, 60);
+  overflow.Expire(clock, 60);
+
+  const auto expired = [clock](const FlarmTraffic &traffic){
+    return IsExpired(traffic, clock);
+  };
+
+  if (std::none_of(list.begin(), list.end(), expired))
+    return;
+
+  /* remove_if() instead of swapping with the last element preserves
+     the order */
+  auto &items = list.Modify();
+  items.erase(std::remove_if(items.begin(), items.end(), expired),
+              items.end());
+}
+
+const FlarmTraffic *
+TrafficList::FindTraffic(FlarmId id) const
+{
+  for (const auto &traffic : list)
+    if (traffic.id == id)
+      return &traffic;
+
+  return NULL;
+}
+
+FlarmTraffic *
+TrafficList::ModifyTraffic(FlarmId id)
+{
+  const FlarmTraffic *traffic = FindTraffic(id);
+  if (traffic == NULL)
+    return NULL;
+
+  const unsigned i = TrafficIndex(traffic);
+  return &list.Modify()[i];
+}
+
+gcc_pure
+static double
+GetSquaredDistance(const FlarmTraffic &traffic)
+{
+  return traffic.relative_north * traffic.relative_north +
+    traffic.relative_east * traffic.relative_east;
+}
+
+/**
+ * Is #a more critical than #b?  A higher alarm level wins; if the
+ * levels match, the smaller distance wins.
+ */
+gcc_pure
+static bool
+IsMoreCritical(const FlarmTraffic &a, const FlarmTraffic &b)
+{
+  return (unsigned)a.alarm_level > (unsigned)b.alarm_level ||
+    (a.alarm_level == b.alarm_level &&
+     GetSquaredDistance(a) < GetSquaredDistance(b));
+}
+
+bool
+TrafficList::MakeRoom(const FlarmTraffic &traffic, double clock)
+{
+  if (list.size() < MAX_COUNT)
+    return true;
+
+  overflow.Update(clock);
+
+  const FlarmTraffic *victim = NULL;
+  for (const auto &i : list)
+    if (victim == NULL || IsMoreCritical(*victim, i))
+      victim = &i;
+
+  if (!IsMoreCritical(traffic, *victim))
+    return false;
+
+  const unsigned i = TrafficIndex(victim);
+  auto &items = list.Modify();
+  items.erase(items.begin() + i);
+  return true;
+}
+
+FlarmTraffic *
+TrafficList::AllocateTraffic(FlarmId id)
+{
+  assert(FindTraffic(id) == NULL);
+
+  if (list.size() >= MAX_COUNT)
+    return NULL;
+
+  auto &items = list.Modify();
+  items.emplace_back();
+
+  FlarmTraffic &traffic = items.back();
+  traffic.Clear();
+  traffic.id = id;
+  return &traffic;
+}
+
 const FlarmTraffic *
 TrafficList::FindMaximumAlert() const
 {
@@ -40,3 +174,20 @@ TrafficList::FindMaximumAlert() const
 
   return alert;
 }
+
+const FlarmTraffic *
+TrafficList::FindNearest() const
+{
+  const FlarmTraffic *nearest = NULL;
+  double nearest_distance = 0;
+
+  for (const auto &traffic : list) {
+    const double d = GetSquaredDistance(traffic);
+    if (nearest == NULL || d < nearest_distance) {
+      nearest = &traffic;
+      nearest_distance = d;
+    }
+  }
+
+  return nearest;
+}
@@ -26,16 +26,118 @@ Copyright_License {
 
 #include "Traffic.hpp"
 #include "NMEA/Validity.hpp"
-#include "Util/TrivialArray.hxx"
+#include "Compiler.h"
 
-#include <type_traits>
+#include <atomic>
+#include <vector>
+
+#include <stddef.h>
+
+/**
+ * An array of #FlarmTraffic objects which is shared between copies
+ * (copy on write).  Copying it only increments a reference counter,
+ * which keeps the #NMEAInfo and #MoreData copies on the blackboards
+ * cheap, no matter how many targets there are.
+ *
+ * The const methods never modify the array.  Modify() returns a
+ * private copy of the array if it is shared; a shared array is never
+ * modified, so other threads may read their copy without a lock.
+ */
+class TrafficArray {
+  struct Buffer {
+    std::atomic<unsigned> references;
+    std::vector<FlarmTraffic> items;
+
+    Buffer():references(1) {}
+    Buffer(const Buffer &src):references(1), items(src.items) {}
+  };
+
+  Buffer *buffer = nullptr;
+
+public:
+  typedef const FlarmTraffic *const_iterator;
+
+  TrafficArray() = default;
+
+  TrafficArray(const TrafficArray &src):buffer(src.buffer) {
+    Ref();
+  }
+
+  ~TrafficArray() {
+    Unref();
+  }
+
+  TrafficArray &operator=(const TrafficArray &src) {
+    if (buffer != src.buffer) {
+      Unref();
+      buffer = src.buffer;
+      Ref();
+    }
+
+    return *this;
+  }
+
+  unsigned size() const {
+    return buffer != nullptr ? buffer->items.size() : 0;
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  const_iterator begin() const {
+    return buffer != nullptr ? buffer->items.data() : nullptr;
+  }
+
+  const_iterator end() const {
+    return begin() + size();
+  }
+
+  const FlarmTraffic &operator[](unsigned i) const {
+    return buffer->items[i];
+  }
+
+  /**
+   * Release the array.
+   */
+  void clear() {
+    Unref();
+    buffer = nullptr;
+  }
+
+  /**
+   * Returns the array for modification; it is copied first if it is
+   * shared with another #TrafficArray.  Pointers obtained before are
+   * invalidated.
+   */
+  std::vector<FlarmTraffic> &Modify();
+
+private:
+  void Ref() {
+    if (buffer != nullptr)
+      buffer->references.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void Unref() {
+    if (buffer != nullptr &&
+        buffer->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete buffer;
+  }
+};
 
 /**
  * This class keeps track of the traffic objects received from a
  * FLARM.
+ *
+ * The items in #list keep their order (the order in which they were
+ * first received), which gives the user interface a stable order.
  */
 struct TrafficList {
-  static constexpr size_t MAX_COUNT = 25;
+  /**
+   * The maximum number of targets.  If more are received, the least
+   * critical ones are discarded (see MakeRoom()).
+   */
+  static constexpr size_t MAX_COUNT = 512;
 
   /**
    * Time stamp of the latest modification to this object.
@@ -47,12 +149,18 @@ struct TrafficList {
    */
   Validity new_traffic;
 
+  /**
+   * When was a target discarded because #list was full?
+   */
+  Validity overflow;
+
   /** Flarm traffic information */
-  TrivialArray<FlarmTraffic, MAX_COUNT> list;
+  TrafficArray list;
 
   void Clear() {
     modified.Clear();
     new_traffic.Clear();
+    overflow.Clear();
     list.clear();
   }
 
@@ -69,14 +177,7 @@ struct TrafficList {
       *this = add;
   }
 
-  void Expire(double clock) {
-    modified.Expire(clock, 300);
-    new_traffic.Expire(clock, 60);
-
-    for (unsigned i = list.size(); i-- > 0;)
-      if (!list[i].Refresh(clock))
-        list.quick_remove(i);
-  }
+  void Expire(double clock);
 
   unsigned GetActiveTrafficCount() const {
     return list.size();
@@ -88,66 +189,54 @@ struct TrafficList {
    * @param id FLARM id
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
-  FlarmTraffic *FindTraffic(FlarmId id) {
-    for (auto &traffic : list)
-      if (traffic.id == id)
-        return &traffic;
-
-    return NULL;
-  }
+  gcc_pure
+  const FlarmTraffic *FindTraffic(FlarmId id) const;
 
   /**
    * Looks up an item in the traffic list.
    *
-   * @param id FLARM id
+   * @param name the name or call sign
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
-  const FlarmTraffic *FindTraffic(FlarmId id) const {
+  gcc_pure
+  const FlarmTraffic *FindTraffic(const TCHAR *name) const {
     for (const auto &traffic : list)
-      if (traffic.id == id)
+      if (traffic.name.equals(name))
         return &traffic;
 
     return NULL;
   }
 
   /**
-   * Looks up an item in the traffic list.
+   * Looks up an item in the traffic list for modification.  The
+   * array is copied first if it is shared (see TrafficArray::Modify()).
    *
-   * @param name the name or call sign
+   * @param id FLARM id
    * @return the FLARM_TRAFFIC pointer, NULL if not found
    */
-  FlarmTraffic *FindTraffic(const TCHAR *name) {
-    for (auto &traffic : list)
-      if (traffic.name.equals(name))
-        return &traffic;
-
-    return NULL;
-  }
+  FlarmTraffic *ModifyTraffic(FlarmId id);
 
   /**
-   * Looks up an item in the traffic list.
+   * Make room for the given new target if the list is full, by
+   * removing the least critical target (the farthest one without an
+   * alarm), unless the new target is even less critical.  Updates
+   * #overflow if the list is full.
    *
-   * @param name the name or call sign
-   * @return the FLARM_TRAFFIC pointer, NULL if not found
+   * @param traffic the new target, with its relative position and
+   * alarm level
+   * @return false if the new target shall be discarded
    */
-  const FlarmTraffic *FindTraffic(const TCHAR *name) const {
-    for (const auto &traffic : list)
-      if (traffic.name.equals(name))
-        return &traffic;
-
-    return NULL;
-  }
+  bool MakeRoom(const FlarmTraffic &traffic, double clock);
 
   /**
-   * Allocates a new FLARM_TRAFFIC object from the array.
+   * Allocates a new FLARM_TRAFFIC object at the end of the array.
+   * The caller must ensure that there is no object with this id yet.
    *
-   * @return the FLARM_TRAFFIC pointer, NULL if the array is full
+   * @param id the FLARM id of the new object
+   * @return the FLARM_TRAFFIC pointer (cleared, with the given id),
+   * NULL if the array is full
    */
-  FlarmTraffic *AllocateTraffic() {
-    return list.full()
-      ? NULL
-      : &list.append();
-  }
+  FlarmTraffic *AllocateTraffic(FlarmId id);
 
   /**
    * Search for the previous traffic in the ordered list.
@@ -185,13 +274,19 @@ struct TrafficList {
    * Finds the most critical alert.  Returns NULL if there is no
    * alert.
    */
+  gcc_pure
   const FlarmTraffic *FindMaximumAlert() const;
 
+  /**
+   * Finds the target with the smallest horizontal distance to the
+   * own aircraft.  Returns NULL if the list is empty.
+   */
+  gcc_pure
+  const FlarmTraffic *FindNearest() const;
+
   unsigned TrafficIndex(const FlarmTraffic *t) const {
     return t - list.begin();
   }
 };
 
-static_assert(std::is_trivial<TrafficList>::value, "type is not trivial");
-
 #endif
@@ -147,7 +147,7 @@ FlarmTrafficWindow::PrevTarget()
 
 /**
  * Checks whether the selection is still on the valid target and if not tries
- * to select the next one
+ * to select the nearest one
  */
 void
 FlarmTrafficWindow::UpdateSelector(const FlarmId id, const PixelPoint pt)
@@ -159,12 +159,12 @@ FlarmTrafficWindow::UpdateSelector(const FlarmId id, const PixelPoint pt)
     SetTarget(id);
 
   // If we don't have a valid selection and we can't find
-  // a target close to to the PixelPoint we select the next one
-  // on the internal list
+  // a target close to to the PixelPoint we select the nearest
+  // target
   if (selection < 0 && (
       pt.x < 0 || pt.y < 0 ||
       !SelectNearTarget(pt, radius * 2)) )
-    NextTarget();
+    SetTarget(data.FindNearest());
 }
 
 /**
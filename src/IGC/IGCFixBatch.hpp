@@ -0,0 +1,104 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IGC_FIX_BATCH_HPP
+#define XCSOAR_IGC_FIX_BATCH_HPP
+
+#include "IGCFix.hpp"
+#include "Math/Angle.hpp"
+#include "Time/BrokenTime.hpp"
+
+#include <assert.h>
+#include <stdint.h>
+
+/**
+ * A batch of IGC "B" records in a structure-of-arrays layout: each
+ * attribute of #IGCFix is stored in its own array, so a consumer
+ * which is interested in only a few attributes touches only those.
+ *
+ * @see MappedIGCReader
+ */
+struct IGCFixBatch {
+  static constexpr unsigned CAPACITY = 256;
+
+  /**
+   * Indexes into #extensions.
+   */
+  enum Extension : unsigned {
+    ENL, RPM, HDM, HDT, TRM, TRT, GSP, IAS, TAS, SIU,
+    N_EXTENSIONS
+  };
+
+  unsigned size;
+
+  BrokenTime time[CAPACITY];
+
+  Angle latitude[CAPACITY], longitude[CAPACITY];
+
+  bool gps_valid[CAPACITY];
+
+  int gps_altitude[CAPACITY], pressure_altitude[CAPACITY];
+
+  /**
+   * The extension values, see #IGCFix.  Negative if undefined.
+   */
+  int16_t extensions[N_EXTENSIONS][CAPACITY];
+
+  void Clear() {
+    size = 0;
+  }
+
+  bool IsEmpty() const {
+    return size == 0;
+  }
+
+  bool IsFull() const {
+    return size == CAPACITY;
+  }
+
+  /**
+   * Copy one fix into an #IGCFix object.
+   */
+  void GetFix(unsigned i, IGCFix &fix) const {
+    assert(i < size);
+
+    fix.time = time[i];
+    fix.location = GeoPoint(longitude[i], latitude[i]);
+    fix.gps_valid = gps_valid[i];
+    fix.gps_altitude = gps_altitude[i];
+    fix.pressure_altitude = pressure_altitude[i];
+    fix.enl = extensions[ENL][i];
+    fix.rpm = extensions[RPM][i];
+    fix.hdm = extensions[HDM][i];
+    fix.hdt = extensions[HDT][i];
+    fix.trm = extensions[TRM][i];
+    fix.trt = extensions[TRT][i];
+    fix.gsp = extensions[GSP][i];
+    fix.ias = extensions[IAS][i];
+    fix.tas = extensions[TAS][i];
+    fix.siu = extensions[SIU][i];
+  }
+};
+
+#endif
@@ -34,7 +34,8 @@ IGCWriter::IGCWriter(Path path)
   :file(path,
         /* we use CREATE_VISIBLE here so the user can recover partial
            IGC files after a crash/battery failure/etc. */
-        FileOutputStream::Mode::CREATE_VISIBLE),
+        FileOutputStream::Mode::CREATE_VISIBLE,
+        "IGCWriter"),
    buffered(file)
 {
   fix.Clear();
@@ -25,8 +25,8 @@ Copyright_License {
 #define XCSOAR_IGC_WRITER_HPP
 
 #include "Logger/GRecord.hpp"
+#include "Logger/AsyncLogWriter.hpp"
 #include "IGCFix.hpp"
-#include "IO/FileOutputStream.hxx"
 #include "IO/BufferedOutputStream.hxx"
 
 #include <tchar.h>
@@ -42,7 +42,7 @@ class IGCWriter {
     MAX_IGC_BUFF = 255,
   };
 
-  FileOutputStream file;
+  AsyncLogWriter file;
   BufferedOutputStream buffered;
 
   GRecord grecord;
@@ -57,8 +57,36 @@ public:
    */
   explicit IGCWriter(Path path);
 
+  /**
+   * Pass all buffered lines to the writer thread.  This does not
+   * wait for the data to be written.
+   */
   void Flush() {
     buffered.Flush();
+    file.Flush();
+  }
+
+  /**
+   * Flush() and wait until the file has been written and synced.
+   */
+  void Sync() {
+    buffered.Flush();
+    file.Sync();
+  }
+
+  /**
+   * Has writing to the file failed?  All further records are
+   * discarded then.
+   */
+  bool HasFailed() {
+    return file.HasFailed();
+  }
+
+  /**
+   * Write the writer thread's statistics to the log file.
+   */
+  void LogStats() {
+    file.LogStats("IGCWriter");
   }
 
   void Sign();
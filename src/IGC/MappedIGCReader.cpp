@@ -0,0 +1,355 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "MappedIGCReader.hpp"
+#include "IGCFixBatch.hpp"
+#include "IGCParser.hpp"
+#include "IGCFix.hpp"
+#include "OS/Path.hpp"
+#include "Util/CharUtil.hpp"
+#include "Util/StringAPI.hxx"
+#include "Compiler.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include <string.h>
+
+/**
+ * The shortest "B" record which can be decoded by
+ * MappedIGCReader::DecodeFix(): time, location, validity and both
+ * altitudes.
+ */
+static constexpr size_t MIN_FIX_LENGTH = 35;
+
+static constexpr struct {
+  char code[4];
+  uint8_t index;
+  uint8_t max_digits;
+} supported_extensions[] = {
+  { "ENL", IGCFixBatch::ENL, 0 },
+  { "RPM", IGCFixBatch::RPM, 0 },
+  { "HDM", IGCFixBatch::HDM, 0 },
+  { "HDT", IGCFixBatch::HDT, 0 },
+  { "TRM", IGCFixBatch::TRM, 0 },
+  { "TRT", IGCFixBatch::TRT, 0 },
+  { "GSP", IGCFixBatch::GSP, 3 },
+  { "IAS", IGCFixBatch::IAS, 3 },
+  { "TAS", IGCFixBatch::TAS, 3 },
+  { "SIU", IGCFixBatch::SIU, 0 },
+};
+
+/**
+ * Find the end of the line starting at #p, i.e. the next newline
+ * character or #end.  This uses memchr(), which is vectorised in all
+ * relevant C libraries; a hand-written SSE2 loop was not faster.
+ */
+gcc_pure
+static const char *
+FindNewline(const char *p, const char *end)
+{
+  const char *newline = (const char *)memchr(p, '\n', end - p);
+  return newline != nullptr ? newline : end;
+}
+
+/**
+ * Copy a line into a null-terminated buffer for the parsers in
+ * IGCParser.cpp.  Overlong lines are truncated.
+ */
+template<size_t size>
+static const char *
+CopyLine(char (&buffer)[size], const char *line, const char *line_end)
+{
+  const size_t length = std::min(size_t(line_end - line), size - 1);
+  std::copy_n(line, length, buffer);
+  buffer[length] = 0;
+  return buffer;
+}
+
+/**
+ * Parse exactly #n decimal digits.
+ *
+ * @return the value, or -1 if one of the characters is not a digit
+ */
+gcc_pure gcc_always_inline
+static int
+ParseDigits(const char *p, unsigned n)
+{
+  int value = 0;
+  for (const char *end = p + n; p != end; ++p) {
+    if (!IsDigitASCII(*p))
+      return -1;
+
+    value = value * 10 + (*p - '0');
+  }
+
+  return value;
+}
+
+/**
+ * Parse a 5 character altitude column, which may be negative
+ * ("-0012").
+ */
+gcc_always_inline
+static bool
+ParseAltitude(const char *p, int &value_r)
+{
+  if (*p == '-') {
+    const int value = ParseDigits(p + 1, 4);
+    if (value < 0)
+      return false;
+
+    value_r = -value;
+  } else {
+    const int value = ParseDigits(p, 5);
+    if (value < 0)
+      return false;
+
+    value_r = value;
+  }
+
+  return true;
+}
+
+/**
+ * Decode "DDMMmmm[N/S]DDDMMmmm[E/W]"; the same as IGCParseLocation(),
+ * but without sscanf().
+ */
+gcc_always_inline
+static bool
+ParseLocation(const char *p, Angle &latitude, Angle &longitude)
+{
+  const int lat_degrees = ParseDigits(p, 2);
+  const int lat_minutes = ParseDigits(p + 2, 5);
+  const char lat_char = p[7];
+  const int lon_degrees = ParseDigits(p + 8, 3);
+  const int lon_minutes = ParseDigits(p + 11, 5);
+  const char lon_char = p[16];
+
+  if (lat_degrees < 0 || lat_degrees >= 90 ||
+      lat_minutes < 0 || lat_minutes >= 60000 ||
+      (lat_char != 'N' && lat_char != 'S'))
+    return false;
+
+  if (lon_degrees < 0 || lon_degrees >= 180 ||
+      lon_minutes < 0 || lon_minutes >= 60000 ||
+      (lon_char != 'E' && lon_char != 'W'))
+    return false;
+
+  latitude = Angle::Degrees(lat_degrees + lat_minutes / 60000.);
+  if (lat_char == 'S')
+    latitude.Flip();
+
+  longitude = Angle::Degrees(lon_degrees + lon_minutes / 60000.);
+  if (lon_char == 'W')
+    longitude.Flip();
+
+  return true;
+}
+
+/**
+ * Parse an unsigned integer of arbitrary length.
+ *
+ * @return the value, or -1 on error
+ */
+gcc_pure
+static int
+ParseUnsigned(const char *p, const char *end)
+{
+  unsigned value = 0;
+
+  for (; p < end; ++p) {
+    if (!IsDigitASCII(*p))
+      return -1;
+
+    value = value * 10 + (*p - '0');
+  }
+
+  return value;
+}
+
+MappedIGCReader::MappedIGCReader(Path path)
+  :mapping(path), date(BrokenDate::Invalid())
+{
+  if (mapping.error())
+    throw std::runtime_error(std::string("Failed to map ") +
+                             path.ToUTF8());
+
+  position = (const char *)mapping.data();
+  end = (const char *)mapping.end();
+
+  extensions.clear();
+  columns.clear();
+}
+
+void
+MappedIGCReader::ApplyExtensions()
+{
+  columns.clear();
+
+  for (const IGCExtension &extension : extensions) {
+    for (const auto &i : supported_extensions) {
+      if (StringIsEqual(extension.code, i.code)) {
+        Column &column = columns.append();
+        column.start = extension.start;
+        column.finish = extension.finish;
+        column.index = i.index;
+        column.max_digits = i.max_digits;
+        break;
+      }
+    }
+  }
+}
+
+inline void
+MappedIGCReader::StoreFix(const IGCFix &fix,
+                          IGCFixBatch &batch, unsigned i) const
+{
+  batch.time[i] = fix.time;
+  batch.latitude[i] = fix.location.latitude;
+  batch.longitude[i] = fix.location.longitude;
+  batch.gps_valid[i] = fix.gps_valid;
+  batch.gps_altitude[i] = fix.gps_altitude;
+  batch.pressure_altitude[i] = fix.pressure_altitude;
+  batch.extensions[IGCFixBatch::ENL][i] = fix.enl;
+  batch.extensions[IGCFixBatch::RPM][i] = fix.rpm;
+  batch.extensions[IGCFixBatch::HDM][i] = fix.hdm;
+  batch.extensions[IGCFixBatch::HDT][i] = fix.hdt;
+  batch.extensions[IGCFixBatch::TRM][i] = fix.trm;
+  batch.extensions[IGCFixBatch::TRT][i] = fix.trt;
+  batch.extensions[IGCFixBatch::GSP][i] = fix.gsp;
+  batch.extensions[IGCFixBatch::IAS][i] = fix.ias;
+  batch.extensions[IGCFixBatch::TAS][i] = fix.tas;
+  batch.extensions[IGCFixBatch::SIU][i] = fix.siu;
+}
+
+inline bool
+MappedIGCReader::DecodeFix(const char *line, const char *line_end,
+                           IGCFixBatch &batch, unsigned i) const
+{
+  assert(*line == 'B');
+
+  const size_t length = line_end - line;
+
+  /* the fixed-width part: "BHHMMSSDDMMmmmNDDDMMmmmEVPPPPPGGGGG" */
+
+  int hour = -1, minute = -1, second = -1;
+  char valid_char = 0;
+  if (gcc_likely(length >= MIN_FIX_LENGTH)) {
+    hour = ParseDigits(line + 1, 2);
+    minute = ParseDigits(line + 3, 2);
+    second = ParseDigits(line + 5, 2);
+    valid_char = line[24];
+  }
+
+  if (gcc_likely(hour >= 0 && minute >= 0 && second >= 0 &&
+                 (valid_char == 'A' || valid_char == 'V') &&
+                 ParseLocation(line + 7, batch.latitude[i],
+                               batch.longitude[i]) &&
+                 ParseAltitude(line + 25, batch.pressure_altitude[i]) &&
+                 ParseAltitude(line + 30, batch.gps_altitude[i]))) {
+    const BrokenTime time(hour, minute, second);
+    if (!time.IsPlausible())
+      return false;
+
+    batch.time[i] = time;
+    batch.gps_valid[i] = valid_char == 'A';
+
+    for (unsigned j = 0; j < IGCFixBatch::N_EXTENSIONS; ++j)
+      batch.extensions[j][i] = -1;
+
+    for (const Column &column : columns) {
+      if (column.finish > length)
+        /* exceeds the input line length */
+        continue;
+
+      const char *start = line + column.start - 1;
+      const char *finish = line + column.finish;
+      if (column.max_digits > 0) {
+        if (size_t(finish - start) < column.max_digits)
+          continue;
+
+        finish = start + column.max_digits;
+      }
+
+      const int value = ParseUnsigned(start, finish);
+      if (value >= 0)
+        batch.extensions[column.index][i] = value;
+    }
+
+    return true;
+  }
+
+  /* not in the strict format (e.g. too short, or with blanks instead
+     of leading zeroes); let the generic parser decide */
+  char buffer[256];
+  IGCFix fix;
+  if (!IGCParseFix(CopyLine(buffer, line, line_end), extensions, fix))
+    return false;
+
+  StoreFix(fix, batch, i);
+  return true;
+}
+
+bool
+MappedIGCReader::Read(IGCFixBatch &batch)
+{
+  batch.Clear();
+
+  while (position < end && !batch.IsFull()) {
+    const char *line = position;
+    const char *const newline = FindNewline(line, end);
+    const char *line_end = newline;
+    if (line_end > line && line_end[-1] == '\r')
+      --line_end;
+
+    if (*line == 'B') {
+      if (DecodeFix(line, line_end, batch, batch.size))
+        ++batch.size;
+    } else if (*line == 'I' ||
+               (line_end - line >= 5 && memcmp(line, "HFDTE", 5) == 0)) {
+      if (!batch.IsEmpty())
+        /* finish this batch first, so the caller sees the new
+           extensions/date only with the fixes that follow */
+        return true;
+
+      char buffer[256];
+      CopyLine(buffer, line, line_end);
+
+      if (*line == 'I') {
+        IGCParseExtensions(buffer, extensions);
+        ApplyExtensions();
+      } else {
+        BrokenDate new_date;
+        if (IGCParseDateRecord(buffer, new_date))
+          date = new_date;
+      }
+    }
+
+    position = newline < end ? newline + 1 : end;
+  }
+
+  return !batch.IsEmpty();
+}
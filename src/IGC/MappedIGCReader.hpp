@@ -0,0 +1,120 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_MAPPED_IGC_READER_HPP
+#define XCSOAR_MAPPED_IGC_READER_HPP
+
+#include "IGCExtensions.hpp"
+#include "OS/FileMapping.hpp"
+#include "Time/BrokenDate.hpp"
+#include "Util/TrivialArray.hxx"
+
+#include <stdint.h>
+
+class Path;
+struct IGCFix;
+struct IGCFixBatch;
+
+/**
+ * Reads the "B" records of an IGC file which is mapped into memory.
+ * Unlike IGCParseFix(), the fixed-width columns of a "B" record are
+ * decoded in place, without copying the line and without sscanf();
+ * lines which do not fit the strict format are passed to
+ * IGCParseFix(), so the results are the same.
+ *
+ * "I" records (extensions) and "HFDTE" records (date) are evaluated
+ * as they appear.  A batch never spans one of them, so the caller
+ * can query GetExtensions() and GetDate() between two batches.
+ */
+class MappedIGCReader {
+  FileMapping mapping;
+
+  const char *position, *end;
+
+  IGCExtensions extensions;
+
+  /**
+   * The supported entries of #extensions, resolved to an
+   * IGCFixBatch::Extension index.
+   */
+  struct Column {
+    uint16_t start, finish;
+
+    uint8_t index;
+
+    /**
+     * If non-zero, then only this number of leading characters is
+     * parsed (see ParseExtensionValueN() in IGCParser.cpp).
+     */
+    uint8_t max_digits;
+  };
+
+  TrivialArray<Column, 16> columns;
+
+  BrokenDate date;
+
+public:
+  /**
+   * Throws std::runtime_error on error.
+   */
+  explicit MappedIGCReader(Path path);
+
+  MappedIGCReader(const MappedIGCReader &) = delete;
+  MappedIGCReader &operator=(const MappedIGCReader &) = delete;
+
+  /**
+   * The extensions declared by the last "I" record.
+   */
+  const IGCExtensions &GetExtensions() const {
+    return extensions;
+  }
+
+  /**
+   * The date of the last "HFDTE" record, or an invalid date if there
+   * was none.
+   */
+  const BrokenDate &GetDate() const {
+    return date;
+  }
+
+  /**
+   * Decode the next batch of "B" records.  Records which cannot be
+   * parsed are skipped.  The batch ends early when it is followed by
+   * an "I" or "HFDTE" record.
+   *
+   * @return false if the end of the file has been reached and the
+   * batch is empty
+   */
+  bool Read(IGCFixBatch &batch);
+
+private:
+  void ApplyExtensions();
+
+  bool DecodeFix(const char *line, const char *line_end,
+                 IGCFixBatch &batch, unsigned i) const;
+
+  void StoreFix(const IGCFix &fix, IGCFixBatch &batch, unsigned i) const;
+};
+
+#endif
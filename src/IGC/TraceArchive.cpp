@@ -0,0 +1,155 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TraceArchive.hpp"
+#include "TraceArchiveFormat.hpp"
+#include "OS/Path.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+#include <string.h>
+
+constexpr unsigned TraceArchive::Chunk::CAPACITY;
+
+TraceArchive::TraceArchive(Path path)
+  :mapping(path)
+{
+  if (mapping.error())
+    throw std::runtime_error("Failed to map trace archive");
+
+  const size_t size = mapping.size();
+  TraceArchiveTrailer trailer;
+  if (size < sizeof(trailer))
+    throw std::runtime_error("Malformed trace archive");
+
+  memcpy(&trailer, mapping.at(size - sizeof(trailer)), sizeof(trailer));
+  if (trailer.magic != TRACE_ARCHIVE_MAGIC ||
+      trailer.table_offset % alignof(ChunkInfo) != 0 ||
+      size - sizeof(trailer) != trailer.table_offset +
+      size_t(trailer.n_chunks) * sizeof(ChunkInfo))
+    throw std::runtime_error("Malformed trace archive");
+
+  table = (const ChunkInfo *)mapping.at(trailer.table_offset);
+  n_chunks = trailer.n_chunks;
+  n_fixes = trailer.n_fixes;
+  date = BrokenDate(trailer.year, trailer.month, trailer.day);
+
+  for (unsigned i = 0; i < n_chunks; ++i) {
+    const ChunkInfo &info = table[i];
+    if (info.n_fixes == 0 || info.n_fixes > Chunk::CAPACITY ||
+        info.offset > trailer.table_offset ||
+        info.column_end[N_COLUMNS - 1] > trailer.table_offset - info.offset)
+      throw std::runtime_error("Malformed trace archive");
+  }
+}
+
+unsigned
+TraceArchive::FindChunk(unsigned time) const
+{
+  const ChunkInfo *end = table + n_chunks;
+  return std::lower_bound(table, end, time,
+                          [](const ChunkInfo &info, unsigned t){
+                            return info.last_time < t;
+                          }) - table;
+}
+
+/**
+ * Decode a column of delta-encoded integers.
+ */
+template<typename T>
+static void
+DecodeDeltas(const uint8_t *p, const uint8_t *end, T *dest, unsigned n)
+{
+  int32_t value = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    uint32_t delta;
+    p = ReadVarInt(p, end, delta);
+    if (p == nullptr)
+      throw std::runtime_error("Malformed trace archive");
+
+    value += ZigZagDecode(delta);
+    dest[i] = value;
+  }
+}
+
+void
+TraceArchive::Decode(unsigned i, Chunk &chunk, unsigned columns) const
+{
+  assert(i < n_chunks);
+
+  const ChunkInfo &info = table[i];
+  const uint8_t *base = (const uint8_t *)mapping.at(info.offset);
+  const unsigned n = info.n_fixes;
+
+  chunk.size = n;
+
+  uint32_t column_begin = 0;
+  for (unsigned c = 0; c < N_COLUMNS; column_begin = info.column_end[c++]) {
+    if ((columns & (1u << c)) == 0)
+      continue;
+
+    if (info.column_end[c] < column_begin)
+      throw std::runtime_error("Malformed trace archive");
+
+    const uint8_t *p = base + column_begin, *end = base + info.column_end[c];
+
+    switch (Column(c)) {
+    case TIME:
+      DecodeDeltas(p, end, chunk.time, n);
+      break;
+
+    case LATITUDE:
+      DecodeDeltas(p, end, chunk.latitude, n);
+      break;
+
+    case LONGITUDE:
+      DecodeDeltas(p, end, chunk.longitude, n);
+      break;
+
+    case GPS_ALTITUDE:
+      DecodeDeltas(p, end, chunk.gps_altitude, n);
+      break;
+
+    case PRESSURE_ALTITUDE:
+      DecodeDeltas(p, end, chunk.pressure_altitude, n);
+      break;
+
+    case VARIO:
+      DecodeDeltas(p, end, chunk.vario, n);
+      break;
+
+    case GPS_VALID:
+      if (size_t(end - p) != (n + 7) / 8)
+        throw std::runtime_error("Malformed trace archive");
+
+      for (unsigned j = 0; j < n; ++j)
+        chunk.gps_valid[j] = (p[j / 8] >> (j % 8)) & 1;
+      break;
+
+    case N_COLUMNS:
+      gcc_unreachable();
+    }
+  }
+}
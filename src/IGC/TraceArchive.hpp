@@ -0,0 +1,195 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TRACE_ARCHIVE_HPP
+#define XCSOAR_TRACE_ARCHIVE_HPP
+
+#include "OS/FileMapping.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Time/BrokenDate.hpp"
+#include "Compiler.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+class Path;
+
+/**
+ * A compact, column-oriented copy of the fixes of one flight, stored
+ * next to its IGC file (see WriteTraceArchive()).  Unlike the
+ * #Trace kept by the #GlideComputer, it has the full resolution of
+ * the IGC file, and unlike the IGC file, it can be loaded without
+ * parsing text.
+ *
+ * The fixes are grouped in chunks of up to Chunk::CAPACITY.  Each
+ * chunk stores each attribute in its own column: integers are delta
+ * encoded and written as zig-zag variable-length integers.  A table
+ * at the end of the file lists the time range and the bounds of each
+ * chunk, so readers can skip chunks (and columns) they are not
+ * interested in.
+ */
+class TraceArchive {
+public:
+  enum Column : unsigned {
+    TIME,
+    LATITUDE,
+    LONGITUDE,
+    GPS_ALTITUDE,
+    PRESSURE_ALTITUDE,
+    VARIO,
+    GPS_VALID,
+    N_COLUMNS
+  };
+
+  static constexpr unsigned ALL_COLUMNS = (1u << N_COLUMNS) - 1;
+
+  /**
+   * Locations are stored in the IGC resolution: 1/1000 minute.
+   */
+  static constexpr double LOCATION_FACTOR = 60000;
+
+  /**
+   * An entry of the chunk table.
+   */
+  struct ChunkInfo {
+    /**
+     * The position of the chunk in the file.
+     */
+    uint32_t offset;
+
+    /**
+     * The end of each column, relative to #offset; column i starts
+     * where column i-1 ends.
+     */
+    uint32_t column_end[N_COLUMNS];
+
+    uint32_t n_fixes;
+
+    /**
+     * The time of the first and the last fix [seconds since
+     * midnight UTC of the archive's date]; may exceed one day.
+     */
+    uint32_t first_time, last_time;
+
+    /**
+     * The bounds of all locations [1/#LOCATION_FACTOR degrees].
+     */
+    int32_t min_latitude, max_latitude, min_longitude, max_longitude;
+  };
+
+  /**
+   * The fixes of one chunk, decoded into arrays.
+   */
+  struct Chunk {
+    static constexpr unsigned CAPACITY = 256;
+
+    unsigned size;
+
+    /** @see ChunkInfo::first_time */
+    unsigned time[CAPACITY];
+
+    /** [1/#LOCATION_FACTOR degrees] */
+    int32_t latitude[CAPACITY], longitude[CAPACITY];
+
+    /** [m] */
+    int gps_altitude[CAPACITY], pressure_altitude[CAPACITY];
+
+    /**
+     * The altitude change since the previous fix [cm/s], calculated
+     * from the pressure altitude if available, else from the GPS
+     * altitude.  It is stored so charts need not differentiate the
+     * altitude themselves.
+     */
+    int vario[CAPACITY];
+
+    bool gps_valid[CAPACITY];
+
+    gcc_pure
+    GeoPoint GetLocation(unsigned i) const {
+      assert(i < size);
+
+      return GeoPoint(Angle::Degrees(longitude[i] / LOCATION_FACTOR),
+                      Angle::Degrees(latitude[i] / LOCATION_FACTOR));
+    }
+  };
+
+private:
+  FileMapping mapping;
+
+  const ChunkInfo *table;
+  unsigned n_chunks, n_fixes;
+
+  BrokenDate date;
+
+public:
+  /**
+   * Map and verify the archive.
+   *
+   * Throws std::runtime_error on error.
+   */
+  explicit TraceArchive(Path path);
+
+  TraceArchive(const TraceArchive &) = delete;
+  TraceArchive &operator=(const TraceArchive &) = delete;
+
+  /**
+   * The date of the flight, as declared by the IGC file; may be
+   * invalid.
+   */
+  const BrokenDate &GetDate() const {
+    return date;
+  }
+
+  unsigned GetFixCount() const {
+    return n_fixes;
+  }
+
+  unsigned GetChunkCount() const {
+    return n_chunks;
+  }
+
+  const ChunkInfo &GetChunkInfo(unsigned i) const {
+    assert(i < n_chunks);
+
+    return table[i];
+  }
+
+  /**
+   * Returns the first chunk which contains fixes at or after the
+   * given time, or GetChunkCount() if there is none.
+   */
+  gcc_pure
+  unsigned FindChunk(unsigned time) const;
+
+  /**
+   * Decode a chunk.  Only the columns in the bit mask are filled.
+   *
+   * Throws std::runtime_error if the chunk is malformed.
+   *
+   * @param columns a bit mask of #Column values
+   */
+  void Decode(unsigned i, Chunk &chunk, unsigned columns=ALL_COLUMNS) const;
+};
+
+#endif
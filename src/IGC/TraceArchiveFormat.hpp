@@ -0,0 +1,108 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TRACE_ARCHIVE_FORMAT_HPP
+#define XCSOAR_TRACE_ARCHIVE_FORMAT_HPP
+
+/*
+ * Internal definitions shared by TraceArchive.cpp and
+ * TraceArchiveWriter.cpp.
+ */
+
+#include <stdint.h>
+
+static constexpr uint32_t TRACE_ARCHIVE_MAGIC = 0x58a1c0d2;
+
+struct TraceArchiveTrailer {
+  uint32_t magic;
+
+  uint32_t n_chunks;
+  uint32_t n_fixes;
+
+  /**
+   * The position of the TraceArchive::ChunkInfo table.
+   */
+  uint32_t table_offset;
+
+  uint16_t year;
+  uint8_t month, day;
+
+  uint32_t reserved;
+};
+
+static_assert(sizeof(TraceArchiveTrailer) == 24, "Unexpected padding");
+
+static constexpr uint32_t
+ZigZagEncode(int32_t value)
+{
+  return (uint32_t(value) << 1) ^ uint32_t(value >> 31);
+}
+
+static constexpr int32_t
+ZigZagDecode(uint32_t value)
+{
+  return int32_t(value >> 1) ^ -int32_t(value & 1);
+}
+
+/**
+ * Write a variable-length integer (7 bits per byte, least
+ * significant first).
+ *
+ * @return the end of the output
+ */
+static inline uint8_t *
+WriteVarInt(uint8_t *p, uint32_t value)
+{
+  while (value >= 0x80) {
+    *p++ = uint8_t(value) | 0x80;
+    value >>= 7;
+  }
+
+  *p++ = uint8_t(value);
+  return p;
+}
+
+/**
+ * Read a variable-length integer.
+ *
+ * @return the end of the integer, or nullptr if it is malformed or
+ * truncated
+ */
+static inline const uint8_t *
+ReadVarInt(const uint8_t *p, const uint8_t *end, uint32_t &value_r)
+{
+  uint32_t value = 0;
+  for (unsigned shift = 0; shift < 35 && p < end; shift += 7) {
+    const uint8_t byte = *p++;
+    value |= uint32_t(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      value_r = value;
+      return p;
+    }
+  }
+
+  return nullptr;
+}
+
+#endif
@@ -0,0 +1,192 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TraceArchiveWriter.hpp"
+#include "TraceArchiveFormat.hpp"
+#include "MappedIGCReader.hpp"
+#include "IGCFixBatch.hpp"
+#include "IGCFix.hpp"
+
+#include <algorithm>
+
+#include <math.h>
+#include <string.h>
+
+TraceArchiveWriter::TraceArchiveWriter(Path path)
+  :file(path), buffered(file)
+{
+  chunk.size = 0;
+}
+
+void
+TraceArchiveWriter::Append(const IGCFix &fix)
+{
+  unsigned time = fix.time.GetSecondOfDay() + day_offset;
+  if (n_fixes > 0 && time + 12 * 3600 < last_time) {
+    /* midnight UTC has passed */
+    day_offset += 24 * 3600;
+    time += 24 * 3600;
+  }
+
+  const int altitude = fix.pressure_altitude != 0
+    ? fix.pressure_altitude
+    : fix.gps_altitude;
+
+  int vario = 0;
+  if (n_fixes > 0 && time > last_time)
+    vario = (altitude - last_altitude) * 100 / int(time - last_time);
+
+  const unsigned i = chunk.size++;
+  chunk.time[i] = time;
+  chunk.latitude[i] =
+    lround(fix.location.latitude.Degrees() * TraceArchive::LOCATION_FACTOR);
+  chunk.longitude[i] =
+    lround(fix.location.longitude.Degrees() * TraceArchive::LOCATION_FACTOR);
+  chunk.gps_altitude[i] = fix.gps_altitude;
+  chunk.pressure_altitude[i] = fix.pressure_altitude;
+  chunk.vario[i] = vario;
+  chunk.gps_valid[i] = fix.gps_valid;
+
+  ++n_fixes;
+  last_time = time;
+  last_altitude = altitude;
+
+  if (chunk.size == TraceArchive::Chunk::CAPACITY)
+    FlushChunk();
+}
+
+template<typename T>
+static uint8_t *
+EncodeDeltas(uint8_t *p, const T *src, unsigned n)
+{
+  int32_t previous = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    const int32_t value = src[i];
+    p = WriteVarInt(p, ZigZagEncode(value - previous));
+    previous = value;
+  }
+
+  return p;
+}
+
+void
+TraceArchiveWriter::FlushChunk()
+{
+  using Chunk = TraceArchive::Chunk;
+
+  const unsigned n = chunk.size;
+  assert(n > 0);
+
+  /* 5 bytes is the maximum length of a 32 bit variable-length
+     integer */
+  uint8_t buffer[TraceArchive::N_COLUMNS * Chunk::CAPACITY * 5];
+  uint8_t *p = buffer;
+
+  TraceArchive::ChunkInfo info;
+  info.offset = position;
+  info.n_fixes = n;
+  info.first_time = chunk.time[0];
+  info.last_time = chunk.time[n - 1];
+
+  const auto lat = std::minmax_element(chunk.latitude, chunk.latitude + n);
+  info.min_latitude = *lat.first;
+  info.max_latitude = *lat.second;
+
+  const auto lon = std::minmax_element(chunk.longitude, chunk.longitude + n);
+  info.min_longitude = *lon.first;
+  info.max_longitude = *lon.second;
+
+  p = EncodeDeltas(p, chunk.time, n);
+  info.column_end[TraceArchive::TIME] = p - buffer;
+  p = EncodeDeltas(p, chunk.latitude, n);
+  info.column_end[TraceArchive::LATITUDE] = p - buffer;
+  p = EncodeDeltas(p, chunk.longitude, n);
+  info.column_end[TraceArchive::LONGITUDE] = p - buffer;
+  p = EncodeDeltas(p, chunk.gps_altitude, n);
+  info.column_end[TraceArchive::GPS_ALTITUDE] = p - buffer;
+  p = EncodeDeltas(p, chunk.pressure_altitude, n);
+  info.column_end[TraceArchive::PRESSURE_ALTITUDE] = p - buffer;
+  p = EncodeDeltas(p, chunk.vario, n);
+  info.column_end[TraceArchive::VARIO] = p - buffer;
+
+  std::fill_n(p, (n + 7) / 8, 0);
+  for (unsigned i = 0; i < n; ++i)
+    if (chunk.gps_valid[i])
+      p[i / 8] |= 1 << (i % 8);
+  p += (n + 7) / 8;
+  info.column_end[TraceArchive::GPS_VALID] = p - buffer;
+
+  buffered.Write(buffer, p - buffer);
+  position += p - buffer;
+
+  table.push_back(info);
+  chunk.size = 0;
+}
+
+void
+TraceArchiveWriter::Commit()
+{
+  if (chunk.size > 0)
+    FlushChunk();
+
+  /* align the table */
+  static constexpr uint8_t padding[alignof(TraceArchive::ChunkInfo)] = {};
+  const unsigned padding_size = -position % alignof(TraceArchive::ChunkInfo);
+  buffered.Write(padding, padding_size);
+  position += padding_size;
+
+  TraceArchiveTrailer trailer;
+  trailer.magic = TRACE_ARCHIVE_MAGIC;
+  trailer.n_chunks = table.size();
+  trailer.n_fixes = n_fixes;
+  trailer.table_offset = position;
+  trailer.year = date.year;
+  trailer.month = date.month;
+  trailer.day = date.day;
+  trailer.reserved = 0;
+
+  buffered.Write(table.data(), table.size() * sizeof(table.front()));
+  buffered.Write(&trailer, sizeof(trailer));
+  buffered.Flush();
+  file.Commit();
+}
+
+void
+WriteTraceArchive(Path igc_path, Path archive_path)
+{
+  MappedIGCReader reader(igc_path);
+  TraceArchiveWriter writer(archive_path);
+
+  IGCFixBatch batch;
+  IGCFix fix;
+  while (reader.Read(batch)) {
+    for (unsigned i = 0; i < batch.size; ++i) {
+      batch.GetFix(i, fix);
+      writer.Append(fix);
+    }
+  }
+
+  writer.SetDate(reader.GetDate());
+  writer.Commit();
+}
@@ -0,0 +1,102 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TRACE_ARCHIVE_WRITER_HPP
+#define XCSOAR_TRACE_ARCHIVE_WRITER_HPP
+
+#include "TraceArchive.hpp"
+#include "IO/FileOutputStream.hxx"
+#include "IO/BufferedOutputStream.hxx"
+
+#include <vector>
+
+struct IGCFix;
+
+/**
+ * Writes a #TraceArchive file.
+ */
+class TraceArchiveWriter {
+  FileOutputStream file;
+  BufferedOutputStream buffered;
+
+  /**
+   * The fixes of the chunk being built.
+   */
+  TraceArchive::Chunk chunk;
+
+  std::vector<TraceArchive::ChunkInfo> table;
+
+  uint32_t position = 0;
+  unsigned n_fixes = 0;
+
+  BrokenDate date = BrokenDate::Invalid();
+
+  /**
+   * Added to the second of day to make the time monotonic across
+   * midnight.
+   */
+  unsigned day_offset = 0;
+
+  /**
+   * The time and the altitude (see TraceArchive::Chunk::vario) of
+   * the previous fix; only valid if #n_fixes is non-zero.
+   */
+  unsigned last_time;
+  int last_altitude;
+
+public:
+  /**
+   * Throws std::runtime_error on error.
+   */
+  explicit TraceArchiveWriter(Path path);
+
+  void SetDate(const BrokenDate &_date) {
+    date = _date;
+  }
+
+  /**
+   * Throws std::runtime_error on error.
+   */
+  void Append(const IGCFix &fix);
+
+  /**
+   * Write the chunk table and close the file.
+   *
+   * Throws std::runtime_error on error.
+   */
+  void Commit();
+
+private:
+  void FlushChunk();
+};
+
+/**
+ * Create a #TraceArchive from all fixes of an IGC file.
+ *
+ * Throws std::runtime_error on error.
+ */
+void
+WriteTraceArchive(Path igc_path, Path archive_path);
+
+#endif
@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "FileCache.hpp"
 #include "OS/FileUtil.hpp"
+#include "OS/FileMapping.hpp"
 #include "Compiler.h"
 
 #include <stdint.h>
@@ -142,6 +143,26 @@ FileCache::Load(const TCHAR *name, Path original_path)
   return file;
 }
 
+std::unique_ptr<FileMapping>
+FileCache::Map(const TCHAR *name, Path original_path, size_t &offset_r)
+{
+  FILE *file = Load(name, original_path);
+  if (file == nullptr)
+    return nullptr;
+
+  const long offset = ftell(file);
+  fclose(file);
+  if (offset < 0)
+    return nullptr;
+
+  std::unique_ptr<FileMapping> mapping(new FileMapping(MakeCachePath(name)));
+  if (mapping->error() || mapping->size() < size_t(offset))
+    return nullptr;
+
+  offset_r = offset;
+  return mapping;
+}
+
 FILE *
 FileCache::Save(const TCHAR *name, Path original_path)
 {
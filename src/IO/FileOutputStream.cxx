@@ -102,6 +102,16 @@ FileOutputStream::Write(const void *data, size_t size)
 				      GetPath().c_str());
 }
 
+void
+FileOutputStream::Sync()
+{
+	assert(IsDefined());
+
+	if (!FlushFileBuffers(handle))
+		throw FormatLastError("Failed to sync %s",
+				      GetPath().c_str());
+}
+
 void
 FileOutputStream::Commit()
 {
@@ -199,6 +209,22 @@ FileOutputStream::Write(const void *data, size_t size)
 				  GetPath().c_str());
 }
 
+void
+FileOutputStream::Sync()
+{
+	assert(IsDefined());
+
+#ifdef __linux__
+	/* fdatasync() skips metadata which is not needed to read
+	   the data back (e.g. the modification time) */
+	const int result = fdatasync(fd.Get());
+#else
+	const int result = fsync(fd.Get());
+#endif
+	if (result < 0)
+		throw FormatErrno("Failed to sync %s", GetPath().c_str());
+}
+
 void
 FileOutputStream::Commit()
 {
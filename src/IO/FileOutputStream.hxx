@@ -109,6 +109,13 @@ public:
 	/* virtual methods from class OutputStream */
 	void Write(const void *data, size_t size) override;
 
+	/**
+	 * Flush the data written so far to the storage device, so
+	 * it survives a power failure.  Throws std::runtime_error on
+	 * error.
+	 */
+	void Sync();
+
 	void Commit();
 	void Cancel();
 
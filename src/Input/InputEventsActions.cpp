@@ -84,6 +84,10 @@ doc/html/advanced/input/ALL		http://xcsoar.sourceforge.net/advanced/input/
 #include "MapWindow/GlueMapWindow.hpp"
 #include "Simulator.hpp"
 #include "Formatter/TimeFormatter.hpp"
+#include "OS/Profiler.hpp"
+#include "OS/Path.hpp"
+#include "ProfilerGlue.hpp"
+#include "UIGlobals.hpp"
 
 #include <assert.h>
 #include <tchar.h>
@@ -576,6 +580,48 @@ InputEvents::eventBrightness(gcc_unused const TCHAR *misc)
   // not implemented (was only implemented on Altair)
 }
 
+// Profiler
+// Controls the render/calculation profiler and its map overlay
+// on: starts recording
+// off: stops recording
+// toggle: toggles between on and off
+// clear: discards all samples
+// csv: writes all samples to xcsoar-profile.csv in the data directory
+// trace: writes all samples as a Chrome trace to xcsoar-profile.json
+// allocations: writes the heap allocation counts to the log file
+//   (only with ALLOCATION_COUNTER=y)
+void
+InputEvents::eventProfiler(const TCHAR *misc)
+{
+  if (StringIsEqual(misc, _T("on")))
+    Profiler::SetEnabled(true);
+  else if (StringIsEqual(misc, _T("off")))
+    Profiler::SetEnabled(false);
+  else if (StringIsEqual(misc, _T("toggle")))
+    Profiler::SetEnabled(!Profiler::IsEnabled());
+  else if (StringIsEqual(misc, _T("clear")))
+    Profiler::Clear();
+  else if (StringIsEqual(misc, _T("allocations"))) {
+    LogAllocationStatistics();
+    return;
+  } else if (StringIsEqual(misc, _T("csv")) ||
+           StringIsEqual(misc, _T("trace"))) {
+    try {
+      const auto path = DumpProfiler(StringIsEqual(misc, _T("trace")));
+      Message::AddMessage(_("Profile saved"), path.c_str());
+    } catch (const std::runtime_error &e) {
+      ShowError(e, _("Failed to save file."));
+    }
+
+    return;
+  }
+
+  /* show or hide the overlay */
+  auto *map_window = UIGlobals::GetMap();
+  if (map_window != nullptr)
+    map_window->QuickRedraw();
+}
+
 void
 InputEvents::eventExit(gcc_unused const TCHAR *misc)
 {
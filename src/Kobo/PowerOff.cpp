@@ -33,8 +33,7 @@ Copyright_License {
 #include "Screen/Layout.hpp"
 #include "Renderer/FlightListRenderer.hpp"
 #include "FlightInfo.hpp"
-#include "Logger/FlightParser.hpp"
-#include "IO/FileLineReader.hpp"
+#include "Logger/FlightIndex.hpp"
 #include "Resources.hpp"
 #include "Model.hpp"
 
@@ -95,14 +94,17 @@ DrawBanner(Canvas &canvas, PixelRect &rc)
 static void
 DrawFlights(Canvas &canvas, const PixelRect &rc)
 try {
-  FileLineReaderA file(Path("/mnt/onboard/XCSoarData/flights.log"));
+  const FlightIndex index(Path("/mnt/onboard/XCSoarData/flights.log"));
 
   FlightListRenderer renderer(normal_font, bold_font);
 
-  FlightParser parser(file);
-  FlightInfo flight;
-  while (parser.Read(flight))
-    renderer.AddFlight(flight);
+  /* the renderer keeps only the most recent flights; skip the
+     older ones */
+  const unsigned n = index.size();
+  for (unsigned i = n > FlightListRenderer::MAX_FLIGHTS
+         ? n - FlightListRenderer::MAX_FLIGHTS : 0;
+       i < n; ++i)
+    renderer.AddFlight(index[i]);
 
   renderer.Draw(canvas, rc);
 } catch (const std::runtime_error &e) {
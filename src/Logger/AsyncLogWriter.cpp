@@ -0,0 +1,239 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AsyncLogWriter.hpp"
+#include "OS/Clock.hpp"
+#include "LogFile.hpp"
+
+#include <stdexcept>
+
+#include <string.h>
+
+AsyncLogWriter::AsyncLogWriter(Path path, FileOutputStream::Mode mode,
+                               const char *name, size_t capacity,
+                               unsigned _sync_interval_ms)
+  :StandbyThread(name),
+   file(path, mode),
+   buffers{AllocatedArray<char>(capacity), AllocatedArray<char>(capacity)},
+   fill{0, 0}, current(0),
+   sync_interval_ms(_sync_interval_ms),
+   last_sync_ms(MonotonicClockMS()),
+   sync_requested(false), failed(false)
+{
+  stats = Stats();
+}
+
+AsyncLogWriter::~AsyncLogWriter()
+{
+  {
+    const ScopeLock protect(mutex);
+    if (!failed) {
+      sync_requested = true;
+      Trigger();
+      WaitDone();
+    }
+
+    Stop();
+  }
+
+  try {
+    file.Commit();
+  } catch (const std::runtime_error &e) {
+    LogError(e);
+  }
+}
+
+inline void
+AsyncLogWriter::Append(const void *data, size_t size)
+{
+  assert(mutex.IsLockedByCurrent());
+
+  AllocatedArray<char> &buffer = buffers[current];
+  size_t &n = fill[current];
+  assert(n + size <= buffer.size());
+
+  memcpy(buffer.begin() + n, data, size);
+  n += size;
+
+  if (n > stats.max_pending)
+    stats.max_pending = n;
+
+  if (n >= buffer.size() / 2)
+    /* don't wait for Flush(), start writing early to avoid a
+       stall */
+    Trigger();
+}
+
+bool
+AsyncLogWriter::TryWrite(const void *data, size_t size)
+{
+  const ScopeLock protect(mutex);
+
+  if (failed || fill[current] + size > buffers[current].size()) {
+    ++stats.n_dropped;
+    return false;
+  }
+
+  Append(data, size);
+  return true;
+}
+
+bool
+AsyncLogWriter::TryWriteLine(const char *line)
+{
+#ifdef HAVE_POSIX
+  static constexpr char eol[] = "\n";
+#else
+  static constexpr char eol[] = "\r\n";
+#endif
+  static constexpr size_t eol_length = sizeof(eol) - 1;
+
+  const size_t length = strlen(line);
+
+  const ScopeLock protect(mutex);
+
+  if (failed ||
+      fill[current] + length + eol_length > buffers[current].size()) {
+    ++stats.n_dropped;
+    return false;
+  }
+
+  Append(line, length);
+  Append(eol, eol_length);
+  return true;
+}
+
+void
+AsyncLogWriter::Write(const void *data, size_t size)
+{
+  assert(size <= buffers[current].size());
+
+  const ScopeLock protect(mutex);
+
+  if (!failed && fill[current] + size > buffers[current].size()) {
+    ++stats.n_stalls;
+
+    do {
+      Trigger();
+      space_cond.wait(mutex);
+    } while (!failed && fill[current] + size > buffers[current].size());
+  }
+
+  if (failed) {
+    ++stats.n_dropped;
+    return;
+  }
+
+  Append(data, size);
+}
+
+void
+AsyncLogWriter::Flush()
+{
+  const ScopeLock protect(mutex);
+  if (!failed && fill[current] > 0)
+    Trigger();
+}
+
+void
+AsyncLogWriter::Sync()
+{
+  const ScopeLock protect(mutex);
+  if (failed)
+    return;
+
+  sync_requested = true;
+  Trigger();
+  WaitDone();
+}
+
+void
+AsyncLogWriter::LogStats(const char *name)
+{
+  const Stats s = GetStats();
+  LogFormat("%s: %llu bytes in %u writes, %u syncs, max %u ms; "
+            "max %u bytes queued, %u stalls, %u dropped",
+            name, (unsigned long long)s.written_bytes,
+            s.n_writes, s.n_syncs, s.max_write_ms,
+            (unsigned)s.max_pending, s.n_stalls, s.n_dropped);
+}
+
+void
+AsyncLogWriter::Tick()
+{
+  while (!failed && (fill[current] > 0 || sync_requested)) {
+    /* let the producers continue with the other (empty) buffer
+       while this one is being written */
+    const unsigned i = current;
+    assert(fill[i ^ 1] == 0);
+    current ^= 1;
+    space_cond.broadcast();
+
+    const size_t size = fill[i];
+    const unsigned start_ms = MonotonicClockMS();
+    const bool sync = sync_requested ||
+      start_ms - last_sync_ms >= sync_interval_ms;
+    sync_requested = false;
+
+    bool success = true;
+
+    {
+      const ScopeUnlock unlock(mutex);
+
+      try {
+        if (size > 0)
+          file.Write(buffers[i].begin(), size);
+
+        if (sync)
+          file.Sync();
+      } catch (const std::runtime_error &e) {
+        LogError(e);
+        success = false;
+      }
+    }
+
+    fill[i] = 0;
+
+    if (!success) {
+      failed = true;
+      /* wake up producers waiting in Write() */
+      space_cond.broadcast();
+      break;
+    }
+
+    const unsigned end_ms = MonotonicClockMS();
+
+    stats.written_bytes += size;
+    if (size > 0)
+      ++stats.n_writes;
+
+    if (sync) {
+      ++stats.n_syncs;
+      last_sync_ms = end_ms;
+    }
+
+    if (end_ms - start_ms > stats.max_write_ms)
+      stats.max_write_ms = end_ms - start_ms;
+  }
+}
@@ -0,0 +1,188 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_ASYNC_LOG_WRITER_HPP
+#define XCSOAR_ASYNC_LOG_WRITER_HPP
+
+#include "IO/OutputStream.hxx"
+#include "IO/FileOutputStream.hxx"
+#include "Thread/StandbyThread.hpp"
+#include "Util/AllocatedArray.hxx"
+
+#include <stdint.h>
+
+/**
+ * Appends data to a log file in a dedicated thread, so the threads
+ * producing log lines never block on slow storage.
+ *
+ * Producers copy their data into one of two buffers; the thread
+ * takes the filled buffer, writes it in one batch and calls
+ * FileOutputStream::Sync() every few seconds, while producers
+ * continue filling the other buffer.  The mutex protects only the
+ * copy, never a system call.
+ */
+class AsyncLogWriter final : public OutputStream, private StandbyThread {
+public:
+  /**
+   * Counters describing how well the thread keeps up with the
+   * producers.
+   */
+  struct Stats {
+    /** Number of bytes written to the file */
+    uint64_t written_bytes;
+
+    /** Number of batches written to the file */
+    unsigned n_writes;
+
+    /** Number of FileOutputStream::Sync() calls */
+    unsigned n_syncs;
+
+    /** Number of records discarded by TryWrite() or after an error */
+    unsigned n_dropped;
+
+    /** Number of Write() calls which had to wait for free space */
+    unsigned n_stalls;
+
+    /** The maximum number of bytes queued at a time */
+    size_t max_pending;
+
+    /** The duration of the slowest batch (write and sync) [ms] */
+    unsigned max_write_ms;
+  };
+
+private:
+  FileOutputStream file;
+
+  /**
+   * Producers append to buffers[current]; the thread writes the
+   * other one.
+   */
+  AllocatedArray<char> buffers[2];
+  size_t fill[2];
+  unsigned current;
+
+  /**
+   * Signalled by the thread each time it has taken a buffer.
+   */
+  Cond space_cond;
+
+  /**
+   * The interval between two FileOutputStream::Sync() calls [ms].
+   */
+  const unsigned sync_interval_ms;
+
+  unsigned last_sync_ms;
+
+  /**
+   * Shall the next batch be synced regardless of #sync_interval_ms?
+   */
+  bool sync_requested;
+
+  /**
+   * Has writing to the file failed?  All further data is discarded.
+   */
+  bool failed;
+
+  Stats stats;
+
+public:
+  /**
+   * Open the file.  The thread is launched on demand.
+   *
+   * Throws std::runtime_error on error.
+   *
+   * @param name the name of the thread
+   * @param capacity the size of each of the two buffers; no record
+   * may be larger than this
+   */
+  AsyncLogWriter(Path path, FileOutputStream::Mode mode,
+                 const char *name, size_t capacity=32768,
+                 unsigned _sync_interval_ms=10000);
+
+  /**
+   * Write all pending data, sync and close the file.
+   */
+  ~AsyncLogWriter();
+
+  /**
+   * Has writing to the file failed?
+   */
+  bool HasFailed() {
+    const ScopeLock protect(mutex);
+    return failed;
+  }
+
+  Stats GetStats() {
+    const ScopeLock protect(mutex);
+    return stats;
+  }
+
+  /**
+   * Write the #Stats to the log file.
+   */
+  void LogStats(const char *name);
+
+  /**
+   * Queue a record.  It is discarded (and counted in
+   * Stats::n_dropped) if there is not enough space.  This method
+   * never waits for the thread.
+   *
+   * @return true if the record has been queued
+   */
+  bool TryWrite(const void *data, size_t size);
+
+  /**
+   * Like TryWrite(), but append the platform's end-of-line marker.
+   * The line and its end-of-line marker are queued or discarded
+   * together.
+   */
+  bool TryWriteLine(const char *line);
+
+  /**
+   * Queue a record.  Unlike TryWrite(), this method waits for the
+   * thread if there is not enough space, because the caller cannot
+   * afford losing data.  Write errors are not reported here; see
+   * HasFailed().
+   */
+  void Write(const void *data, size_t size) override;
+
+  /**
+   * Wake up the thread to write the queued data.  Does not wait.
+   */
+  void Flush();
+
+  /**
+   * Write the queued data and sync the file.  Waits until this is
+   * done.
+   */
+  void Sync();
+
+private:
+  void Append(const void *data, size_t size);
+
+  /* virtual methods from class StandbyThread */
+  void Tick() override;
+};
+
+#endif
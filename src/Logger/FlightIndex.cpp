@@ -0,0 +1,264 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "FlightIndex.hpp"
+#include "FlightParser.hpp"
+#include "IO/FileLineReader.hpp"
+#include "IO/FileOutputStream.hxx"
+#include "IO/BufferedOutputStream.hxx"
+#include "OS/FileMapping.hpp"
+#include "OS/FileUtil.hpp"
+#include "Time/BrokenDateTime.hpp"
+#include "Util/ScopeExit.hxx"
+
+#include <stdexcept>
+
+#include <stdio.h>
+#include <string.h>
+
+static constexpr uint32_t FLIGHT_INDEX_MAGIC = 0x46a7e312;
+
+struct FlightIndexHeader {
+  uint32_t magic;
+  uint32_t reserved;
+
+  /**
+   * The size of the flight log this index was built from.
+   */
+  uint64_t log_size;
+};
+
+static_assert(sizeof(FlightIndexHeader) == 16, "Unexpected padding");
+
+FlightIndex::FlightIndex(Path log_path)
+  :records(nullptr), n_records(0)
+{
+  if (!File::Exists(log_path))
+    return;
+
+  const auto index_path = GetIndexPath(log_path);
+  if (!Load(index_path, File::GetSize(log_path)) &&
+      !Load(index_path, Rebuild(log_path)))
+    throw std::runtime_error("Malformed flight index");
+}
+
+FlightIndex::~FlightIndex() = default;
+
+/**
+ * Check the header and the size of an index file.
+ *
+ * @return the number of records, or -1 if the file does not match
+ */
+static int
+CheckIndex(const FlightIndexHeader &header, uint64_t file_size,
+           uint64_t log_size)
+{
+  if (header.magic != FLIGHT_INDEX_MAGIC || header.log_size != log_size ||
+      file_size < sizeof(header) ||
+      (file_size - sizeof(header)) % sizeof(FlightIndex::Record) != 0)
+    return -1;
+
+  return (file_size - sizeof(header)) / sizeof(FlightIndex::Record);
+}
+
+bool
+FlightIndex::Load(Path index_path, uint64_t log_size)
+{
+  if (!File::Exists(index_path))
+    return false;
+
+  std::unique_ptr<FileMapping> _mapping(new FileMapping(index_path));
+  if (_mapping->error() || _mapping->size() < sizeof(FlightIndexHeader))
+    return false;
+
+  FlightIndexHeader header;
+  memcpy(&header, _mapping->data(), sizeof(header));
+
+  const int n = CheckIndex(header, _mapping->size(), log_size);
+  if (n < 0)
+    return false;
+
+  mapping = std::move(_mapping);
+  records = (const Record *)mapping->at(sizeof(header));
+  n_records = n;
+  return true;
+}
+
+AllocatedPath
+FlightIndex::GetIndexPath(Path log_path)
+{
+  return log_path + _T(".idx");
+}
+
+FlightInfo
+FlightIndex::ToFlightInfo(const Record &record)
+{
+  FlightInfo flight;
+  flight.date = BrokenDate(record.year, record.month, record.day);
+  flight.start_time = BrokenTime(record.start_hour, record.start_minute,
+                                 record.start_second);
+  flight.end_time = BrokenTime(record.end_hour, record.end_minute,
+                               record.end_second);
+  return flight;
+}
+
+FlightIndex::Record
+FlightIndex::ToRecord(const FlightInfo &flight)
+{
+  Record record;
+  record.year = flight.date.year;
+  record.month = flight.date.month;
+  record.day = flight.date.day;
+  record.start_hour = flight.start_time.hour;
+  record.start_minute = flight.start_time.minute;
+  record.start_second = flight.start_time.second;
+  record.end_hour = flight.end_time.hour;
+  record.end_minute = flight.end_time.minute;
+  record.end_second = flight.end_time.second;
+  record.reserved[0] = record.reserved[1] = 0;
+  return record;
+}
+
+uint64_t
+FlightIndex::Rebuild(Path log_path)
+{
+  FileLineReaderA reader(log_path);
+  const uint64_t log_size = reader.GetSize();
+
+  /* Mode::CREATE replaces the old index atomically */
+  FileOutputStream file(GetIndexPath(log_path));
+  BufferedOutputStream writer(file);
+
+  FlightIndexHeader header;
+  header.magic = FLIGHT_INDEX_MAGIC;
+  header.reserved = 0;
+  header.log_size = log_size;
+  writer.Write(&header, sizeof(header));
+
+  FlightParser parser(reader);
+  FlightInfo flight;
+  while (parser.Read(flight)) {
+    const Record record = ToRecord(flight);
+    writer.Write(&record, sizeof(record));
+  }
+
+  writer.Flush();
+  file.Commit();
+  return log_size;
+}
+
+/**
+ * Does this flight have a start, but no landing yet?  A landing
+ * logged shortly afterwards belongs to this flight (see
+ * FlightParser::Read()).
+ */
+gcc_pure
+static bool
+IsOpen(const FlightInfo &flight)
+{
+  return flight.date.IsPlausible() && flight.start_time.IsPlausible() &&
+    !flight.end_time.IsPlausible();
+}
+
+void
+FlightIndex::Add(Path log_path, uint64_t old_log_size, uint64_t new_log_size,
+                 const BrokenDateTime &date_time, bool landing)
+{
+  const auto index_path = GetIndexPath(log_path);
+  FILE *file = _tfopen(index_path.c_str(), _T("r+b"));
+  if (file == nullptr) {
+    Rebuild(log_path);
+    return;
+  }
+
+  AtScopeExit(file) { fclose(file); };
+
+  FlightIndexHeader header;
+  if (fread(&header, sizeof(header), 1, file) != 1 ||
+      fseek(file, 0, SEEK_END) != 0) {
+    Rebuild(log_path);
+    return;
+  }
+
+  const long file_size = ftell(file);
+  const int n = file_size >= 0
+    ? CheckIndex(header, file_size, old_log_size)
+    : -1;
+  if (n < 0) {
+    /* the flight log was modified behind our back, or an earlier
+       update was interrupted */
+    Rebuild(log_path);
+    return;
+  }
+
+  /* the position of the record to be written; append by default */
+  long position = file_size;
+
+  FlightInfo flight;
+  if (!date_time.IsPlausible()) {
+    /* ignored by FlightParser; just update the header below */
+    position = -1;
+  } else if (!landing) {
+    flight.date = date_time;
+    flight.start_time = date_time;
+    flight.end_time = BrokenTime::Invalid();
+  } else {
+    flight.date = date_time;
+    flight.start_time = BrokenTime::Invalid();
+    flight.end_time = date_time;
+
+    Record last;
+    if (n > 0 &&
+        fseek(file, file_size - sizeof(last), SEEK_SET) == 0 &&
+        fread(&last, sizeof(last), 1, file) == 1) {
+      const FlightInfo last_flight = ToFlightInfo(last);
+      if (IsOpen(last_flight)) {
+        const int duration = date_time -
+          BrokenDateTime(last_flight.date, last_flight.start_time);
+        if (duration >= 0 && duration <= 14 * 60 * 60) {
+          /* the landing of the last flight: complete its record */
+          flight = last_flight;
+          flight.end_time = date_time;
+          position = file_size - sizeof(last);
+        }
+      }
+    }
+  }
+
+  if (position >= 0) {
+    const Record record = ToRecord(flight);
+    if (fseek(file, position, SEEK_SET) != 0 ||
+        fwrite(&record, sizeof(record), 1, file) != 1)
+      throw std::runtime_error("Failed to write flight index");
+  }
+
+  /* update the header last; if this doesn't happen, the next call
+     will rebuild the index */
+  header.log_size = new_log_size;
+  if (fflush(file) != 0 ||
+      fseek(file, 0, SEEK_SET) != 0 ||
+      fwrite(&header, sizeof(header), 1, file) != 1 ||
+      fflush(file) != 0)
+    throw std::runtime_error("Failed to write flight index");
+}
@@ -0,0 +1,147 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_FLIGHT_INDEX_HPP
+#define XCSOAR_FLIGHT_INDEX_HPP
+
+#include "FlightInfo.hpp"
+#include "OS/Path.hpp"
+#include "Compiler.h"
+
+#include <memory>
+
+#include <assert.h>
+#include <stdint.h>
+
+class FileMapping;
+struct BrokenDateTime;
+
+/**
+ * A binary index of the flights in the text file written by
+ * #FlightLogger, so the flight list can be shown without parsing the
+ * whole text file with #FlightParser.  The index is stored next to
+ * the text file (with the suffix ".idx") and is mapped into memory.
+ *
+ * File layout: a 16 byte header (magic and the size of the text file
+ * the index was built from), followed by one fixed-size record per
+ * flight, oldest first.  New flights are appended; only the last
+ * record is ever modified (when its landing gets logged).
+ *
+ * The index is rebuilt from the text file automatically if it is
+ * missing or if its size does not match the text file's.
+ */
+class FlightIndex {
+public:
+  struct Record {
+    uint16_t year;
+    uint8_t month, day;
+    uint8_t start_hour, start_minute, start_second;
+    uint8_t end_hour, end_minute, end_second;
+    uint8_t reserved[2];
+  };
+
+  static_assert(sizeof(Record) == 12, "Unexpected padding");
+
+private:
+  std::unique_ptr<FileMapping> mapping;
+
+  const Record *records;
+  unsigned n_records;
+
+public:
+  /**
+   * Open the index of the given flight log, and rebuild it if
+   * necessary.  A missing flight log results in an empty index.
+   *
+   * Throws std::runtime_error on error.
+   */
+  explicit FlightIndex(Path log_path);
+
+  ~FlightIndex();
+
+  FlightIndex(const FlightIndex &) = delete;
+  FlightIndex &operator=(const FlightIndex &) = delete;
+
+  unsigned size() const {
+    return n_records;
+  }
+
+  bool empty() const {
+    return n_records == 0;
+  }
+
+  /**
+   * Returns the flight with the given index; 0 is the oldest one.
+   */
+  gcc_pure
+  FlightInfo operator[](unsigned i) const {
+    assert(i < n_records);
+
+    return ToFlightInfo(records[i]);
+  }
+
+  gcc_pure
+  static AllocatedPath GetIndexPath(Path log_path);
+
+  /**
+   * Parse the whole flight log and write a new index.
+   *
+   * Throws std::runtime_error on error.
+   *
+   * @return the size of the flight log which was indexed
+   */
+  static uint64_t Rebuild(Path log_path);
+
+  /**
+   * Update the index after an event has been appended to the flight
+   * log by #FlightLogger.  The index is rebuilt if it did not match
+   * the flight log before the event was appended.
+   *
+   * Throws std::runtime_error on error.
+   *
+   * @param old_log_size the size of the flight log before the event
+   * @param new_log_size the size of the flight log after the event
+   * @param landing true for a "landing" event, false for "start"
+   */
+  static void Add(Path log_path,
+                  uint64_t old_log_size, uint64_t new_log_size,
+                  const BrokenDateTime &date_time, bool landing);
+
+  gcc_pure
+  static FlightInfo ToFlightInfo(const Record &record);
+
+  gcc_pure
+  static Record ToRecord(const FlightInfo &flight);
+
+private:
+  /**
+   * Map the index file and verify it.
+   *
+   * @return false if the file is missing, malformed or was not built
+   * from a flight log of the given size
+   */
+  bool Load(Path index_path, uint64_t log_size);
+};
+
+#endif
@@ -22,10 +22,13 @@ Copyright_License {
 */
 
 #include "FlightLogger.hpp"
+#include "FlightIndex.hpp"
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
 #include "IO/FileOutputStream.hxx"
 #include "IO/BufferedOutputStream.hxx"
+#include "OS/FileUtil.hpp"
+#include "Util/StringAPI.hxx"
 #include "LogFile.hpp"
 
 void
@@ -42,6 +45,8 @@ FlightLogger::LogEvent(const BrokenDateTime &date_time, const char *type)
 try {
   assert(type != nullptr);
 
+  const uint64_t old_size = File::GetSize(path);
+
   FileOutputStream file(path, FileOutputStream::Mode::APPEND_OR_CREATE);
   BufferedOutputStream writer(file);
 
@@ -53,7 +58,11 @@ try {
                 type);
 
   writer.Flush();
+  const uint64_t new_size = file.Tell();
   file.Commit();
+
+  FlightIndex::Add(path, old_size, new_size, date_time,
+                   StringIsEqual(type, "landing"));
 } catch (const std::runtime_error &e) {
   LogError(e);
 }
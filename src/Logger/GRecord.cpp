@@ -68,27 +68,48 @@ GRecord::AppendRecordToBuffer(const char *in)
 }
 
 /**
+ * Copy the characters which are relevant for the G record to the
+ * buffer.
+ *
  * @param ignore_comma if true, then the comma is ignored, even though
  * it's a valid IGC character
+ * @return the end of the consumed input; the number of characters
+ * written to the buffer is returned in #length_r
  */
-static void
-AppendIGCString(MD5 &md5, const char *s, bool ignore_comma)
+static const char *
+FilterIGCString(char *buffer, size_t max_length, size_t &length_r,
+                const char *s, bool ignore_comma)
 {
-  while (*s != '\0') {
-    const char ch = *s++;
+  char *p = buffer, *const end = buffer + max_length;
+
+  for (; *s != '\0' && p != end; ++s) {
+    const char ch = *s;
     if (ignore_comma && ch == ',')
       continue;
 
     if (IsValidIGCChar(ch))
-      md5.Append(ch);
+      *p++ = ch;
   }
+
+  length_r = p - buffer;
+  return s;
 }
 
 void
 GRecord::AppendStringToBuffer(const char *in)
 {
-  for (auto &i : md5)
-    AppendIGCString(i, in, ignore_comma);
+  /* filter the record only once, and then append it to all MD5
+     instances in bulk; this is called for each record IGCWriter
+     writes */
+  char buffer[256];
+
+  while (*in != '\0') {
+    size_t length;
+    in = FilterIGCString(buffer, sizeof(buffer), length, in, ignore_comma);
+
+    for (auto &i : md5)
+      i.Append(buffer, length);
+  }
 }
 
 void
@@ -22,15 +22,15 @@
 */
 
 #include "IGCFileCleanup.hpp"
-#include "Util/StaticString.hxx"
+#include "TraceArchiveJob.hpp"
 #include "LocalPath.hpp"
 #include "OS/FileUtil.hpp"
 #include "OS/Path.hpp"
+#include "Operation/Operation.hpp"
 #include "UtilsSystem.hpp"
 
 #include <tchar.h>
 #include <time.h>
-#include <windef.h>
 
 // JMW note: we want to clear up enough space to save the persistent
 // data (85 kb approx) and a new log file
@@ -107,67 +107,77 @@ LogFileDate(unsigned current_year, const TCHAR *filename)
   return 0;
 }
 
-class OldIGCFileFinder: public File::Visitor
+/**
+ * Delete the eldest IGC file in the index.
+ * @param current_year The current year (for short filenames)
+ * @param freed Incremented by the size of the deleted file
+ * @return True if a file was removed from the index, False if the
+ * index is empty
+ */
+static bool
+DeleteOldestIGCFile(IGCFileIndex &index, unsigned current_year,
+                    uint64_t &freed)
 {
-  unsigned current_year;
-  time_t oldest_time;
-  StaticString<MAX_PATH> oldest_path;
-
-public:
-  OldIGCFileFinder(unsigned _current_year):current_year(_current_year) {
-    oldest_path.clear();
-  }
-
-  void Visit(Path path, Path filename) override {
-    time_t this_time = LogFileDate(current_year, filename.c_str());
-    if (oldest_path.empty() || oldest_time > this_time) {
+  auto oldest = index.end();
+  time_t oldest_time = 0;
+  for (auto i = index.begin(); i != index.end(); ++i) {
+    time_t this_time = LogFileDate(current_year, i->path.GetBase().c_str());
+    if (oldest == index.end() || oldest_time > this_time) {
       oldest_time = this_time;
-      oldest_path = path.c_str();
+      oldest = i;
     }
   }
 
-  Path GetOldestIGCFile() const {
-    return Path(oldest_path.c_str());
-  }
-};
+  if (oldest == index.end())
+    return false;
 
-/**
- * Delete eldest IGC file in the given path
- * @param gps_info Current NMEA_INFO
- * @param pathname Path where to search for the IGC files
- * @return True if a file was found and deleted, False otherwise
- */
-static bool
-DeleteOldestIGCFile(unsigned current_year, Path pathname)
-{
-  OldIGCFileFinder visitor(current_year);
-  Directory::VisitSpecificFiles(pathname, _T("*.igc"), visitor, true);
+  const AllocatedPath path(Path(oldest->path));
+  const uint64_t size = index.Remove(oldest);
 
-  if (visitor.GetOldestIGCFile().IsEmpty())
-    return false;
+  // now, delete the file and its trace archive...
+  if (File::Delete(path))
+    /* a stale index entry doesn't free anything */
+    freed += size;
 
-  // now, delete the file...
-  File::Delete(visitor.GetOldestIGCFile());
+  File::Delete(TraceArchiveJob::GetArchivePath(path));
   return true;
 }
 
-bool
-IGCFileCleanup(unsigned current_year)
+/**
+ * Delete old IGC files from the index until enough space is
+ * available.  The free space is queried only once; after that, the
+ * sizes recorded in the index are used.
+ */
+static bool
+IGCFileCleanup(IGCFileIndex &index, Path pathname, unsigned current_year,
+               OperationEnvironment &env)
 {
-  const auto pathname = GetPrimaryDataPath();
+  // Find out how much space is available
+  const uint64_t kbfree = FindFreeSpace(pathname.c_str());
+  uint64_t freed = 0;
+  bool rescanned = false;
 
   int numtries = 0;
   do {
-    // Find out how much space is available
-    unsigned long kbfree = FindFreeSpace(pathname.c_str());
-    if (kbfree >= LOGGER_MINFREESTORAGE) {
+    if (kbfree + freed / 1024 >= LOGGER_MINFREESTORAGE) {
       // if enough space is available we return happily
       return true;
     }
 
+    if (env.IsCancelled())
+      return false;
+
     // if we don't have enough space yet we try to delete old IGC files
-    if (!DeleteOldestIGCFile(current_year, pathname))
-      break;
+    if (!DeleteOldestIGCFile(index, current_year, freed)) {
+      if (rescanned)
+        break;
+
+      /* the index may be stale, e.g. if IGC files were copied to the
+         data directory; visit the directory once before giving up */
+      index.Scan(pathname);
+      rescanned = true;
+      continue;
+    }
 
     // but only 100 times
     numtries++;
@@ -177,3 +187,42 @@ IGCFileCleanup(unsigned current_year)
   // 100 old IGC files already
   return false;
 }
+
+void
+IGCFileCleanupJob::AddFile(Path path)
+{
+  new_files.emplace_back(path);
+}
+
+void
+IGCFileCleanupJob::Run(OperationEnvironment &env)
+{
+  const auto pathname = GetPrimaryDataPath();
+  const auto index_path = AllocatedPath::Build(pathname, _T("igc.idx"));
+
+  if (!loaded) {
+    if (!index.Load(index_path))
+      index.Scan(pathname);
+    loaded = true;
+  }
+
+  for (const auto &path : new_files)
+    index.Add(path, File::GetSize(path));
+  new_files.clear();
+
+  /* IGC files may have been created by others since the index was
+     saved (e.g. downloaded from an external logger, or copied by the
+     user); a directory which has been modified after the index file
+     is visited again */
+  const uint64_t index_time = File::GetLastModification(index_path);
+  const auto logs_path = AllocatedPath::Build(pathname, _T("logs"));
+  for (Path directory : {Path(pathname), Path(logs_path)})
+    /* ">=" because the time stamps have a resolution of one second;
+       a file created in the same second as the index is not missed */
+    if (Directory::GetLastModification(directory) >= index_time)
+      index.Update(directory);
+
+  result = IGCFileCleanup(index, pathname, current_year, env);
+  has_result = true;
+  index.Save(index_path);
+}
@@ -24,12 +24,68 @@ Copyright_License {
 #ifndef XCSOAR_IGC_CLEANUP_HPP
 #define XCSOAR_IGC_CLEANUP_HPP
 
+#include "IGCFileIndex.hpp"
+#include "Job/Job.hpp"
+
+#include <list>
+
 /**
  * Deletes old IGC files until at least LOGGER_MINFREESTORAGE KiB of
- * space are available
- * @param current_year The current year (for short filenames)
- * @return True if enough space could be cleared, False otherwise
+ * space are available.  This is a #Job, so it can be run in a
+ * background thread by #AsyncJobRunner.
+ *
+ * The list of IGC files is loaded from the #IGCFileIndex file in the
+ * data directory and kept in memory between runs; the directory tree
+ * is visited only if there is no valid index file, or if the index
+ * runs out of files to delete.  The data directory and its "logs"
+ * subdirectory are listed again if they have been modified after the
+ * index file was saved.
  */
-bool IGCFileCleanup(unsigned current_year);
+class IGCFileCleanupJob final : public Job {
+  IGCFileIndex index;
+
+  /**
+   * Files which have been created since the last run, to be added to
+   * the index.
+   */
+  std::list<AllocatedPath> new_files;
+
+  unsigned current_year;
+
+  bool loaded = false;
+
+  bool has_result = false, result = false;
+
+public:
+  /**
+   * @param current_year The current year (for short filenames)
+   */
+  void SetCurrentYear(unsigned _current_year) {
+    current_year = _current_year;
+  }
+
+  /**
+   * Add a new IGC file to the index in the next run.
+   */
+  void AddFile(Path path);
+
+  /**
+   * Has Run() completed at least once?
+   */
+  bool HasResult() const {
+    return has_result;
+  }
+
+  /**
+   * @return True if enough space could be cleared in the last run,
+   * False otherwise
+   */
+  bool GetResult() const {
+    return result;
+  }
+
+  /* virtual methods from class Job */
+  void Run(OperationEnvironment &env) override;
+};
 
 #endif
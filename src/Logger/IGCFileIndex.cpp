@@ -0,0 +1,142 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IGCFileIndex.hpp"
+#include "IO/FileLineReader.hpp"
+#include "IO/FileOutputStream.hxx"
+#include "IO/BufferedOutputStream.hxx"
+#include "OS/FileUtil.hpp"
+#include "Util/NumberParser.hpp"
+#include "Util/StringAPI.hxx"
+
+#include <algorithm>
+
+#include <string.h>
+
+static constexpr TCHAR HEADER[] = _T("XCSoar IGC file index 1");
+
+class IGCFileIndexVisitor final : public File::Visitor {
+  IGCFileIndex &index;
+
+public:
+  explicit IGCFileIndexVisitor(IGCFileIndex &_index):index(_index) {}
+
+  void Visit(Path path, Path filename) override {
+    index.Add(path, File::GetSize(path));
+  }
+};
+
+void
+IGCFileIndex::Scan(Path directory)
+{
+  Clear();
+
+  IGCFileIndexVisitor visitor(*this);
+  Directory::VisitSpecificFiles(directory, _T("*.igc"), visitor, true);
+}
+
+void
+IGCFileIndex::Update(Path directory)
+{
+  IGCFileIndexVisitor visitor(*this);
+  Directory::VisitSpecificFiles(directory, _T("*.igc"), visitor, false);
+}
+
+bool
+IGCFileIndex::Load(Path index_path)
+{
+  Clear();
+
+  if (!File::Exists(index_path))
+    return false;
+
+  FileLineReader reader(index_path);
+
+  const TCHAR *line = reader.ReadLine();
+  if (line == nullptr || !StringIsEqual(line, HEADER))
+    return false;
+
+  while ((line = reader.ReadLine()) != nullptr) {
+    TCHAR *endptr;
+    const uint64_t size = ParseUint64(line, &endptr);
+    if (endptr == line || *endptr != _T(' ') || endptr[1] == _T('\0')) {
+      Clear();
+      return false;
+    }
+
+    Add(Path(endptr + 1), size);
+  }
+
+  return true;
+}
+
+void
+IGCFileIndex::Save(Path index_path) const
+{
+  FileOutputStream file(index_path);
+  BufferedOutputStream buffered(file);
+
+  buffered.Write(HEADER);
+  buffered.Write('\n');
+
+  for (const auto &i : entries) {
+    buffered.Format("%llu ", (unsigned long long)i.size);
+    buffered.Write(i.path.c_str());
+    buffered.Write('\n');
+  }
+
+  buffered.Flush();
+  file.Commit();
+}
+
+IGCFileIndex::const_iterator
+IGCFileIndex::Find(Path path) const
+{
+  return std::find_if(entries.begin(), entries.end(),
+                      [path](const Entry &entry){
+                        return entry.path == path;
+                      });
+}
+
+void
+IGCFileIndex::Add(Path path, uint64_t size)
+{
+  auto i = entries.begin() + (Find(path) - entries.begin());
+  if (i != entries.end()) {
+    total_size -= i->size;
+    i->size = size;
+  } else
+    entries.emplace_back(path, size);
+
+  total_size += size;
+}
+
+uint64_t
+IGCFileIndex::Remove(const_iterator i)
+{
+  const uint64_t size = i->size;
+  total_size -= size;
+  entries.erase(entries.begin() + (i - entries.begin()));
+  return size;
+}
@@ -0,0 +1,142 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IGC_FILE_INDEX_HPP
+#define XCSOAR_IGC_FILE_INDEX_HPP
+
+#include "OS/Path.hpp"
+#include "Compiler.h"
+
+#include <vector>
+
+#include <stdint.h>
+
+/**
+ * A list of the IGC files in the data directory and their sizes,
+ * used by IGCFileCleanup() to decide which files to delete without
+ * visiting the whole directory tree.  The list is kept up to date
+ * incrementally (Add(), Remove()) and is saved to a text file, so it
+ * needs to be rebuilt with Scan() only if that file is missing or
+ * turns out to be stale.
+ *
+ * File format: a header line, followed by one line per IGC file with
+ * its size in bytes and its absolute path, separated by a space.
+ *
+ * This class is not thread-safe.
+ */
+class IGCFileIndex {
+public:
+  struct Entry {
+    AllocatedPath path;
+    uint64_t size;
+
+    Entry(Path _path, uint64_t _size):path(_path), size(_size) {}
+  };
+
+private:
+  std::vector<Entry> entries;
+
+  /**
+   * The sum of all Entry::size values.
+   */
+  uint64_t total_size;
+
+public:
+  IGCFileIndex():total_size(0) {}
+
+  typedef std::vector<Entry>::const_iterator const_iterator;
+
+  const_iterator begin() const {
+    return entries.begin();
+  }
+
+  const_iterator end() const {
+    return entries.end();
+  }
+
+  unsigned size() const {
+    return entries.size();
+  }
+
+  bool empty() const {
+    return entries.empty();
+  }
+
+  uint64_t GetTotalSize() const {
+    return total_size;
+  }
+
+  void Clear() {
+    entries.clear();
+    total_size = 0;
+  }
+
+  /**
+   * Replace the contents with all "*.igc" files in the given
+   * directory and its subdirectories.
+   */
+  void Scan(Path directory);
+
+  /**
+   * Add all "*.igc" files in the given directory (but not its
+   * subdirectories) which are not yet in the index, and update the
+   * sizes of the others.  Unlike Scan(), this keeps all existing
+   * entries.
+   */
+  void Update(Path directory);
+
+  /**
+   * Replace the contents with the index file written by Save().
+   *
+   * Throws std::runtime_error on I/O error.
+   *
+   * @return false if the file does not exist or is malformed (the
+   * index is then empty)
+   */
+  bool Load(Path index_path);
+
+  /**
+   * Write the index file, replacing the old one atomically.
+   *
+   * Throws std::runtime_error on error.
+   */
+  void Save(Path index_path) const;
+
+  /**
+   * Add a file, or update its size if it is already in the index.
+   */
+  void Add(Path path, uint64_t size);
+
+  /**
+   * Remove an entry; the file itself is not touched.
+   *
+   * @return the size of the removed entry
+   */
+  uint64_t Remove(const_iterator i);
+
+  gcc_pure
+  const_iterator Find(Path path) const;
+};
+
+#endif
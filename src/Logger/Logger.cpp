@@ -26,12 +26,12 @@
 #include "NMEA/Info.hpp"
 #include "Language/Language.hpp"
 #include "Dialogs/Message.hpp"
+#include "Message.hpp"
 #include "LogFile.hpp"
 #include "Task/ProtectedTaskManager.hpp"
 #include "Engine/Task/Ordered/OrderedTask.hpp"
 #include "Asset.hpp"
 #include "Computer/Settings.hpp"
-#include "IGCFileCleanup.hpp"
 
 void
 Logger::LogPoint(const NMEAInfo &gps_info)
@@ -41,7 +41,17 @@ Logger::LogPoint(const NMEAInfo &gps_info)
 
   if (lock.try_lock()) {
     logger.LogPoint(gps_info);
+
+    const bool failed = logger.HasFailed();
+    if (failed)
+      logger.StopLogger(gps_info);
+
     lock.unlock();
+
+    if (failed) {
+      LogFormat("Logger stopped: IGC file write error");
+      Message::AddMessage(_("Logger stopped, could not write the IGC file!"));
+    }
   }
 }
 
@@ -76,7 +86,8 @@ Logger::IsLoggerActive() const
 bool
 Logger::LoggerClearFreeSpace(unsigned current_year)
 {
-  return IGCFileCleanup(current_year);
+  const ScopeExclusiveLock protect(lock);
+  return logger.ClearFreeSpace(current_year);
 }
 
 void
@@ -37,6 +37,7 @@
 
 #include <tchar.h>
 #include <algorithm>
+#include <stdexcept>
 
 const struct LoggerImpl::PreTakeoffBuffer &
 LoggerImpl::PreTakeoffBuffer::operator=(const NMEAInfo &src)
@@ -84,6 +85,56 @@ LoggerImpl::LoggerImpl()
 LoggerImpl::~LoggerImpl()
 {
   delete writer;
+
+  if (cleanup_runner.IsBusy())
+    cleanup_runner.Cancel();
+  WaitCleanup();
+
+  /* not cancelled: the archive of the last flight shall be
+     complete */
+  WaitArchive();
+}
+
+void
+LoggerImpl::WaitCleanup()
+{
+  if (!cleanup_runner.IsBusy())
+    return;
+
+  try {
+    cleanup_runner.Wait();
+  } catch (const std::runtime_error &e) {
+    LogError("IGC file cleanup failed", e);
+  }
+}
+
+void
+LoggerImpl::WaitArchive()
+{
+  if (archive_runner.IsBusy())
+    archive_runner.Wait();
+}
+
+bool
+LoggerImpl::HasFailed() const
+{
+  return writer != nullptr && writer->HasFailed();
+}
+
+bool
+LoggerImpl::ClearFreeSpace(unsigned current_year)
+{
+  /* the job object may be modified only while it is not running */
+  WaitCleanup();
+
+  if (cleanup_job.HasResult() && cleanup_job.GetResult())
+    return true;
+
+  cleanup_job.SetCurrentYear(current_year);
+  cleanup_runner.Start(&cleanup_job, cleanup_env);
+  WaitCleanup();
+
+  return cleanup_job.GetResult();
 }
 
 void
@@ -98,7 +149,8 @@ LoggerImpl::StopLogger(const NMEAInfo &gps_info)
   if (!simulator)
     writer->Sign();
 
-  writer->Flush();
+  writer->Sync();
+  writer->LogStats();
 
   LogFormat(_T("Logger stopped: %s"), filename.c_str());
 
@@ -106,9 +158,20 @@ LoggerImpl::StopLogger(const NMEAInfo &gps_info)
   delete writer;
   writer = nullptr;
 
-  // Make space for logger file, if unsuccessful -> cancel
-  if (gps_info.gps.real && gps_info.date_time_utc.IsDatePlausible())
-    IGCFileCleanup(gps_info.date_time_utc.year);
+  /* write a compact copy of the trace for post-flight analysis; the
+     job object may be modified only while it is not running */
+  WaitArchive();
+  archive_job.AddFile(filename);
+  archive_runner.Start(&archive_job, archive_env);
+
+  WaitCleanup();
+  cleanup_job.AddFile(filename);
+
+  // Make space for logger file in a background thread
+  if (gps_info.gps.real && gps_info.date_time_utc.IsDatePlausible()) {
+    cleanup_job.SetCurrentYear(gps_info.date_time_utc.year);
+    cleanup_runner.Start(&cleanup_job, cleanup_env);
+  }
 
   pre_takeoff_buffer.clear();
 }
@@ -25,6 +25,10 @@ Copyright_License {
 #define XCSOAR_LOGGER_IMPL_HPP
 
 #include "LoggerFRecord.hpp"
+#include "IGCFileCleanup.hpp"
+#include "TraceArchiveJob.hpp"
+#include "Job/Async.hpp"
+#include "Operation/Operation.hpp"
 #include "Time/BrokenDateTime.hpp"
 #include "Geo/GeoPoint.hpp"
 #include "OS/Path.hpp"
@@ -105,6 +109,24 @@ private:
    */
   bool simulator;
 
+  /**
+   * Deletes old IGC files in a background thread after the logger
+   * has been stopped, and before it is started if needed (see
+   * ClearFreeSpace()).  All runs go through #cleanup_runner, so
+   * they never overlap.
+   */
+  IGCFileCleanupJob cleanup_job;
+  AsyncJobRunner cleanup_runner;
+  NullOperationEnvironment cleanup_env;
+
+  /**
+   * Writes the #TraceArchive of each finished IGC file in a
+   * background thread.
+   */
+  TraceArchiveJob archive_job;
+  AsyncJobRunner archive_runner;
+  NullOperationEnvironment archive_env;
+
 public:
   /** Default constructor */
   LoggerImpl();
@@ -118,6 +140,23 @@ public:
     return writer != nullptr;
   }
 
+  /**
+   * Has writing the IGC file failed?  The logger should be stopped
+   * then, because all further records are lost.
+   */
+  bool HasFailed() const;
+
+  /**
+   * Is there enough free storage for a new IGC file?  The answer is
+   * the result of the last #IGCFileCleanupJob run (the job runs in
+   * the background each time the logger stops).  Only if there is
+   * no such result, or if it was negative, the job is run now and
+   * this method waits for it.
+   *
+   * @param current_year The current year (for short filenames)
+   */
+  bool ClearFreeSpace(unsigned current_year);
+
   void StartLogger(const NMEAInfo &gps_info, const LoggerSettings &settings,
                    const TCHAR *asset_number, const Declaration &decl);
 
@@ -138,6 +177,16 @@ private:
                    const char *logger_id);
   
 private:
+  /**
+   * Wait for the #IGCFileCleanupJob to finish, if it was started.
+   */
+  void WaitCleanup();
+
+  /**
+   * Wait for the #TraceArchiveJob to finish, if it was started.
+   */
+  void WaitArchive();
+
   void LogPointToBuffer(const NMEAInfo &gps_info);
   void WritePoint(const NMEAInfo &gps_info);
 };
@@ -131,10 +131,23 @@ MD5::Append(uint8_t ch)
 void
 MD5::Append(const void *data, size_t length)
 {
-  const uint8_t *i = (const uint8_t *)data, *const end = i + length;
+  const uint8_t *i = (const uint8_t *)data;
 
-  while (i != end)
-    Append(*i++);
+  unsigned position = unsigned(message_length) % ARRAY_SIZE(buff512bits);
+  message_length += length;
+
+  while (length > 0) {
+    const size_t n = std::min(length, ARRAY_SIZE(buff512bits) - position);
+    std::copy_n(i, n, buff512bits + position);
+    i += n;
+    length -= n;
+    position += n;
+
+    if (position == ARRAY_SIZE(buff512bits)) {
+      Process512(buff512bits);
+      position = 0;
+    }
+  }
 }
 
 /**
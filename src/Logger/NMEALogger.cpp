@@ -22,17 +22,22 @@ Copyright_License {
 */
 
 #include "Logger/NMEALogger.hpp"
-#include "IO/TextWriter.hpp"
+#include "Logger/AsyncLogWriter.hpp"
 #include "LocalPath.hpp"
+#include "LogFile.hpp"
 #include "Time/BrokenDateTime.hpp"
 #include "Thread/Mutex.hpp"
 #include "OS/Path.hpp"
+#include "OS/Clock.hpp"
 #include "Util/StaticString.hxx"
 
 namespace NMEALogger
 {
   static Mutex mutex;
-  static TextWriter *writer;
+  static AsyncLogWriter *writer;
+
+  static constexpr unsigned FLUSH_INTERVAL_MS = 2000;
+  static unsigned last_flush_ms;
 
   bool enabled = false;
 
@@ -56,13 +61,12 @@ NMEALogger::Start()
   const auto logs_path = MakeLocalPath(_T("logs"));
 
   const auto path = AllocatedPath::Build(logs_path, name);
-  writer = new TextWriter(path, false);
-  if (writer == nullptr)
-    return false;
 
-  if (!writer->IsOpen()) {
-    delete writer;
-    writer = nullptr;
+  try {
+    writer = new AsyncLogWriter(path, FileOutputStream::Mode::CREATE_VISIBLE,
+                                "NMEALogger");
+  } catch (const std::runtime_error &e) {
+    LogError(e);
     return false;
   }
 
@@ -72,7 +76,14 @@ NMEALogger::Start()
 void
 NMEALogger::Shutdown()
 {
+  ScopeLock protect(mutex);
+  if (writer == nullptr)
+    return;
+
+  writer->Sync();
+  writer->LogStats("NMEALogger");
   delete writer;
+  writer = nullptr;
 }
 
 void
@@ -82,6 +93,18 @@ NMEALogger::Log(const char *text)
     return;
 
   ScopeLock protect(mutex);
-  if (Start())
-    writer->WriteLine(text);
+  if (Start()) {
+    /* discard the line if the writer thread doesn't keep up; the
+       device thread must not wait for the storage */
+    writer->TryWriteLine(text);
+
+    /* the writer thread wakes up by itself when half of its buffer
+       is filled; wake it up at least once per FLUSH_INTERVAL_MS so
+       the file does not lag too far behind */
+    const unsigned now_ms = MonotonicClockMS();
+    if (now_ms - last_flush_ms >= FLUSH_INTERVAL_MS) {
+      last_flush_ms = now_ms;
+      writer->Flush();
+    }
+  }
 }
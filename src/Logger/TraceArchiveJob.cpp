@@ -0,0 +1,57 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TraceArchiveJob.hpp"
+#include "IGC/TraceArchiveWriter.hpp"
+#include "Operation/Operation.hpp"
+#include "LogFile.hpp"
+
+#include <stdexcept>
+
+AllocatedPath
+TraceArchiveJob::GetArchivePath(Path igc_path)
+{
+  return igc_path.WithExtension(_T(".xta"));
+}
+
+void
+TraceArchiveJob::AddFile(Path path)
+{
+  pending.emplace_back(path);
+}
+
+void
+TraceArchiveJob::Run(OperationEnvironment &env)
+{
+  while (!pending.empty() && !env.IsCancelled()) {
+    const Path igc_path = pending.front();
+
+    try {
+      WriteTraceArchive(igc_path, GetArchivePath(igc_path));
+    } catch (const std::runtime_error &e) {
+      LogError("Failed to write trace archive", e);
+    }
+
+    pending.pop_front();
+  }
+}
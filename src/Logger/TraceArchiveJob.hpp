@@ -0,0 +1,59 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TRACE_ARCHIVE_JOB_HPP
+#define XCSOAR_TRACE_ARCHIVE_JOB_HPP
+
+#include "Job/Job.hpp"
+#include "OS/Path.hpp"
+
+#include <list>
+
+/**
+ * Writes a #TraceArchive next to each IGC file passed to AddFile().
+ * This is a #Job, so it can be run in a background thread by
+ * #AsyncJobRunner after the logger has been stopped.
+ */
+class TraceArchiveJob final : public Job {
+  /**
+   * IGC files which have no archive yet.
+   */
+  std::list<AllocatedPath> pending;
+
+public:
+  /**
+   * Returns the path of the archive which belongs to the given IGC
+   * file.
+   */
+  static AllocatedPath GetArchivePath(Path igc_path);
+
+  /**
+   * Write the archive of this IGC file in the next run.
+   */
+  void AddFile(Path path);
+
+  /* virtual methods from class Job */
+  void Run(OperationEnvironment &env) override;
+};
+
+#endif
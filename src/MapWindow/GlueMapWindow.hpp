@@ -230,6 +230,11 @@ private:
   void DrawVario(Canvas &canvas, const PixelRect &rc) const;
   void DrawStallRatio(Canvas &canvas, const PixelRect &rc) const;
 
+  /**
+   * Draw the statistics of the #Profiler, if it is enabled.
+   */
+  void DrawProfiler(Canvas &canvas, const PixelRect &rc) const;
+
   void SwitchZoomClimb();
 
   void SaveDisplayModeScales();
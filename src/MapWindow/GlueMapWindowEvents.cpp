@@ -464,4 +464,6 @@ GlueMapWindow::Render(Canvas &canvas, const PixelRect &rc)
     DrawVario(canvas, rc);
     DrawGPSStatus(canvas, rc, Basic());
   }
+
+  DrawProfiler(canvas, rc);
 }
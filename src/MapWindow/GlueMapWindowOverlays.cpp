@@ -42,6 +42,9 @@ Copyright_License {
 #include "Look/GestureLook.hpp"
 #include "Input/InputEvents.hpp"
 #include "Renderer/MapScaleRenderer.hpp"
+#include "OS/Profiler.hpp"
+#include "Util/ConvertString.hpp"
+#include "Util/StringFormat.hpp"
 
 #include <stdio.h>
 
@@ -427,3 +430,39 @@ GlueMapWindow::DrawStallRatio(Canvas &canvas, const PixelRect &rc) const
     canvas.DrawLine(rc.right - 1, rc.bottom - m, rc.right - 11, rc.bottom - m);
   }
 }
+
+void
+GlueMapWindow::DrawProfiler(Canvas &canvas, const PixelRect &rc) const
+{
+  if (!Profiler::IsEnabled())
+    return;
+
+  Profiler::Statistics statistics[32];
+  const unsigned n = Profiler::Summarise(statistics, ARRAY_SIZE(statistics));
+
+  TextInBoxMode mode;
+  mode.shape = LabelShape::OUTLINED;
+
+  const Font &font = *look.overlay.overlay_font;
+  canvas.Select(font);
+
+  const int padding = Layout::FastScale(4);
+  const int height = font.GetHeight();
+  int y = rc.top + padding;
+
+  for (unsigned i = 0; i < n && y + height < rc.bottom; ++i) {
+    const Profiler::Statistics &s = statistics[i];
+
+    const UTF8ToWideConverter track(Profiler::GetTrackName(s.track));
+    const UTF8ToWideConverter name(s.name);
+
+    TCHAR buffer[128];
+    StringFormat(buffer, ARRAY_SIZE(buffer),
+                 _T("%s/%s: %.1f ms (max %.1f)"),
+                 (const TCHAR *)track, (const TCHAR *)name,
+                 s.GetAverage() / 1000., s.max_us / 1000.);
+
+    TextInBox(canvas, buffer, rc.left + padding, y, mode, rc, nullptr);
+    y += height;
+  }
+}
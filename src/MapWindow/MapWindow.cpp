@@ -58,6 +58,7 @@ void
 MapWindow::SetOverlay(std::unique_ptr<MapOverlay> &&_overlay)
 {
   overlay = std::move(_overlay);
+  ground_cache.Invalidate();
 }
 
 #endif
@@ -78,6 +79,7 @@ MapWindow::FlushCaches()
   if (rasp_renderer)
     rasp_renderer->Flush();
   airspace_renderer.Flush();
+  ground_cache.Invalidate();
 }
 
 /**
@@ -137,8 +139,11 @@ MapWindow::OnPaintBuffer(Canvas &canvas)
 #endif
 
   // Render the moving map
-  Render(canvas, GetClientRect());
-  draw_sw.Finish();
+  {
+    const ScopeProfiler profile(Profiler::Track::DRAW, "Frame");
+    Render(canvas, GetClientRect());
+    draw_sw.Finish();
+  }
 
 #ifndef ENABLE_OPENGL
   /* save the generation number which was active when rendering had
@@ -157,6 +162,7 @@ MapWindow::SetTopography(TopographyStore *_topography)
   topography_renderer = topography != nullptr
     ? new CachedTopographyRenderer(*topography, look.topography)
     : nullptr;
+  ground_cache.Invalidate();
 }
 
 void
@@ -164,6 +170,7 @@ MapWindow::SetTerrain(RasterTerrain *_terrain)
 {
   terrain = _terrain;
   background.SetTerrain(_terrain);
+  ground_cache.Invalidate();
 }
 
 void
@@ -171,4 +178,5 @@ MapWindow::SetRasp(const std::shared_ptr<RaspStore> &_rasp_store)
 {
   rasp_renderer.reset();
   rasp_store = _rasp_store;
+  ground_cache.Invalidate();
 }
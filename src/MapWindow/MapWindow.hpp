@@ -31,12 +31,15 @@ Copyright_License {
 #include "Screen/BufferCanvas.hpp"
 #endif
 #include "Renderer/LabelBlock.hpp"
+#include "Renderer/LayerCache.hpp"
 #include "Screen/StopWatch.hpp"
 #include "MapWindowBlackboard.hpp"
 #include "Renderer/AirspaceLabelRenderer.hpp"
 #include "Renderer/BackgroundRenderer.hpp"
 #include "Renderer/WaypointRenderer.hpp"
 #include "Renderer/TrailRenderer.hpp"
+#include "Terrain/TerrainSettings.hpp"
+#include "Util/Serial.hpp"
 #include "Compiler.h"
 #include "Weather/Features.hpp"
 #include "Tracking/SkyLines/Features.hpp"
@@ -75,6 +78,42 @@ class MapWindow :
 
   LabelBlock label_block;
 
+  /**
+   * The inputs of #ground_cache, except for the projection.
+   */
+  struct GroundLayerState {
+    TerrainRendererSettings terrain_settings;
+    Angle shading_angle;
+    Serial terrain_serial;
+
+    bool topography_enabled;
+    unsigned topography_serial;
+
+    int rasp_map;
+    Serial rasp_serial;
+
+    gcc_pure
+    bool operator==(const GroundLayerState &other) const {
+      return terrain_settings == other.terrain_settings &&
+        shading_angle == other.shading_angle &&
+        terrain_serial == other.terrain_serial &&
+        topography_enabled == other.topography_enabled &&
+        topography_serial == other.topography_serial &&
+        rasp_map == other.rasp_map &&
+        rasp_serial == other.rasp_serial;
+    }
+  };
+
+  GroundLayerState ground_state;
+
+  /**
+   * The items on ground (terrain, RASP, topography and overlays).
+   * They are drawn again only if the projection or one of the
+   * #GroundLayerState attributes changes; all other frames copy
+   * this cache.
+   */
+  LayerCache ground_cache;
+
 protected:
   const MapLook &look;
 
@@ -338,28 +377,40 @@ protected:
   virtual void OnPaintBuffer(Canvas& canvas) override;
 
 private:
+  /**
+   * Renders the items on ground, or copies them from #ground_cache
+   * @param canvas The drawing canvas
+   */
+  void RenderGround(Canvas &canvas);
+
+  gcc_pure
+  GroundLayerState GetGroundLayerState() const;
+
   /**
    * Renders the terrain background
    * @param canvas The drawing canvas
+   * @param projection the projection of the #ground_cache
    */
-  void RenderTerrain(Canvas &canvas);
+  void RenderTerrain(Canvas &canvas, const WindowProjection &projection);
 
-  void RenderRasp(Canvas &canvas);
+  void UpdateRasp();
+  void RenderRasp(Canvas &canvas, const WindowProjection &projection);
 
   void RenderTerrainAbove(Canvas &canvas, bool working);
 
   /**
    * Renders the topography
    * @param canvas The drawing canvas
+   * @param projection the projection of the #ground_cache
    */
-  void RenderTopography(Canvas &canvas);
+  void RenderTopography(Canvas &canvas, const WindowProjection &projection);
   /**
    * Renders the topography labels
    * @param canvas The drawing canvas
    */
   void RenderTopographyLabels(Canvas &canvas);
 
-  void RenderOverlays(Canvas &canvas);
+  void RenderOverlays(Canvas &canvas, const WindowProjection &projection);
 
   /**
    * Renders the final glide shading
@@ -371,6 +422,11 @@ private:
    * @param canvas The drawing canvas
    */
   void RenderAirspace(Canvas &canvas);
+  /**
+   * Renders the airspace labels
+   * @param canvas The drawing canvas
+   */
+  void RenderAirspaceLabels(Canvas &canvas);
 
   /**
    * Renders the NOAA stations
@@ -27,6 +27,8 @@ Copyright_License {
 #include "Weather/Rasp/RaspRenderer.hpp"
 #include "Weather/Rasp/RaspCache.hpp"
 #include "Topography/CachedTopographyRenderer.hpp"
+#include "Topography/TopographyStore.hpp"
+#include "Terrain/RasterTerrain.hpp"
 #include "Renderer/AircraftRenderer.hpp"
 #include "Renderer/WaveRenderer.hpp"
 #include "Operation/Operation.hpp"
@@ -43,16 +45,74 @@ MapWindow::RenderTrackBearing(Canvas &canvas, const PixelPoint aircraft_pos)
   DrawTrackBearing(canvas, aircraft_pos, false);
 }
 
+MapWindow::GroundLayerState
+MapWindow::GetGroundLayerState() const
+{
+  GroundLayerState state;
+  state.terrain_settings = GetMapSettings().terrain;
+  state.shading_angle = background.GetShadingAngle();
+  if (terrain != nullptr) {
+    /* the serial is modified by the terrain loader thread while it
+       holds the lock */
+    RasterTerrain::Lease lease(*terrain);
+    state.terrain_serial = lease->GetSerial();
+  }
+
+  state.topography_enabled = topography_renderer != nullptr &&
+    GetMapSettings().topography_enabled;
+  state.topography_serial = topography != nullptr
+    ? topography->GetSerial()
+    : 0;
+
+  state.rasp_map = rasp_renderer ? GetUIState().weather.map : -1;
+  if (rasp_renderer)
+    state.rasp_serial = rasp_renderer->GetSerial();
+
+  return state;
+}
+
 void
-MapWindow::RenderTerrain(Canvas &canvas)
+MapWindow::RenderGround(Canvas &canvas)
 {
   background.SetShadingAngle(render_projection, GetMapSettings().terrain,
                              Calculated());
-  background.Draw(canvas, render_projection, GetMapSettings().terrain);
+  UpdateRasp();
+
+  const GroundLayerState state = GetGroundLayerState();
+  PixelPoint offset;
+  if (state == ground_state && ground_cache.Check(render_projection, offset)) {
+    ground_cache.CopyTo(canvas, offset);
+    return;
+  }
+
+  ground_state = state;
+
+  Canvas &buffer = ground_cache.Begin(canvas, render_projection);
+  const WindowProjection &projection = ground_cache.GetProjection();
+
+  draw_sw.Mark("RenderTerrain");
+  RenderTerrain(buffer, projection);
+
+  draw_sw.Mark("RenderRasp");
+  RenderRasp(buffer, projection);
+
+  draw_sw.Mark("RenderTopography");
+  RenderTopography(buffer, projection);
+
+  draw_sw.Mark("RenderOverlays");
+  RenderOverlays(buffer, projection);
+
+  ground_cache.Commit(canvas);
+}
+
+void
+MapWindow::RenderTerrain(Canvas &canvas, const WindowProjection &projection)
+{
+  background.Draw(canvas, projection, GetMapSettings().terrain);
 }
 
 inline void
-MapWindow::RenderRasp(Canvas &canvas)
+MapWindow::UpdateRasp()
 {
   if (rasp_store == nullptr)
     return;
@@ -82,17 +142,25 @@ MapWindow::RenderRasp(Canvas &canvas)
     QuietOperationEnvironment operation;
     rasp_renderer->Update(Calculated().date_time_local, operation);
   }
+}
+
+inline void
+MapWindow::RenderRasp(Canvas &canvas, const WindowProjection &projection)
+{
+  if (!rasp_renderer)
+    return;
 
   const auto &terrain_settings = GetMapSettings().terrain;
-  if (rasp_renderer->Generate(render_projection, terrain_settings))
-    rasp_renderer->Draw(canvas, render_projection);
+  if (rasp_renderer->Generate(projection, terrain_settings))
+    rasp_renderer->Draw(canvas, projection);
 }
 
 void
-MapWindow::RenderTopography(Canvas &canvas)
+MapWindow::RenderTopography(Canvas &canvas,
+                            const WindowProjection &projection)
 {
   if (topography_renderer != nullptr && GetMapSettings().topography_enabled)
-    topography_renderer->Draw(canvas, render_projection);
+    topography_renderer->Draw(canvas, projection);
 }
 
 void
@@ -103,11 +171,12 @@ MapWindow::RenderTopographyLabels(Canvas &canvas)
 }
 
 inline void
-MapWindow::RenderOverlays(Canvas &canvas)
+MapWindow::RenderOverlays(Canvas &canvas,
+                          gcc_unused const WindowProjection &projection)
 {
 #ifdef ENABLE_OPENGL
   if (overlay)
-    overlay->Draw(canvas, render_projection);
+    overlay->Draw(canvas, projection);
 #endif
 }
 
@@ -131,16 +200,21 @@ MapWindow::RenderAirspace(Canvas &canvas)
                            Basic(), Calculated(),
                            GetComputerSettings().airspace,
                            GetMapSettings().airspace);
+  }
+}
 
+void
+MapWindow::RenderAirspaceLabels(Canvas &canvas)
+{
+  if (GetMapSettings().airspace.enable)
     airspace_label_renderer.Draw(canvas,
 #ifndef ENABLE_OPENGL
                                  buffer_canvas,
 #endif
-                                 render_projection,
+                                 render_projection, label_block,
                                  Basic(), Calculated(),
                                  GetComputerSettings().airspace,
                                  GetMapSettings().airspace);
-  }
 }
 
 void
@@ -210,17 +284,8 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc)
   //////////////////////////////////////////////// items on ground
 
   // Render terrain, groundline and topography
-  draw_sw.Mark("RenderTerrain");
-  RenderTerrain(canvas);
-
-  draw_sw.Mark("RenderRasp");
-  RenderRasp(canvas);
-
-  draw_sw.Mark("RenderTopography");
-  RenderTopography(canvas);
-
-  draw_sw.Mark("RenderOverlays");
-  RenderOverlays(canvas);
+  draw_sw.Mark("RenderGround");
+  RenderGround(canvas);
 
   draw_sw.Mark("DrawNOAAStations");
   RenderNOAAStations(canvas);
@@ -259,6 +324,12 @@ MapWindow::Render(Canvas &canvas, const PixelRect &rc)
   DrawThermalEstimate(canvas);
 
   //////////////////////////////////////////////// text items
+  // Labels are placed in order of importance: the waypoint labels
+  // (DrawWaypoints() above) win over airspace labels, which win over
+  // topography labels
+  draw_sw.Mark("RenderAirspaceLabels");
+  RenderAirspaceLabels(canvas);
+
   // Render topography on top of airspace, to keep the text readable
   draw_sw.Mark("RenderTopographyLabels");
   RenderTopographyLabels(canvas);
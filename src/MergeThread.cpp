@@ -56,6 +56,21 @@ MergeThread::Process()
                          last_fix.flarm, basic);
 }
 
+void
+MergeThread::SaveLast()
+{
+  const MoreData &basic = device_blackboard.Basic();
+
+  /* update last_any in every iteration */
+  last_any = basic;
+
+  /* update last_fix only when a new GPS fix was received */
+  if ((basic.time_available &&
+       (!last_fix.time_available || basic.time != last_fix.time)) ||
+      basic.location_available != last_fix.location_available)
+    last_fix = basic;
+}
+
 void
 MergeThread::Tick()
 {
@@ -91,14 +106,7 @@ MergeThread::Tick()
     vario = vario_available ? basic.brutto_vario : 0;
 #endif
 
-    /* update last_any in every iteration */
-    last_any = basic;
-
-    /* update last_fix only when a new GPS fix was received */
-    if ((basic.time_available &&
-         (!last_fix.time_available || basic.time != last_fix.time)) ||
-        basic.location_available != last_fix.location_available)
-      last_fix = basic;
+    SaveLast();
   }
 
 #ifdef HAVE_PCM_PLAYER
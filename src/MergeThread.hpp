@@ -66,6 +66,18 @@ public:
     Process();
   }
 
+  /**
+   * Merge new data in the calling thread, without notifying anybody.
+   * This is used by #LockStepReplay instead of starting the thread.
+   * The caller must lock the #DeviceBlackboard.
+   */
+  void ProcessSynchronous() {
+    assert(!IsDefined());
+
+    Process();
+    SaveLast();
+  }
+
   bool Start(bool suspended=false) {
     if (!WorkerThread::Start(suspended))
       return false;
@@ -77,6 +89,11 @@ public:
 private:
   void Process();
 
+  /**
+   * Remember the merged data for the next Process() call.
+   */
+  void SaveLast();
+
 protected:
   virtual void Tick();
 };
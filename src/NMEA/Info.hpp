@@ -38,8 +38,6 @@ Copyright_License {
 #include "FLARM/Data.hpp"
 #include "Geo/SpeedVector.hpp"
 
-#include <type_traits>
-
 /**
  * A struct that holds all the parsed data read from the connected devices
  */
@@ -623,6 +621,4 @@ struct NMEAInfo {
   void Complement(const NMEAInfo &add);
 };
 
-static_assert(std::is_trivial<NMEAInfo>::value, "type is not trivial");
-
 #endif
@@ -26,8 +26,6 @@ Copyright_License {
 
 #include "NMEA/Info.hpp"
 
-#include <type_traits>
-
 /**
  * A wrapper for NMEA_INFO which adds a few attributes that are cheap
  * to calculate.  They are managed by #BasicComputer inside
@@ -66,6 +64,4 @@ struct MoreData : public NMEAInfo {
   }
 };
 
-static_assert(std::is_trivial<MoreData>::value, "type is not trivial");
-
 #endif
@@ -0,0 +1,207 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <new>
+
+#include <stdlib.h>
+
+/**
+ * The number of allocations of the current thread.  This is a plain
+ * integer (no atomic operation) because no other thread writes it.
+ */
+static thread_local uint64_t thread_count;
+
+static std::atomic<uint64_t> total_count;
+
+struct Slot {
+  std::atomic<const char *> name;
+  std::atomic<uint64_t> count, total, max;
+};
+
+static Slot slots[AllocationCounter::MAX_SECTIONS];
+
+static inline void
+CountAllocation() noexcept
+{
+  ++thread_count;
+  total_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void *
+operator new(size_t size)
+{
+  CountAllocation();
+
+  /* operator new must not return nullptr for zero-sized requests */
+  void *p = malloc(size > 0 ? size : 1);
+  if (p == nullptr)
+    throw std::bad_alloc();
+
+  return p;
+}
+
+void *
+operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void *
+operator new(size_t size, const std::nothrow_t &) noexcept
+{
+  CountAllocation();
+  return malloc(size > 0 ? size : 1);
+}
+
+void *
+operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+  CountAllocation();
+  return malloc(size > 0 ? size : 1);
+}
+
+void
+operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete[](void *p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void *p, size_t) noexcept
+{
+  free(p);
+}
+
+void
+operator delete[](void *p, size_t) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void *p, const std::nothrow_t &) noexcept
+{
+  free(p);
+}
+
+void
+operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+  free(p);
+}
+
+uint64_t
+AllocationCounter::GetThreadCount() noexcept
+{
+  return thread_count;
+}
+
+uint64_t
+AllocationCounter::GetTotalCount() noexcept
+{
+  return total_count.load(std::memory_order_relaxed);
+}
+
+/**
+ * Find the slot of the given code section, or claim a new one.
+ *
+ * @return nullptr if all slots are in use
+ */
+static Slot *
+FindSlot(const char *name) noexcept
+{
+  for (auto &slot : slots) {
+    const char *current = slot.name.load(std::memory_order_acquire);
+    if (current == nullptr &&
+        slot.name.compare_exchange_strong(current, name,
+                                          std::memory_order_acq_rel))
+      return &slot;
+
+    /* after a failed compare_exchange_strong(), "current" contains
+       the name which was claimed by another thread */
+    if (current == name)
+      return &slot;
+  }
+
+  return nullptr;
+}
+
+void
+AllocationCounter::Record(const char *name, uint64_t allocations) noexcept
+{
+  Slot *slot = FindSlot(name);
+  if (slot == nullptr)
+    return;
+
+  slot->count.fetch_add(1, std::memory_order_relaxed);
+  slot->total.fetch_add(allocations, std::memory_order_relaxed);
+
+  uint64_t max = slot->max.load(std::memory_order_relaxed);
+  while (allocations > max &&
+         !slot->max.compare_exchange_weak(max, allocations,
+                                          std::memory_order_relaxed)) {}
+}
+
+unsigned
+AllocationCounter::Summarise(Statistics *dest, unsigned max) noexcept
+{
+  unsigned n = 0;
+  for (const auto &slot : slots) {
+    if (n >= max)
+      break;
+
+    const char *name = slot.name.load(std::memory_order_acquire);
+    if (name == nullptr)
+      break;
+
+    Statistics &s = dest[n++];
+    s.name = name;
+    s.count = slot.count.load(std::memory_order_relaxed);
+    s.total = slot.total.load(std::memory_order_relaxed);
+    s.max = slot.max.load(std::memory_order_relaxed);
+  }
+
+  return n;
+}
+
+void
+AllocationCounter::Clear() noexcept
+{
+  /* the names are kept, so concurrent Record() calls always find
+     their slot */
+  for (auto &slot : slots) {
+    slot.count.store(0, std::memory_order_relaxed);
+    slot.total.store(0, std::memory_order_relaxed);
+    slot.max.store(0, std::memory_order_relaxed);
+  }
+}
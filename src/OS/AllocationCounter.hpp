@@ -0,0 +1,133 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_OS_ALLOCATION_COUNTER_HPP
+#define XCSOAR_OS_ALLOCATION_COUNTER_HPP
+
+#include "Compiler.h"
+
+#include <stdint.h>
+
+/**
+ * Counts heap allocations, i.e. calls to the global operator new.
+ * The counting operator new replaces the standard one in every
+ * program which links AllocationCounter.cpp: the benchmarks, and
+ * XCSoar itself only with "make ALLOCATION_COUNTER=y" (which defines
+ * ENABLE_ALLOCATION_COUNTER).
+ *
+ * With ENABLE_ALLOCATION_COUNTER, #ScopeAllocationCounter and the
+ * #Profiler markers attribute the allocations of the calling thread
+ * to named code sections.
+ */
+namespace AllocationCounter {
+
+/**
+ * The maximum number of code sections.  Allocations in additional
+ * sections are not attributed.
+ */
+static constexpr unsigned MAX_SECTIONS = 64;
+
+/**
+ * Summary of all executions of one code section.
+ */
+struct Statistics {
+  const char *name;
+
+  /**
+   * The number of times the section has been executed.
+   */
+  uint64_t count;
+
+  uint64_t total, max;
+};
+
+/**
+ * Returns the number of allocations by the calling thread so far.
+ */
+gcc_pure
+uint64_t
+GetThreadCount() noexcept;
+
+/**
+ * Returns the number of allocations by all threads so far.
+ */
+gcc_pure
+uint64_t
+GetTotalCount() noexcept;
+
+/**
+ * Add one execution of a code section.  This may be called from any
+ * thread.
+ *
+ * @param name the name of the code section; this must be a string
+ * literal (or otherwise live forever)
+ */
+void
+Record(const char *name, uint64_t allocations) noexcept;
+
+/**
+ * Copy the statistics of all code sections, in the order of their
+ * first appearance.
+ *
+ * @return the number of code sections copied to #dest
+ */
+unsigned
+Summarise(Statistics *dest, unsigned max) noexcept;
+
+/**
+ * Reset the statistics of all code sections.
+ */
+void
+Clear() noexcept;
+
+}
+
+/**
+ * Counts the allocations of the calling thread from construction to
+ * destruction, and records them with AllocationCounter::Record().
+ * This is a no-op unless ENABLE_ALLOCATION_COUNTER is defined.
+ */
+class ScopeAllocationCounter {
+#ifdef ENABLE_ALLOCATION_COUNTER
+  const char *const name;
+  const uint64_t start;
+
+public:
+  explicit ScopeAllocationCounter(const char *_name)
+    :name(_name), start(AllocationCounter::GetThreadCount()) {}
+
+  ~ScopeAllocationCounter() {
+    AllocationCounter::Record(name,
+                              AllocationCounter::GetThreadCount() - start);
+  }
+#else
+public:
+  explicit ScopeAllocationCounter(gcc_unused const char *_name) {}
+#endif
+
+  ScopeAllocationCounter(const ScopeAllocationCounter &) = delete;
+  ScopeAllocationCounter &operator=(const ScopeAllocationCounter &) = delete;
+};
+
+#endif
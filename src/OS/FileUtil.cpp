@@ -69,6 +69,26 @@ Directory::Exists(Path path)
 #endif
 }
 
+uint64_t
+Directory::GetLastModification(Path path)
+{
+#ifdef HAVE_POSIX
+  struct stat st;
+  if (stat(path.c_str(), &st) < 0 || !S_ISDIR(st.st_mode))
+    return 0;
+
+  return st.st_mtime;
+#else
+  WIN32_FILE_ATTRIBUTE_DATA data;
+  if (!GetFileAttributesEx(path.c_str(), GetFileExInfoStandard, &data) ||
+      (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+    return 0;
+
+  return data.ftLastWriteTime.dwLowDateTime |
+         ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32);
+#endif
+}
+
 /**
  * Checks whether the given string str equals "." or ".."
  * @param str The string to check
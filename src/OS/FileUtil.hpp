@@ -70,6 +70,16 @@ namespace Directory
    */
   void Create(Path path);
 
+  /**
+   * Get a timestamp of the last modification of the directory (i.e.
+   * the last time an entry was created, deleted or renamed) that can
+   * be compared with File::GetLastModification()
+   * @param path Path to the folder
+   * @return 0 in case of failure or a timestamp for comparison
+   */
+  gcc_pure
+  uint64_t GetLastModification(Path path);
+
   /**
    * Visit all the files of a specific directory with the given visitor
    * @param path Path to visit
@@ -0,0 +1,279 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Profiler.hpp"
+#include "Clock.hpp"
+
+#include <atomic>
+
+#include <assert.h>
+
+static_assert((Profiler::CAPACITY & (Profiler::CAPACITY - 1)) == 0,
+              "CAPACITY must be a power of two");
+
+namespace {
+
+/**
+ * One entry of the ring buffer.  The fields are protected by a
+ * sequence lock: the writer stores an odd #sequence while it is
+ * writing and an even one when it is done, and the reader discards
+ * the entry if #sequence has changed meanwhile.  All fields are
+ * atomic to avoid data races; they are accessed with relaxed memory
+ * order.
+ */
+struct Slot {
+  /**
+   * 0 = empty; 2*n+1 = sample n is being written; 2*n+2 = sample n
+   * is complete.
+   */
+  std::atomic<uint32_t> sequence;
+
+  std::atomic<const char *> name;
+  std::atomic<uint64_t> start_us;
+  std::atomic<uint32_t> duration_us;
+  std::atomic<uint8_t> track;
+};
+
+}
+
+static Slot ring[Profiler::CAPACITY];
+
+/**
+ * The number of samples which have been recorded so far.
+ */
+static std::atomic<uint32_t> head;
+
+/**
+ * The value of #head when Clear() was called last.
+ */
+static std::atomic<uint32_t> tail;
+
+static std::atomic<bool> enabled;
+
+const char *
+Profiler::GetTrackName(Track track)
+{
+  switch (track) {
+  case Track::DRAW:
+    return "Draw";
+
+  case Track::CALCULATION:
+    return "Calculation";
+
+  case Track::TERRAIN:
+    return "Terrain";
+  }
+
+  gcc_unreachable();
+}
+
+bool
+Profiler::IsEnabled()
+{
+  return enabled.load(std::memory_order_relaxed);
+}
+
+void
+Profiler::SetEnabled(bool _enabled)
+{
+  enabled.store(_enabled, std::memory_order_relaxed);
+}
+
+void
+Profiler::Clear()
+{
+  tail.store(head.load(std::memory_order_relaxed),
+             std::memory_order_relaxed);
+}
+
+void
+Profiler::Record(Track track, const char *name,
+                 uint64_t start_us, uint64_t end_us)
+{
+  assert(name != nullptr);
+  assert(end_us >= start_us);
+
+  const uint32_t n = head.fetch_add(1, std::memory_order_relaxed);
+  Slot &slot = ring[n & (CAPACITY - 1)];
+
+  slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.start_us.store(start_us, std::memory_order_relaxed);
+  slot.duration_us.store(uint32_t(end_us - start_us),
+                         std::memory_order_relaxed);
+  slot.track.store(uint8_t(track), std::memory_order_relaxed);
+
+  slot.sequence.store(2 * n + 2, std::memory_order_release);
+}
+
+/**
+ * Read sample number #n from the ring buffer.
+ *
+ * @return false if the sample has been overwritten or is still being
+ * written
+ */
+static bool
+ReadSample(uint32_t n, Profiler::Sample &sample)
+{
+  const Slot &slot = ring[n & (Profiler::CAPACITY - 1)];
+
+  const uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+  if (sequence != 2 * n + 2)
+    return false;
+
+  sample.name = slot.name.load(std::memory_order_relaxed);
+  sample.start_us = slot.start_us.load(std::memory_order_relaxed);
+  sample.duration_us = slot.duration_us.load(std::memory_order_relaxed);
+  sample.track = Profiler::Track(slot.track.load(std::memory_order_relaxed));
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+/**
+ * Determine the range of sample numbers which may be read.
+ */
+static void
+GetRange(uint32_t &begin, uint32_t &end, unsigned max)
+{
+  end = head.load(std::memory_order_acquire);
+  begin = tail.load(std::memory_order_relaxed);
+
+  uint32_t available = end - begin;
+  if (available > Profiler::CAPACITY)
+    available = Profiler::CAPACITY;
+  if (available > max)
+    available = max;
+  begin = end - available;
+}
+
+unsigned
+Profiler::Snapshot(Sample *dest, unsigned max)
+{
+  uint32_t begin, end;
+  GetRange(begin, end, max);
+
+  unsigned n = 0;
+  for (uint32_t i = begin; i != end; ++i)
+    if (ReadSample(i, dest[n]))
+      ++n;
+
+  return n;
+}
+
+unsigned
+Profiler::Summarise(Statistics *dest, unsigned max)
+{
+  uint32_t begin, end;
+  GetRange(begin, end, CAPACITY);
+
+  unsigned n = 0;
+  for (uint32_t i = begin; i != end; ++i) {
+    Sample sample;
+    if (!ReadSample(i, sample))
+      continue;
+
+    Statistics *s = dest;
+    Statistics *const s_end = dest + n;
+    while (s != s_end &&
+           (s->name != sample.name || s->track != sample.track))
+      ++s;
+
+    if (s == s_end) {
+      if (n == max)
+        continue;
+
+      ++n;
+      s->name = sample.name;
+      s->track = sample.track;
+      s->count = 0;
+      s->total_us = 0;
+      s->max_us = 0;
+    }
+
+    ++s->count;
+    s->total_us += sample.duration_us;
+    if (sample.duration_us > s->max_us)
+      s->max_us = sample.duration_us;
+    s->last_us = sample.duration_us;
+  }
+
+  return n;
+}
+
+ScopeProfiler::ScopeProfiler(Profiler::Track _track, const char *_name)
+  :track(_track), name(_name),
+   start_us(Profiler::IsEnabled() ? MonotonicClockUS() : 0),
+   allocation_counter(_name) {}
+
+ScopeProfiler::~ScopeProfiler()
+{
+  if (start_us != 0)
+    Profiler::Record(track, name, start_us, MonotonicClockUS());
+}
+
+void
+ProfilerMarks::Mark(const char *name)
+{
+#ifdef ENABLE_ALLOCATION_COUNTER
+  const uint64_t allocations = AllocationCounter::GetThreadCount();
+  if (allocation_section != nullptr)
+    AllocationCounter::Record(allocation_section,
+                              allocations - allocation_start);
+
+  allocation_section = name;
+  allocation_start = allocations;
+#endif
+
+  const bool enabled = Profiler::IsEnabled();
+  const uint64_t now_us = enabled || current != nullptr
+    ? MonotonicClockUS()
+    : 0;
+
+  if (current != nullptr)
+    Profiler::Record(track, current, start_us, now_us);
+
+  current = enabled ? name : nullptr;
+  start_us = now_us;
+}
+
+void
+ProfilerMarks::Finish()
+{
+#ifdef ENABLE_ALLOCATION_COUNTER
+  if (allocation_section != nullptr) {
+    AllocationCounter::Record(allocation_section,
+                              AllocationCounter::GetThreadCount() -
+                              allocation_start);
+    allocation_section = nullptr;
+  }
+#endif
+
+  if (current == nullptr)
+    return;
+
+  Profiler::Record(track, current, start_us, MonotonicClockUS());
+  current = nullptr;
+}
@@ -0,0 +1,207 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_OS_PROFILER_HPP
+#define XCSOAR_OS_PROFILER_HPP
+
+#include "AllocationCounter.hpp"
+#include "Compiler.h"
+
+#include <stdint.h>
+
+/**
+ * A lightweight profiler which is always compiled in.  Code sections
+ * are timed with #ScopeProfiler or #ProfilerMarks, and each
+ * measurement is stored in a fixed-size lock-free ring buffer, which
+ * can be read from any thread.  Recording is disabled by default;
+ * while disabled, the timers cost one atomic load.
+ */
+namespace Profiler {
+
+/**
+ * The subsystem which recorded a sample.  This is used to group
+ * samples in the overlay and as the "thread" in the Chrome trace.
+ */
+enum class Track : uint8_t {
+  DRAW,
+  CALCULATION,
+  TERRAIN,
+};
+
+static constexpr unsigned N_TRACKS = 3;
+
+/**
+ * The number of samples kept in the ring buffer.  Older samples are
+ * overwritten.  Must be a power of two.
+ */
+static constexpr unsigned CAPACITY = 4096;
+
+struct Sample {
+  /**
+   * The name of the code section.  This must be a string literal (or
+   * otherwise live forever).
+   */
+  const char *name;
+
+  /**
+   * The start time [MonotonicClockUS()].
+   */
+  uint64_t start_us;
+
+  uint32_t duration_us;
+
+  Track track;
+};
+
+/**
+ * Summary of all samples of one code section.
+ */
+struct Statistics {
+  const char *name;
+  Track track;
+
+  unsigned count;
+
+  uint64_t total_us;
+  uint32_t max_us, last_us;
+
+  uint32_t GetAverage() const {
+    return uint32_t(total_us / count);
+  }
+};
+
+gcc_const
+const char *
+GetTrackName(Track track);
+
+gcc_pure
+bool
+IsEnabled();
+
+void
+SetEnabled(bool enabled);
+
+/**
+ * Discard all samples.
+ */
+void
+Clear();
+
+/**
+ * Store one sample.  This may be called from any thread, even if
+ * the profiler is disabled.
+ */
+void
+Record(Track track, const char *name, uint64_t start_us, uint64_t end_us);
+
+/**
+ * Copy the most recent samples, oldest first.  Samples which are
+ * being overwritten concurrently are skipped.
+ *
+ * @return the number of samples copied to #dest
+ */
+unsigned
+Snapshot(Sample *dest, unsigned max);
+
+/**
+ * Summarise the samples in the ring buffer by code section, in the
+ * order of their first appearance.
+ *
+ * @return the number of code sections copied to #dest
+ */
+unsigned
+Summarise(Statistics *dest, unsigned max);
+
+}
+
+/**
+ * Measures the time from construction to destruction.  With
+ * ENABLE_ALLOCATION_COUNTER, the heap allocations are counted, too
+ * (see #ScopeAllocationCounter).
+ */
+class ScopeProfiler {
+  const Profiler::Track track;
+  const char *const name;
+
+  /**
+   * The start time, or 0 if the profiler was disabled at
+   * construction.
+   */
+  const uint64_t start_us;
+
+  const ScopeAllocationCounter allocation_counter;
+
+public:
+  ScopeProfiler(Profiler::Track _track, const char *_name);
+
+  ~ScopeProfiler();
+
+  ScopeProfiler(const ScopeProfiler &) = delete;
+  ScopeProfiler &operator=(const ScopeProfiler &) = delete;
+};
+
+/**
+ * Measures a sequence of code sections: each Mark() call ends the
+ * previous section and begins a new one.  This is convenient for
+ * long functions with many steps.  With ENABLE_ALLOCATION_COUNTER,
+ * the heap allocations of each section are counted, too.
+ */
+class ProfilerMarks {
+  const Profiler::Track track;
+
+  /**
+   * The section which is currently being measured, or nullptr.
+   */
+  const char *current = nullptr;
+
+  uint64_t start_us;
+
+#ifdef ENABLE_ALLOCATION_COUNTER
+  /**
+   * The section whose allocations are being counted, or nullptr.
+   * Unlike #current, this does not depend on Profiler::IsEnabled().
+   */
+  const char *allocation_section = nullptr;
+
+  uint64_t allocation_start;
+#endif
+
+public:
+  explicit ProfilerMarks(Profiler::Track _track):track(_track) {}
+
+  ~ProfilerMarks() {
+    Finish();
+  }
+
+  ProfilerMarks(const ProfilerMarks &) = delete;
+  ProfilerMarks &operator=(const ProfilerMarks &) = delete;
+
+  void Mark(const char *name);
+
+  /**
+   * End the current section.
+   */
+  void Finish();
+};
+
+#endif
@@ -0,0 +1,130 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ProfilerGlue.hpp"
+#include "OS/Profiler.hpp"
+#include "OS/AllocationCounter.hpp"
+#include "OS/Path.hpp"
+#include "IO/FileOutputStream.hxx"
+#include "IO/BufferedOutputStream.hxx"
+#include "LocalPath.hpp"
+#include "LogFile.hpp"
+
+#include <memory>
+
+/**
+ * Invoke the function for each sample in the ring buffer, oldest
+ * first.
+ */
+template<typename F>
+static void
+VisitSamples(F &&f)
+{
+  std::unique_ptr<Profiler::Sample[]>
+    samples(new Profiler::Sample[Profiler::CAPACITY]);
+
+  const unsigned n = Profiler::Snapshot(samples.get(), Profiler::CAPACITY);
+  for (unsigned i = 0; i < n; ++i)
+    f(samples[i]);
+}
+
+void
+WriteProfilerCSV(BufferedOutputStream &os)
+{
+  os.Write("track,name,start_us,duration_us\n");
+
+  VisitSamples([&os](const Profiler::Sample &sample){
+      os.Format("%s,%s,%llu,%u\n",
+                Profiler::GetTrackName(sample.track), sample.name,
+                (unsigned long long)sample.start_us,
+                (unsigned)sample.duration_us);
+    });
+}
+
+void
+WriteProfilerChromeTrace(BufferedOutputStream &os)
+{
+  os.Write("{\"traceEvents\":[\n"
+           "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+           "\"args\":{\"name\":\"XCSoar\"}}");
+
+  /* name the "threads" */
+  for (unsigned i = 0; i < Profiler::N_TRACKS; ++i)
+    os.Format(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+              "\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+              i, Profiler::GetTrackName(Profiler::Track(i)));
+
+  /* the section names are string literals which don't need
+     escaping */
+  VisitSamples([&os](const Profiler::Sample &sample){
+      os.Format(",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                "\"ts\":%llu,\"dur\":%u,\"pid\":1,\"tid\":%u}",
+                sample.name, Profiler::GetTrackName(sample.track),
+                (unsigned long long)sample.start_us,
+                (unsigned)sample.duration_us,
+                (unsigned)sample.track);
+    });
+
+  os.Write("\n]}\n");
+}
+
+AllocatedPath
+DumpProfiler(bool chrome_trace)
+{
+  auto path = LocalPath(chrome_trace
+                        ? _T("xcsoar-profile.json")
+                        : _T("xcsoar-profile.csv"));
+
+  FileOutputStream file(path);
+  BufferedOutputStream os(file);
+
+  if (chrome_trace)
+    WriteProfilerChromeTrace(os);
+  else
+    WriteProfilerCSV(os);
+
+  os.Flush();
+  file.Commit();
+  return path;
+}
+
+void
+LogAllocationStatistics()
+{
+#ifdef ENABLE_ALLOCATION_COUNTER
+  AllocationCounter::Statistics statistics[AllocationCounter::MAX_SECTIONS];
+  const unsigned n =
+    AllocationCounter::Summarise(statistics,
+                                 AllocationCounter::MAX_SECTIONS);
+
+  LogFormat("Allocations: %llu",
+            (unsigned long long)AllocationCounter::GetTotalCount());
+
+  for (unsigned i = 0; i < n; ++i) {
+    const auto &s = statistics[i];
+    LogFormat("Allocations '%s': count=%llu total=%llu max=%llu",
+              s.name, (unsigned long long)s.count,
+              (unsigned long long)s.total, (unsigned long long)s.max);
+  }
+#endif
+}
@@ -0,0 +1,63 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_PROFILER_GLUE_HPP
+#define XCSOAR_PROFILER_GLUE_HPP
+
+class BufferedOutputStream;
+class AllocatedPath;
+
+/**
+ * Write all samples of the #Profiler as CSV, one line per sample.
+ */
+void
+WriteProfilerCSV(BufferedOutputStream &os);
+
+/**
+ * Write all samples of the #Profiler in the Chrome trace event
+ * format, which can be viewed with chrome://tracing.  Each
+ * Profiler::Track becomes one "thread".
+ */
+void
+WriteProfilerChromeTrace(BufferedOutputStream &os);
+
+/**
+ * Write all samples of the #Profiler to a file in the data directory.
+ *
+ * Throws std::runtime_error on error.
+ *
+ * @param chrome_trace write a Chrome trace (JSON) instead of CSV
+ * @return the path of the new file
+ */
+AllocatedPath
+DumpProfiler(bool chrome_trace);
+
+/**
+ * Write the #AllocationCounter statistics of all code sections to
+ * the log file.  This is a no-op unless ENABLE_ALLOCATION_COUNTER is
+ * defined.
+ */
+void
+LogAllocationStatistics();
+
+#endif
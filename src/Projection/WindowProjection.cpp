@@ -49,6 +49,19 @@ WindowProjection::ScreenVisible(const PixelPoint &P) const
     P.y >= 0 && (unsigned)P.y < screen_size.y;
 }
 
+void
+WindowProjection::AddScreenMargin(unsigned margin)
+{
+  assert(screen_size_initialised);
+
+  screen_size.x += 2 * margin;
+  screen_size.y += 2 * margin;
+  screen_margin += margin;
+
+  SetScreenOrigin(GetScreenOrigin().x + margin,
+                  GetScreenOrigin().y + margin);
+}
+
 void
 WindowProjection::SetScaleFromRadius(double radius)
 {
@@ -42,6 +42,12 @@ class WindowProjection:
 
   UnsignedPoint2D screen_size;
 
+  /**
+   * The number of pixels added to each side by AddScreenMargin().
+   * They do not count for GetMapScale().
+   */
+  unsigned screen_margin = 0;
+
   /**
    * Geographical representation of the screen boundaries.
    *
@@ -86,6 +92,7 @@ public:
 
     screen_size.x = new_size.cx;
     screen_size.y = new_size.cy;
+    screen_margin = 0;
 
 #ifndef NDEBUG
     screen_size_initialised = true;
@@ -96,6 +103,18 @@ public:
     SetScreenSize(rc.GetSize());
   }
 
+  /**
+   * Extend the screen by the given number of pixels on each side.
+   * The screen origin moves along, so the map keeps its position
+   * relative to the original screen area, and GetMapScale() does not
+   * change.  Call UpdateScreenBounds() afterwards.
+   */
+  void AddScreenMargin(unsigned margin);
+
+  unsigned GetScreenMargin() const {
+    return screen_margin;
+  }
+
   gcc_pure
   double GetMapScale() const;
 
@@ -180,7 +199,7 @@ public:
 protected:
   gcc_pure
   int GetMapResolutionFactor() const {
-    return GetMinScreenDistance() / 8;
+    return (GetMinScreenDistance() - 2 * screen_margin) / 8;
   }
 };
 
@@ -24,6 +24,7 @@ Copyright_License {
 #include "AirspaceLabelList.hpp"
 #include "AirspaceLabelRenderer.hpp"
 #include "AirspaceRendererSettings.hpp"
+#include "LabelBlock.hpp"
 #include "Projection/WindowProjection.hpp"
 #include "Look/AirspaceLook.hpp"
 #include "Airspace/Airspaces.hpp"
@@ -62,6 +63,7 @@ AirspaceLabelRenderer::Draw(Canvas &canvas,
                             Canvas &stencil_canvas,
 #endif
                             const WindowProjection &projection,
+                            LabelBlock &label_block,
                             const MoreData &basic, const DerivedInfo &calculated,
                             const AirspaceComputerSettings &computer_settings,
                             const AirspaceRendererSettings &settings)
@@ -81,7 +83,8 @@ AirspaceLabelRenderer::Draw(Canvas &canvas,
 #ifndef ENABLE_OPENGL
                stencil_canvas,
 #endif
-               projection, settings, awc, visible, computer_settings.warnings);
+               projection, label_block,
+               settings, awc, visible, computer_settings.warnings);
 }
 
 void
@@ -90,6 +93,7 @@ AirspaceLabelRenderer::DrawInternal(Canvas &canvas,
                                     Canvas &stencil_canvas,
 #endif
                                     const WindowProjection &projection,
+                                    LabelBlock &label_block,
                                     const AirspaceRendererSettings &settings,
                                     const AirspaceWarningCopy &awc,
                                     const AirspacePredicate &visible,
@@ -136,6 +140,10 @@ AirspaceLabelRenderer::DrawInternal(Canvas &canvas,
       rect.top = pos.y;
       rect.right = rect.left + labelWidth;
       rect.bottom = rect.top + labelHeight;
+
+      if (!label_block.check(rect))
+        continue;
+
       canvas.Rectangle(rect.left, rect.top, rect.right, rect.bottom);
 
 #ifdef USE_GDI
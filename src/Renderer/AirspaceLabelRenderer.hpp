@@ -43,6 +43,7 @@ class ProtectedAirspaceWarningManager;
 class AirspaceWarningCopy;
 class Canvas;
 class WindowProjection;
+class LabelBlock;
 
 class AirspaceLabelRenderer
 {
@@ -95,6 +96,7 @@ private:
                     Canvas &stencil_canvas,
 #endif
                     const WindowProjection &projection,
+                    LabelBlock &label_block,
                     const AirspaceRendererSettings &settings,
                     const AirspaceWarningCopy &awc,
                     const AirspacePredicate &visible,
@@ -102,13 +104,16 @@ private:
 
 public:
    /**
-   * Draw labels that are visible according to standard rules.
+   * Draw labels that are visible according to standard rules.  Labels
+   * which collide with one already registered in the #LabelBlock are
+   * skipped.
    */
   void Draw(Canvas &canvas,
 #ifndef ENABLE_OPENGL
             Canvas &stencil_canvas,
 #endif
             const WindowProjection &projection,
+            LabelBlock &label_block,
             const MoreData &basic, const DerivedInfo &calculated,
             const AirspaceComputerSettings &computer_settings,
             const AirspaceRendererSettings &settings);
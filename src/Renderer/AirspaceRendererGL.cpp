@@ -39,18 +39,25 @@ Copyright_License {
 class AirspaceVisitorRenderer final
   : protected MapCanvas
 {
+  const WindowProjection &window_projection;
   const AirspaceLook &look;
   const AirspaceWarningCopy &warning_manager;
   const AirspaceRendererSettings &settings;
+  AirspaceTriangleCache &triangle_cache;
+
+  Color fill_color;
 
 public:
   AirspaceVisitorRenderer(Canvas &_canvas, const WindowProjection &_projection,
                           const AirspaceLook &_look,
                           const AirspaceWarningCopy &_warnings,
-                          const AirspaceRendererSettings &_settings)
+                          const AirspaceRendererSettings &_settings,
+                          AirspaceTriangleCache &_triangle_cache)
     :MapCanvas(_canvas, _projection,
                _projection.GetScreenBounds().Scale(1.1)),
-     look(_look), warning_manager(_warnings), settings(_settings)
+     window_projection(_projection),
+     look(_look), warning_manager(_warnings), settings(_settings),
+     triangle_cache(_triangle_cache)
   {
     glStencilMask(0xff);
     glClear(GL_STENCIL_BUFFER_BIT);
@@ -127,7 +134,7 @@ private:
       {
         SetupInterior(airspace, !fill_airspace);
         const GLEnable<GL_BLEND> blend;
-        DrawPrepared();
+        DrawInterior(airspace);
       }
 
       if (!fill_airspace) {
@@ -189,10 +196,20 @@ private:
       glStencilFunc(GL_EQUAL, 0, 2);
     glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
-    canvas.Select(Brush(class_look.fill_color.WithAlpha(90)));
+    fill_color = class_look.fill_color.WithAlpha(90);
+    canvas.Select(Brush(fill_color));
     canvas.SelectNullPen();
   }
 
+  /**
+   * Fill the prepared polygon with the brush selected by
+   * SetupInterior(), preferably with the cached triangles.
+   */
+  void DrawInterior(const AbstractAirspace &airspace) {
+    if (!triangle_cache.Fill(airspace, window_projection, fill_color))
+      DrawPrepared();
+  }
+
   void SetFillStencil() {
     glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
     glStencilFunc(GL_ALWAYS, 3, 3);
@@ -217,18 +234,25 @@ private:
 class AirspaceFillRenderer final
   : protected MapCanvas
 {
+  const WindowProjection &window_projection;
   const AirspaceLook &look;
   const AirspaceWarningCopy &warning_manager;
   const AirspaceRendererSettings &settings;
+  AirspaceTriangleCache &triangle_cache;
+
+  Color fill_color;
 
 public:
   AirspaceFillRenderer(Canvas &_canvas, const WindowProjection &_projection,
                        const AirspaceLook &_look,
                        const AirspaceWarningCopy &_warnings,
-                       const AirspaceRendererSettings &_settings)
+                       const AirspaceRendererSettings &_settings,
+                       AirspaceTriangleCache &_triangle_cache)
     :MapCanvas(_canvas, _projection,
                _projection.GetScreenBounds().Scale(1.1)),
-     look(_look), warning_manager(_warnings), settings(_settings)
+     window_projection(_projection),
+     look(_look), warning_manager(_warnings), settings(_settings),
+     triangle_cache(_triangle_cache)
   {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   }
@@ -255,7 +279,8 @@ private:
     if (!warning_manager.IsAcked(airspace) && SetupInterior(airspace)) {
       // fill interior without overpainting any previous outlines
       GLEnable<GL_BLEND> blend;
-      DrawPrepared();
+      if (!triangle_cache.Fill(airspace, window_projection, fill_color))
+        DrawPrepared();
     }
 
     // draw outline
@@ -299,7 +324,8 @@ private:
 
     const AirspaceClassLook &class_look = look.classes[airspace.GetType()];
 
-    canvas.Select(Brush(class_look.fill_color.WithAlpha(48)));
+    fill_color = class_look.fill_color.WithAlpha(48);
+    canvas.Select(Brush(fill_color));
     canvas.SelectNullPen();
 
     return true;
@@ -313,20 +339,24 @@ AirspaceRenderer::DrawInternal(Canvas &canvas,
                                const AirspaceWarningCopy &awc,
                                const AirspacePredicate &visible)
 {
+  triangle_cache.Update(*airspaces);
+
   const auto range =
     airspaces->QueryWithinRange(projection.GetGeoScreenCenter(),
                                 projection.GetScreenDistanceMeters());
 
   if (settings.fill_mode == AirspaceRendererSettings::FillMode::ALL ||
       settings.fill_mode == AirspaceRendererSettings::FillMode::NONE) {
-    AirspaceFillRenderer renderer(canvas, projection, look, awc, settings);
+    AirspaceFillRenderer renderer(canvas, projection, look, awc, settings,
+                                  triangle_cache);
     for (const auto &i : range) {
       const AbstractAirspace &airspace = i.GetAirspace();
       if (visible(airspace))
         renderer.Visit(airspace);
     }
   } else {
-    AirspaceVisitorRenderer renderer(canvas, projection, look, awc, settings);
+    AirspaceVisitorRenderer renderer(canvas, projection, look, awc, settings,
+                                     triangle_cache);
     for (const auto &i : range) {
       const AbstractAirspace &airspace = i.GetAirspace();
       if (visible(airspace))
@@ -0,0 +1,203 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifdef ENABLE_OPENGL
+
+#include "AirspaceTriangleCache.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Airspace/Airspaces.hpp"
+#include "Airspace/AirspacePolygon.hpp"
+#include "Screen/Color.hpp"
+#include "Screen/OpenGL/FallbackBuffer.hpp"
+#include "Screen/OpenGL/VertexPointer.hpp"
+#include "Screen/OpenGL/Triangulate.hpp"
+#include "Screen/OpenGL/Geo.hpp"
+#include "Math/Point2D.hpp"
+
+#ifdef USE_GLSL
+#include "Screen/OpenGL/Program.hpp"
+#include "Screen/OpenGL/Shaders.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+#endif
+
+#include <vector>
+
+AirspaceTriangleCache::AirspaceTriangleCache()
+  :airspaces(nullptr), vertex_buffer(nullptr), index_buffer(nullptr)
+{
+  AddSurfaceListener(*this);
+}
+
+AirspaceTriangleCache::~AirspaceTriangleCache()
+{
+  RemoveSurfaceListener(*this);
+
+  Clear();
+}
+
+void
+AirspaceTriangleCache::Clear()
+{
+  delete vertex_buffer;
+  vertex_buffer = nullptr;
+
+  delete index_buffer;
+  index_buffer = nullptr;
+
+  items.clear();
+  airspaces = nullptr;
+}
+
+void
+AirspaceTriangleCache::Update(const Airspaces &_airspaces)
+{
+  if (&_airspaces == airspaces && _airspaces.GetSerial() == serial)
+    /* cache is clean */
+    return;
+
+  Clear();
+
+  airspaces = &_airspaces;
+  serial = _airspaces.GetSerial();
+
+  const auto &projection = _airspaces.GetProjection();
+  if (!projection.IsValid())
+    return;
+
+  reference = projection.GetCenter();
+
+  std::vector<FloatPoint2D> vertices;
+  std::vector<GLushort> indices, triangles;
+
+  for (const auto &i : _airspaces.QueryAll()) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+    if (airspace.GetShape() != AbstractAirspace::Shape::POLYGON)
+      continue;
+
+    const SearchPointVector &points =
+      ((const AirspacePolygon &)airspace).GetPoints();
+    const unsigned n = points.size();
+    if (n < 3 || n >= 0x10000)
+      continue;
+
+    const unsigned vertex_offset = vertices.size();
+    for (const auto &p : points) {
+      const GeoPoint delta = p.GetLocation() - reference;
+      vertices.emplace_back(GLfloat(delta.longitude.Native()),
+                            GLfloat(delta.latitude.Native()));
+    }
+
+    /* no thinning: the triangles are reused at all zoom levels */
+    triangles.resize(3 * (n - 2));
+    const unsigned count = PolygonToTriangles(vertices.data() + vertex_offset,
+                                              n, triangles.data(), 0);
+    if (count == 0) {
+      /* triangulation failed; leave this one to Canvas::DrawPolygon() */
+      vertices.resize(vertex_offset);
+      continue;
+    }
+
+    Item &item = items[&airspace];
+    item.vertex_offset = vertex_offset;
+    item.index_offset = indices.size();
+    item.index_count = count;
+    indices.insert(indices.end(), triangles.begin(),
+                   triangles.begin() + count);
+  }
+
+  if (items.empty())
+    return;
+
+  vertex_buffer = new GLFallbackArrayBuffer();
+  size_t size = vertices.size() * sizeof(vertices.front());
+  FloatPoint2D *v = (FloatPoint2D *)vertex_buffer->BeginWrite(size);
+  std::copy(vertices.begin(), vertices.end(), v);
+  vertex_buffer->CommitWrite(size, v);
+
+  index_buffer = new GLFallbackElementArrayBuffer();
+  size = indices.size() * sizeof(indices.front());
+  GLushort *p = (GLushort *)index_buffer->BeginWrite(size);
+  std::copy(indices.begin(), indices.end(), p);
+  index_buffer->CommitWrite(size, p);
+}
+
+bool
+AirspaceTriangleCache::Fill(const AbstractAirspace &airspace,
+                            const WindowProjection &projection, Color color)
+{
+  const auto i = items.find(&airspace);
+  if (i == items.end())
+    return false;
+
+  const Item &item = i->second;
+
+#ifdef USE_GLSL
+  OpenGL::solid_shader->Use();
+  glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
+                     glm::value_ptr(ToGLM(projection, reference)));
+#else
+  glPushMatrix();
+  ApplyProjection(projection, reference);
+#endif
+
+  color.Bind();
+
+  const FloatPoint2D *const vertices = (const FloatPoint2D *)
+    vertex_buffer->BeginRead();
+  const GLushort *const indices = (const GLushort *)
+    index_buffer->BeginRead();
+
+  {
+    const ScopeVertexPointer vp(vertices + item.vertex_offset);
+    glDrawElements(GL_TRIANGLES, item.index_count, GL_UNSIGNED_SHORT,
+                   indices + item.index_offset);
+  }
+
+  index_buffer->EndRead();
+  vertex_buffer->EndRead();
+
+#ifdef USE_GLSL
+  glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
+                     glm::value_ptr(glm::mat4()));
+#else
+  glPopMatrix();
+#endif
+
+  return true;
+}
+
+void
+AirspaceTriangleCache::SurfaceCreated()
+{
+}
+
+void
+AirspaceTriangleCache::SurfaceDestroyed()
+{
+  /* the buffer objects are gone; rebuild everything on the next
+     Update() call */
+  Clear();
+}
+
+#endif /* ENABLE_OPENGL */
@@ -0,0 +1,98 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_AIRSPACE_TRIANGLE_CACHE_HPP
+#define XCSOAR_AIRSPACE_TRIANGLE_CACHE_HPP
+
+#include "Screen/OpenGL/Surface.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Util/Serial.hpp"
+
+#include <unordered_map>
+
+class Airspaces;
+class AbstractAirspace;
+class WindowProjection;
+class GLFallbackArrayBuffer;
+class GLFallbackElementArrayBuffer;
+class Color;
+
+/**
+ * Caches the triangulated interior of all polygon airspaces in
+ * OpenGL buffer objects.  The vertices are stored as angles relative
+ * to a reference point (just like the topography) and are projected
+ * by the modelview matrix, so the triangulation is done only once
+ * per airspace database, and not each time the map is redrawn.
+ */
+class AirspaceTriangleCache final : GLSurfaceListener {
+  struct Item {
+    /** the first vertex of this airspace in #vertex_buffer */
+    unsigned vertex_offset;
+
+    unsigned index_offset, index_count;
+  };
+
+  /**
+   * The database and its Airspaces::GetSerial() value this cache was
+   * built for.
+   */
+  const Airspaces *airspaces;
+  Serial serial;
+
+  GeoPoint reference;
+
+  GLFallbackArrayBuffer *vertex_buffer;
+  GLFallbackElementArrayBuffer *index_buffer;
+
+  std::unordered_map<const AbstractAirspace *, Item> items;
+
+public:
+  AirspaceTriangleCache();
+  ~AirspaceTriangleCache();
+
+  AirspaceTriangleCache(const AirspaceTriangleCache &) = delete;
+
+  /**
+   * Triangulate all airspaces again if the database has been
+   * modified since the last call.
+   */
+  void Update(const Airspaces &airspaces);
+
+  /**
+   * Fill the interior of the specified airspace with a solid color.
+   *
+   * @return false if the airspace is not in the cache; the caller
+   * should then draw it with Canvas::DrawPolygon()
+   */
+  bool Fill(const AbstractAirspace &airspace,
+            const WindowProjection &projection, Color color);
+
+private:
+  void Clear();
+
+  /* virtual methods from class GLSurfaceListener */
+  void SurfaceCreated() override;
+  void SurfaceDestroyed() override;
+};
+
+#endif
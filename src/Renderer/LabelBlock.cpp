@@ -23,45 +23,54 @@ Copyright_License {
 
 #include "LabelBlock.hpp"
 
+#include <algorithm>
+
 void
-LabelBlock::Bucket::Clear()
+LabelBlock::reset()
 {
   blocks.clear();
+  nodes.clear();
+  std::fill_n(&heads[0][0], GRID_WIDTH * GRID_HEIGHT, unsigned(NO_NODE));
 }
 
 bool
-LabelBlock::Bucket::Check(const PixelRect rc) const
+LabelBlock::Check(const PixelRect rc, const CellRange cells) const
 {
-  for (auto i = blocks.begin(), end = blocks.end(); i != end; ++i)
-    if (i->OverlapsWith(rc))
-      return false;
+  for (unsigned y = cells.top; y <= cells.bottom; ++y) {
+    for (unsigned x = cells.left; x <= cells.right; ++x) {
+      for (unsigned i = heads[y][x]; i != NO_NODE; i = nodes[i].next) {
+        const Node &node = nodes[i];
+        if (blocks[node.block].OverlapsWith(rc))
+          return false;
+      }
+    }
+  }
 
   return true;
 }
 
-void LabelBlock::reset()
+void
+LabelBlock::Add(const PixelRect rc, const CellRange cells)
 {
-  for (unsigned i = 0; i < BUCKET_COUNT; ++i)
-    buckets[i].Clear();
+  const unsigned block = blocks.size();
+  blocks.push_back(rc);
+
+  for (unsigned y = cells.top; y <= cells.bottom; ++y) {
+    for (unsigned x = cells.left; x <= cells.right; ++x) {
+      unsigned &head = heads[y][x];
+      nodes.push_back({block, head});
+      head = nodes.size() - 1;
+    }
+  }
 }
 
-bool LabelBlock::check(const PixelRect rc)
+bool
+LabelBlock::check(const PixelRect rc)
 {
-  unsigned top = rc.top >> BUCKET_SHIFT;
-  unsigned bottom = rc.bottom >> BUCKET_SHIFT;
-
-  if (top >= BUCKET_COUNT)
-    top = BUCKET_COUNT - 1;
-
-  if (bottom < BUCKET_COUNT && !buckets[bottom].Check(rc))
-    return false;
-
-  if (top < bottom && !buckets[top].Check(rc))
+  const CellRange cells = ToCells(rc);
+  if (!Check(rc, cells))
     return false;
 
-  buckets[top].Add(rc);
-  if (bottom < BUCKET_COUNT && top != bottom)
-    buckets[bottom].Add(rc);
-
+  Add(rc, cells);
   return true;
 }
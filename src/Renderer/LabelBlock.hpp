@@ -25,51 +25,98 @@ Copyright_License {
 #define SCREEN_LABELBLOCK_HPP
 
 #include "Screen/Point.hpp"
-#include "Util/StaticArray.hxx"
 #include "Compiler.h"
 
+#include <vector>
+
 /**
  * Simple code to prevent text writing over map city names.
+ *
+ * The rectangles of all labels which were drawn are kept in a uniform
+ * grid of square cells.  A rectangle is linked into every cell it
+ * touches, so a collision test only needs to look at the few labels
+ * near the new one.  There is no limit on the number of labels.
+ *
+ * Labels are placed first come, first served; callers draw the most
+ * important labels first (see MapWindow::Render()).
  */
 class LabelBlock {
-#if defined(HAVE_GLES)
-  /* embedded (Android or Windows CE) */
-  static constexpr unsigned SCREEN_HEIGHT = 2048;
-  static constexpr unsigned BUCKET_SIZE = 64;
-#else
-  /* desktop, screen may be huge, lots of memory */
-  static constexpr unsigned SCREEN_HEIGHT = 4096;
-  static constexpr unsigned BUCKET_SIZE = 64;
-#endif
-  static constexpr unsigned BUCKET_SHIFT = 7;
-  static constexpr unsigned BUCKET_HEIGHT = 1 << BUCKET_SHIFT;
-  static constexpr unsigned BUCKET_COUNT = SCREEN_HEIGHT / BUCKET_HEIGHT;
+  static constexpr unsigned CELL_SHIFT = 6;
 
   /**
-   * A bucket is responsible for hit tests in one horizontal section
-   * of the screen.
+   * The grid dimensions in cells.  Rectangles outside of the grid are
+   * clamped to the border cells, which keeps the test correct for
+   * labels beyond the grid, only slower.
    */
-  class Bucket {
-    typedef StaticArray<PixelRect, BUCKET_SIZE> BlockArray;
-    BlockArray blocks;
+  static constexpr unsigned GRID_WIDTH = 64, GRID_HEIGHT = 64;
 
-  public:
-    void Clear();
+  static constexpr unsigned NO_NODE = unsigned(-1);
 
-    gcc_pure
-    bool Check(const PixelRect rc) const;
+  /**
+   * The rectangles of all labels which were accepted since the last
+   * reset().
+   */
+  std::vector<PixelRect> blocks;
 
-    void Add(const PixelRect rc) {
-      if (!blocks.full())
-        blocks.append(rc);
-    }
+  /**
+   * An element of a cell's singly linked list.
+   */
+  struct Node {
+    /** index into #blocks */
+    unsigned block;
+
+    /** index of the next node in #nodes or #NO_NODE */
+    unsigned next;
   };
 
-  Bucket buckets[BUCKET_COUNT];
+  std::vector<Node> nodes;
+
+  /**
+   * The index of the first #Node of each cell or #NO_NODE.
+   */
+  unsigned heads[GRID_HEIGHT][GRID_WIDTH];
+
+  struct CellRange {
+    unsigned left, top, right, bottom;
+  };
 
 public:
+  LabelBlock() {
+    reset();
+  }
+
+  /**
+   * Check whether the given rectangle overlaps any of the previous
+   * ones, and if not, reserve it.
+   *
+   * @return true if the label may be drawn
+   */
   bool check(const PixelRect rc);
+
   void reset();
+
+private:
+  gcc_const
+  static unsigned ToCell(int position, unsigned size) {
+    if (position < 0)
+      return 0;
+
+    unsigned cell = unsigned(position) >> CELL_SHIFT;
+    return cell < size ? cell : size - 1;
+  }
+
+  gcc_const
+  static CellRange ToCells(const PixelRect rc) {
+    return {
+      ToCell(rc.left, GRID_WIDTH), ToCell(rc.top, GRID_HEIGHT),
+      ToCell(rc.right, GRID_WIDTH), ToCell(rc.bottom, GRID_HEIGHT),
+    };
+  }
+
+  gcc_pure
+  bool Check(const PixelRect rc, const CellRange cells) const;
+
+  void Add(const PixelRect rc, const CellRange cells);
 };
 
 #endif
@@ -0,0 +1,148 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "LayerCache.hpp"
+
+#ifdef ENABLE_OPENGL
+#include "Screen/OpenGL/Globals.hpp"
+#include "Screen/OpenGL/System.hpp"
+#endif
+
+#include <algorithm>
+
+#include <math.h>
+#include <stdlib.h>
+
+bool
+LayerCache::Check(const WindowProjection &_projection,
+                  PixelPoint &offset_r) const
+{
+  assert(_projection.IsValid());
+
+  const unsigned margin = projection.GetScreenMargin();
+  if (!buffer.IsDefined() || !projection.IsValid() ||
+      buffer.GetWidth() != _projection.GetScreenWidth() + 2 * margin ||
+      buffer.GetHeight() != _projection.GetScreenHeight() + 2 * margin ||
+      projection.GetScale() != _projection.GetScale() ||
+      projection.GetScreenAngle() != _projection.GetScreenAngle())
+    return false;
+
+  /* how far has the reference location moved on the screen? */
+  const PixelPoint origin = projection.GetScreenOrigin() -
+    PixelPoint(margin, margin);
+  const PixelPoint shift =
+    _projection.GeoToScreen(projection.GetGeoLocation()) - origin;
+  if (unsigned(abs(shift.x)) > margin || unsigned(abs(shift.y)) > margin)
+    return false;
+
+  /* translating is exact only at the reference latitude; draw again
+     when the error may exceed half a pixel */
+  if ((abs(shift.x) + abs(shift.y)) * max_cosine_delta > 0.5)
+    return false;
+
+  offset_r = PixelPoint(int(margin) - shift.x, int(margin) - shift.y);
+  return true;
+}
+
+Canvas &
+LayerCache::Begin(Canvas &canvas, const WindowProjection &_projection)
+{
+  assert(canvas.IsDefined());
+  assert(_projection.IsValid());
+
+  projection = _projection;
+
+#ifdef ENABLE_OPENGL
+  /* without a frame buffer object, BufferCanvas draws to the screen
+     and the scissor box still applies; the buffer cannot be larger
+     than the screen then */
+  const bool fbo = OpenGL::frame_buffer_object &&
+    OpenGL::render_buffer_stencil;
+  if (fbo)
+    projection.AddScreenMargin(projection.GetMinScreenDistance() / 8);
+#else
+  projection.AddScreenMargin(projection.GetMinScreenDistance() / 8);
+#endif
+
+  projection.UpdateScreenBounds();
+
+  const double cosine = projection.GetGeoLocation().latitude.fastcosine();
+  const GeoBounds &bounds = projection.GetScreenBounds();
+  max_cosine_delta = std::max(fabs(bounds.GetNorth().fastcosine() - cosine),
+                              fabs(bounds.GetSouth().fastcosine() - cosine));
+
+  const PixelSize size(projection.GetScreenWidth(),
+                       projection.GetScreenHeight());
+
+#ifdef ENABLE_OPENGL
+  if (!buffer.IsDefined())
+    buffer.Create(size);
+  else
+    buffer.Resize(size);
+
+  scissor = fbo && glIsEnabled(GL_SCISSOR_TEST);
+  if (scissor)
+    glDisable(GL_SCISSOR_TEST);
+
+  buffer.Begin(canvas);
+#else
+  if (buffer.IsDefined())
+    buffer.Resize(size);
+  else
+    buffer.Create(canvas, size);
+#endif
+
+  return buffer;
+}
+
+void
+LayerCache::Commit(Canvas &canvas)
+{
+  assert(canvas.IsDefined());
+  assert(projection.IsValid());
+
+  const unsigned margin = projection.GetScreenMargin();
+  const PixelPoint offset(margin, margin);
+
+#ifdef ENABLE_OPENGL
+  if (scissor)
+    glEnable(GL_SCISSOR_TEST);
+
+  buffer.Commit(canvas, offset);
+#else
+  CopyTo(canvas, offset);
+#endif
+}
+
+void
+LayerCache::CopyTo(Canvas &canvas, PixelPoint offset)
+{
+  assert(buffer.IsDefined());
+
+#ifdef ENABLE_OPENGL
+  buffer.CopyTo(canvas, offset);
+#else
+  canvas.Copy(0, 0, canvas.GetWidth(), canvas.GetHeight(),
+              buffer, offset.x, offset.y);
+#endif
+}
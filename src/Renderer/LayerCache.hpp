@@ -0,0 +1,115 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_LAYER_CACHE_HPP
+#define XCSOAR_LAYER_CACHE_HPP
+
+#include "Projection/WindowProjection.hpp"
+#include "Screen/BufferCanvas.hpp"
+#include "Screen/Point.hpp"
+#include "Compiler.h"
+
+class Canvas;
+
+/**
+ * Caches a group of opaque map layers in an off-screen buffer (a
+ * frame buffer object on OpenGL).  As long as the scale, the rotation
+ * and the layers' inputs (which are checked by the caller) do not
+ * change, the buffer is copied to the screen instead of drawing the
+ * layers again.
+ *
+ * The buffer is larger than the screen by a margin on each side.
+ * When the map moves (e.g. following the aircraft), the visible part
+ * of the buffer is copied, until it leaves the margin.
+ */
+class LayerCache {
+  /**
+   * The projection which was used to draw #buffer, including the
+   * margin.  Invalid if the cache is empty.
+   */
+  WindowProjection projection;
+
+  /**
+   * The maximum difference between the cosine of the reference
+   * latitude and the cosine of a latitude within the buffer.  The
+   * longitude scale of Projection::GeoToScreen() depends on it,
+   * which makes translating an approximation.
+   */
+  double max_cosine_delta;
+
+  BufferCanvas buffer;
+
+#ifdef ENABLE_OPENGL
+  /**
+   * Was GL_SCISSOR_TEST disabled by Begin()?  The scissor box is in
+   * screen coordinates, which must not be applied to the frame
+   * buffer object.
+   */
+  bool scissor;
+#endif
+
+public:
+  void Invalidate() {
+    projection.SetGeoLocation(GeoPoint::Invalid());
+  }
+
+  /**
+   * Check if the cache can be used.
+   *
+   * @param offset_r on success, the position of the screen's top
+   * left corner within the buffer; pass it to CopyTo()
+   * @return true if the cache is valid for the given projection; the
+   * caller may skip to CopyTo()
+   */
+  gcc_pure
+  bool Check(const WindowProjection &projection, PixelPoint &offset_r) const;
+
+  /**
+   * Begin drawing to the cache.  Render to the returned Canvas with
+   * the projection returned by GetProjection().  Call Commit() when
+   * you're done.
+   */
+  Canvas &Begin(Canvas &canvas, const WindowProjection &projection);
+
+  /**
+   * The projection to be used for drawing between Begin() and
+   * Commit().  It includes the margin.
+   */
+  const WindowProjection &GetProjection() const {
+    return projection;
+  }
+
+  /**
+   * Finish drawing to the cache, and copy it to the given #Canvas.
+   */
+  void Commit(Canvas &canvas);
+
+  /**
+   * Copy the cache to the given #Canvas.
+   *
+   * @param offset the value returned by Check()
+   */
+  void CopyTo(Canvas &canvas, PixelPoint offset);
+};
+
+#endif
@@ -35,11 +35,19 @@ Copyright_License {
 
 #include <algorithm>
 
+#include <math.h>
+#include <stdlib.h>
+
 bool
 TrailRenderer::LoadTrace(const TraceComputer &trace_computer)
 {
   trace.clear();
   trace_computer.LockedCopyTo(trace);
+
+  /* the next filtered LoadTrace() call starts from scratch */
+  this->trace_computer = nullptr;
+  projected.clear();
+
   return !trace.empty();
 }
 
@@ -48,13 +56,69 @@ TrailRenderer::LoadTrace(const TraceComputer &trace_computer,
                          unsigned min_time,
                          const WindowProjection &projection)
 {
-  trace.clear();
-  trace_computer.LockedCopyTo(trace, min_time,
-                              projection.GetGeoScreenCenter(),
-                              projection.DistancePixelsToMeters(3));
+  const double resolution = projection.DistancePixelsToMeters(3);
+  if (&trace_computer != this->trace_computer ||
+      resolution != trace_resolution) {
+    /* different source or zoom level: start from scratch */
+    trace.clear();
+    this->trace_computer = &trace_computer;
+    trace_resolution = resolution;
+  }
+
+  if (trace_computer.LockedSyncTo(trace, min_time,
+                                  projection.GetGeoScreenCenter(),
+                                  resolution, trace_serial)) {
+    /* only new points were appended; remove the ones which have
+       become too old */
+    const auto first =
+      std::find_if(trace.begin(), trace.end(),
+                   [min_time](const TracePoint &p){
+                     return p.GetTime() >= min_time;
+                   });
+    const size_t n = std::distance(trace.begin(), first);
+    trace.erase(trace.begin(), first);
+    projected.erase(projected.begin(),
+                    projected.begin() + std::min(n, projected.size()));
+  } else
+    projected.clear();
+
   return !trace.empty();
 }
 
+void
+TrailRenderer::ProjectionKey::Set(const WindowProjection &_projection)
+{
+  projection = _projection;
+  bounds = _projection.GetScreenBounds().Scale(4);
+
+  const double cosine = _projection.GetGeoLocation().latitude.fastcosine();
+  max_cosine_delta = std::max(fabs(bounds.GetNorth().fastcosine() - cosine),
+                              fabs(bounds.GetSouth().fastcosine() - cosine));
+}
+
+bool
+TrailRenderer::ProjectionKey::GetOffset(const WindowProjection &_projection,
+                                        PixelPoint &offset_r) const
+{
+  if (!projection.IsValid() ||
+      projection.GetScale() != _projection.GetScale() ||
+      projection.GetScreenAngle() != _projection.GetScreenAngle() ||
+      !bounds.IsInside(_projection.GetScreenBounds()))
+    return false;
+
+  const PixelPoint offset =
+    _projection.GeoToScreen(projection.GetGeoLocation()) -
+    projection.GetScreenOrigin();
+
+  /* translating is exact only at the reference latitude; start over
+     when the error may exceed half a pixel */
+  if ((abs(offset.x) + abs(offset.y)) * max_cosine_delta > 0.5)
+    return false;
+
+  offset_r = offset;
+  return true;
+}
+
 /**
  * This function returns the corresponding SnailTrail
  * color array index to the input
@@ -140,22 +204,21 @@ TrailRenderer::Draw(Canvas &canvas, const TraceComputer &trace_computer,
   bool scaled_trail = settings.scaling_enabled &&
                       projection.GetMapScale() <= 6000;
 
-  const GeoBounds bounds = projection.GetScreenBounds().Scale(4);
+  const PixelPoint offset =
+    ProjectTrace(projection, enable_traildrift, traildrift, basic.time);
+  assert(projected.size() == trace.size());
 
   PixelPoint last_point(0, 0);
   bool last_valid = false;
-  for (auto it = trace.begin(), end = trace.end(); it != end; ++it) {
-    const GeoPoint gp = enable_traildrift
-      ? it->GetLocation().Parametric(traildrift,
-                                     it->CalculateDrift(basic.time))
-      : it->GetLocation();
-    if (!bounds.IsInside(gp)) {
+  auto p = projected.begin();
+  for (auto it = trace.begin(), end = trace.end(); it != end; ++it, ++p) {
+    if (!p->visible) {
       /* the point is outside of the MapWindow; don't paint it */
       last_valid = false;
       continue;
     }
 
-    auto pt = projection.GeoToScreen(gp);
+    const PixelPoint pt = p->point + offset;
 
     if (last_valid) {
       if (settings.type == TrailSettings::Type::ALTITUDE) {
@@ -201,6 +264,50 @@ TrailRenderer::Draw(Canvas &canvas, const TraceComputer &trace_computer,
     canvas.DrawLine(last_point, pos);
 }
 
+PixelPoint
+TrailRenderer::ProjectTrace(const WindowProjection &projection,
+                            bool enable_traildrift, const GeoPoint &traildrift,
+                            unsigned time)
+{
+  PixelPoint offset(0, 0);
+  if (enable_traildrift || !projected_key.GetOffset(projection, offset)) {
+    /* the drift moves all points each time, and a different scale or
+       rotation moves them as well: project the whole trace again */
+    projected.clear();
+
+    if (enable_traildrift)
+      projected_key.Clear();
+    else
+      projected_key.Set(projection);
+  }
+
+  /* new points are projected with the reference projection, so they
+     can be translated like the others */
+  const Projection &reference = enable_traildrift
+    ? (const Projection &)projection
+    : projected_key.projection;
+  const GeoBounds &bounds = enable_traildrift
+    ? projection.GetScreenBounds().Scale(4)
+    : projected_key.bounds;
+
+  projected.reserve(trace.size());
+  for (auto it = std::next(trace.begin(), projected.size()), end = trace.end();
+       it != end; ++it) {
+    const GeoPoint gp = enable_traildrift
+      ? it->GetLocation().Parametric(traildrift,
+                                     it->CalculateDrift(time))
+      : it->GetLocation();
+
+    ProjectedPoint p;
+    p.visible = bounds.IsInside(gp);
+    if (p.visible)
+      p.point = reference.GeoToScreen(gp);
+    projected.push_back(p);
+  }
+
+  return offset;
+}
+
 void
 TrailRenderer::Draw(Canvas &canvas, const WindowProjection &projection)
 {
@@ -25,14 +25,19 @@ Copyright_License {
 #define XCSOAR_TRAIL_RENDERER_HPP
 
 #include "Util/AllocatedArray.hxx"
+#include "Util/Serial.hpp"
 #include "Engine/Trace/Point.hpp"
 #include "Engine/Trace/Vector.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Projection/Projection.hpp"
+#include "Screen/Point.hpp"
+
+#include <vector>
 
-struct PixelPoint;
 struct BulkPixelPoint;
 class Canvas;
 class TraceComputer;
-class Projection;
 class WindowProjection;
 class ContestTraceVector;
 struct ContestTracePoint;
@@ -52,6 +57,70 @@ class TrailRenderer {
   TracePointVector trace;
   AllocatedArray<BulkPixelPoint> points;
 
+  /**
+   * The source and the parameters of the last filtered LoadTrace()
+   * call.  As long as they remain the same, the #trace is updated
+   * incrementally.
+   */
+  const TraceComputer *trace_computer = nullptr;
+  double trace_resolution;
+  Serial trace_serial;
+
+  struct ProjectedPoint {
+    PixelPoint point;
+
+    /** is the point inside the (scaled) screen bounds? */
+    bool visible;
+  };
+
+  /**
+   * The screen positions of the first #trace points, calculated by
+   * the snail trail Draw() method with #projected_key.  This is kept
+   * in sync with #trace, so only new points need to be projected
+   * while the scale and the rotation are unchanged.
+   */
+  std::vector<ProjectedPoint> projected;
+
+  /**
+   * The #Projection used for #projected.  The screen origin and the
+   * map location are not part of the key: when only they change
+   * (i.e. the map follows the aircraft), the cached points are
+   * translated.
+   */
+  struct ProjectionKey {
+    Projection projection;
+
+    /**
+     * The area which was checked for visible points.  The cache
+     * cannot be used when the screen leaves it.
+     */
+    GeoBounds bounds;
+
+    /**
+     * The maximum difference between the cosine of the reference
+     * latitude and the cosine of a point's latitude within #bounds.
+     * The longitude scale of Projection::GeoToScreen() depends on
+     * it, which makes translating an approximation.
+     */
+    double max_cosine_delta;
+
+    void Clear() {
+      projection = Projection();
+    }
+
+    void Set(const WindowProjection &projection);
+
+    /**
+     * Calculate the offset which converts the cached screen
+     * positions to the given projection.
+     *
+     * @return false if the cache cannot be used
+     */
+    gcc_pure
+    bool GetOffset(const WindowProjection &projection,
+                   PixelPoint &offset_r) const;
+  } projected_key;
+
 public:
   TrailRenderer(const TrailLook &_look):look(_look) {}
 
@@ -103,6 +172,15 @@ public:
                     const ContestTraceVector &trace);
 
 private:
+  /**
+   * Project the #trace points which are not yet in #projected.
+   *
+   * @return the offset to be added to all #projected points
+   */
+  PixelPoint ProjectTrace(const WindowProjection &projection,
+                          bool enable_traildrift, const GeoPoint &traildrift,
+                          unsigned time);
+
   void DrawTraceVector(Canvas &canvas, const Projection &projection,
                        const TracePointVector &trace);
 };
@@ -77,10 +77,8 @@ WaypointLabelList::Add(const TCHAR *Name, int X, int Y,
       Y < - WPCIRCLESIZE || Y > (int)height + WPCIRCLESIZE)
     return;
 
-  if (labels.full())
-    return;
-
-  auto &l = labels.append();
+  labels.emplace_back();
+  auto &l = labels.back();
 
   CopyString(l.Name, Name, ARRAY_SIZE(l.Name));
   l.Pos.x = X;
@@ -27,9 +27,10 @@ Copyright_License {
 #include "Renderer/TextInBox.hpp"
 #include "Screen/Point.hpp"
 #include "Util/NonCopyable.hpp"
-#include "Util/StaticArray.hxx"
 #include "Sizes.h" /* for NAME_SIZE */
 
+#include <vector>
+
 #include <tchar.h>
 
 class WaypointLabelList : private NonCopyable {
@@ -49,7 +50,11 @@ public:
 protected:
   const unsigned width, height;
 
-  StaticArray<Label, 256u> labels;
+  /**
+   * All labels on the screen.  This list is not limited, because
+   * Sort() must see all of them to pick the most important ones.
+   */
+  std::vector<Label> labels;
 
 public:
   WaypointLabelList(unsigned _width, unsigned _height)
@@ -62,11 +67,11 @@ public:
            bool isWatchedWaypoint);
   void Sort();
 
-  const Label *begin() const {
+  std::vector<Label>::const_iterator begin() const {
     return labels.begin();
   }
 
-  const Label *end() const {
+  std::vector<Label>::const_iterator end() const {
     return labels.end();
   }
 };
@@ -32,9 +32,7 @@ Copyright_License {
 #include "Engine/Waypoint/Waypoint.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 #include "Engine/Waypoint/WaypointVisitor.hpp"
-#include "Engine/GlideSolvers/GlideState.hpp"
-#include "Engine/GlideSolvers/GlideResult.hpp"
-#include "Engine/GlideSolvers/MacCready.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
 #include "Engine/Task/TaskManager.hpp"
 #include "Engine/Task/AbstractTask.hpp"
 #include "Engine/Task/Unordered/UnorderedTaskPoint.hpp"
@@ -44,13 +42,14 @@ Copyright_License {
 #include "Screen/Canvas.hpp"
 #include "Units/Units.hpp"
 #include "Util/TruncateString.hpp"
-#include "Util/StaticArray.hxx"
 #include "Util/Macros.hpp"
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
 #include "Engine/Route/ReachResult.hpp"
 #include "Look/WaypointLook.hpp"
 
+#include <vector>
+
 #include <assert.h>
 #include <stdio.h>
 
@@ -82,24 +81,15 @@ struct VisibleWaypoint {
       reachable == WaypointRenderer::ReachableTerrain;
   }
 
-  void CalculateReachabilityDirect(const MoreData &basic,
-                                   const SpeedVector &wind,
-                                   const MacCready &mac_cready,
-                                   const TaskBehaviour &task_behaviour) {
-    assert(basic.location_available);
-    assert(basic.NavAltitudeAvailable());
-
-    const auto elevation = waypoint->elevation +
-      task_behaviour.safety_height_arrival;
-    const GlideState state(GeoVector(basic.location, waypoint->location),
-                           elevation, basic.nav_altitude, wind);
-
-    const GlideResult result = mac_cready.SolveStraight(state);
-    if (!result.IsOk())
+  /**
+   * Apply the result of GlidePolar::SolveStraightBatch().
+   */
+  void SetReachabilityDirect(double arrival) {
+    if (arrival <= GlidePolar::UNREACHABLE)
       return;
 
-    reach.direct = result.pure_glide_altitude_difference;
-    if (result.pure_glide_altitude_difference > 0)
+    reach.direct = arrival;
+    if (arrival > 0)
       reachable = WaypointRenderer::ReachableTerrain;
   }
 
@@ -158,8 +148,11 @@ class WaypointVisitorMap final
    * reachability is calculated, and the third stage draws them.  This
    * should ensure that the drawing methods don't need to hold a
    * mutex.
+   *
+   * This list is not limited: the visitor sees the waypoints in
+   * no particular order, and a limit would drop arbitrary ones.
    */
-  StaticArray<VisibleWaypoint, 256> waypoints;
+  std::vector<VisibleWaypoint> waypoints;
 
 public:
   WaypointLabelList labels;
@@ -350,9 +343,6 @@ protected:
   }
 
   void AddWaypoint(const WaypointPtr &way_point, bool in_task) {
-    if (waypoints.full())
-      return;
-
     if (!projection.WaypointInScaleFilter(*way_point) && !in_task)
       return;
 
@@ -360,8 +350,8 @@ protected:
     if (!projection.GeoToScreenIfVisible(way_point->location, sc))
       return;
 
-    VisibleWaypoint &vwp = waypoints.append();
-    vwp.Set(way_point, sc, in_task);
+    waypoints.emplace_back();
+    waypoints.back().Set(way_point, sc, in_task);
   }
 
 public:
@@ -410,15 +400,49 @@ public:
       task_behaviour.route_planner.reach_polar_mode == RoutePlannerConfig::Polar::TASK
       ? polar_settings.glide_polar_task
       : calculated.glide_polar_safety;
-    const MacCready mac_cready(task_behaviour.glide, glide_polar);
+    if (!glide_polar.IsValid())
+      return;
+
+    /* collect the targets in a structure of arrays, and solve them
+       in batches */
+    static constexpr unsigned BATCH_SIZE = 256;
+    VisibleWaypoint *targets[BATCH_SIZE];
+    double distance[BATCH_SIZE], altitude_difference[BATCH_SIZE];
+    Angle bearing[BATCH_SIZE];
+    double arrival[BATCH_SIZE];
+    unsigned n = 0;
+
+    const auto wind = calculated.GetWindOrZero();
+    auto flush = [&](){
+      glide_polar.SolveStraightBatch(wind, n,
+                                     distance, bearing, altitude_difference,
+                                     arrival);
+
+      for (unsigned i = 0; i < n; ++i)
+        targets[i]->SetReachabilityDirect(arrival[i]);
+
+      n = 0;
+    };
 
     for (VisibleWaypoint &vwp : waypoints) {
       const Waypoint &way_point = *vwp.waypoint;
-
-      if (way_point.IsLandable() || way_point.flags.watched)
-        vwp.CalculateReachabilityDirect(basic, calculated.GetWindOrZero(),
-                                        mac_cready, task_behaviour);
+      if (!way_point.IsLandable() && !way_point.flags.watched)
+        continue;
+
+      const GeoVector vector(basic.location, way_point.location);
+      const auto elevation = way_point.elevation +
+        task_behaviour.safety_height_arrival;
+
+      targets[n] = &vwp;
+      distance[n] = vector.distance;
+      bearing[n] = vector.bearing;
+      altitude_difference[n] = basic.nav_altitude - elevation;
+      if (++n == BATCH_SIZE)
+        flush();
     }
+
+    if (n > 0)
+      flush();
   }
 
   void Calculate(const ProtectedRoutePlanner *route_planner,
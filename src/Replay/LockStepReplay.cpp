@@ -0,0 +1,89 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "LockStepReplay.hpp"
+#include "AbstractReplay.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "MergeThread.hpp"
+#include "Computer/GlideComputer.hpp"
+
+LockStepReplay::LockStepReplay(std::unique_ptr<AbstractReplay> &&_replay,
+                               DeviceBlackboard &_device_blackboard,
+                               MergeThread &_merge_thread,
+                               GlideComputer &_glide_computer)
+  :replay(std::move(_replay)),
+   device_blackboard(_device_blackboard),
+   merge_thread(_merge_thread),
+   glide_computer(_glide_computer)
+{
+  data.Reset();
+
+  /* the idle interval must not depend on the host's speed */
+  glide_computer.SetFixClock(true);
+}
+
+LockStepReplay::~LockStepReplay()
+{
+  glide_computer.SetFixClock(false);
+  device_blackboard.StopReplay();
+}
+
+bool
+LockStepReplay::Next()
+{
+  if (!replay->Update(data))
+    return false;
+
+  ++n_records;
+
+  bool gps_updated;
+
+  /* this is what MergeThread::Tick() and the first half of
+     CalculationThread::Tick() do */
+  {
+    ScopeLock protect(device_blackboard.mutex);
+    device_blackboard.SetReplayState() = data;
+    merge_thread.ProcessSynchronous();
+
+    gps_updated = device_blackboard.Basic().location_available
+      .Modified(glide_computer.Basic().location_available);
+
+    glide_computer.ReadBlackboard(device_blackboard.Basic());
+    glide_computer.ReadComputerSettings(device_blackboard.GetComputerSettings());
+  }
+
+  glide_computer.Expire();
+
+  const bool do_idle = gps_updated && glide_computer.ProcessGPS();
+
+  {
+    ScopeLock protect(device_blackboard.mutex);
+    device_blackboard.ReadBlackboard(glide_computer.Calculated());
+  }
+
+  if (do_idle)
+    glide_computer.ProcessIdle();
+
+  return true;
+}
@@ -0,0 +1,96 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_LOCK_STEP_REPLAY_HPP
+#define XCSOAR_LOCK_STEP_REPLAY_HPP
+
+#include "NMEA/Info.hpp"
+
+#include <memory>
+
+class AbstractReplay;
+class DeviceBlackboard;
+class MergeThread;
+class GlideComputer;
+
+/**
+ * Replay a recorded flight as quickly as possible.  Unlike #Replay,
+ * this class does not use a timer and does not wake up the
+ * #MergeThread and the #CalculationThread; instead, each record is
+ * pushed through DeviceBlackboard::Merge(), the #MergeThread
+ * computers and the #GlideComputer synchronously, in the same order
+ * the threads would process it.  The #GlideComputer measures its idle
+ * interval in record time stamps (GlideComputer::SetFixClock()), so
+ * the result is deterministic and independent of the wall clock.
+ *
+ * Like Replay::FastForward(), the records are passed on without
+ * interpolation.
+ *
+ * The #MergeThread and the #CalculationThread must not be running.
+ */
+class LockStepReplay {
+  std::unique_ptr<AbstractReplay> replay;
+
+  DeviceBlackboard &device_blackboard;
+  MergeThread &merge_thread;
+  GlideComputer &glide_computer;
+
+  /**
+   * The last record returned by the #AbstractReplay.
+   */
+  NMEAInfo data;
+
+  unsigned n_records = 0;
+
+public:
+  LockStepReplay(std::unique_ptr<AbstractReplay> &&_replay,
+                 DeviceBlackboard &_device_blackboard,
+                 MergeThread &_merge_thread,
+                 GlideComputer &_glide_computer);
+
+  ~LockStepReplay();
+
+  /**
+   * The number of records which have been processed so far.
+   */
+  unsigned GetRecordCount() const {
+    return n_records;
+  }
+
+  /**
+   * Read the next record and process it.
+   *
+   * @return false on end of input
+   */
+  bool Next();
+
+  /**
+   * Process all remaining records.
+   */
+  void Run() {
+    while (Next()) {}
+  }
+};
+
+#endif
@@ -0,0 +1,153 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_SCREEN_AVX2_HPP
+#define XCSOAR_SCREEN_AVX2_HPP
+
+/*
+ * Pixel conversion kernels using Intel AVX2 instructions.  They are
+ * compiled for AVX2 even if the rest of the program is not, and the
+ * caller must check HaveAVX2() at run time.
+ */
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+
+#define HAVE_AVX2_DISPATCH
+
+#include "Screen/PortableColor.hpp"
+#include "Compiler.h"
+
+#include <immintrin.h>
+
+/**
+ * Does this CPU support AVX2?  The check is done only once.
+ */
+static inline bool
+HaveAVX2()
+{
+  static const bool value = __builtin_cpu_supports("avx2");
+  return value;
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-align"
+
+/**
+ * Convert greyscale pixels to RGB565, 16 at a time.
+ *
+ * @return the number of pixels which were converted; the caller
+ * converts the remainder
+ */
+__attribute__((target("avx2")))
+static inline unsigned
+AVX2GreyscaleToRGB565(RGB565Color *gcc_restrict _dest,
+                      const Luminosity8 *gcc_restrict _src,
+                      unsigned width)
+{
+  __m256i *dest = (__m256i *)_dest;
+  const __m128i *src = (const __m128i *)_src;
+
+  const __m256i mask_r = _mm256_set1_epi16(0xf8);
+  const __m256i mask_g = _mm256_set1_epi16(0xfc);
+
+  const unsigned n = width / 16;
+  for (unsigned i = 0; i < n; ++i) {
+    const __m256i x = _mm256_cvtepu8_epi16(_mm_loadu_si128(src + i));
+
+    __m256i r = _mm256_slli_epi16(_mm256_and_si256(x, mask_r), 8);
+    __m256i g = _mm256_slli_epi16(_mm256_and_si256(x, mask_g), 3);
+    __m256i b = _mm256_srli_epi16(x, 3);
+
+    _mm256_storeu_si256(dest + i, _mm256_or_si256(_mm256_or_si256(r, g), b));
+  }
+
+  return n * 16;
+}
+
+/**
+ * Convert greyscale pixels to 32 bit RGB (see GreyscaleToRGB8()), 8
+ * at a time.
+ *
+ * @return the number of pixels which were converted
+ */
+__attribute__((target("avx2")))
+static inline unsigned
+AVX2GreyscaleToRGB8(uint32_t *gcc_restrict _dest,
+                    const Luminosity8 *gcc_restrict src,
+                    unsigned width)
+{
+  __m256i *dest = (__m256i *)_dest;
+  const __m256i factor = _mm256_set1_epi32(0x01010101);
+
+  const unsigned n = width / 8;
+  for (unsigned i = 0; i < n; ++i) {
+    const __m128i v = _mm_loadl_epi64((const __m128i *)(src + i * 8));
+    _mm256_storeu_si256(dest + i,
+                        _mm256_mullo_epi32(_mm256_cvtepu8_epi32(v), factor));
+  }
+
+  return n * 8;
+}
+
+/**
+ * Convert BGRA pixels to RGB565, 16 at a time.
+ *
+ * @return the number of pixels which were converted
+ */
+__attribute__((target("avx2")))
+static inline unsigned
+AVX2BGRAToRGB565(RGB565Color *gcc_restrict _dest,
+                 const BGRA8Color *gcc_restrict _src,
+                 unsigned width)
+{
+  __m256i *dest = (__m256i *)_dest;
+  const __m256i *src = (const __m256i *)_src;
+
+  const __m256i mask_r = _mm256_set1_epi32(0xf800);
+  const __m256i mask_g = _mm256_set1_epi32(0x07e0);
+  const __m256i mask_b = _mm256_set1_epi32(0x001f);
+
+  const unsigned n = width / 16;
+  for (unsigned i = 0; i < n; ++i) {
+    __m256i c[2];
+    for (unsigned j = 0; j < 2; ++j) {
+      const __m256i x = _mm256_loadu_si256(src + i * 2 + j);
+      __m256i r = _mm256_and_si256(_mm256_srli_epi32(x, 8), mask_r);
+      __m256i g = _mm256_and_si256(_mm256_srli_epi32(x, 5), mask_g);
+      __m256i b = _mm256_and_si256(_mm256_srli_epi32(x, 3), mask_b);
+      c[j] = _mm256_or_si256(_mm256_or_si256(r, g), b);
+    }
+
+    /* packus works on 128 bit lanes; restore the pixel order */
+    const __m256i packed = _mm256_packus_epi32(c[0], c[1]);
+    _mm256_storeu_si256(dest + i, _mm256_permute4x64_epi64(packed, 0xd8));
+  }
+
+  return n * 16;
+}
+
+#pragma GCC diagnostic pop
+
+#endif /* __x86_64__ && __GNUC__ && !__clang__ */
+
+#endif
@@ -28,8 +28,94 @@ Copyright_License {
 #include "../Memory/Dither.hpp"
 #endif
 
+#ifdef __SSE2__
+#include "SSE2.hpp"
+#endif
+
+#include "AVX2.hpp"
+
 #include <assert.h>
 
+#if defined(GREYSCALE) && !defined(DITHER)
+
+/**
+ * Vectorised version of CopyGreyscaleToRGB565().
+ */
+static void
+ConvertGreyscaleToRGB565(RGB565Color *gcc_restrict dest,
+                         const Luminosity8 *gcc_restrict src,
+                         unsigned width)
+{
+  unsigned done = 0;
+
+#ifdef HAVE_AVX2_DISPATCH
+  if (HaveAVX2())
+    done = AVX2GreyscaleToRGB565(dest, src, width);
+#endif
+
+#ifdef __SSE2__
+  for (; done + 16 <= width; done += 16)
+    SSE2GreyscaleToRGB565((uint8_t *)(dest + done),
+                          (const uint8_t *)(src + done));
+#endif
+
+  CopyGreyscaleToRGB565(dest + done, src + done, width - done);
+}
+
+/**
+ * Vectorised version of CopyGreyscaleToRGB8().
+ */
+static void
+ConvertGreyscaleToRGB8(uint32_t *gcc_restrict dest,
+                       const Luminosity8 *gcc_restrict src,
+                       unsigned width)
+{
+  unsigned done = 0;
+
+#ifdef HAVE_AVX2_DISPATCH
+  if (HaveAVX2())
+    done = AVX2GreyscaleToRGB8(dest, src, width);
+#endif
+
+#ifdef __SSE2__
+  for (; done + 16 <= width; done += 16)
+    SSE2GreyscaleToRGB8((uint8_t *)(dest + done),
+                        (const uint8_t *)(src + done));
+#endif
+
+  CopyGreyscaleToRGB8(dest + done, src + done, width - done);
+}
+
+#endif
+
+#ifndef GREYSCALE
+
+/**
+ * Vectorised version of BGRAToRGB565().
+ */
+static void
+ConvertBGRAToRGB565(RGB565Color *gcc_restrict dest,
+                    const BGRA8Color *gcc_restrict src,
+                    unsigned width)
+{
+  unsigned done = 0;
+
+#ifdef HAVE_AVX2_DISPATCH
+  if (HaveAVX2())
+    done = AVX2BGRAToRGB565(dest, src, width);
+#endif
+
+#ifdef __SSE2__
+  for (; done + 8 <= width; done += 8)
+    SSE2BGRAToRGB565((uint8_t *)(dest + done),
+                     (const uint8_t *)(src + done));
+#endif
+
+  BGRAToRGB565(dest + done, src + done, width - done);
+}
+
+#endif
+
 #ifdef GREYSCALE
 
 #ifdef KOBO
@@ -97,13 +183,13 @@ CopyFromGreyscale(
   if (dest_bpp == 2) {
     for (unsigned row = height; row > 0;
          --row, src_pixels += src_pitch, dest_pixels += dest_pitch)
-      CopyGreyscaleToRGB565((RGB565Color *)dest_pixels,
-                            (const Luminosity8 *)src_pixels, width);
+      ConvertGreyscaleToRGB565((RGB565Color *)dest_pixels,
+                               (const Luminosity8 *)src_pixels, width);
   } else {
     for (unsigned row = height; row > 0;
          --row, src_pixels += src_pitch, dest_pixels += dest_pitch)
-      CopyGreyscaleToRGB8((uint32_t *)dest_pixels,
-                           (const Luminosity8 *)src_pixels, width);
+      ConvertGreyscaleToRGB8((uint32_t *)dest_pixels,
+                             (const Luminosity8 *)src_pixels, width);
   }
 
 #endif
@@ -128,9 +214,9 @@ CopyFromBGRA(void *_dest_pixels, unsigned _dest_pitch, unsigned dest_bpp,
 
     for (unsigned row = src.height; row > 0;
          --row, src_pixels += src_pitch, dest_pixels += dest_pitch)
-      BGRAToRGB565((RGB565Color *)dest_pixels,
-                   (const BGRA8Color *)src_pixels,
-                   src.width);
+      ConvertBGRAToRGB565((RGB565Color *)dest_pixels,
+                          (const BGRA8Color *)src_pixels,
+                          src.width);
   } else {
     uint32_t *dest_pixels = reinterpret_cast<uint32_t *>(_dest_pixels);
     const uint32_t *src_pixels = reinterpret_cast<const uint32_t *>(src.data);
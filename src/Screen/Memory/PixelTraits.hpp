@@ -139,12 +139,12 @@ struct GreyscalePixelTraits {
     return p + CalcIncrement(delta);
   }
 
-  static constexpr pointer_type NextByte(pointer_type p, int delta) {
+  static pointer_type NextByte(pointer_type p, int delta) {
     return pointer_type((uint8_t *)p + delta);
   }
 
-  static constexpr const_pointer_type NextByte(const_pointer_type p,
-                                               int delta) {
+  static const_pointer_type NextByte(const_pointer_type p,
+                                     int delta) {
     return const_pointer_type((const uint8_t *)p + delta);
   }
 
@@ -153,13 +153,13 @@ struct GreyscalePixelTraits {
    *
    * @param pitch the number of bytes per row
    */
-  static constexpr pointer_type NextRow(pointer_type p,
-                                        unsigned pitch, int delta) {
+  static pointer_type NextRow(pointer_type p,
+                              unsigned pitch, int delta) {
     return NextByte(p, int(pitch) * delta);
   }
 
-  static constexpr const_pointer_type NextRow(const_pointer_type p,
-                                              unsigned pitch, int delta) {
+  static const_pointer_type NextRow(const_pointer_type p,
+                                    unsigned pitch, int delta) {
     return NextByte(p, int(pitch) * delta);
   }
 
@@ -168,13 +168,13 @@ struct GreyscalePixelTraits {
    *
    * @param pitch the number of bytes per row
    */
-  static constexpr pointer_type At(pointer_type p, unsigned pitch,
-                                   int x, int y) {
+  static pointer_type At(pointer_type p, unsigned pitch,
+                         int x, int y) {
     return Next(NextRow(p, pitch, y), x);
   }
 
-  static constexpr const_pointer_type At(const_pointer_type p, unsigned pitch,
-                                         int x, int y) {
+  static const_pointer_type At(const_pointer_type p, unsigned pitch,
+                               int x, int y) {
     return Next(NextRow(p, pitch, y), x);
   }
 
@@ -337,32 +337,32 @@ struct BGRAPixelTraits {
     return p + CalcIncrement(delta);
   }
 
-  static constexpr pointer_type NextByte(pointer_type p, int delta) {
+  static pointer_type NextByte(pointer_type p, int delta) {
     return pointer_type((uint8_t *)p + delta);
   }
 
-  static constexpr const_pointer_type NextByte(const_pointer_type p,
-                                               int delta) {
+  static const_pointer_type NextByte(const_pointer_type p,
+                                     int delta) {
     return const_pointer_type((const uint8_t *)p + delta);
   }
 
-  static constexpr pointer_type NextRow(pointer_type p,
-                                        unsigned pitch, int delta) {
+  static pointer_type NextRow(pointer_type p,
+                              unsigned pitch, int delta) {
     return NextByte(p, int(pitch) * delta);
   }
 
-  static constexpr const_pointer_type NextRow(const_pointer_type p,
-                                              unsigned pitch, int delta) {
+  static const_pointer_type NextRow(const_pointer_type p,
+                                    unsigned pitch, int delta) {
     return NextByte(p, int(pitch) * delta);
   }
 
-  static constexpr pointer_type At(pointer_type p, unsigned pitch,
-                                   int x, int y) {
+  static pointer_type At(pointer_type p, unsigned pitch,
+                         int x, int y) {
     return Next(NextRow(p, pitch, y), x);
   }
 
-  static constexpr const_pointer_type At(const_pointer_type p, unsigned pitch,
-                                         int x, int y) {
+  static const_pointer_type At(const_pointer_type p, unsigned pitch,
+                               int x, int y) {
     return Next(NextRow(p, pitch, y), x);
   }
 
@@ -0,0 +1,305 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_SCREEN_SSE2_HPP
+#define XCSOAR_SCREEN_SSE2_HPP
+
+#include "Screen/PortableColor.hpp"
+#include "Compiler.h"
+
+#ifndef __SSE2__
+#error SSE2 required
+#endif
+
+#include <emmintrin.h>
+
+#if CLANG_OR_GCC_VERSION(4,8)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-align"
+#endif
+
+/**
+ * Implementation of BitOrPixelOperations using Intel SSE2
+ * instructions.  The operation is bit-wise, therefore it works on
+ * greyscale and on BGRA pixels alike.
+ */
+class SSE2BitOrPixelOperations {
+public:
+  gcc_always_inline
+  static void Blend16(uint8_t *gcc_restrict p,
+                      const uint8_t *gcc_restrict q) {
+    __m128i pv = _mm_loadu_si128((const __m128i *)p);
+    __m128i qv = _mm_loadu_si128((const __m128i *)q);
+
+    _mm_storeu_si128((__m128i *)p, _mm_or_si128(pv, qv));
+  }
+
+  gcc_flatten
+  void CopyPixels(uint8_t *gcc_restrict p,
+                  const uint8_t *gcc_restrict q, unsigned n) const {
+    for (unsigned i = 0; i < n / 16; ++i, p += 16, q += 16)
+      Blend16(p, q);
+  }
+
+  void CopyPixels(Luminosity8 *p, const Luminosity8 *q, unsigned n) const {
+    CopyPixels((uint8_t *)p, (const uint8_t *)q, n);
+  }
+
+  void CopyPixels(BGRA8Color *p, const BGRA8Color *q, unsigned n) const {
+    CopyPixels((uint8_t *)p, (const uint8_t *)q, n * 4);
+  }
+};
+
+/**
+ * Implementation of TransparentPixelOperations using Intel SSE2
+ * instructions: source pixels which equal the key are skipped.
+ */
+class SSE2TransparentPixelOperations {
+  uint32_t key;
+
+public:
+  constexpr SSE2TransparentPixelOperations(Luminosity8 _key)
+    :key(_key.GetLuminosity()) {}
+
+  constexpr SSE2TransparentPixelOperations(BGRA8Color _key)
+    :key(ToInteger(_key)) {}
+
+  static constexpr uint32_t ToInteger(BGRA8Color c) {
+    return c.Blue() | (c.Green() << 8) | (c.Red() << 16) |
+      (uint32_t(c.Alpha()) << 24);
+  }
+
+  gcc_always_inline
+  static void Blend16(uint8_t *gcc_restrict p,
+                      const uint8_t *gcc_restrict q, __m128i mask) {
+    __m128i pv = _mm_loadu_si128((const __m128i *)p);
+    __m128i qv = _mm_loadu_si128((const __m128i *)q);
+
+    __m128i r = _mm_or_si128(_mm_and_si128(mask, pv),
+                             _mm_andnot_si128(mask, qv));
+    _mm_storeu_si128((__m128i *)p, r);
+  }
+
+  gcc_flatten
+  void CopyPixels(Luminosity8 *_p, const Luminosity8 *_q, unsigned n) const {
+    uint8_t *p = (uint8_t *)_p;
+    const uint8_t *q = (const uint8_t *)_q;
+    const __m128i v_key = _mm_set1_epi8(key);
+
+    for (unsigned i = 0; i < n / 16; ++i, p += 16, q += 16) {
+      __m128i qv = _mm_loadu_si128((const __m128i *)q);
+      Blend16(p, q, _mm_cmpeq_epi8(qv, v_key));
+    }
+  }
+
+  gcc_flatten
+  void CopyPixels(BGRA8Color *_p, const BGRA8Color *_q, unsigned n) const {
+    uint8_t *p = (uint8_t *)_p;
+    const uint8_t *q = (const uint8_t *)_q;
+    const __m128i v_key = _mm_set1_epi32(key);
+
+    for (unsigned i = 0; i < n / 4; ++i, p += 16, q += 16) {
+      __m128i qv = _mm_loadu_si128((const __m128i *)q);
+      Blend16(p, q, _mm_cmpeq_epi32(qv, v_key));
+    }
+  }
+};
+
+/**
+ * Implementation of AlphaPixelOperations using Intel SSE2
+ * instructions.  Unlike #MMXAlphaPixelOperations, this one calculates
+ * (a*(256-alpha) + b*alpha) / 256, which is bit-exact with
+ * #PixelAlphaOperation.  On BGRA pixels, the destination's alpha
+ * channel is preserved.
+ */
+class SSE2AlphaPixelOperations {
+  /**
+   * Selects the alpha channel of a BGRA pixel.
+   */
+  static constexpr int ALPHA_MASK = int(0xff000000);
+
+  uint8_t alpha;
+
+public:
+  constexpr SSE2AlphaPixelOperations(uint8_t _alpha):alpha(_alpha) {}
+
+  gcc_always_inline
+  static __m128i AlphaBlend8(__m128i p, __m128i q,
+                             __m128i v_alpha, __m128i inverse_alpha) {
+    p = _mm_mullo_epi16(p, inverse_alpha);
+    q = _mm_mullo_epi16(q, v_alpha);
+    return _mm_srli_epi16(_mm_add_epi16(p, q), 8);
+  }
+
+  /**
+   * Blend 16 bytes of #q into #p.  The bytes selected by #keep are
+   * not modified.
+   */
+  gcc_always_inline
+  static __m128i AlphaBlend16(__m128i pv, __m128i qv,
+                              __m128i v_alpha, __m128i inverse_alpha,
+                              __m128i keep) {
+    const __m128i zero = _mm_setzero_si128();
+
+    __m128i lo = AlphaBlend8(_mm_unpacklo_epi8(pv, zero),
+                             _mm_unpacklo_epi8(qv, zero),
+                             v_alpha, inverse_alpha);
+    __m128i hi = AlphaBlend8(_mm_unpackhi_epi8(pv, zero),
+                             _mm_unpackhi_epi8(qv, zero),
+                             v_alpha, inverse_alpha);
+
+    __m128i r = _mm_packus_epi16(lo, hi);
+    return _mm_or_si128(_mm_and_si128(keep, pv), _mm_andnot_si128(keep, r));
+  }
+
+  gcc_flatten
+  void CopyPixels(uint8_t *gcc_restrict p,
+                  const uint8_t *gcc_restrict q, unsigned n,
+                  __m128i keep) const {
+    const __m128i v_alpha = _mm_set1_epi16(alpha);
+    const __m128i inverse_alpha = _mm_set1_epi16(256 - alpha);
+
+    for (unsigned i = 0; i < n / 16; ++i, p += 16, q += 16) {
+      __m128i pv = _mm_loadu_si128((const __m128i *)p);
+      __m128i qv = _mm_loadu_si128((const __m128i *)q);
+
+      _mm_storeu_si128((__m128i *)p,
+                       AlphaBlend16(pv, qv, v_alpha, inverse_alpha, keep));
+    }
+  }
+
+  gcc_flatten
+  void FillPixels(uint8_t *p, unsigned n, __m128i qv, __m128i keep) const {
+    const __m128i v_alpha = _mm_set1_epi16(alpha);
+    const __m128i inverse_alpha = _mm_set1_epi16(256 - alpha);
+
+    for (unsigned i = 0; i < n / 16; ++i, p += 16) {
+      __m128i pv = _mm_loadu_si128((const __m128i *)p);
+
+      _mm_storeu_si128((__m128i *)p,
+                       AlphaBlend16(pv, qv, v_alpha, inverse_alpha, keep));
+    }
+  }
+
+  void CopyPixels(Luminosity8 *p, const Luminosity8 *q, unsigned n) const {
+    CopyPixels((uint8_t *)p, (const uint8_t *)q, n, _mm_setzero_si128());
+  }
+
+  void FillPixels(Luminosity8 *p, unsigned n, Luminosity8 c) const {
+    FillPixels((uint8_t *)p, n, _mm_set1_epi8(c.GetLuminosity()),
+               _mm_setzero_si128());
+  }
+
+  void CopyPixels(BGRA8Color *p, const BGRA8Color *q, unsigned n) const {
+    CopyPixels((uint8_t *)p, (const uint8_t *)q, n * 4,
+               _mm_set1_epi32(ALPHA_MASK));
+  }
+
+  void FillPixels(BGRA8Color *p, unsigned n, BGRA8Color c) const {
+    FillPixels((uint8_t *)p, n * 4,
+               _mm_set1_epi32(SSE2TransparentPixelOperations::ToInteger(c)),
+               _mm_set1_epi32(ALPHA_MASK));
+  }
+};
+
+/**
+ * Convert 16 greyscale pixels to RGB565.
+ */
+gcc_always_inline
+static inline void
+SSE2GreyscaleToRGB565(uint8_t *gcc_restrict dest,
+                      const uint8_t *gcc_restrict src)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i v = _mm_loadu_si128((const __m128i *)src);
+
+  for (unsigned i = 0; i < 2; ++i) {
+    const __m128i x = i == 0
+      ? _mm_unpacklo_epi8(v, zero)
+      : _mm_unpackhi_epi8(v, zero);
+
+    __m128i r = _mm_slli_epi16(_mm_and_si128(x, _mm_set1_epi16(0xf8)), 8);
+    __m128i g = _mm_slli_epi16(_mm_and_si128(x, _mm_set1_epi16(0xfc)), 3);
+    __m128i b = _mm_srli_epi16(x, 3);
+
+    _mm_storeu_si128((__m128i *)dest + i,
+                     _mm_or_si128(_mm_or_si128(r, g), b));
+  }
+}
+
+/**
+ * Convert 16 greyscale pixels to 32 bit RGB (see GreyscaleToRGB8()).
+ */
+gcc_always_inline
+static inline void
+SSE2GreyscaleToRGB8(uint8_t *gcc_restrict dest,
+                    const uint8_t *gcc_restrict src)
+{
+  const __m128i v = _mm_loadu_si128((const __m128i *)src);
+  const __m128i lo = _mm_unpacklo_epi8(v, v);
+  const __m128i hi = _mm_unpackhi_epi8(v, v);
+
+  __m128i *d = (__m128i *)dest;
+  _mm_storeu_si128(d, _mm_unpacklo_epi16(lo, lo));
+  _mm_storeu_si128(d + 1, _mm_unpackhi_epi16(lo, lo));
+  _mm_storeu_si128(d + 2, _mm_unpacklo_epi16(hi, hi));
+  _mm_storeu_si128(d + 3, _mm_unpackhi_epi16(hi, hi));
+}
+
+/**
+ * Convert 4 BGRA pixels to RGB565.  The result is returned in the low
+ * 16 bits of each 32 bit lane, sign-extended, so two of these can be
+ * combined with _mm_packs_epi32().
+ */
+gcc_always_inline
+static inline __m128i
+SSE2BGRAToRGB565x4(const uint8_t *src)
+{
+  const __m128i x = _mm_loadu_si128((const __m128i *)src);
+
+  __m128i r = _mm_and_si128(_mm_srli_epi32(x, 8), _mm_set1_epi32(0xf800));
+  __m128i g = _mm_and_si128(_mm_srli_epi32(x, 5), _mm_set1_epi32(0x07e0));
+  __m128i b = _mm_and_si128(_mm_srli_epi32(x, 3), _mm_set1_epi32(0x001f));
+
+  __m128i c = _mm_or_si128(_mm_or_si128(r, g), b);
+  return _mm_srai_epi32(_mm_slli_epi32(c, 16), 16);
+}
+
+/**
+ * Convert 8 BGRA pixels to RGB565.
+ */
+gcc_always_inline
+static inline void
+SSE2BGRAToRGB565(uint8_t *gcc_restrict dest,
+                 const uint8_t *gcc_restrict src)
+{
+  _mm_storeu_si128((__m128i *)dest,
+                   _mm_packs_epi32(SSE2BGRAToRGB565x4(src),
+                                   SSE2BGRAToRGB565x4(src + 16)));
+}
+
+#if CLANG_OR_GCC_VERSION(4,8)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
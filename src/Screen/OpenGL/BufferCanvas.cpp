@@ -175,12 +175,10 @@ BufferCanvas::Begin(Canvas &other)
 }
 
 void
-BufferCanvas::Commit(Canvas &other)
+BufferCanvas::Commit(Canvas &other, PixelPoint position)
 {
   assert(IsDefined());
   assert(active);
-  assert(GetWidth() == other.GetWidth());
-  assert(GetHeight() == other.GetHeight());
 
   if (frame_buffer != nullptr) {
     assert(OpenGL::translate.x == 0);
@@ -223,8 +221,11 @@ BufferCanvas::Commit(Canvas &other)
 #endif
 
     /* copy frame buffer to screen */
-    CopyTo(other);
+    CopyTo(other, position);
   } else {
+    assert(GetWidth() == other.GetWidth());
+    assert(GetHeight() == other.GetHeight());
+    assert(position == PixelPoint(0, 0));
     assert(offset == other.offset);
 
     /* copy screen to texture */
@@ -253,6 +254,33 @@ BufferCanvas::CopyTo(Canvas &other)
   texture->Draw(other.GetRect(), GetRect());
 }
 
+void
+BufferCanvas::CopyTo(Canvas &other, PixelPoint position)
+{
+  assert(IsDefined());
+  assert(!active || frame_buffer != nullptr);
+  assert(position.x >= 0 && position.y >= 0);
+  assert(position.x + other.GetWidth() <= GetWidth());
+  assert(position.y + other.GetHeight() <= GetHeight());
+
+#ifdef USE_GLSL
+  OpenGL::texture_shader->Use();
+#else
+  const GLEnable<GL_TEXTURE_2D> scope;
+  OpenGL::glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+#endif
+
+  /* the texture is flipped: its rows count from the bottom of this
+     canvas */
+  PixelRect src(position, other.GetSize());
+  const int top = GetHeight() - src.bottom;
+  src.bottom = GetHeight() - src.top;
+  src.top = top;
+
+  texture->Bind();
+  texture->Draw(other.GetRect(), src);
+}
+
 void
 BufferCanvas::SurfaceCreated()
 {
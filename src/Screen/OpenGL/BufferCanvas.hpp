@@ -113,10 +113,27 @@ public:
    *
    * @param other an on-screen #Canvas
    */
-  void Commit(Canvas &other);
+  /**
+   * Finish drawing, and copy this buffer to the given #Canvas.
+   *
+   * @param position the position within this buffer which is copied
+   * to the top left corner of the other #Canvas; a position other
+   * than zero requires a frame buffer object
+   */
+  void Commit(Canvas &other, PixelPoint position);
+
+  void Commit(Canvas &other) {
+    Commit(other, PixelPoint(0, 0));
+  }
 
   void CopyTo(Canvas &other);
 
+  /**
+   * Copy the part of this buffer at the given position to the other
+   * #Canvas, without scaling.
+   */
+  void CopyTo(Canvas &other, PixelPoint position);
+
 #ifdef ENABLE_OPENGL
 private:
   /* from GLSurfaceListener */
@@ -104,4 +104,8 @@ public:
 class GLFallbackArrayBuffer : public GLFallbackBuffer<GLArrayBuffer> {
 };
 
+class GLFallbackElementArrayBuffer
+  : public GLFallbackBuffer<GLElementArrayBuffer> {
+};
+
 #endif
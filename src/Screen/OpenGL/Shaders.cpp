@@ -44,14 +44,27 @@ namespace OpenGL {
 
   GLProgram *combine_texture_shader;
   GLint combine_texture_projection, combine_texture_texture;
+
+#ifdef ENABLE_GLSL_TERRAIN
+  GLProgram *terrain_shader;
+  GLint terrain_projection, terrain_heights, terrain_ramp;
+  GLint terrain_texel, terrain_size;
+  GLint terrain_quantisation, terrain_slope_factor, terrain_contrast;
+  GLint terrain_light, terrain_height_divisor, terrain_contour_divisor;
+#endif
 }
 
 #ifdef HAVE_GLES
 #define GLSL_VERSION
 #define GLSL_PRECISION "precision mediump float;\n"
+/* decoding 16 bit terrain heights needs more than mediump; the
+   shader is only used if the GPU supports highp in the fragment
+   shader, see HaveFragmentHighPrecision() */
+#define GLSL_HIGH_PRECISION "precision highp float;\n"
 #else
 #define GLSL_VERSION "#version 120\n"
 #define GLSL_PRECISION
+#define GLSL_HIGH_PRECISION
 #endif
 
 static constexpr char solid_vertex_shader[] =
@@ -132,6 +145,97 @@ static constexpr char combine_texture_fragment_shader[] =
   "  gl_FragColor = colorvar * texture2D(texture, texcoordvar);"
   "}";
 
+#ifdef ENABLE_GLSL_TERRAIN
+
+/**
+ * Shade the terrain height texture (see class TerrainTexture).  The
+ * formulas are the same as in RasterRenderer::GenerateSlopeImage(),
+ * with one difference: contour lines are detected by comparing with
+ * the pixels to the left and above, instead of carrying the state
+ * along each row and column.
+ */
+static const char *const terrain_vertex_shader = texture_vertex_shader;
+static constexpr char terrain_fragment_shader[] =
+  GLSL_VERSION
+  GLSL_HIGH_PRECISION
+  "uniform sampler2D heights;"
+  "uniform sampler2D ramp;"
+  "uniform vec2 texel;"
+  "uniform vec2 size;"
+  "uniform float quantisation;"
+  "uniform float slope_factor;"
+  "uniform float contrast;"
+  "uniform vec3 light;"
+  "uniform float height_divisor;"
+  "uniform float contour_divisor;"
+  "varying vec2 texcoordvar;"
+  "vec2 Fetch(vec2 pixel) {"
+  "  return floor(texture2D(heights, (pixel + 0.5) * texel).ra * 255. + 0.5);"
+  "}"
+  "bool IsSpecial(vec2 v) {"
+  "  return v.y >= 128.;"
+  "}"
+  "float Height(vec2 v) {"
+  "  return v.y * 256. + v.x;"
+  "}"
+  "float Contour(float h) {"
+  "  return min(254., floor(h / contour_divisor));"
+  "}"
+  "bool IsContour(vec2 v, float contour) {"
+  "  return !IsSpecial(v) && Contour(Height(v)) != contour;"
+  "}"
+  "vec3 Shade(vec3 color, float illum) {"
+  "  if (illum < 0.)"
+  "    return mix(color, vec3(0., 0., 64. / 255.), min(63., -illum) / 128.);"
+  "  else"
+  "    return mix(color, vec3(1., 1., 16. / 255.), min(32., illum / 2.) / 128.);"
+  "}"
+  "void main() {"
+  "  vec2 pixel = min(floor(texcoordvar / texel), size - 1.);"
+  "  vec2 v = Fetch(pixel);"
+  "  if (IsSpecial(v)) {"
+  "    gl_FragColor = v.y == 255."
+  "      ? texture2D(ramp, vec2(255.5 / 256., 0.5))"
+  "      : vec4(1.);"
+  "    return;"
+  "  }"
+  "  float h = Height(v);"
+  "  float index = min(254., floor(h / height_divisor));"
+  "  vec3 color = texture2D(ramp, vec2((index + 0.5) / 256., 0.5)).rgb;"
+  "  vec2 minus = min(vec2(quantisation), pixel);"
+  "  vec2 plus = min(vec2(quantisation), size - 1. - pixel);"
+  "  vec2 left = Fetch(pixel - vec2(minus.x, 0.));"
+  "  vec2 right = Fetch(pixel + vec2(plus.x, 0.));"
+  "  vec2 above = Fetch(pixel - vec2(0., minus.y));"
+  "  vec2 below = Fetch(pixel + vec2(0., plus.y));"
+  "  if (quantisation > 0. &&"
+  "      (IsSpecial(left) || IsSpecial(right) ||"
+  "       IsSpecial(above) || IsSpecial(below))) {"
+  "    gl_FragColor = vec4(color, 1.);"
+  "    return;"
+  "  }"
+  "  if (contour_divisor > 0.) {"
+  "    float contour = Contour(h);"
+  "    if ((pixel.x > 0. && IsContour(Fetch(pixel - vec2(1., 0.)), contour)) ||"
+  "        (pixel.y > 0. && IsContour(Fetch(pixel - vec2(0., 1.)), contour))) {"
+  "      gl_FragColor = vec4(mix(color, vec3(100., 70., 26.) / 255., 0.5), 1.);"
+  "      return;"
+  "    }"
+  "  }"
+  "  if (quantisation > 0.) {"
+  /* scale the normal vector by 1/32768 to keep its square small */
+  "    vec2 p = (plus + minus) / 64.;"
+  "    vec3 d = vec3(clamp(Height(right) - Height(left), -512., 512.) / 512. * p.y,"
+  "                  p.x * clamp(Height(above) - Height(below), -512., 512.) / 512.,"
+  "                  p.x * p.y * slope_factor / 8.);"
+  "    float illum = (dot(d, light) / length(d) - light.z) * contrast / 128.;"
+  "    color = Shade(color, clamp(illum, -63., 63.));"
+  "  }"
+  "  gl_FragColor = vec4(color, 1.);"
+  "}";
+
+#endif
+
 static void
 CompileAttachShader(GLProgram &program, GLenum type, const char *code)
 {
@@ -177,6 +281,70 @@ LinkProgram(GLProgram &program)
   }
 }
 
+#ifdef ENABLE_GLSL_TERRAIN
+
+/**
+ * Does the fragment shader support "highp" floats?
+ */
+static bool
+HaveFragmentHighPrecision()
+{
+#ifdef HAVE_GLES
+  GLint range[2], precision = 0;
+  glGetShaderPrecisionFormat(GL_FRAGMENT_SHADER, GL_HIGH_FLOAT,
+                             range, &precision);
+  return precision > 0;
+#else
+  return true;
+#endif
+}
+
+/**
+ * Create #terrain_shader.  It remains nullptr if the GPU cannot run
+ * it, and TerrainRenderer falls back to RasterRenderer.
+ */
+static void
+InitTerrainShader()
+{
+  using namespace OpenGL;
+
+  if (!HaveFragmentHighPrecision())
+    return;
+
+  terrain_shader = CompileProgram(terrain_vertex_shader,
+                                  terrain_fragment_shader);
+  terrain_shader->BindAttribLocation(Attribute::TRANSLATE, "translate");
+  terrain_shader->BindAttribLocation(Attribute::POSITION, "position");
+  terrain_shader->BindAttribLocation(Attribute::TEXCOORD, "texcoord");
+  LinkProgram(*terrain_shader);
+
+  if (terrain_shader->GetLinkStatus() != GL_TRUE) {
+    delete terrain_shader;
+    terrain_shader = nullptr;
+    return;
+  }
+
+  terrain_projection = terrain_shader->GetUniformLocation("projection");
+  terrain_heights = terrain_shader->GetUniformLocation("heights");
+  terrain_ramp = terrain_shader->GetUniformLocation("ramp");
+  terrain_texel = terrain_shader->GetUniformLocation("texel");
+  terrain_size = terrain_shader->GetUniformLocation("size");
+  terrain_quantisation = terrain_shader->GetUniformLocation("quantisation");
+  terrain_slope_factor = terrain_shader->GetUniformLocation("slope_factor");
+  terrain_contrast = terrain_shader->GetUniformLocation("contrast");
+  terrain_light = terrain_shader->GetUniformLocation("light");
+  terrain_height_divisor =
+    terrain_shader->GetUniformLocation("height_divisor");
+  terrain_contour_divisor =
+    terrain_shader->GetUniformLocation("contour_divisor");
+
+  terrain_shader->Use();
+  glUniform1i(terrain_heights, 0);
+  glUniform1i(terrain_ramp, 1);
+}
+
+#endif
+
 void
 OpenGL::InitShaders()
 {
@@ -248,6 +416,10 @@ OpenGL::InitShaders()
   combine_texture_shader->Use();
   glUniform1i(combine_texture_texture, 0);
 
+#ifdef ENABLE_GLSL_TERRAIN
+  InitTerrainShader();
+#endif
+
   glVertexAttrib4f(Attribute::TRANSLATE, 0, 0, 0, 0);
 }
 
@@ -256,6 +428,11 @@ OpenGL::DeinitShaders()
 {
   delete solid_shader;
   solid_shader = nullptr;
+
+#ifdef ENABLE_GLSL_TERRAIN
+  delete terrain_shader;
+  terrain_shader = nullptr;
+#endif
 }
 
 void
@@ -280,4 +457,12 @@ OpenGL::UpdateShaderProjectionMatrix()
   combine_texture_shader->Use();
   glUniformMatrix4fv(combine_texture_projection, 1, GL_FALSE,
                      glm::value_ptr(projection_matrix));
+
+#ifdef ENABLE_GLSL_TERRAIN
+  if (terrain_shader != nullptr) {
+    terrain_shader->Use();
+    glUniformMatrix4fv(terrain_projection, 1, GL_FALSE,
+                       glm::value_ptr(projection_matrix));
+  }
+#endif
 }
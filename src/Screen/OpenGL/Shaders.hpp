@@ -61,6 +61,19 @@ namespace OpenGL {
   extern GLProgram *combine_texture_shader;
   extern GLint combine_texture_projection, combine_texture_texture;
 
+#ifdef ENABLE_GLSL_TERRAIN
+  /**
+   * A shader that renders terrain from a height texture, see class
+   * TerrainTexture.  This is nullptr if the GPU does not support
+   * it.
+   */
+  extern GLProgram *terrain_shader;
+  extern GLint terrain_projection, terrain_heights, terrain_ramp;
+  extern GLint terrain_texel, terrain_size;
+  extern GLint terrain_quantisation, terrain_slope_factor, terrain_contrast;
+  extern GLint terrain_light, terrain_height_divisor, terrain_contour_divisor;
+#endif
+
   void InitShaders();
   void DeinitShaders();
 
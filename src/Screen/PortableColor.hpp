@@ -198,6 +198,18 @@ public:
   constexpr uint16_t GetNativeValue() const {
     return value;
   }
+
+  constexpr uint8_t Red() const {
+    return (value >> 8) & 0xf8;
+  }
+
+  constexpr uint8_t Green() const {
+    return (value >> 3) & 0xfc;
+  }
+
+  constexpr uint8_t Blue() const {
+    return (value << 3) & 0xf8;
+  }
 };
 
 class Luminosity8 {
@@ -161,6 +161,18 @@ public:
 #endif
   }
 
+  /**
+   * Returns a pointer to the specified row, 0 being the top-most
+   * one.
+   */
+  RawColor *GetRow(unsigned y) {
+#ifndef USE_GDI
+    return GetBuffer() + y * corrected_width;
+#else
+    return GetBuffer() + (height - 1 - y) * corrected_width;
+#endif
+  }
+
   /**
    * Returns a pointer to the row below the current one.
    */
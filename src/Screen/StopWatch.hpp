@@ -24,6 +24,8 @@ Copyright_License {
 #ifndef XCSOAR_SCREEN_STOP_WATCH_HPP
 #define XCSOAR_SCREEN_STOP_WATCH_HPP
 
+#include "OS/Profiler.hpp"
+
 #ifdef STOP_WATCH
 
 #include "Util/StaticArray.hxx"
@@ -44,10 +46,14 @@ Copyright_License {
 
 /**
  * A stop watch which measures the time needed to perform an
- * operation, and writes it to the log file.  It is a no-op if the
- * macro STOP_WATCH is not defined.
+ * operation, and writes it to the log file.  The log output is a
+ * no-op if the macro STOP_WATCH is not defined.  Independent of that,
+ * each section is recorded by the #Profiler (on the "draw" track)
+ * while it is enabled.
  */
 class ScreenStopWatch {
+  ProfilerMarks profiler_marks{Profiler::Track::DRAW};
+
 #ifdef STOP_WATCH
   typedef uint64_t clock_stamp_t;
   typedef uint64_t cpu_stamp_t;
@@ -126,6 +132,7 @@ public:
   void Mark(const char *text) {
     FlushScreen();
     markers.append().Set(text);
+    profiler_marks.Mark(text);
   }
 
   void Finish() {
@@ -133,6 +140,7 @@ public:
       return;
 
     FlushScreen();
+    profiler_marks.Finish();
     markers.append().Set(nullptr);
 
     for (unsigned i = 0; markers[i + 1].text != nullptr; ++i) {
@@ -155,8 +163,13 @@ public:
 
 #else /* !STOP_WATCH */
 public:
-  void Mark(const char *text) {}
-  void Finish() {}
+  void Mark(const char *text) {
+    profiler_marks.Mark(text);
+  }
+
+  void Finish() {
+    profiler_marks.Finish();
+  }
 #endif /* !STOP_WATCH */
 };
 
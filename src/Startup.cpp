@@ -40,6 +40,7 @@ Copyright_License {
 #include "Language/Language.hpp"
 #include "Protection.hpp"
 #include "LogFile.hpp"
+#include "ProfilerGlue.hpp"
 #include "UtilsSystem.hpp"
 #include "FLARM/Glue.hpp"
 #include "Logger/Logger.hpp"
@@ -332,7 +333,7 @@ Startup()
 
   // Read the topography file(s)
   topography = new TopographyStore();
-  LoadConfiguredTopography(*topography, operation);
+  LoadConfiguredTopography(*topography, operation, file_cache);
 
   // Read the waypoint files
   WaypointGlue::LoadWaypoints(way_points, terrain, operation);
@@ -495,6 +496,7 @@ Shutdown()
   main_window->BeginShutdown();
 
   StartupLogFreeRamAndStorage();
+  LogAllocationStatistics();
 
   Lua::StopAllBackground();
 
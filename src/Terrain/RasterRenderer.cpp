@@ -33,6 +33,10 @@ Copyright_License {
 #include "Projection/WindowProjection.hpp"
 #include "Asset.hpp"
 #include "Event/Idle.hpp"
+#include "Thread/WorkerPool.hpp"
+
+#include <algorithm>
+#include <memory>
 
 #include <assert.h>
 #include <stdint.h>
@@ -113,6 +117,7 @@ RasterRenderer::~RasterRenderer()
   delete[] color_table;
   delete image;
   delete[] contour_column_base;
+  delete worker_pool;
 }
 
 #ifdef ENABLE_OPENGL
@@ -235,15 +240,154 @@ RasterRenderer::GenerateImage(bool do_shading,
   image->SetDirty();
 }
 
+/**
+ * A marker for "no contour interval", used while splitting the image
+ * into bands.  ContourInterval() never returns this value.
+ */
+static constexpr unsigned char NO_CONTOUR = 0xff;
+
+/**
+ * Split the height matrix into bands of rows and render them in
+ * parallel.
+ *
+ * The contour detection carries state from one row to the next: the
+ * contour interval of the last pixel in each column which took part
+ * in it.  To obtain exactly the same image as a sequential pass,
+ * each band first determines this state for its bottom row (which
+ * is cheap, because usually the last row decides every column), and
+ * then the initial state of each band is propagated from the band
+ * above it.
+ *
+ * @param contour_column_base the state for the top row (initialised
+ * by ContourStart())
+ * @param get_interval a function (x, y) returning the contour
+ * interval of a pixel, or #NO_CONTOUR if the pixel does not take
+ * part in contour detection
+ * @param render a function (y_start, y_end, column_base) rendering a
+ * range of rows
+ */
+template<typename G, typename R>
+static void
+RenderBands(WorkerPool &pool, unsigned width, unsigned height,
+            const unsigned char *contour_column_base,
+            G &&get_interval, R &&render)
+{
+  /* more bands than threads to balance the load; the cost of a row
+     varies a lot (water, special values) */
+  static constexpr unsigned MIN_BAND_ROWS = 16;
+  const unsigned n_bands = pool.GetConcurrency() > 1
+    ? Clamp(height / MIN_BAND_ROWS, 1u, pool.GetConcurrency() * 4)
+    : 1u;
+
+  const auto band_start = [height, n_bands](unsigned band){
+    return height * band / n_bands;
+  };
+
+  /* the contour state after each band's bottom row, or NO_CONTOUR if
+     the band does not change a column */
+  std::unique_ptr<unsigned char[]> last(new unsigned char[n_bands * width]);
+  pool.Run(n_bands - 1, [&](unsigned band){
+      unsigned char *const l = last.get() + band * width;
+      std::fill_n(l, width, NO_CONTOUR);
+
+      unsigned unresolved = width;
+      const unsigned y_start = band_start(band);
+      for (unsigned y = band_start(band + 1); unresolved > 0 && y > y_start;) {
+        --y;
+        for (unsigned x = 0; x < width; ++x) {
+          if (l[x] != NO_CONTOUR)
+            continue;
+
+          const unsigned char interval = get_interval(x, y);
+          if (interval != NO_CONTOUR) {
+            l[x] = interval;
+            --unresolved;
+          }
+        }
+      }
+    });
+
+  /* propagate the state from top to bottom */
+  std::unique_ptr<unsigned char[]> base(new unsigned char[n_bands * width]);
+  std::copy_n(contour_column_base, width, base.get());
+  for (unsigned band = 1; band < n_bands; ++band) {
+    const unsigned char *const previous = base.get() + (band - 1) * width;
+    const unsigned char *const l = last.get() + (band - 1) * width;
+    unsigned char *const b = base.get() + band * width;
+    for (unsigned x = 0; x < width; ++x)
+      b[x] = l[x] != NO_CONTOUR ? l[x] : previous[x];
+  }
+
+  pool.Run(n_bands, [&](unsigned band){
+      render(band_start(band), band_start(band + 1),
+             base.get() + band * width);
+    });
+}
+
+/**
+ * The threads shared by all #RasterRenderer instances which were not
+ * given their own (see RasterRenderer::SetWorkers()).  Created on
+ * demand.
+ */
+static WorkerPool &
+GetSharedWorkerPool()
+{
+  static WorkerPool pool(WorkerPool::GetDefaultWorkers());
+  return pool;
+}
+
+inline WorkerPool &
+RasterRenderer::GetWorkerPool()
+{
+  return worker_pool != nullptr
+    ? *worker_pool
+    : GetSharedWorkerPool();
+}
+
+void
+RasterRenderer::SetWorkers(unsigned n_workers)
+{
+  delete worker_pool;
+  worker_pool = new WorkerPool(n_workers);
+}
+
 void
 RasterRenderer::GenerateUnshadedImage(unsigned height_scale,
                                       const unsigned contour_height_scale)
 {
-  const auto *src = height_matrix.GetData();
+  const unsigned width = height_matrix.GetWidth();
+  const auto *const data = height_matrix.GetData();
+
+  const auto get_interval = [=](unsigned x, unsigned y) -> unsigned char {
+    const auto e = data[y * width + x];
+    if (e.IsSpecial())
+      return NO_CONTOUR;
+
+    return ContourInterval(unsigned(std::max(0, (int)e.GetValue())),
+                           contour_height_scale);
+  };
+
+  const auto render = [=](unsigned y_start, unsigned y_end,
+                          unsigned char *column_base){
+    GenerateUnshadedRows(y_start, y_end, column_base,
+                         height_scale, contour_height_scale);
+  };
+
+  RenderBands(GetWorkerPool(), width, height_matrix.GetHeight(),
+              contour_column_base, get_interval, render);
+}
+
+void
+RasterRenderer::GenerateUnshadedRows(unsigned y_start, unsigned y_end,
+                                     unsigned char *contour_column_base,
+                                     unsigned height_scale,
+                                     const unsigned contour_height_scale)
+{
+  const auto *src = height_matrix.GetData() + y_start * height_matrix.GetWidth();
   const RawColor *oColorBuf = color_table + 64 * 256;
-  RawColor *dest = image->GetTopRow();
+  RawColor *dest = image->GetRow(y_start);
 
-  for (unsigned y = height_matrix.GetHeight(); y > 0; --y) {
+  for (unsigned y = y_start; y < y_end; ++y) {
     RawColor *p = dest;
     dest = image->GetNextRow(dest);
 
@@ -300,6 +444,61 @@ ClipHeightDelta(TerrainHeight a, TerrainHeight b)
   return ClipHeightDelta(a.GetValue() - b.GetValue());
 }
 
+/**
+ * The offsets of the neighbours of a pixel used for the slope
+ * calculation.
+ */
+class SlopeNeighbours {
+  const unsigned width, height;
+  const unsigned quantisation_effective;
+
+  PixelRect border;
+
+public:
+  SlopeNeighbours(unsigned _width, unsigned _height,
+                  unsigned _quantisation_effective)
+    :width(_width), height(_height),
+     quantisation_effective(_quantisation_effective) {
+    border.left = quantisation_effective;
+    border.top = quantisation_effective;
+    border.right = width - quantisation_effective;
+    border.bottom = height - quantisation_effective;
+  }
+
+  unsigned RowPlusIndex(unsigned y) const {
+    return y < (unsigned)border.bottom
+      ? quantisation_effective
+      : height - 1 - y;
+  }
+
+  unsigned RowMinusIndex(unsigned y) const {
+    return y >= quantisation_effective
+      ? quantisation_effective : y;
+  }
+
+  unsigned ColumnPlusIndex(unsigned x) const {
+    return x < (unsigned)border.right
+      ? quantisation_effective
+      : width - 1 - x;
+  }
+
+  unsigned ColumnMinusIndex(unsigned x) const {
+    return x >= (unsigned)border.left
+      ? quantisation_effective : x;
+  }
+
+  /**
+   * Are all four neighbours of the pixel regular terrain heights?
+   */
+  gcc_pure
+  bool AreRegular(const TerrainHeight *src, unsigned x, unsigned y) const {
+    return !src[-int(width * RowMinusIndex(y))].IsSpecial() &&
+      !src[width * RowPlusIndex(y)].IsSpecial() &&
+      !src[-(int)ColumnMinusIndex(x)].IsSpecial() &&
+      !src[ColumnPlusIndex(x)].IsSpecial();
+  }
+};
+
 // JMW: if zoomed right in (e.g. one unit is larger than terrain
 // grid), then increase the step size to be equal to the terrain
 // grid for purposes of calculating slope, to avoid shading problems
@@ -313,11 +512,43 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
 {
   assert(quantisation_effective > 0);
 
-  PixelRect border;
-  border.left = quantisation_effective;
-  border.top = quantisation_effective;
-  border.right = height_matrix.GetWidth() - quantisation_effective;
-  border.bottom = height_matrix.GetHeight() - quantisation_effective;
+  const unsigned width = height_matrix.GetWidth();
+  const auto *const data = height_matrix.GetData();
+  const SlopeNeighbours neighbours(width, height_matrix.GetHeight(),
+                                   quantisation_effective);
+
+  const auto get_interval = [=, &neighbours](unsigned x,
+                                             unsigned y) -> unsigned char {
+    const auto *src = data + y * width + x;
+    const auto e = *src;
+    if (e.IsSpecial() || !neighbours.AreRegular(src, x, y))
+      return NO_CONTOUR;
+
+    return ContourInterval(unsigned(std::max(0, (int)e.GetValue())),
+                           contour_height_scale);
+  };
+
+  const auto render = [=](unsigned y_start, unsigned y_end,
+                          unsigned char *column_base){
+    GenerateSlopeRows(y_start, y_end, column_base,
+                      height_scale, contrast, sx, sy, sz,
+                      contour_height_scale);
+  };
+
+  RenderBands(GetWorkerPool(), width, height_matrix.GetHeight(),
+              contour_column_base, get_interval, render);
+}
+
+void
+RasterRenderer::GenerateSlopeRows(unsigned y_start, unsigned y_end,
+                                  unsigned char *contour_column_base,
+                                  unsigned height_scale, int contrast,
+                                  const int sx, const int sy, const int sz,
+                                  const unsigned contour_height_scale)
+{
+  const SlopeNeighbours neighbours(height_matrix.GetWidth(),
+                                   height_matrix.GetHeight(),
+                                   quantisation_effective);
 
   const unsigned height_slope_factor =
     Clamp((unsigned)pixel_size, 1u,
@@ -326,19 +557,16 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
              square will not overflow */
           8192u / (quantisation_effective * quantisation_effective));
 
-  const auto *src = height_matrix.GetData();
+  const auto *src = height_matrix.GetData() + y_start * height_matrix.GetWidth();
   const RawColor *oColorBuf = color_table + 64 * 256;
 
-  RawColor *dest = image->GetTopRow();
+  RawColor *dest = image->GetRow(y_start);
 
-  for (unsigned y = 0; y < height_matrix.GetHeight(); ++y) {
-    const unsigned row_plus_index = y < (unsigned)border.bottom
-      ? quantisation_effective
-      : height_matrix.GetHeight() - 1 - y;
+  for (unsigned y = y_start; y < y_end; ++y) {
+    const unsigned row_plus_index = neighbours.RowPlusIndex(y);
     const unsigned row_plus_offset = height_matrix.GetWidth() * row_plus_index;
 
-    const unsigned row_minus_index = y >= quantisation_effective
-      ? quantisation_effective : y;
+    const unsigned row_minus_index = neighbours.RowMinusIndex(y);
     const unsigned row_minus_offset = height_matrix.GetWidth() * row_minus_index;
 
     const unsigned p31 = row_plus_index + row_minus_index;
@@ -369,11 +597,8 @@ RasterRenderer::GenerateSlopeImage(unsigned height_scale,
 
         // X direction
 
-        const unsigned column_plus_index = x < (unsigned)border.right
-          ? quantisation_effective
-          : height_matrix.GetWidth() - 1 - x;
-        const unsigned column_minus_index = x >= (unsigned)border.left
-          ? quantisation_effective : x;
+        const unsigned column_plus_index = neighbours.ColumnPlusIndex(x);
+        const unsigned column_minus_index = neighbours.ColumnMinusIndex(x);
 
         assert(src - column_minus_index >= height_matrix.GetData());
         assert(src + column_plus_index >= height_matrix.GetData());
@@ -37,6 +37,7 @@ class Canvas;
 class RasterMap;
 class WindowProjection;
 class RawBitmap;
+class WorkerPool;
 struct RawColor;
 struct ColorRamp;
 
@@ -80,6 +81,13 @@ class RasterRenderer {
 
   RawColor *color_table = nullptr;
 
+  /**
+   * The threads which render the image in bands of rows, if this
+   * instance has its own (see SetWorkers()).  By default, all
+   * instances share one pool (see GetWorkerPool()).
+   */
+  WorkerPool *worker_pool = nullptr;
+
 public:
   RasterRenderer();
   ~RasterRenderer();
@@ -99,6 +107,21 @@ public:
     return height_matrix.GetHeight();
   }
 
+  /**
+   * The slope step size determined by ScanMap(); 0 if slope shading
+   * is disabled at the current zoom level.
+   */
+  unsigned GetQuantisationEffective() const {
+    return quantisation_effective;
+  }
+
+  /**
+   * The edge length of one pixel in metres, determined by ScanMap().
+   */
+  double GetPixelSize() const {
+    return pixel_size;
+  }
+
 #ifdef ENABLE_OPENGL
   void Invalidate() {
     bounds.SetInvalid();
@@ -140,6 +163,16 @@ public:
                      const Angle sunazimuth,
                      bool do_contour);
 
+  /**
+   * Render the image with a private pool of the given number of
+   * worker threads (in addition to the calling thread).  With zero
+   * workers, the image is rendered in one sequential pass.  By
+   * default, all instances share one pool with
+   * WorkerPool::GetDefaultWorkers() threads; renderers in different
+   * threads then take turns.
+   */
+  void SetWorkers(unsigned n_workers);
+
   const RawBitmap &GetImage() const {
     return *image;
   }
@@ -170,6 +203,32 @@ protected:
                           const unsigned contour_height_scale);
 
 private:
+  WorkerPool &GetWorkerPool();
+
+  /**
+   * Render a range of rows without shading.  This may be called from
+   * several threads at a time, for distinct row ranges.
+   *
+   * @param contour_column_base the contour state of each column;
+   * will be modified
+   */
+  void GenerateUnshadedRows(unsigned y_start, unsigned y_end,
+                            unsigned char *contour_column_base,
+                            unsigned height_scale,
+                            const unsigned contour_height_scale);
+
+  /**
+   * Render a range of rows with slope shading.  This may be called
+   * from several threads at a time, for distinct row ranges.
+   *
+   * @param contour_column_base the contour state of each column;
+   * will be modified
+   */
+  void GenerateSlopeRows(unsigned y_start, unsigned y_end,
+                         unsigned char *contour_column_base,
+                         unsigned height_scale, int contrast,
+                         const int sx, const int sy, const int sz,
+                         const unsigned contour_height_scale);
 
   void ContourStart(const unsigned contour_height_scale);
 };
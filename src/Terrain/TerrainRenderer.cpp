@@ -316,6 +316,17 @@ bool
 TerrainRenderer::Generate(const WindowProjection &map_projection,
                           const Angle sunazimuth)
 {
+  const bool do_water = true;
+  const unsigned height_scale = 4;
+  const int interp_levels = 2;
+  const bool is_terrain = true;
+  const bool do_shading = is_terrain &&
+                          settings.slope_shading != SlopeShading::OFF;
+  const bool do_contour = is_terrain &&
+                          settings.contours != Contours::OFF;
+
+  const ColorRamp *const color_ramp = &terrain_colors[settings.ramp][0];
+
 #ifdef ENABLE_OPENGL
   const GeoBounds &old_bounds = raster_renderer.GetBounds();
   GeoBounds new_bounds = map_projection.GetScreenBounds();
@@ -328,6 +339,41 @@ TerrainRenderer::Generate(const WindowProjection &map_projection,
       return false;
   }
 
+#ifdef ENABLE_GLSL_TERRAIN
+  if (TerrainTexture::IsAvailable()) {
+    /* the shader applies the color ramp and the shading parameters;
+       changing them does not require scanning the map again */
+    if (color_ramp != last_color_ramp) {
+      texture.SetColorRamp(color_ramp, do_water, height_scale,
+                           interp_levels);
+      last_color_ramp = color_ramp;
+    }
+
+    if (!old_bounds.IsValid() || !old_bounds.IsInside(new_bounds) ||
+        IsLargeSizeDifference(old_bounds, new_bounds) ||
+        terrain_serial != terrain.GetSerial() ||
+        raster_renderer.UpdateQuantisation()) {
+      terrain_serial = terrain.GetSerial();
+
+      {
+        RasterTerrain::Lease map(terrain);
+        raster_renderer.ScanMap(map, map_projection);
+      }
+
+      texture.SetHeights(raster_renderer.GetHeightMatrix(),
+                         raster_renderer.GetBounds());
+    }
+
+    last_sun_azimuth = sunazimuth;
+    texture.SetShading(raster_renderer.GetQuantisationEffective(),
+                       raster_renderer.GetPixelSize(),
+                       do_shading, height_scale,
+                       settings.contrast, settings.brightness,
+                       sunazimuth, do_contour);
+    return true;
+  }
+#endif
+
   if (old_bounds.IsValid() && old_bounds.IsInside(new_bounds) &&
       !IsLargeSizeDifference(old_bounds, new_bounds) &&
       terrain_serial == terrain.GetSerial() &&
@@ -350,16 +396,6 @@ TerrainRenderer::Generate(const WindowProjection &map_projection,
 
   last_sun_azimuth = sunazimuth;
 
-  const bool do_water = true;
-  const unsigned height_scale = 4;
-  const int interp_levels = 2;
-  const bool is_terrain = true;
-  const bool do_shading = is_terrain &&
-                          settings.slope_shading != SlopeShading::OFF;
-  const bool do_contour = is_terrain &&
-                          settings.contours != Contours::OFF;
-
-  const ColorRamp *const color_ramp = &terrain_colors[settings.ramp][0];
   if (color_ramp != last_color_ramp) {
     raster_renderer.PrepareColorTable(color_ramp, do_water,
                                       height_scale, interp_levels);
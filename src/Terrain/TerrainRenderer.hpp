@@ -28,6 +28,10 @@ Copyright_License {
 #include "Util/Serial.hpp"
 #include "Terrain/TerrainSettings.hpp"
 
+#ifdef ENABLE_GLSL_TERRAIN
+#include "TerrainTexture.hpp"
+#endif
+
 #ifndef ENABLE_OPENGL
 #include "Projection/CompareProjection.hpp"
 #endif
@@ -55,6 +59,15 @@ protected:
 
   RasterRenderer raster_renderer;
 
+#ifdef ENABLE_GLSL_TERRAIN
+  /**
+   * Shades the #HeightMatrix on the GPU if
+   * TerrainTexture::IsAvailable(); the #RasterRenderer only scans
+   * the map then.
+   */
+  TerrainTexture texture;
+#endif
+
 public:
   TerrainRenderer(const RasterTerrain &_terrain);
   ~TerrainRenderer() {}
@@ -90,6 +103,13 @@ public:
                 const Angle sunazimuth);
 
   void Draw(Canvas &canvas, const WindowProjection &projection) const {
+#ifdef ENABLE_GLSL_TERRAIN
+    if (TerrainTexture::IsAvailable()) {
+      texture.Draw(projection);
+      return;
+    }
+#endif
+
     raster_renderer.Draw(canvas, projection);
   }
 };
@@ -0,0 +1,296 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifdef ENABLE_GLSL_TERRAIN
+
+#include "TerrainTexture.hpp"
+#include "RasterRenderer.hpp"
+#include "HeightMatrix.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Screen/Ramp.hpp"
+#include "Screen/OpenGL/Texture.hpp"
+#include "Screen/OpenGL/VertexPointer.hpp"
+#include "Screen/OpenGL/BulkPoint.hpp"
+#include "Screen/OpenGL/Shaders.hpp"
+#include "Screen/OpenGL/Program.hpp"
+#include "Screen/Point.hpp"
+#include "Math/Angle.hpp"
+#include "Util/Clamp.hpp"
+
+#include <algorithm>
+
+/**
+ * The encoded value of a water pixel.  All "special" values have the
+ * high byte's most significant bit set; regular heights are clipped
+ * to 0..32767.
+ */
+static constexpr unsigned WATER = 0xff00;
+static constexpr unsigned INVALID = 0x8000;
+
+TerrainTexture::TerrainTexture()
+{
+  AddSurfaceListener(*this);
+}
+
+TerrainTexture::~TerrainTexture()
+{
+  RemoveSurfaceListener(*this);
+
+  delete height_texture;
+  delete ramp_texture;
+}
+
+bool
+TerrainTexture::IsAvailable()
+{
+  return OpenGL::terrain_shader != nullptr;
+}
+
+void
+TerrainTexture::SetHeights(const HeightMatrix &matrix,
+                           const GeoBounds &_bounds)
+{
+  width = matrix.GetWidth();
+  height = matrix.GetHeight();
+  bounds = _bounds;
+
+  heights.GrowDiscard(width * height * 2);
+
+  uint8_t *p = heights.begin();
+  for (const TerrainHeight *i = matrix.GetData(), *end = matrix.GetDataEnd();
+       i != end; ++i) {
+    unsigned value;
+    if (!i->IsSpecial())
+      value = std::max(0, (int)i->GetValue());
+    else if (i->IsWater())
+      value = WATER;
+    else
+      value = INVALID;
+
+    *p++ = value;
+    *p++ = value >> 8;
+  }
+
+  heights_dirty = true;
+}
+
+void
+TerrainTexture::SetColorRamp(const ColorRamp *color_ramp, bool do_water,
+                             unsigned height_scale, int interp_levels)
+{
+  uint8_t *p = ramp;
+  for (unsigned i = 0; i < 255; ++i) {
+    const RGB8Color color =
+      ColorRampLookup(i << height_scale, color_ramp,
+                      NUM_COLOR_RAMP_LEVELS, interp_levels);
+    *p++ = color.Red();
+    *p++ = color.Green();
+    *p++ = color.Blue();
+  }
+
+  if (do_water) {
+    // water colours
+    *p++ = 85;
+    *p++ = 160;
+    *p++ = 255;
+  } else
+    std::fill_n(p, 3, 0xff);
+
+  ramp_dirty = true;
+}
+
+void
+TerrainTexture::SetShading(unsigned quantisation_effective, double pixel_size,
+                           bool do_shading, unsigned height_scale,
+                           int _contrast, int brightness,
+                           Angle sunazimuth, bool do_contour)
+{
+  if (quantisation_effective == 0) {
+    do_shading = false;
+    do_contour = false;
+  }
+
+  if (do_shading) {
+    const unsigned q = quantisation_effective;
+    quantisation = q;
+    slope_factor = Clamp((unsigned)pixel_size, 1u, 8192u / (q * q));
+  } else {
+    quantisation = 0;
+    slope_factor = 1;
+  }
+
+  contrast = _contrast;
+
+  const Angle fudgeelevation = Angle::Degrees(10) +
+    Angle::Degrees(80.0 / 255.0) * brightness;
+
+  light[0] = 255 * fudgeelevation.fastcosine() * -sunazimuth.fastsine();
+  light[1] = 255 * fudgeelevation.fastcosine() * -sunazimuth.fastcosine();
+  light[2] = 255 * fudgeelevation.fastsine();
+
+  height_divisor = 1u << height_scale;
+  contour_divisor = do_contour ? 1u << (height_scale * 2) : 0;
+}
+
+void
+TerrainTexture::Upload() const
+{
+  if (heights_dirty) {
+    const PixelSize size(width, height);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (height_texture == nullptr || height_texture->GetSize() != size) {
+      delete height_texture;
+      height_texture = new GLTexture(GL_LUMINANCE_ALPHA, size,
+                                     GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE,
+                                     heights.begin());
+
+      /* the shader decodes the exact texel values; interpolation
+         would mix the high and low bytes of neighbouring heights */
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    } else {
+      height_texture->Bind();
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height,
+                      GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, heights.begin());
+    }
+
+    heights_dirty = false;
+  }
+
+  if (ramp_dirty) {
+    if (ramp_texture == nullptr) {
+      ramp_texture = new GLTexture(GL_RGB, PixelSize(256, 1),
+                                   GL_RGB, GL_UNSIGNED_BYTE, ramp);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    } else {
+      ramp_texture->Bind();
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 1,
+                      GL_RGB, GL_UNSIGNED_BYTE, ramp);
+    }
+
+    ramp_dirty = false;
+  }
+}
+
+void
+TerrainTexture::Draw(const WindowProjection &projection) const
+{
+  if (!bounds.IsValid() || !bounds.Overlaps(projection.GetScreenBounds()))
+    return;
+
+  const BulkPixelPoint corners[] = {
+    projection.GeoToScreen(bounds.GetNorthWest()),
+    projection.GeoToScreen(bounds.GetNorthEast()),
+    projection.GeoToScreen(bounds.GetSouthWest()),
+    projection.GeoToScreen(bounds.GetSouthEast()),
+  };
+
+  Draw(corners);
+}
+
+void
+TerrainTexture::Draw(const PixelRect &rc) const
+{
+  const BulkPixelPoint corners[] = {
+    BulkPixelPoint(rc.left, rc.top),
+    BulkPixelPoint(rc.right, rc.top),
+    BulkPixelPoint(rc.left, rc.bottom),
+    BulkPixelPoint(rc.right, rc.bottom),
+  };
+
+  Draw(corners);
+}
+
+void
+TerrainTexture::Draw(const BulkPixelPoint *corners) const
+{
+  if (width == 0 || height == 0)
+    return;
+
+  Upload();
+
+  if (height_texture == nullptr || ramp_texture == nullptr)
+    /* SetColorRamp() has not been called yet */
+    return;
+
+  const ScopeVertexPointer vp(corners);
+
+  const PixelSize allocated = height_texture->GetAllocatedSize();
+  const GLfloat x1 = GLfloat(width) / allocated.cx;
+  const GLfloat y1 = GLfloat(height) / allocated.cy;
+
+  const GLfloat coord[] = {
+    0, 0,
+    x1, 0,
+    0, y1,
+    x1, y1,
+  };
+
+  OpenGL::terrain_shader->Use();
+  glUniform2f(OpenGL::terrain_texel,
+              1.f / allocated.cx, 1.f / allocated.cy);
+  glUniform2f(OpenGL::terrain_size, width, height);
+  glUniform1f(OpenGL::terrain_quantisation, quantisation);
+  glUniform1f(OpenGL::terrain_slope_factor, slope_factor);
+  glUniform1f(OpenGL::terrain_contrast, contrast);
+  glUniform3fv(OpenGL::terrain_light, 1, light);
+  glUniform1f(OpenGL::terrain_height_divisor, height_divisor);
+  glUniform1f(OpenGL::terrain_contour_divisor, contour_divisor);
+
+  glActiveTexture(GL_TEXTURE1);
+  ramp_texture->Bind();
+  glActiveTexture(GL_TEXTURE0);
+  height_texture->Bind();
+
+  glEnableVertexAttribArray(OpenGL::Attribute::TEXCOORD);
+  glVertexAttribPointer(OpenGL::Attribute::TEXCOORD, 2, GL_FLOAT, GL_FALSE,
+                        0, coord);
+
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+  glDisableVertexAttribArray(OpenGL::Attribute::TEXCOORD);
+  OpenGL::solid_shader->Use();
+}
+
+void
+TerrainTexture::SurfaceCreated()
+{
+}
+
+void
+TerrainTexture::SurfaceDestroyed()
+{
+  /* upload everything again when the new surface is used */
+  heights_dirty |= height_texture != nullptr;
+  delete height_texture;
+  height_texture = nullptr;
+
+  ramp_dirty |= ramp_texture != nullptr;
+  delete ramp_texture;
+  ramp_texture = nullptr;
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_TERRAIN_TEXTURE_HPP
+#define XCSOAR_TERRAIN_TEXTURE_HPP
+
+#include "Screen/OpenGL/Surface.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Util/AllocatedArray.hxx"
+#include "Compiler.h"
+
+#include <stdint.h>
+
+class Angle;
+class HeightMatrix;
+class WindowProjection;
+class GLTexture;
+struct ColorRamp;
+struct PixelRect;
+struct BulkPixelPoint;
+
+/**
+ * Renders the terrain on the GPU: the #HeightMatrix is uploaded to a
+ * texture, and a GLSL fragment shader calculates the slope shading,
+ * the contour lines and the color ramp lookup.  Changing the sun
+ * azimuth, the contrast, the brightness or the color ramp does not
+ * require a new texture upload.
+ *
+ * This is an experimental replacement for
+ * RasterRenderer::GenerateImage(), enabled with "make
+ * GLSL_TERRAIN=y".  The result is not pixel-identical; see
+ * TestTerrainTexture.
+ */
+class TerrainTexture final : GLSurfaceListener {
+  /** the dimensions of the height matrix */
+  unsigned width = 0, height = 0;
+
+  /** the area covered by the height matrix */
+  GeoBounds bounds = GeoBounds::Invalid();
+
+  /**
+   * The heights encoded for the texture: two bytes per pixel
+   * (luminance=low, alpha=high); see SetHeights().  Rows are padded
+   * to an even number of pixels.
+   */
+  AllocatedArray<uint8_t> heights;
+
+  /** the color ramp with 256 RGB entries; the last one is water */
+  uint8_t ramp[256 * 3];
+
+  /**
+   * The textures are created on demand by Upload().
+   */
+  mutable GLTexture *height_texture = nullptr, *ramp_texture = nullptr;
+
+  /**
+   * Have #heights or #ramp been modified, and need to be copied into
+   * the textures?
+   */
+  mutable bool heights_dirty = false, ramp_dirty = false;
+
+  /**
+   * The shader parameters, see SetShading().
+   */
+  float quantisation, slope_factor, contrast;
+  float light[3];
+  float height_divisor, contour_divisor;
+
+public:
+  TerrainTexture();
+  ~TerrainTexture();
+
+  TerrainTexture(const TerrainTexture &) = delete;
+  TerrainTexture &operator=(const TerrainTexture &) = delete;
+
+  /**
+   * Was the shader compiled successfully?  If not, the caller must
+   * fall back to #RasterRenderer.
+   */
+  gcc_pure
+  static bool IsAvailable();
+
+  const GeoBounds &GetBounds() const {
+    return bounds;
+  }
+
+  /**
+   * Copy the height matrix, which covers the given area.
+   */
+  void SetHeights(const HeightMatrix &matrix, const GeoBounds &bounds);
+
+  /**
+   * Calculate the color ramp.  The parameters are the same as in
+   * RasterRenderer::PrepareColorTable().
+   */
+  void SetColorRamp(const ColorRamp *color_ramp, bool do_water,
+                    unsigned height_scale, int interp_levels);
+
+  /**
+   * Set up the shading.  The parameters are the same as in
+   * RasterRenderer::GenerateImage().
+   *
+   * @param quantisation_effective the slope step size in pixels
+   * (RasterRenderer::GetQuantisationEffective()); 0 disables slope
+   * shading and contours
+   * @param pixel_size the edge length of one pixel in metres
+   */
+  void SetShading(unsigned quantisation_effective, double pixel_size,
+                  bool do_shading, unsigned height_scale,
+                  int contrast, int brightness, Angle sunazimuth,
+                  bool do_contour);
+
+  void Draw(const WindowProjection &projection) const;
+
+  /**
+   * Draw the whole height matrix into the given rectangle, north up.
+   */
+  void Draw(const PixelRect &rc) const;
+
+private:
+  void Upload() const;
+
+  /**
+   * @param corners the screen positions of the north-west,
+   * north-east, south-west and south-east corners
+   */
+  void Draw(const BulkPixelPoint *corners) const;
+
+  /* virtual methods from class GLSurfaceListener */
+  void SurfaceCreated() override;
+  void SurfaceDestroyed() override;
+};
+
+#endif
@@ -25,6 +25,7 @@ Copyright_License {
 #include "RasterTerrain.hpp"
 #include "Projection/WindowProjection.hpp"
 #include "Thread/Util.hpp"
+#include "OS/Profiler.hpp"
 
 TerrainThread::TerrainThread(RasterTerrain &_terrain,
                              std::function<void()> &&_callback)
@@ -54,6 +55,8 @@ TerrainThread::Tick()
 {
   SetIdlePriority(); // TODO: call only once
 
+  const ScopeProfiler profile(Profiler::Track::TERRAIN, "Tick");
+
   bool again = true;
   while (next_center.IsValid() && again && !IsStopped()) {
     const GeoPoint center = next_center;
@@ -61,6 +64,8 @@ TerrainThread::Tick()
 
     {
       const ScopeUnlock unlock(mutex);
+      const ScopeProfiler profile_tiles(Profiler::Track::TERRAIN,
+                                        "UpdateTiles");
       again = terrain.UpdateTiles(center, radius);
     }
 
@@ -0,0 +1,136 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "WorkerPool.hpp"
+
+#ifdef HAVE_POSIX
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+WorkerPool::WorkerPool(unsigned _n_workers)
+  :n_workers(_n_workers),
+   workers(new std::unique_ptr<Worker>[_n_workers])
+{
+  for (unsigned i = 0; i < n_workers; ++i) {
+    workers[i].reset(new Worker(*this, i));
+    workers[i]->Start();
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  mutex.Lock();
+  stop = true;
+  work_cond.broadcast();
+  mutex.Unlock();
+
+  for (unsigned i = 0; i < n_workers; ++i)
+    if (workers[i]->IsDefined())
+      workers[i]->Join();
+}
+
+unsigned
+WorkerPool::GetDefaultWorkers()
+{
+#ifdef HAVE_POSIX
+  const long n = sysconf(_SC_NPROCESSORS_ONLN);
+#else
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  const long n = info.dwNumberOfProcessors;
+#endif
+  return n > 1 ? unsigned(n - 1) : 0;
+}
+
+inline void
+WorkerPool::RunJobs(unsigned worker)
+{
+  while (next_job < n_jobs) {
+    const unsigned job = next_job++;
+    ++running;
+
+    try {
+      const ScopeUnlock unlock(mutex);
+      (*function)(job, worker);
+    } catch (...) {
+      if (!error)
+        error = std::current_exception();
+
+      /* skip the remaining jobs */
+      next_job = n_jobs;
+    }
+
+    if (--running == 0 && next_job >= n_jobs)
+      done_cond.broadcast();
+  }
+}
+
+void
+WorkerPool::Run(unsigned _n_jobs, const Function &f)
+{
+  RunPerWorker(_n_jobs, [&f](unsigned job, unsigned){
+      f(job);
+    });
+}
+
+void
+WorkerPool::RunPerWorker(unsigned _n_jobs, const WorkerFunction &f)
+{
+  const ScopeLock run_lock(run_mutex);
+  const ScopeLock lock(mutex);
+  assert(function == nullptr);
+
+  function = &f;
+  next_job = 0;
+  n_jobs = _n_jobs;
+  work_cond.broadcast();
+
+  /* the calling thread is the last worker */
+  RunJobs(n_workers);
+
+  while (running > 0)
+    done_cond.wait(mutex);
+
+  function = nullptr;
+
+  if (error) {
+    std::exception_ptr e = std::move(error);
+    error = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+void
+WorkerPool::WorkerRun(unsigned worker)
+{
+  const ScopeLock lock(mutex);
+
+  while (!stop) {
+    if (function != nullptr && next_job < n_jobs)
+      RunJobs(worker);
+    else
+      work_cond.wait(mutex);
+  }
+}
@@ -0,0 +1,164 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_THREAD_WORKER_POOL_HPP
+#define XCSOAR_THREAD_WORKER_POOL_HPP
+
+#include "Thread/Thread.hpp"
+#include "Thread/Mutex.hpp"
+#include "Cond.hxx"
+
+#include <exception>
+#include <functional>
+#include <memory>
+
+/**
+ * A fixed set of threads which execute a number of independent jobs
+ * in parallel.  The calling thread participates in the work, so a
+ * pool with zero threads simply runs all jobs sequentially.
+ */
+class WorkerPool {
+public:
+  typedef std::function<void(unsigned job)> Function;
+
+  /**
+   * A job function which also receives the index of the thread
+   * executing it, in the range [0..GetConcurrency()).
+   */
+  typedef std::function<void(unsigned job, unsigned worker)> WorkerFunction;
+
+private:
+  class Worker final : public Thread {
+    WorkerPool &pool;
+    const unsigned index;
+
+  public:
+    Worker(WorkerPool &_pool, unsigned _index)
+      :Thread("WorkerPool"), pool(_pool), index(_index) {}
+
+  protected:
+    void Run() override {
+      pool.WorkerRun(index);
+    }
+  };
+
+  /**
+   * Serialises callers of RunPerWorker(), which may be in different
+   * threads.
+   */
+  Mutex run_mutex;
+
+  Mutex mutex;
+
+  /**
+   * Signalled when a new batch of jobs is available, or when the
+   * pool shall be stopped.
+   */
+  Cond work_cond;
+
+  /**
+   * Signalled when the last job of the batch has been finished.
+   */
+  Cond done_cond;
+
+  const unsigned n_workers;
+  std::unique_ptr<std::unique_ptr<Worker>[]> workers;
+
+  const WorkerFunction *function = nullptr;
+
+  /**
+   * The job counter of the current batch.
+   */
+  unsigned next_job = 0, n_jobs = 0;
+
+  /**
+   * The number of jobs which have been started but not finished yet.
+   */
+  unsigned running = 0;
+
+  /**
+   * The first exception thrown by a job of the current batch.  It is
+   * rethrown by RunPerWorker().
+   */
+  std::exception_ptr error;
+
+  bool stop = false;
+
+public:
+  /**
+   * @param n_workers the number of threads in addition to the
+   * calling thread
+   */
+  explicit WorkerPool(unsigned n_workers);
+
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  /**
+   * Returns the number of threads which work on a batch of jobs,
+   * including the caller.
+   */
+  unsigned GetConcurrency() const {
+    return n_workers + 1;
+  }
+
+  /**
+   * Call the function once for each job index in the range
+   * [0..n_jobs) and return after all of them have finished.  If
+   * several threads call this method, their batches are executed one
+   * after another.
+   *
+   * If a job throws, the remaining jobs of the batch are skipped, and
+   * the exception is rethrown here after the running jobs have
+   * finished.
+   */
+  void Run(unsigned n_jobs, const Function &f);
+
+  /**
+   * Like Run(), but pass the worker index to the function.  Jobs
+   * which are executed by the same worker never run concurrently, so
+   * they can share per-worker state without locking.  Jobs are handed
+   * out one at a time, in ascending order, to whichever worker
+   * becomes idle first.
+   */
+  void RunPerWorker(unsigned n_jobs, const WorkerFunction &f);
+
+  /**
+   * Determine a sensible number of worker threads for this machine,
+   * i.e. one less than the number of CPU cores.
+   */
+  static unsigned GetDefaultWorkers();
+
+private:
+  /**
+   * Execute jobs of the current batch until there are no more.  The
+   * mutex must be locked.
+   */
+  void RunJobs(unsigned worker);
+
+  void WorkerRun(unsigned worker);
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "ThinningCache.hpp"
+#include "OS/FileMapping.hpp"
+
+#include <string.h>
+
+static constexpr uint32_t THINNING_CACHE_MAGIC = 0x7c41d0e3;
+
+struct ThinningCacheTrailer {
+  uint32_t magic;
+  uint32_t num_shapes;
+  uint32_t num_levels;
+
+  /**
+   * The size of the index buffer area in 16 bit words.
+   */
+  uint32_t data_size;
+
+  double scale_threshold;
+};
+
+static_assert(sizeof(ThinningCacheTrailer) == 24, "Unexpected padding");
+
+constexpr uint32_t ThinningCache::NO_INDICES;
+
+ThinningCache::ThinningCache()
+  :data(nullptr), offsets(nullptr), num_shapes(0), num_levels(0) {}
+
+ThinningCache::~ThinningCache() = default;
+
+void
+ThinningCache::Clear()
+{
+  mapping.reset();
+  data = nullptr;
+  offsets = nullptr;
+  num_shapes = num_levels = 0;
+}
+
+bool
+ThinningCache::Load(std::unique_ptr<FileMapping> &&_mapping, size_t offset,
+                    unsigned _num_shapes, unsigned _num_levels,
+                    double scale_threshold)
+{
+  Clear();
+
+  const size_t size = _mapping->size() - offset;
+  if (size < sizeof(ThinningCacheTrailer))
+    return false;
+
+  const uint8_t *payload = (const uint8_t *)_mapping->at(offset);
+
+  ThinningCacheTrailer trailer;
+  memcpy(&trailer, payload + size - sizeof(trailer), sizeof(trailer));
+  if (trailer.magic != THINNING_CACHE_MAGIC ||
+      trailer.num_shapes != _num_shapes ||
+      trailer.num_levels != _num_levels ||
+      trailer.scale_threshold != scale_threshold ||
+      trailer.data_size % 2 != 0)
+    return false;
+
+  const size_t n_offsets = size_t(_num_shapes) * _num_levels;
+  if (size != trailer.data_size * sizeof(uint16_t) +
+      n_offsets * sizeof(uint32_t) + sizeof(trailer))
+    return false;
+
+  const uint8_t *table = payload + trailer.data_size * sizeof(uint16_t);
+  if ((uintptr_t)table % alignof(uint32_t) != 0)
+    return false;
+
+  const uint32_t *_offsets = (const uint32_t *)table;
+  for (size_t i = 0; i < n_offsets; ++i)
+    if (_offsets[i] != NO_INDICES && _offsets[i] >= trailer.data_size)
+      return false;
+
+  mapping = std::move(_mapping);
+  data = (const uint16_t *)payload;
+  offsets = _offsets;
+  num_shapes = _num_shapes;
+  num_levels = _num_levels;
+  return true;
+}
+
+const uint16_t *
+ThinningCache::Get(unsigned shape, unsigned level) const
+{
+  if (shape >= num_shapes || level >= num_levels)
+    return nullptr;
+
+  const uint32_t offset = offsets[shape * num_levels + level];
+  return offset != NO_INDICES
+    ? data + offset
+    : nullptr;
+}
+
+void
+ThinningCache::Writer::Append(ConstBuffer<uint16_t> buffer)
+{
+  if (buffer.IsNull()) {
+    offsets.push_back(NO_INDICES);
+    return;
+  }
+
+  offsets.push_back(position);
+  position += buffer.size;
+
+  if (!error &&
+      fwrite(buffer.data, sizeof(buffer.data[0]), buffer.size,
+             file) != buffer.size)
+    error = true;
+}
+
+bool
+ThinningCache::Writer::Finish(unsigned num_shapes, unsigned num_levels,
+                              double scale_threshold)
+{
+  if (error || offsets.size() != size_t(num_shapes) * num_levels)
+    return false;
+
+  /* pad to 4 bytes to align the offset table */
+  if (position % 2 != 0) {
+    static constexpr uint16_t padding = 0;
+    if (fwrite(&padding, sizeof(padding), 1, file) != 1)
+      return false;
+    ++position;
+  }
+
+  ThinningCacheTrailer trailer;
+  trailer.magic = THINNING_CACHE_MAGIC;
+  trailer.num_shapes = num_shapes;
+  trailer.num_levels = num_levels;
+  trailer.data_size = position;
+  trailer.scale_threshold = scale_threshold;
+
+  return fwrite(offsets.data(), sizeof(offsets.front()), offsets.size(),
+                file) == offsets.size() &&
+    fwrite(&trailer, sizeof(trailer), 1, file) == 1;
+}
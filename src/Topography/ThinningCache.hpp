@@ -0,0 +1,130 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef TOPOGRAPHY_THINNING_CACHE_HPP
+#define TOPOGRAPHY_THINNING_CACHE_HPP
+
+#include "Util/ConstBuffer.hxx"
+
+#include <memory>
+#include <vector>
+
+#include <stdio.h>
+#include <stdint.h>
+
+class FileMapping;
+
+/**
+ * A sidecar file which contains the index lists of all shapes of one
+ * #TopographyFile for all thinning levels (see XShape::GetIndices()).
+ * It is generated once per shapefile, stored in the #FileCache and
+ * mapped into memory, so shapes which get loaded later do not need
+ * to build their indices on the drawing thread.
+ *
+ * File layout (after the #FileCache header): the index buffers of
+ * all shapes and levels, padded to a multiple of 4 bytes, followed
+ * by a table of 32 bit offsets (one per shape and level, measured in
+ * 16 bit words from the beginning of the payload) and a trailer.
+ */
+class ThinningCache {
+  std::unique_ptr<FileMapping> mapping;
+
+  const uint16_t *data;
+  const uint32_t *offsets;
+
+  unsigned num_shapes, num_levels;
+
+public:
+  /**
+   * The offset table entry for a shape/level without indices.
+   */
+  static constexpr uint32_t NO_INDICES = 0xffffffff;
+
+  ThinningCache();
+  ~ThinningCache();
+
+  ThinningCache(const ThinningCache &) = delete;
+  ThinningCache &operator=(const ThinningCache &) = delete;
+
+  bool IsDefined() const {
+    return data != nullptr;
+  }
+
+  /**
+   * Take over a mapped cache file (see FileCache::Map()).
+   *
+   * @param offset the offset of the payload within the mapping
+   * @param scale_threshold the TopographyFile's scale threshold; the
+   * cache is rejected if it was generated with a different one
+   * @return false if the file is malformed or does not match
+   */
+  bool Load(std::unique_ptr<FileMapping> &&_mapping, size_t offset,
+            unsigned num_shapes, unsigned num_levels,
+            double scale_threshold);
+
+  void Clear();
+
+  /**
+   * Returns the buffer (as built by XShape::BuildIndices()) of the
+   * given shape and thinning level, or nullptr if there is none.
+   */
+  const uint16_t *Get(unsigned shape, unsigned level) const;
+
+  /**
+   * Generates a new cache file.  Call Append() once for each shape
+   * and level (shape-major), then Finish().
+   */
+  class Writer {
+    FILE *const file;
+
+    std::vector<uint32_t> offsets;
+
+    /**
+     * The number of 16 bit words written so far.
+     */
+    uint32_t position;
+
+    bool error;
+
+  public:
+    explicit Writer(FILE *_file)
+      :file(_file), position(0), error(false) {}
+
+    /**
+     * @param buffer the index buffer; nullptr if this shape has no
+     * indices on this level
+     */
+    void Append(ConstBuffer<uint16_t> buffer);
+
+    /**
+     * Write the offset table and the trailer.
+     *
+     * @return false on I/O error
+     */
+    bool Finish(unsigned num_shapes, unsigned num_levels,
+                double scale_threshold);
+  };
+};
+
+#endif
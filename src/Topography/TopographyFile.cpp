@@ -26,9 +26,16 @@ Copyright_License {
 #include "Convert.hpp"
 #include "Projection/WindowProjection.hpp"
 
+#ifdef ENABLE_OPENGL
+#include "IO/FileCache.hpp"
+#include "OS/FileMapping.hpp"
+#include "Operation/Operation.hpp"
+#endif
+
 #include <zzip/lib.h>
 
 #include <algorithm>
+#include <memory>
 
 TopographyFile::TopographyFile(zzip_dir *_dir, const char *filename,
                                double _threshold,
@@ -97,11 +104,22 @@ TopographyFile::ClearCache()
   first = nullptr;
 }
 
-static XShape *
-LoadShape(shapefileObj *file, const GeoPoint &center, int i,
-          int label_field)
+XShape *
+TopographyFile::LoadShape(int i)
 {
-  return new XShape(file, center, i, label_field);
+  XShape *shape = new XShape(&file, center, i, label_field);
+
+#ifdef ENABLE_OPENGL
+  if (thinning_cache.IsDefined()) {
+    for (unsigned level = 0; level < XShape::THINNING_LEVELS; ++level) {
+      const uint16_t *buffer = thinning_cache.Get(i, level);
+      if (buffer != nullptr)
+        shape->SetIndexBuffer(level, buffer);
+    }
+  }
+#endif
+
+  return shape;
 }
 
 bool
@@ -169,7 +187,7 @@ TopographyFile::Update(const WindowProjection &map_projection)
         assert(*current != it);
 
         // shape isn't cached yet -> cache the shape
-        it->shape = LoadShape(&file, center, i, label_field);
+        it->shape = LoadShape(i);
         it->next = *current;
 
         /* insert into linked list (protected) */
@@ -198,7 +216,7 @@ TopographyFile::LoadAll()
   for (int i = 0; i < file.numshapes; ++i, ++it) {
     if (it->shape == nullptr)
       // shape isn't cached yet -> cache the shape
-      it->shape = LoadShape(&file, center, i, label_field);
+      it->shape = LoadShape(i);
     // update list pointer
     *current = it;
     current = &it->next;
@@ -250,4 +268,86 @@ TopographyFile::GetMinimumPointDistance(unsigned level) const
   return 1;
 }
 
+inline bool
+TopographyFile::MapThinningCache(FileCache &cache, const TCHAR *name,
+                                 Path original_path)
+{
+  size_t offset;
+  auto mapping = cache.Map(name, original_path, offset);
+  return mapping &&
+    thinning_cache.Load(std::move(mapping), offset, file.numshapes,
+                        XShape::THINNING_LEVELS, scale_threshold);
+}
+
+inline bool
+TopographyFile::SaveThinningCache(FileCache &cache, const TCHAR *name,
+                                  Path original_path,
+                                  OperationEnvironment &operation)
+{
+  FILE *f = cache.Save(name, original_path);
+  if (f == nullptr)
+    return false;
+
+  ThinningCache::Writer writer(f);
+
+  operation.SetProgressRange(file.numshapes);
+
+  for (int i = 0; i < file.numshapes; ++i) {
+    if (operation.IsCancelled()) {
+      cache.Cancel(name, f);
+      return false;
+    }
+
+    operation.SetProgressPosition(i);
+
+    std::unique_ptr<XShape> loaded;
+    const XShape *shape = shapes[i].shape;
+    if (shape == nullptr) {
+      loaded.reset(new XShape(&file, center, i));
+      shape = loaded.get();
+    }
+
+    const bool has_indices = shape->GetPoints() != nullptr &&
+      !shape->GetLines().IsEmpty() &&
+      (shape->get_type() == MS_SHAPE_LINE ||
+       shape->get_type() == MS_SHAPE_POLYGON);
+
+    for (unsigned level = 0; level < XShape::THINNING_LEVELS; ++level) {
+      /* lines are drawn without indices on level 0 (see
+         TopographyFileRenderer) */
+      if (!has_indices ||
+          (level == 0 && shape->get_type() == MS_SHAPE_LINE)) {
+        writer.Append(nullptr);
+        continue;
+      }
+
+      const ShapeScalar min_distance(GetMinimumPointDistance(level));
+      writer.Append(shape->GetIndexBuffer(level, min_distance));
+    }
+  }
+
+  if (!writer.Finish(file.numshapes, XShape::THINNING_LEVELS,
+                     scale_threshold)) {
+    cache.Cancel(name, f);
+    return false;
+  }
+
+  return cache.Commit(name, f);
+}
+
+void
+TopographyFile::LoadThinningCache(FileCache &cache, const TCHAR *name,
+                                  Path original_path,
+                                  OperationEnvironment &operation)
+{
+  if (IsEmpty())
+    return;
+
+  if (MapThinningCache(cache, name, original_path))
+    return;
+
+  if (SaveThinningCache(cache, name, original_path, operation))
+    MapThinningCache(cache, name, original_path);
+}
+
 #endif
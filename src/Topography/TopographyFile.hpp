@@ -35,12 +35,17 @@ Copyright_License {
 
 #ifdef ENABLE_OPENGL
 #include "XShapePoint.hpp"
+#include "ThinningCache.hpp"
 #endif
 
 #include <assert.h>
+#include <tchar.h>
 
 class WindowProjection;
 class XShape;
+class FileCache;
+class OperationEnvironment;
+class Path;
 struct zzip_dir;
 
 class TopographyFile {
@@ -103,6 +108,13 @@ class TopographyFile {
    */
   GeoBounds cache_bounds;
 
+#ifdef ENABLE_OPENGL
+  /**
+   * The precomputed indices of all shapes, see LoadThinningCache().
+   */
+  ThinningCache thinning_cache;
+#endif
+
 public:
   /**
    * Protects #serial, #shapes, #first.
@@ -275,6 +287,23 @@ public:
    */
   gcc_pure
   unsigned GetMinimumPointDistance(unsigned level) const;
+
+  /**
+   * Map the indices of all shapes and thinning levels from the
+   * #FileCache.  If there is no valid cache file, generate it first;
+   * this loads every shape once.  Shapes loaded after this call
+   * never need to build their indices while drawing.
+   *
+   * @param name the name of the cache file
+   * @param original_path the file this shapefile was loaded from; the
+   * cache is discarded when it gets modified
+   * @param operation receives the progress while the cache is being
+   * generated (one step per shape); generation is aborted when it
+   * gets cancelled
+   */
+  void LoadThinningCache(FileCache &cache, const TCHAR *name,
+                         Path original_path,
+                         OperationEnvironment &operation);
 #endif
 
   /**
@@ -289,6 +318,17 @@ public:
 
 protected:
   void ClearCache();
+
+private:
+  XShape *LoadShape(int i);
+
+#ifdef ENABLE_OPENGL
+  bool MapThinningCache(FileCache &cache, const TCHAR *name,
+                        Path original_path);
+  bool SaveThinningCache(FileCache &cache, const TCHAR *name,
+                         Path original_path,
+                         OperationEnvironment &operation);
+#endif
 };
 
 #endif
@@ -59,7 +59,7 @@ TopographyFileRenderer::TopographyFileRenderer(const TopographyFile &_file,
   :file(_file), look(_look),
    pen(Layout::ScaleFinePenWidth(file.GetPenWidth()), file.GetColor()),
 #ifdef ENABLE_OPENGL
-   array_buffer(nullptr)
+   array_buffer(nullptr), index_buffer(nullptr), index_dirty(true)
 #else
    brush(file.GetColor())
 #endif
@@ -79,6 +79,7 @@ TopographyFileRenderer::~TopographyFileRenderer()
   RemoveSurfaceListener(*this);
 
   delete array_buffer;
+  delete index_buffer;
 #endif
 }
 
@@ -95,6 +96,9 @@ TopographyFileRenderer::UpdateVisibleShapes(const WindowProjection &projection)
   visible_bounds = projection.GetScreenBounds().Scale(1.2);
   visible_shapes.clear();
   visible_labels.clear();
+#ifdef ENABLE_OPENGL
+  index_dirty = true;
+#endif
 
   for (const XShape &shape : file) {
     if (!visible_bounds.Overlaps(shape.get_bounds()))
@@ -144,6 +148,138 @@ TopographyFileRenderer::UpdateArrayBuffer()
   array_buffer->CommitWrite(n * sizeof(*p), p - n);
 }
 
+/**
+ * Append a triangle strip to another one, separated by degenerate
+ * triangles.
+ */
+static void
+AppendTriangleStrip(std::vector<GLushort> &dest, unsigned base,
+                    const GLushort *src, unsigned n)
+{
+  if (n == 0)
+    return;
+
+  if (!dest.empty()) {
+    dest.push_back(dest.back());
+    dest.push_back(base + src[0]);
+  }
+
+  for (unsigned i = 0; i < n; ++i)
+    dest.push_back(base + src[i]);
+}
+
+/**
+ * Append the segments of a line strip to a GL_LINES index list.
+ */
+static void
+AppendLineStrip(std::vector<GLushort> &dest, unsigned base,
+                const GLushort *src, unsigned n)
+{
+  for (unsigned i = 1; i < n; ++i) {
+    dest.push_back(base + src[i - 1]);
+    dest.push_back(base + src[i]);
+  }
+}
+
+static void
+AppendLineStrip(std::vector<GLushort> &dest, unsigned first, unsigned n)
+{
+  for (unsigned i = 1; i < n; ++i) {
+    dest.push_back(first + i - 1);
+    dest.push_back(first + i);
+  }
+}
+
+inline void
+TopographyFileRenderer::UpdateIndexBuffer(unsigned level,
+                                          ShapeScalar min_distance)
+{
+  if (index_buffer == nullptr)
+    index_buffer = new GLFallbackElementArrayBuffer();
+  else if (!index_dirty && level == index_level)
+    return;
+
+  index_dirty = false;
+  index_level = level;
+  index_batches.clear();
+
+  std::vector<GLushort> indices, polygons, lines;
+  unsigned base = 0;
+
+  const auto flush = [&](){
+    if (polygons.empty() && lines.empty())
+      return;
+
+    IndexBatch batch;
+    batch.base = base;
+    batch.polygon_start = indices.size();
+    batch.polygon_count = polygons.size();
+    indices.insert(indices.end(), polygons.begin(), polygons.end());
+    batch.line_start = indices.size();
+    batch.line_count = lines.size();
+    indices.insert(indices.end(), lines.begin(), lines.end());
+    index_batches.push_back(batch);
+
+    polygons.clear();
+    lines.clear();
+  };
+
+  for (const XShape *shape_p : visible_shapes) {
+    const XShape &shape = *shape_p;
+    if (shape.get_type() != MS_SHAPE_LINE &&
+        shape.get_type() != MS_SHAPE_POLYGON)
+      continue;
+
+    const auto lines_of_shape = shape.GetLines();
+    const unsigned n_points = std::accumulate(lines_of_shape.begin(),
+                                              lines_of_shape.end(), 0u);
+
+    /* start a new batch if this shape cannot be addressed with 16 bit
+       indices relative to the current one */
+    const unsigned offset = shape.GetOffset();
+    if (offset + n_points - base > 0x10000) {
+      flush();
+      base = offset;
+    }
+
+    const unsigned relative = offset - base;
+
+    if (shape.get_type() == MS_SHAPE_POLYGON) {
+      const GLushort *index_count;
+      const GLushort *triangles = shape.GetIndices(level, min_distance,
+                                                   index_count);
+      if (triangles != nullptr)
+        AppendTriangleStrip(polygons, relative, triangles, *index_count);
+    } else {
+      const GLushort *count, *src;
+      if (level == 0 ||
+          (src = shape.GetIndices(level, min_distance, count)) == nullptr) {
+        unsigned first = relative;
+        for (unsigned n : lines_of_shape) {
+          AppendLineStrip(lines, first, n);
+          first += n;
+        }
+      } else {
+        for (unsigned n : ConstBuffer<GLushort>(count, lines_of_shape.size)) {
+          AppendLineStrip(lines, relative, src, n);
+          src += n;
+        }
+      }
+    }
+  }
+
+  flush();
+
+  if (indices.empty())
+    return;
+
+  const size_t size = indices.size() * sizeof(indices.front());
+  GLushort *p = (GLushort *)index_buffer->BeginWrite(size);
+  assert(p != nullptr);
+  std::copy(indices.begin(), indices.end(), p);
+  index_buffer->CommitWrite(size, p);
+}
+
 inline void
 TopographyFileRenderer::PaintPoint(Canvas &canvas,
                                    const WindowProjection &projection,
@@ -262,69 +398,48 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 #endif
 
 #ifdef ENABLE_OPENGL
-  ScopeVertexPointer vp;
+  UpdateIndexBuffer(level, min_distance);
 
-#ifdef GL_EXT_multi_draw_arrays
-  std::vector<GLsizei> polygon_counts;
-  std::vector<GLshort> polygon_indices;
-#endif
-#endif
+  if (!index_batches.empty()) {
+    const GLushort *const indices = (const GLushort *)
+      index_buffer->BeginRead();
+
+    ScopeVertexPointer vp;
+    for (const IndexBatch &batch : index_batches) {
+      vp.Update(GL_FLOAT, buffer + batch.base);
+
+      if (batch.polygon_count > 0)
+        glDrawElements(GL_TRIANGLE_STRIP, batch.polygon_count,
+                       GL_UNSIGNED_SHORT, indices + batch.polygon_start);
+
+      if (batch.line_count > 0)
+        glDrawElements(GL_LINES, batch.line_count,
+                       GL_UNSIGNED_SHORT, indices + batch.line_start);
+    }
+
+    index_buffer->EndRead();
+  }
 
+  for (const XShape *shape_p : visible_shapes)
+    if (shape_p->get_type() == MS_SHAPE_POINT)
+      PaintPoint(canvas, projection, *shape_p, opengl_matrix);
+#else // !ENABLE_OPENGL
   for (const XShape *shape_p : visible_shapes) {
     const XShape &shape = *shape_p;
 
     const auto lines = shape.GetLines();
-#ifdef ENABLE_OPENGL
-    const ShapePoint *points = buffer + shape.GetOffset();
-#else // !ENABLE_OPENGL
     const GeoPoint *points = shape.GetPoints();
-#endif
 
     switch (shape.get_type()) {
     case MS_SHAPE_NULL:
       break;
 
     case MS_SHAPE_POINT:
-#ifdef ENABLE_OPENGL
-#ifdef USE_GLSL
-      /* disable the ScopeVertexPointer instance because PaintPoint()
-         uses that attribute */
-      glDisableVertexAttribArray(OpenGL::Attribute::POSITION);
-#endif
-
-      PaintPoint(canvas, projection, shape, opengl_matrix);
-
-#ifdef USE_GLSL
-      /* reenable the ScopeVertexPointer instance because PaintPoint()
-         left it disabled */
-      glEnableVertexAttribArray(OpenGL::Attribute::POSITION);
-#endif
-#else // !ENABLE_OPENGL
       PaintPoint(canvas, projection, lines.begin(), lines.end(), points);
-#endif
       break;
 
     case MS_SHAPE_LINE:
-      {
-#ifdef ENABLE_OPENGL
-        vp.Update(GL_FLOAT, points);
-
-        const GLushort *indices, *count;
-        if (level == 0 ||
-            (indices = shape.GetIndices(level, min_distance, count)) == nullptr) {
-          unsigned offset = 0;
-          for (unsigned n : lines) {
-            glDrawArrays(GL_LINE_STRIP, offset, n);
-            offset += n;
-          }
-        } else {
-          for (unsigned n : ConstBuffer<GLushort>(count, lines.size)) {
-            glDrawElements(GL_LINE_STRIP, n, GL_UNSIGNED_SHORT, indices);
-            indices += n;
-          }
-        }
-#else // !ENABLE_OPENGL
-        for (unsigned msize : lines) {
+      for (unsigned msize : lines) {
         shape_renderer.Begin(msize);
 
         const GeoPoint *end = points + msize - 1;
@@ -336,37 +451,9 @@ TopographyFileRenderer::Paint(Canvas &canvas,
 
         shape_renderer.FinishPolyline(canvas);
       }
-#endif
-      }
       break;
 
     case MS_SHAPE_POLYGON:
-#ifdef ENABLE_OPENGL
-      {
-        const GLushort *index_count;
-        const GLushort *triangles = shape.GetIndices(level, min_distance,
-                                                     index_count);
-        const unsigned n = *index_count;
-
-#ifdef GL_EXT_multi_draw_arrays
-        const unsigned offset = shape.GetOffset();
-        if (GLExt::HaveMultiDrawElements() && offset + n < 0x10000) {
-          /* postpone, draw many polygons with a single
-             glMultiDrawElements() call */
-          polygon_counts.push_back(n);
-          const size_t size = polygon_indices.size();
-          polygon_indices.resize(size + n, offset);
-          for (unsigned i = 0; i < n; ++i)
-            polygon_indices[size + i] += triangles[i];
-          break;
-        }
-#endif
-
-        vp.Update(GL_FLOAT, points);
-        glDrawElements(GL_TRIANGLE_STRIP, n, GL_UNSIGNED_SHORT,
-                       triangles);
-      }
-#else // !ENABLE_OPENGL
       {
         const GeoPoint *src = &points[0];
         for (const unsigned n : lines) {
@@ -397,32 +484,12 @@ TopographyFileRenderer::Paint(Canvas &canvas,
           src += n;
         }
       }
-#endif
       break;
     }
   }
-#ifdef ENABLE_OPENGL
-
-#ifdef GL_EXT_multi_draw_arrays
-  if (!polygon_indices.empty()) {
-    assert(GLExt::HaveMultiDrawElements());
-
-    std::vector<const GLshort *> polygon_pointers;
-    unsigned i = 0;
-    for (auto count : polygon_counts) {
-      polygon_pointers.push_back(polygon_indices.data() + i);
-      i += count;
-    }
-
-    vp.Update(GL_FLOAT, nullptr);
-
-    GLExt::MultiDrawElements(GL_TRIANGLE_STRIP, polygon_counts.data(),
-                             GL_UNSIGNED_SHORT,
-                             (const GLvoid **)polygon_pointers.data(),
-                             polygon_counts.size());
-  }
 #endif
 
+#ifdef ENABLE_OPENGL
 #ifdef USE_GLSL
   glUniformMatrix4fv(OpenGL::solid_modelview, 1, GL_FALSE,
                      glm::value_ptr(glm::mat4()));
@@ -544,6 +611,10 @@ TopographyFileRenderer::SurfaceDestroyed()
 {
   delete array_buffer;
   array_buffer = nullptr;
+
+  delete index_buffer;
+  index_buffer = nullptr;
+  index_batches.clear();
 }
 
 #endif
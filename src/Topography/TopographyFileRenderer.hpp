@@ -31,6 +31,7 @@ Copyright_License {
 
 #ifdef ENABLE_OPENGL
 #include "Screen/OpenGL/Surface.hpp"
+#include "Topography/XShapePoint.hpp"
 #else
 #include "Screen/Brush.hpp"
 #include "Topography/ShapeRenderer.hpp"
@@ -41,6 +42,7 @@ Copyright_License {
 class TopographyFile;
 class Canvas;
 class GLFallbackArrayBuffer;
+class GLFallbackElementArrayBuffer;
 class WindowProjection;
 class LabelBlock;
 class XShape;
@@ -79,6 +81,35 @@ class TopographyFileRenderer final
 #ifdef ENABLE_OPENGL
   GLFallbackArrayBuffer *array_buffer;
   Serial array_buffer_serial;
+
+  /**
+   * A range of #array_buffer which can be addressed with 16 bit
+   * indices relative to #base.  All polygons of the batch are merged
+   * into one triangle strip (joined with degenerate triangles), and
+   * all lines into one GL_LINES list, so each batch is drawn with at
+   * most two calls.
+   */
+  struct IndexBatch {
+    /** the first vertex in #array_buffer */
+    unsigned base;
+
+    unsigned polygon_start, polygon_count;
+    unsigned line_start, line_count;
+  };
+
+  /**
+   * The merged indices of all #visible_shapes at the thinning level
+   * #index_level.  It is rebuilt only when the set of visible shapes
+   * or the thinning level changes.
+   */
+  GLFallbackElementArrayBuffer *index_buffer;
+  std::vector<IndexBatch> index_batches;
+  unsigned index_level;
+
+  /**
+   * Was #visible_shapes modified since #index_buffer was built?
+   */
+  bool index_dirty;
 #endif
 
 public:
@@ -112,6 +143,7 @@ private:
 
 #ifdef ENABLE_OPENGL
   void UpdateArrayBuffer();
+  void UpdateIndexBuffer(unsigned level, ShapeScalar min_distance);
 
   void PaintPoint(Canvas &canvas, const WindowProjection &projection,
                   const XShape &shape, const float *opengl_matrix) const;
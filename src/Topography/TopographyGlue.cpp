@@ -25,9 +25,11 @@ Copyright_License {
 #include "Topography/TopographyStore.hpp"
 #include "Language/Language.hpp"
 #include "Profile/Profile.hpp"
+#include "Profile/ProfileKeys.hpp"
 #include "LogFile.hpp"
 #include "Operation/Operation.hpp"
 #include "IO/MapFile.hpp"
+#include "OS/Path.hpp"
 #include "IO/ZipArchive.hpp"
 #include "IO/ZipLineReader.hpp"
 
@@ -37,14 +39,19 @@ Copyright_License {
  */
 static bool
 LoadConfiguredTopographyZip(TopographyStore &store,
-                            OperationEnvironment &operation)
+                            OperationEnvironment &operation,
+                            FileCache *cache)
 try {
   auto archive = OpenMapFile();
   if (!archive)
     return false;
 
+  const auto path = Profile::GetPath(ProfileKeys::MapFile);
+  if (path.IsNull())
+    cache = nullptr;
+
   ZipLineReaderA reader(archive->get(), "topology.tpl");
-  store.Load(operation, reader, nullptr, archive->get());
+  store.Load(operation, reader, nullptr, archive->get(), cache, path);
   return true;
 } catch (const std::runtime_error &e) {
   LogError("No topography in map file", e);
@@ -53,10 +60,11 @@ try {
 
 bool
 LoadConfiguredTopography(TopographyStore &store,
-                         OperationEnvironment &operation)
+                         OperationEnvironment &operation,
+                         FileCache *cache)
 {
   LogFormat("Loading Topography File...");
   operation.SetText(_("Loading Topography File..."));
 
-  return LoadConfiguredTopographyZip(store, operation);
+  return LoadConfiguredTopographyZip(store, operation, cache);
 }
@@ -26,9 +26,15 @@ Copyright_License {
 
 class TopographyStore;
 class OperationEnvironment;
+class FileCache;
 
+/**
+ * @param cache if not nullptr, then precomputed shape indices are
+ * stored in (and loaded from) this cache
+ */
 bool
 LoadConfiguredTopography(TopographyStore &store,
-                         OperationEnvironment &operation);
+                         OperationEnvironment &operation,
+                         FileCache *cache=nullptr);
 
 #endif
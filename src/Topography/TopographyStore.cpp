@@ -32,6 +32,13 @@ Copyright_License {
 #include "Asset.hpp"
 #include "Resources.hpp"
 
+#ifdef ENABLE_OPENGL
+#include "Util/StaticString.hxx"
+
+#include <zzip/lib.h>
+#endif
+
+#include <assert.h>
 #include <stdint.h>
 #include <windef.h> // for MAX_PATH
 
@@ -141,10 +148,32 @@ TopographyStore::~TopographyStore()
   Reset();
 }
 
+#ifdef ENABLE_OPENGL
+
+/**
+ * Returns the size of the given shapefile within the ZIP archive, to
+ * be part of the name of its thinning cache.  Returns 0 if the size
+ * is unknown.
+ */
+static unsigned
+GetShapefileStamp(struct zzip_dir *zdir, const char *path)
+{
+  ZZIP_STAT st;
+  if (zdir == nullptr || zzip_dir_stat(zdir, path, &st, 0) != 0)
+    return 0;
+
+  return st.st_size;
+}
+
+#endif
+
 void
 TopographyStore::Load(OperationEnvironment &operation, NLineReader &reader,
-                      const TCHAR *directory, struct zzip_dir *zdir)
+                      const TCHAR *directory, struct zzip_dir *zdir,
+                      FileCache *cache, Path original_path)
 {
+  assert(cache == nullptr || !original_path.IsNull());
+
   Reset();
 
   // Create buffer for the shape filenames
@@ -290,12 +319,36 @@ TopographyStore::Load(OperationEnvironment &operation, NLineReader &reader,
 #endif
                                               shape_field, icon, big_icon,
                                               pen_width);
-    if (file->IsEmpty())
+    if (file->IsEmpty()) {
       // If the shape file could not be read -> skip this line/file
       delete file;
-    else
+    } else {
+#ifdef ENABLE_OPENGL
+      if (cache != nullptr) {
+        /* the same shapefile may be listed more than once with
+           different ranges, which yields different thinning levels;
+           the size of the ".shp" entry detects a replaced shapefile
+           even if the map file keeps its time stamp */
+        const unsigned stamp = GetShapefileStamp(zdir, shape_filename);
+
+        // Strip the ".shp" extension for the cache file name
+        shape_filename_end[strlen(shape_filename_end) - 4] = 0;
+
+        const UTF8ToWideConverter name(shape_filename_end);
+        StaticString<96> cache_name;
+        cache_name.Format(_T("topography-%s-%u-%x"), (const TCHAR *)name,
+                          (unsigned)shape_range, stamp);
+        file->LoadThinningCache(*cache, cache_name, original_path,
+                                operation);
+
+        // restore the progress range of the ".tpl" file
+        operation.SetProgressRange(100);
+      }
+#endif
+
       // .. otherwise append it to our list of shape files
       files.append(file);
+    }
 
     // Update progress bar
     operation.SetProgressPosition((reader.Tell() * 100) / filesize);
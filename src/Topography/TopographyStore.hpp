@@ -26,6 +26,7 @@ Copyright_License {
 
 #include "Util/NonCopyable.hpp"
 #include "Util/StaticArray.hxx"
+#include "OS/Path.hpp"
 #include "Compiler.h"
 
 #include <tchar.h>
@@ -34,6 +35,7 @@ class WindowProjection;
 class TopographyFile;
 class NLineReader;
 class OperationEnvironment;
+class FileCache;
 struct zzip_dir;
 
 /**
@@ -92,8 +94,16 @@ public:
    */
   void LoadAll();
 
+  /**
+   * @param cache if not nullptr, then the thinned shape indices are
+   * loaded from (or saved to) this cache; see
+   * TopographyFile::LoadThinningCache()
+   * @param original_path the file the topography is loaded from
+   * (required if #cache is set)
+   */
   void Load(OperationEnvironment &operation, NLineReader &reader,
-            const TCHAR *directory, struct zzip_dir *zdir = nullptr);
+            const TCHAR *directory, struct zzip_dir *zdir = nullptr,
+            FileCache *cache = nullptr, Path original_path = nullptr);
   void Reset();
 };
 
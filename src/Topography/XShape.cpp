@@ -92,6 +92,7 @@ XShape::XShape(shapefileObj *shpfile, const GeoPoint &file_center, int i,
   :label(nullptr)
 {
 #ifdef ENABLE_OPENGL
+  borrowed_indices = 0;
   std::fill_n(index_count, THINNING_LEVELS, nullptr);
   std::fill_n(indices, THINNING_LEVELS, nullptr);
 #endif
@@ -173,7 +174,8 @@ XShape::~XShape()
 #ifdef ENABLE_OPENGL
   // Note: index_count and indices share one buffer
   for (unsigned i = 0; i < THINNING_LEVELS; i++)
-    delete[] index_count[i];
+    if ((borrowed_indices & (1u << i)) == 0)
+      delete[] index_count[i];
 #endif
 }
 
@@ -184,7 +186,7 @@ XShape::BuildIndices(unsigned thinning_level, ShapeScalar min_distance)
 {
   assert(indices[thinning_level] == nullptr);
 
-  uint16_t *idx, *idx_count;
+  GLushort *idx, *idx_count;
   unsigned num_points = 0;
 
   for (unsigned i=0; i < num_lines; i++)
@@ -263,4 +265,34 @@ XShape::GetIndices(int thinning_level, ShapeScalar min_distance,
   return indices[thinning_level];
 }
 
+ConstBuffer<uint16_t>
+XShape::GetIndexBuffer(unsigned thinning_level,
+                       ShapeScalar min_distance) const
+{
+  const uint16_t *count;
+  if (GetIndices(thinning_level, min_distance, count) == nullptr)
+    return nullptr;
+
+  if (type == MS_SHAPE_LINE) {
+    unsigned size = num_lines;
+    for (unsigned i = 0; i < num_lines; ++i)
+      size += count[i];
+    return { count, size };
+  } else {
+    return { count, 1u + *count };
+  }
+}
+
+void
+XShape::SetIndexBuffer(unsigned thinning_level, const uint16_t *buffer)
+{
+  assert(type == MS_SHAPE_LINE || type == MS_SHAPE_POLYGON);
+  assert(indices[thinning_level] == nullptr);
+  assert(buffer != nullptr);
+
+  borrowed_indices |= 1u << thinning_level;
+  index_count[thinning_level] = buffer;
+  indices[thinning_level] = buffer + (type == MS_SHAPE_LINE ? num_lines : 1);
+}
+
 #endif // ENABLE_OPENGL
@@ -41,10 +41,13 @@ struct GeoPoint;
 
 class XShape {
   static constexpr unsigned MAX_LINES = 32;
+
+public:
 #ifdef ENABLE_OPENGL
   static constexpr unsigned THINNING_LEVELS = 4;
 #endif
 
+private:
   GeoBounds bounds;
 
   uint8_t type;
@@ -54,6 +57,14 @@ class XShape {
    */
   uint8_t num_lines;
 
+#ifdef ENABLE_OPENGL
+  /**
+   * A bit mask of thinning levels whose buffers are owned by a
+   * #ThinningCache, and must not be freed by this object.
+   */
+  uint8_t borrowed_indices;
+#endif
+
   /**
    * An array which stores the number of points of each line.  This is
    * a fixed-size array to reduce the number of allocations at
@@ -70,7 +81,7 @@ class XShape {
   /**
    * Indices of polygon triangles or lines with reduced number of vertices.
    */
-  uint16_t *indices[THINNING_LEVELS];
+  const uint16_t *indices[THINNING_LEVELS];
 
   /**
    * For polygons this will contain the total number of triangle vertices
@@ -78,7 +89,7 @@ class XShape {
    * For lines there will be an array of size num_lines for each thinning
    * level, which contains the number of points for each line.
    */
-  uint16_t *index_count[THINNING_LEVELS];
+  const uint16_t *index_count[THINNING_LEVELS];
 
   /**
    * The start offset in the #GLArrayBuffer (vertex buffer object).
@@ -115,6 +126,26 @@ public:
   const uint16_t *GetIndices(int thinning_level,
                              ShapeScalar min_distance,
                              const uint16_t *&count) const;
+
+  /**
+   * Returns the whole buffer (counts followed by indices) of the
+   * given thinning level, building it if necessary.  This is the
+   * data which gets stored in the #ThinningCache.
+   *
+   * @return nullptr if this shape has no indices on this level
+   */
+  ConstBuffer<uint16_t> GetIndexBuffer(unsigned thinning_level,
+                                       ShapeScalar min_distance) const;
+
+  /**
+   * Use a buffer from the #ThinningCache instead of building the
+   * indices of this level.  The caller is responsible for keeping the
+   * buffer alive as long as this object exists.
+   *
+   * @param buffer a buffer in the format returned by
+   * GetIndexBuffer()
+   */
+  void SetIndexBuffer(unsigned thinning_level, const uint16_t *buffer);
 #endif
 
   const GeoBounds &get_bounds() const {
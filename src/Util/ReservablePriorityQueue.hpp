@@ -52,6 +52,13 @@ public:
     this->c.clear();
   }
 
+  /**
+   * Access the underlying container, in heap order.
+   */
+  const Container &container() const {
+    return this->c;
+  }
+
 #if defined(_GLIBCXX_DEBUG) && defined(__GLIBCXX__) && __GLIBCXX__ == 20130322
   using std::priority_queue<T, Container, Compare>::size;
 
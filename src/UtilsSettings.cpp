@@ -173,7 +173,7 @@ SettingsLeave(const UISettings &old_ui_settings)
   if (TopographyFileChanged) {
     main_window.SetTopography(nullptr);
     topography->Reset();
-    LoadConfiguredTopography(*topography, operation);
+    LoadConfiguredTopography(*topography, operation, file_cache);
     main_window.SetTopography(topography);
   }
 
@@ -120,11 +120,16 @@ RaspCache::Reload(BrokenTime time_local, OperationEnvironment &operation)
   new_map->UpdateProjection();
 
   map = new_map;
+  ++serial;
 }
 
 void
 RaspCache::Close()
 {
+  if (map == nullptr)
+    return;
+
   delete map;
   map = nullptr;
+  ++serial;
 }
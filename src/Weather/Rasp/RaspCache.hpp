@@ -24,6 +24,7 @@ Copyright_License {
 #ifndef XCSOAR_WEATHER_RASP_CACHE_HPP
 #define XCSOAR_WEATHER_RASP_CACHE_HPP
 
+#include "Util/Serial.hpp"
 #include "Compiler.h"
 
 #include <tchar.h>
@@ -48,6 +49,11 @@ class RaspCache {
 
   RasterMap *map = nullptr;
 
+  /**
+   * Incremented each time #map is replaced.
+   */
+  Serial serial;
+
 public:
   /** 
    * Default constructor
@@ -68,6 +74,10 @@ public:
     return map;
   }
 
+  const Serial &GetSerial() const {
+    return serial;
+  }
+
   /**
    * Returns the current map's name.
    */
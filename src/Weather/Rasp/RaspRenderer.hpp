@@ -64,6 +64,13 @@ public:
     return cache.GetParameter();
   }
 
+  /**
+   * Returns a serial which changes when a new map was loaded.
+   */
+  const Serial &GetSerial() const {
+    return cache.GetSerial();
+  }
+
   /**
    * Returns the human-readable name for the current RASP map, or
    * nullptr if no RASP map is enabled.
@@ -0,0 +1,200 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Analyse many IGC files in parallel and write one JSON array with
+ * the AnalyseFlight results of all of them.  Throughput statistics
+ * are printed to stderr.
+ */
+
+#include "FlightAnalysis.hpp"
+#include "DebugReplayIGC.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "Thread/Mutex.hpp"
+#include "Thread/WorkerPool.hpp"
+#include "IO/StdioOutputStream.hxx"
+#include "JSON/Writer.hpp"
+#include "Util/StringCompare.hxx"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Flight {
+  AllocatedPath path;
+  uint64_t size;
+
+  Flight(AllocatedPath &&_path)
+    :path(std::move(_path)), size(File::GetSize(path)) {}
+};
+
+/**
+ * @param error if not nullptr, the flight could not be analysed, and
+ * this is the error message
+ */
+static void
+WriteFlight(BufferedOutputStream &writer, const Flight *flight,
+            const FlightAnalysis *analysis, const char *error)
+{
+  JSON::ObjectWriter object(writer);
+
+  object.WriteElement("file", JSON::WriteString, flight->path.c_str());
+
+  if (error != nullptr) {
+    object.WriteElement("error", JSON::WriteString, error);
+    return;
+  }
+
+  object.WriteElement("fixes", JSON::WriteUnsigned, analysis->GetFixCount());
+  analysis->Write(object);
+}
+
+static bool
+ParseCount(const char *value, unsigned &result_r)
+{
+  char *endptr;
+  const unsigned long result = strtoul(value, &endptr, 10);
+  if (endptr == value || *endptr != 0 || result == 0)
+    return false;
+
+  result_r = result;
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned full_max_points = 512,
+           triangle_max_points = 1024,
+           sprint_max_points = 64;
+  unsigned n_threads = WorkerPool::GetDefaultWorkers() + 1;
+
+  Args args(argc, argv,
+            "[options] FILE.igc ...\n"
+            "Options:\n"
+            "  --jobs=N                 Number of threads (default = number of CPUs)\n"
+            "  --full-points=512        Maximum number of full trace points (default = 512)\n"
+            "  --triangle-points=1024   Maximum number of triangle trace points (default = 1024)\n"
+            "  --sprint-points=64       Maximum number of sprint trace points (default = 64)");
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--jobs=")) != nullptr) {
+      if (!ParseCount(value, n_threads))
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--full-points=")) != nullptr) {
+      if (!ParseCount(value, full_max_points))
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--triangle-points=")) != nullptr) {
+      if (!ParseCount(value, triangle_max_points))
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--sprint-points=")) != nullptr) {
+      if (!ParseCount(value, sprint_max_points))
+        args.UsageError();
+    } else {
+      args.UsageError();
+    }
+  }
+
+  std::vector<Flight> flights;
+  do {
+    flights.emplace_back(args.ExpectNextPath());
+  } while (!args.IsEmpty());
+
+  /* start with the biggest files, so a long flight picked up last
+     does not leave the other threads idle at the end */
+  std::stable_sort(flights.begin(), flights.end(),
+                   [](const Flight &a, const Flight &b){
+                     return a.size > b.size;
+                   });
+
+  WorkerPool pool(n_threads - 1);
+
+  /* each worker owns one pipeline, which is reused for all flights
+     it picks up */
+  std::vector<std::unique_ptr<FlightAnalysis>> analyses;
+  for (unsigned i = 0; i < pool.GetConcurrency(); ++i)
+    analyses.emplace_back(new FlightAnalysis(full_max_points,
+                                             triangle_max_points,
+                                             sprint_max_points));
+
+  StdioOutputStream os(stdout);
+  BufferedOutputStream writer(os);
+
+  /* protects "writer", "array" and the counters */
+  Mutex mutex;
+  uint64_t total_fixes = 0;
+  unsigned n_failed = 0;
+
+  const uint64_t start_us = MonotonicClockUS();
+
+  {
+    JSON::ArrayWriter array(writer);
+
+    pool.RunPerWorker(flights.size(), [&](unsigned job, unsigned worker){
+        const Flight &flight = flights[job];
+        FlightAnalysis &analysis = *analyses[worker];
+
+        try {
+          std::unique_ptr<DebugReplay>
+            replay(DebugReplayIGC::Create(flight.path));
+          analysis.Analyse(*replay);
+        } catch (const std::exception &e) {
+          const ScopeLock protect(mutex);
+          array.WriteElement(WriteFlight, &flight, nullptr, e.what());
+          writer.Write('\n');
+          ++n_failed;
+          return;
+        }
+
+        const ScopeLock protect(mutex);
+        array.WriteElement(WriteFlight, &flight, &analysis, nullptr);
+        writer.Write('\n');
+        total_fixes += analysis.GetFixCount();
+      });
+  }
+
+  writer.Write('\n');
+  writer.Flush();
+
+  const double duration =
+    std::max(double(MonotonicClockUS() - start_us) / 1000000, 1e-6);
+  const unsigned n_flights = flights.size() - n_failed;
+
+  fprintf(stderr,
+          "# %u flights (%u failed), %llu fixes, %u threads, %.3f s\n"
+          "# %.2f flights/s, %.0f fixes/s\n",
+          n_flights, n_failed, (unsigned long long)total_fixes,
+          pool.GetConcurrency(), duration,
+          n_flights / duration, total_fixes / duration);
+
+  return n_failed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
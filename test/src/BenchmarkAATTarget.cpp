@@ -0,0 +1,122 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures the AAT target optimisation (OrderedTask::UpdateIdle())
+ * of an aircraft approaching the first of three AAT sectors, and
+ * prints the time per call of OrderedTask::Update() and
+ * OrderedTask::UpdateIdle().
+ */
+
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "Engine/Task/Ordered/OrderedTask.hpp"
+#include "Engine/Task/Ordered/Settings.hpp"
+#include "Engine/Task/Ordered/Points/AATPoint.hpp"
+#include "Engine/Task/Ordered/Points/StartPoint.hpp"
+#include "Engine/Task/Ordered/Points/FinishPoint.hpp"
+#include "Engine/Task/ObservationZones/CylinderZone.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "Engine/Waypoint/Waypoint.hpp"
+#include "OS/Clock.hpp"
+#include "Compiler.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+static WaypointPtr
+MakeWaypoint(double longitude, double latitude)
+{
+  Waypoint *wp = new Waypoint(GeoPoint(Angle::Degrees(longitude),
+                                       Angle::Degrees(latitude)));
+  wp->elevation = 100;
+  return WaypointPtr(wp);
+}
+
+int
+main(gcc_unused int argc, gcc_unused char **argv)
+{
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  OrderedTaskSettings ordered_task_settings;
+  ordered_task_settings.SetDefaults();
+
+  const auto start = MakeWaypoint(7.0, 51.0);
+  const auto aat1 = MakeWaypoint(7.5, 51.6);
+  const auto aat2 = MakeWaypoint(8.4, 51.3);
+  const auto aat3 = MakeWaypoint(7.9, 50.6);
+
+  OrderedTask task(task_behaviour);
+  task.Append(StartPoint(new CylinderZone(start->location, 1000),
+                         WaypointPtr(start), task_behaviour,
+                         ordered_task_settings.start_constraints));
+  for (const auto &wp : {aat1, aat2, aat3})
+    task.Append(AATPoint(new CylinderZone(wp->location, 20000),
+                         WaypointPtr(wp), task_behaviour));
+  task.Append(FinishPoint(new CylinderZone(start->location, 1000),
+                          WaypointPtr(start), task_behaviour,
+                          ordered_task_settings.finish_constraints));
+  task.SetActiveTaskPoint(1);
+  task.UpdateGeometry();
+
+  GlidePolar glide_polar(1);
+
+  AircraftState state;
+  state.Reset();
+  state.location = GeoPoint(Angle::Degrees(7.1), Angle::Degrees(51.1));
+  state.altitude = 1500;
+  state.flying = true;
+  state.time = 3600;
+  AircraftState state_last = state;
+
+  static constexpr unsigned N = 4096;
+  uint64_t update_us = 0, idle_us = 0;
+
+  for (unsigned i = 0; i < N; ++i) {
+    state.time += 1;
+
+    const uint64_t t0 = MonotonicClockUS();
+    task.Update(state, state_last, glide_polar);
+    const uint64_t t1 = MonotonicClockUS();
+    task.UpdateIdle(state, glide_polar);
+    const uint64_t t2 = MonotonicClockUS();
+
+    update_us += t1 - t0;
+    idle_us += t2 - t1;
+    state_last = state;
+
+    state.location = GeoPoint(state.location.longitude + Angle::Degrees(0.0001),
+                              state.location.latitude + Angle::Degrees(0.0001));
+  }
+
+  printf("Update()     %10.0f ns/call\n", update_us * 1000. / N);
+  printf("UpdateIdle() %10.0f ns/call\n", idle_us * 1000. / N);
+
+  /* print the optimised target so the solver can't be optimised away */
+  const GeoPoint target = task.GetTaskPoint(1).GetLocationRemaining();
+  printf("target       %f %f\n",
+         target.longitude.Degrees(), target.latitude.Degrees());
+
+  return 0;
+}
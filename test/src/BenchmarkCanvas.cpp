@@ -0,0 +1,171 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures the throughput of the software (memory) canvas: fills,
+ * polygons, blits, alpha blending and the conversion to the
+ * framebuffer's pixel format which is done by TopCanvas::Flip().
+ * Each operation covers the whole 800x480 screen and the result is
+ * printed in megapixels per second.
+ */
+
+#include "Screen/Canvas.hpp"
+#include "Screen/Pen.hpp"
+#include "Screen/Brush.hpp"
+#include "Screen/Memory/Buffer.hpp"
+#include "Screen/Memory/Export.hpp"
+#include "Screen/Memory/ActivePixelTraits.hpp"
+#include "Screen/Point.hpp"
+#include "OS/Clock.hpp"
+#include "Util/Macros.hpp"
+#include "Compiler.h"
+
+#ifdef DITHER
+#include "Screen/Memory/Dither.hpp"
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+
+static constexpr unsigned WIDTH = 800, HEIGHT = 480;
+static constexpr unsigned N_PIXELS = WIDTH * HEIGHT;
+
+/**
+ * Repeat each operation this many times.
+ */
+static constexpr unsigned N_ITERATIONS = 200;
+
+template<typename F>
+static void
+Measure(const char *name, F &&f)
+{
+  /* warm up the caches */
+  f();
+
+  const uint64_t start = MonotonicClockUS();
+  for (unsigned i = 0; i < N_ITERATIONS; ++i)
+    f();
+  const uint64_t duration = MonotonicClockUS() - start;
+
+  const double mpixels = double(N_PIXELS) * N_ITERATIONS / 1e6;
+  printf("%-24s %8.1f MP/s\n", name,
+         mpixels / (double(duration > 0 ? duration : 1) / 1e6));
+}
+
+static void
+FillPattern(Canvas &canvas)
+{
+  /* vertical stripes of white and coloured pixels, so the "transparent
+     white" operations have something to skip */
+  for (unsigned x = 0; x < WIDTH; x += 16)
+    canvas.DrawFilledRectangle(x, 0, x + 8, HEIGHT,
+                               x & 16 ? COLOR_WHITE : COLOR_BLUE);
+}
+
+int
+main(gcc_unused int argc, gcc_unused char **argv)
+{
+  WritableImageBuffer<ActivePixelTraits> dest_buffer, src_buffer;
+  dest_buffer.Allocate(WIDTH, HEIGHT);
+  src_buffer.Allocate(WIDTH, HEIGHT);
+
+  Canvas canvas(dest_buffer), src(src_buffer);
+  FillPattern(canvas);
+  FillPattern(src);
+
+  const PixelRect rc(0, 0, WIDTH, HEIGHT);
+
+  Measure("FillRectangle", [&](){
+      canvas.DrawFilledRectangle(rc, COLOR_YELLOW);
+    });
+
+  const BulkPixelPoint polygon[] = {
+    { 0, 0 }, { WIDTH, 0 }, { WIDTH, HEIGHT }, { 0, HEIGHT },
+  };
+
+  canvas.SelectNullPen();
+
+  const Brush solid_brush(COLOR_GREEN);
+  canvas.Select(solid_brush);
+  Measure("DrawPolygon", [&](){
+      canvas.DrawPolygon(polygon, ARRAY_SIZE(polygon));
+    });
+
+  const Brush alpha_brush(COLOR_GREEN.WithAlpha(0x60));
+  canvas.Select(alpha_brush);
+  Measure("DrawPolygon(alpha)", [&](){
+      canvas.DrawPolygon(polygon, ARRAY_SIZE(polygon));
+    });
+
+  Measure("Copy", [&](){
+      canvas.Copy(src);
+    });
+
+  Measure("CopyTransparentWhite", [&](){
+      canvas.CopyTransparentWhite(0, 0, WIDTH, HEIGHT, src, 0, 0);
+    });
+
+  Measure("CopyOr", [&](){
+      canvas.CopyOr(0, 0, WIDTH, HEIGHT, src, 0, 0);
+    });
+
+  Measure("AlphaBlend", [&](){
+      canvas.AlphaBlend(0, 0, WIDTH, HEIGHT,
+                        src, 0, 0, WIDTH, HEIGHT, 0xa0);
+    });
+
+  Measure("Stretch", [&](){
+      canvas.Stretch(0, 0, WIDTH, HEIGHT,
+                     src, 0, 0, WIDTH / 2, HEIGHT / 2);
+    });
+
+  /* the conversion to the framebuffer format, see TopCanvas::Flip() */
+  for (const unsigned bpp : {2u, 4u}) {
+    const unsigned pitch = WIDTH * bpp;
+    uint8_t *framebuffer = new uint8_t[pitch * HEIGHT];
+#ifdef DITHER
+    Dither dither;
+#endif
+
+    Measure(bpp == 2 ? "Export(RGB565)" : "Export(RGB8)", [&](){
+#ifdef GREYSCALE
+        CopyFromGreyscale(
+#ifdef DITHER
+                          dither,
+#endif
+#ifdef KOBO
+                          true,
+#endif
+                          framebuffer, pitch, bpp, src_buffer);
+#else
+        CopyFromBGRA(framebuffer, pitch, bpp, src_buffer);
+#endif
+      });
+
+    delete[] framebuffer;
+  }
+
+  dest_buffer.Free();
+  src_buffer.Free();
+  return 0;
+}
@@ -0,0 +1,132 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compares the throughput of IGCParseFix() on lines from
+ * FileLineReaderA with the throughput of MappedIGCReader.
+ */
+
+#include "IGC/MappedIGCReader.hpp"
+#include "IGC/IGCFixBatch.hpp"
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/Path.hpp"
+#include "Util/PrintException.hxx"
+
+#include <algorithm>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr unsigned ITERATIONS = 20;
+
+/**
+ * Accumulate something from every fix so the compiler cannot discard
+ * the parser results.
+ */
+static long checksum;
+
+static unsigned
+ParseLines(Path path)
+{
+  IGCExtensions extensions;
+  extensions.clear();
+
+  unsigned n = 0;
+
+  FileLineReaderA reader(path);
+  const char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    IGCFix fix;
+    if (IGCParseFix(line, extensions, fix)) {
+      checksum += fix.gps_altitude;
+      ++n;
+    } else if (*line == 'I')
+      IGCParseExtensions(line, extensions);
+  }
+
+  return n;
+}
+
+static unsigned
+ParseMapped(Path path)
+{
+  unsigned n = 0;
+
+  MappedIGCReader reader(path);
+  IGCFixBatch batch;
+  while (reader.Read(batch)) {
+    for (unsigned i = 0; i < batch.size; ++i)
+      checksum += batch.gps_altitude[i];
+    n += batch.size;
+  }
+
+  return n;
+}
+
+template<typename F>
+static double
+Measure(const char *name, const std::vector<AllocatedPath> &paths, F &&f)
+{
+  unsigned n = 0;
+
+  const uint64_t start_us = MonotonicClockUS();
+  for (unsigned i = 0; i < ITERATIONS; ++i)
+    for (const auto &path : paths)
+      n += f(path);
+
+  const double duration =
+    std::max(double(MonotonicClockUS() - start_us) / 1000000, 1e-6);
+  const double rate = n / duration;
+
+  printf("%-10s %9u fixes %8.3f s %12.0f fixes/s\n",
+         name, n, duration, rate);
+  return rate;
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "FILE.igc ...");
+
+  std::vector<AllocatedPath> paths;
+  do {
+    paths.emplace_back(args.ExpectNextPath());
+  } while (!args.IsEmpty());
+
+  const double line_rate = Measure("IGCParser", paths, ParseLines);
+  const double mapped_rate = Measure("Mapped", paths, ParseMapped);
+
+  printf("speedup %.2f\n", mapped_rate / line_rate);
+  fprintf(stderr, "# checksum %ld\n", checksum);
+  return EXIT_SUCCESS;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,131 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measures the label placement of 10000 waypoints on a 1024x768
+ * screen: collect them in a WaypointLabelList, sort them by
+ * importance and test each one against the LabelBlock, the way
+ * WaypointRenderer does it each frame.  The text size is estimated
+ * from the name length, because no font is loaded here.
+ */
+
+#include "Renderer/WaypointLabelList.hpp"
+#include "Renderer/LabelBlock.hpp"
+#include "OS/Clock.hpp"
+#include "Compiler.h"
+
+#include <stdio.h>
+#include <tchar.h>
+
+static constexpr unsigned WIDTH = 1024, HEIGHT = 768;
+static constexpr unsigned N_WAYPOINTS = 10000;
+static constexpr unsigned N_FRAMES = 100;
+
+static constexpr int CHAR_WIDTH = 7, TEXT_HEIGHT = 13, PADDING = 2;
+
+static unsigned random_state = 1;
+
+static unsigned
+Random(unsigned max)
+{
+  random_state = random_state * 1103515245 + 12345;
+  return (random_state >> 8) % max;
+}
+
+static void
+AddWaypoints(WaypointLabelList &labels, int offset_x)
+{
+  random_state = 1;
+
+  for (unsigned i = 0; i < N_WAYPOINTS; ++i) {
+    TCHAR name[16];
+    _stprintf(name, _T("WP%0*u"), int(1 + Random(8)), i);
+
+    TextInBoxMode mode;
+    const bool landable = Random(8) == 0;
+    if (landable) {
+      mode.shape = LabelShape::ROUNDED_BLACK;
+      mode.align = TextInBoxMode::Alignment::CENTER;
+    }
+
+    const int x = int(Random(WIDTH)) + offset_x;
+    const int y = Random(HEIGHT);
+    labels.Add(name, x + 5, y, mode, landable, int(Random(2000)) - 500,
+               i < 5, landable, landable && Random(4) == 0, false);
+  }
+}
+
+static unsigned
+PlaceLabels(LabelBlock &label_block, const WaypointLabelList &labels)
+{
+  unsigned n = 0;
+  for (const auto &l : labels) {
+    /* this is what TextInBox() does with the label's position */
+    const int cx = int(_tcslen(l.Name)) * CHAR_WIDTH;
+    int x = l.Pos.x;
+    if (l.Mode.align == TextInBoxMode::Alignment::CENTER)
+      x -= cx / 2;
+
+    PixelRect rc;
+    rc.left = x - PADDING - 1;
+    rc.right = x + cx + PADDING;
+    rc.top = l.Pos.y;
+    rc.bottom = l.Pos.y + TEXT_HEIGHT + 1;
+
+    if (label_block.check(rc))
+      ++n;
+  }
+
+  return n;
+}
+
+int
+main(gcc_unused int argc, gcc_unused char **argv)
+{
+  LabelBlock label_block;
+  unsigned n = 0;
+  uint64_t collect_us = 0, place_us = 0;
+
+  for (unsigned frame = 0; frame < N_FRAMES; ++frame) {
+    const uint64_t start = MonotonicClockUS();
+
+    /* pan the map a little bit each frame */
+    WaypointLabelList labels(WIDTH, HEIGHT);
+    AddWaypoints(labels, int(frame % 16) - 8);
+    labels.Sort();
+
+    const uint64_t sorted = MonotonicClockUS();
+
+    label_block.reset();
+    n = PlaceLabels(label_block, labels);
+
+    const uint64_t placed = MonotonicClockUS();
+    collect_us += sorted - start;
+    place_us += placed - sorted;
+  }
+
+  printf("%u of %u labels placed\n", n, N_WAYPOINTS);
+  printf("collect and sort: %u us/frame\n", unsigned(collect_us / N_FRAMES));
+  printf("place: %u us/frame\n", unsigned(place_us / N_FRAMES));
+  return 0;
+}
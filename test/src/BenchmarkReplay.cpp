@@ -0,0 +1,415 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Replays a fixed corpus of flights through the stages of the glide
+ * computer and measures the CPU time and the number of heap
+ * allocations per fix of each stage.  The results are printed as
+ * JSON.  With "--budget FILE", the program fails if a stage exceeds
+ * the limits configured in that file.
+ *
+ * Budget file format: one line per stage with its name, the maximum
+ * number of nanoseconds per fix and the maximum number of allocations
+ * per fix; empty lines and lines starting with '#' are ignored.
+ *
+ * A task file (*.tsk) next to a flight enables the "task" stage for
+ * that flight.
+ */
+
+#include "DebugReplay.hpp"
+#include "DebugReplayIGC.hpp"
+#include "DebugReplayNMEA.hpp"
+#include "Computer/CirclingComputer.hpp"
+#include "Computer/ThermalLocator.hpp"
+#include "Computer/TraceComputer.hpp"
+#include "Computer/WaveComputer.hpp"
+#include "Computer/WaveResult.hpp"
+#include "Computer/WaveSettings.hpp"
+#include "Computer/Settings.hpp"
+#include "Computer/Wind/WindEKFGlue.hpp"
+#include "Computer/Wind/CirclingWind.hpp"
+#include "Engine/Contest/ContestManager.hpp"
+#include "Engine/Task/Ordered/OrderedTask.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Task/TaskManager.hpp"
+#include "Task/LoadFile.hpp"
+#include "NMEA/Aircraft.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "IO/FileLineReader.hpp"
+#include "IO/StdioOutputStream.hxx"
+#include "JSON/Writer.hpp"
+#include "OS/AllocationCounter.hpp"
+#include "OS/Args.hpp"
+#include "OS/Clock.hpp"
+#include "OS/FileUtil.hpp"
+#include "Util/StringAPI.hxx"
+#include "Util/PrintException.hxx"
+
+#include <memory>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+struct Stage {
+  const char *name;
+
+  /**
+   * The number of fixes this stage has processed (or skipped, see
+   * #CONTEST_INTERVAL).
+   */
+  unsigned n_fixes;
+
+  double duration;
+  uint64_t n_allocations;
+
+  /**
+   * The budget; negative means "no limit".
+   */
+  double max_ns_per_fix, max_allocations_per_fix;
+
+  constexpr Stage(const char *_name)
+    :name(_name), n_fixes(0), duration(0), n_allocations(0),
+     max_ns_per_fix(-1), max_allocations_per_fix(-1) {}
+
+  double GetNSPerFix() const {
+    return n_fixes > 0 ? duration * 1e9 / n_fixes : 0;
+  }
+
+  double GetAllocationsPerFix() const {
+    return n_fixes > 0 ? double(n_allocations) / n_fixes : 0;
+  }
+
+  bool IsWithinBudget() const {
+    return (max_ns_per_fix < 0 || GetNSPerFix() <= max_ns_per_fix) &&
+      (max_allocations_per_fix < 0 ||
+       GetAllocationsPerFix() <= max_allocations_per_fix);
+  }
+
+  template<typename F>
+  void Measure(F &&f) {
+    const uint64_t start_allocations =
+      AllocationCounter::GetThreadCount();
+    const double start = MonotonicClockFloat();
+
+    f();
+
+    duration += MonotonicClockFloat() - start;
+    n_allocations += AllocationCounter::GetThreadCount() - start_allocations;
+  }
+};
+
+/**
+ * The glide computer solves the contest in the "idle" loop, not for
+ * every fix; this emulates a fix rate of 1 Hz with an idle call every
+ * 30 seconds.  The costs are nevertheless averaged over all fixes.
+ */
+static constexpr unsigned CONTEST_INTERVAL = 30;
+
+static Stage circling_stage("circling"),
+  wind_ekf_stage("wind_ekf"),
+  circling_wind_stage("circling_wind"),
+  thermal_locator_stage("thermal_locator"),
+  wave_stage("wave"),
+  trace_stage("trace"),
+  contest_stage("contest"),
+  task_stage("task");
+
+static Stage *const stages[] = {
+  &circling_stage,
+  &wind_ekf_stage,
+  &circling_wind_stage,
+  &thermal_locator_stage,
+  &wave_stage,
+  &trace_stage,
+  &contest_stage,
+  &task_stage,
+};
+
+gcc_pure
+static Stage *
+FindStage(const char *name)
+{
+  for (Stage *stage : stages)
+    if (StringIsEqual(stage->name, name))
+      return stage;
+
+  return nullptr;
+}
+
+static void
+LoadBudget(Path path)
+{
+  FileLineReaderA reader(path);
+
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    if (*line == '#' || *line == '\0')
+      continue;
+
+    char name[32];
+    double max_ns, max_allocations;
+    if (sscanf(line, "%31s %lf %lf", name, &max_ns, &max_allocations) != 3)
+      throw std::runtime_error(std::string("Malformed budget line: ") + line);
+
+    Stage *stage = FindStage(name);
+    if (stage == nullptr)
+      throw std::runtime_error(std::string("No such stage: ") + name);
+
+    stage->max_ns_per_fix = max_ns;
+    stage->max_allocations_per_fix = max_allocations;
+  }
+}
+
+static DebugReplay *
+CreateReplay(Path path)
+{
+  if (path.MatchesExtension(_T(".igc")))
+    return DebugReplayIGC::Create(path);
+  else
+    return DebugReplayNMEA::Create(path, _T("Generic"));
+}
+
+static std::unique_ptr<TaskManager>
+LoadTaskManager(Path path, const TaskBehaviour &task_behaviour,
+                const Waypoints &waypoints, const GlidePolar &glide_polar)
+{
+  const auto task_path = path.WithExtension(_T(".tsk"));
+  if (!File::Exists(task_path))
+    return nullptr;
+
+  std::unique_ptr<OrderedTask> task(LoadTask(task_path, task_behaviour));
+  if (!task)
+    throw std::runtime_error("Failed to load task");
+
+  task->UpdateStatsGeometry();
+  if (!task->CheckTask())
+    throw std::runtime_error("Invalid task");
+
+  std::unique_ptr<TaskManager> task_manager(new TaskManager(task_behaviour,
+                                                            waypoints));
+  task_manager->SetGlidePolar(glide_polar);
+  task_manager->Commit(*task);
+  task_manager->Resume();
+  return task_manager;
+}
+
+static unsigned
+Replay(Path path)
+{
+  std::unique_ptr<DebugReplay> replay(CreateReplay(path));
+  if (!replay)
+    throw std::runtime_error("Failed to open replay");
+
+  /* only the settings used by the stages below are initialised */
+  ComputerSettings settings;
+  settings.circling.SetDefaults();
+  settings.task.SetDefaults();
+  settings.contest.SetDefaults();
+  settings.contest.enable = true;
+
+  const GlidePolar glide_polar(1);
+
+  CirclingComputer circling_computer;
+  circling_computer.Reset();
+
+  WindEKFGlue wind_ekf;
+  wind_ekf.Reset();
+
+  CirclingWind circling_wind;
+  circling_wind.Reset();
+
+  ThermalLocator thermal_locator;
+  thermal_locator.Reset();
+
+  WaveSettings wave_settings;
+  wave_settings.SetDefaults();
+  wave_settings.enabled = true;
+
+  WaveComputer wave;
+  wave.Reset();
+
+  WaveResult wave_result;
+  wave_result.Clear();
+
+  TraceComputer trace_computer;
+
+  ContestManager contest_manager(Contest::OLC_PLUS,
+                                 trace_computer.GetFull(),
+                                 trace_computer.GetFull(),
+                                 trace_computer.GetSprint());
+  contest_manager.SetHandicap(100);
+
+  const Waypoints waypoints;
+  auto task_manager = LoadTaskManager(path, settings.task, waypoints,
+                                      glide_polar);
+
+  AircraftState last_state;
+  bool have_last_state = false;
+
+  unsigned n = 0;
+  while (replay->Next()) {
+    const MoreData &basic = replay->Basic();
+    const DerivedInfo &calculated = replay->Calculated();
+    DerivedInfo &set_calculated = replay->SetCalculated();
+
+    circling_stage.Measure([&](){
+        circling_computer.TurnRate(set_calculated, basic, calculated.flight);
+        circling_computer.Turning(set_calculated, basic, calculated.flight,
+                                  settings.circling);
+      });
+
+    wind_ekf_stage.Measure([&](){
+        const auto result = wind_ekf.Update(basic, calculated);
+        if (result.quality > 0) {
+          set_calculated.wind = result.wind;
+          set_calculated.wind_available.Update(basic.clock);
+        }
+      });
+
+    circling_wind_stage.Measure([&](){
+        const auto result = circling_wind.NewSample(basic, calculated);
+        if (result.quality > 0) {
+          set_calculated.wind = result.wind;
+          set_calculated.wind_available.Update(basic.clock);
+        }
+      });
+
+    thermal_locator_stage.Measure([&](){
+        thermal_locator.Process(calculated.circling && calculated.turning,
+                                basic.time, basic.location,
+                                basic.netto_vario,
+                                calculated.GetWindOrZero(),
+                                set_calculated.thermal_locator);
+      });
+
+    wave_stage.Measure([&](){
+        wave.Compute(basic, calculated.flight, wave_result, wave_settings);
+      });
+
+    trace_stage.Measure([&](){
+        trace_computer.Update(settings, basic, calculated);
+      });
+
+    if (n % CONTEST_INTERVAL == 0)
+      contest_stage.Measure([&](){
+          contest_manager.UpdateIdle();
+        });
+
+    if (task_manager) {
+      const AircraftState state = ToAircraftState(basic, calculated);
+      task_stage.Measure([&](){
+          task_manager->Update(state, have_last_state ? last_state : state);
+          task_manager->UpdateIdle(state);
+        });
+
+      last_state = state;
+      have_last_state = true;
+    }
+
+    for (Stage *stage : stages)
+      if (stage != &task_stage || task_manager)
+        ++stage->n_fixes;
+
+    ++n;
+  }
+
+  return n;
+}
+
+static void
+WriteStage(BufferedOutputStream &writer, const Stage &stage)
+{
+  JSON::ObjectWriter object(writer);
+  object.WriteElement("name", JSON::WriteString, stage.name);
+  object.WriteElement("fixes", JSON::WriteUnsigned, stage.n_fixes);
+
+  object.BeginElement("ns_per_fix");
+  writer.Format("%.1f", stage.GetNSPerFix());
+  object.EndElement();
+
+  object.BeginElement("allocations_per_fix");
+  writer.Format("%.3f", stage.GetAllocationsPerFix());
+  object.EndElement();
+
+  object.BeginElement("within_budget");
+  writer.Write(stage.IsWithinBudget() ? "true" : "false");
+  object.EndElement();
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "[--budget FILE] FILE.igc|FILE.nmea ...");
+
+  const char *option = args.PeekNext();
+  if (option != nullptr && StringIsEqual(option, "--budget")) {
+    args.Skip();
+    LoadBudget(args.ExpectNextPath());
+  }
+
+  std::vector<AllocatedPath> paths;
+  do {
+    paths.emplace_back(args.ExpectNextPath());
+  } while (!args.IsEmpty());
+
+  unsigned n_fixes = 0;
+  for (const auto &path : paths)
+    n_fixes += Replay(path);
+
+  bool success = true;
+
+  StdioOutputStream os(stdout);
+  BufferedOutputStream writer(os);
+
+  {
+    JSON::ObjectWriter root(writer);
+    root.WriteElement("files", JSON::WriteUnsigned, unsigned(paths.size()));
+    root.WriteElement("fixes", JSON::WriteUnsigned, n_fixes);
+
+    root.BeginElement("stages");
+    {
+      JSON::ArrayWriter array(writer);
+      for (const Stage *stage : stages) {
+        array.WriteElement(WriteStage, *stage);
+
+        if (!stage->IsWithinBudget()) {
+          fprintf(stderr, "Stage '%s' exceeds its budget: "
+                  "%.1f ns/fix (max %.1f), %.3f allocations/fix (max %.3f)\n",
+                  stage->name, stage->GetNSPerFix(), stage->max_ns_per_fix,
+                  stage->GetAllocationsPerFix(),
+                  stage->max_allocations_per_fix);
+          success = false;
+        }
+      }
+    }
+    root.EndElement();
+  }
+
+  writer.Write('\n');
+  writer.Flush();
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "DebugReplay.hpp"
 #include "DebugReplayIGC.hpp"
+#include "DebugReplayTraceArchive.hpp"
 #include "DebugReplayNMEA.hpp"
 #include "OS/Args.hpp"
 #include "OS/PathName.hpp"
@@ -70,6 +71,8 @@ CreateDebugReplay(Args &args)
 
   if (!args.IsEmpty() && MatchesExtension(args.PeekNext(), ".igc")) {
     replay = DebugReplayIGC::Create(args.ExpectNextPath());
+  } else if (!args.IsEmpty() && MatchesExtension(args.PeekNext(), ".xta")) {
+    replay = DebugReplayTraceArchive::Create(args.ExpectNextPath());
   } else {
     const auto driver_name = args.ExpectNextT();
     const auto input_file = args.ExpectNextPath();
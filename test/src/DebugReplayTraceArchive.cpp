@@ -0,0 +1,105 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "DebugReplayTraceArchive.hpp"
+#include "OS/Path.hpp"
+
+DebugReplayTraceArchive::DebugReplayTraceArchive(Path path)
+  :archive(path)
+{
+  chunk.size = 0;
+
+  if (archive.GetDate().IsPlausible())
+    (BrokenDate &)raw_basic.date_time_utc = archive.GetDate();
+}
+
+DebugReplay *
+DebugReplayTraceArchive::Create(Path input_file)
+{
+  return new DebugReplayTraceArchive(input_file);
+}
+
+bool
+DebugReplayTraceArchive::Next()
+{
+  last_basic = computed_basic;
+
+  while (position >= chunk.size) {
+    if (next_chunk >= archive.GetChunkCount()) {
+      if (computed_basic.time_available)
+        flying_computer.Finish(calculated.flight, computed_basic.time);
+
+      return false;
+    }
+
+    /* the vario column is not needed, BasicComputer calculates it
+       from the altitude */
+    archive.Decode(next_chunk++, chunk,
+                   TraceArchive::ALL_COLUMNS &
+                   ~(1u << TraceArchive::VARIO));
+    position = 0;
+  }
+
+  CopyFromChunk(position++);
+  ++n_read;
+
+  Compute();
+  return true;
+}
+
+void
+DebugReplayTraceArchive::CopyFromChunk(unsigned i)
+{
+  NMEAInfo &basic = raw_basic;
+
+  const unsigned time = chunk.time[i];
+  const unsigned second_of_day = time % (24 * 3600);
+
+  if (time / (24 * 3600) > day) {
+    /* midnight roll-over */
+    ++day;
+    basic.date_time_utc.IncrementDay();
+  }
+
+  basic.clock = basic.time = second_of_day;
+  basic.time_available.Update(basic.clock);
+  basic.date_time_utc.hour = second_of_day / 3600;
+  basic.date_time_utc.minute = second_of_day / 60 % 60;
+  basic.date_time_utc.second = second_of_day % 60;
+  basic.alive.Update(basic.clock);
+  basic.location = chunk.GetLocation(i);
+
+  if (chunk.gps_valid[i]) {
+    basic.location_available.Update(basic.clock);
+    basic.gps_altitude = chunk.gps_altitude[i];
+    basic.gps_altitude_available.Update(basic.clock);
+  } else {
+    basic.location_available.Clear();
+    basic.gps_altitude_available.Clear();
+  }
+
+  if (chunk.pressure_altitude[i] != 0) {
+    basic.pressure_altitude = chunk.pressure_altitude[i];
+    basic.pressure_altitude_available.Update(basic.clock);
+  }
+}
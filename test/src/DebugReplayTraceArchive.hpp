@@ -0,0 +1,81 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_DEBUG_REPLAY_TRACE_ARCHIVE_HPP
+#define XCSOAR_DEBUG_REPLAY_TRACE_ARCHIVE_HPP
+
+#include "DebugReplay.hpp"
+#include "IGC/TraceArchive.hpp"
+
+class Path;
+
+/**
+ * Replays the fixes of a #TraceArchive (".xta" file written by the
+ * logger next to each IGC file).  The archive has no IGC extensions
+ * (airspeed, ENL, ...), only location, time and altitude.
+ */
+class DebugReplayTraceArchive : public DebugReplay {
+  TraceArchive archive;
+
+  TraceArchive::Chunk chunk;
+
+  /**
+   * The index of the next chunk to be decoded.
+   */
+  unsigned next_chunk = 0;
+
+  /**
+   * The index of the next fix within #chunk.
+   */
+  unsigned position = 0;
+
+  /**
+   * The number of fixes returned so far.
+   */
+  unsigned n_read = 0;
+
+  /**
+   * The number of days since the archive's date.
+   */
+  unsigned day = 0;
+
+  explicit DebugReplayTraceArchive(Path path);
+
+public:
+  long Size() const override {
+    return archive.GetFixCount();
+  }
+
+  long Tell() const override {
+    return n_read;
+  }
+
+  bool Next() override;
+
+  static DebugReplay *Create(Path input_file);
+
+private:
+  void CopyFromChunk(unsigned i);
+};
+
+#endif
@@ -0,0 +1,95 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_FLIGHT_ANALYSIS_HPP
+#define XCSOAR_FLIGHT_ANALYSIS_HPP
+
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Contest/ContestStatistics.hpp"
+#include "Computer/CirclingComputer.hpp"
+#include "Time/BrokenDateTime.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "FlightPhaseDetector.hpp"
+
+class DebugReplay;
+class BufferedOutputStream;
+namespace JSON { class ObjectWriter; }
+
+/**
+ * The analysis pipeline of AnalyseFlight: replays one flight through
+ * #CirclingComputer and #FlightPhaseDetector, and scores it with
+ * #ContestManager.  The object may be reused for any number of
+ * flights; it owns all of its state, so one instance per thread can
+ * analyse flights in parallel.
+ */
+class FlightAnalysis {
+public:
+  struct Result {
+    BrokenDateTime takeoff_time, release_time, landing_time;
+    GeoPoint takeoff_location, release_location, landing_location;
+
+    void Clear();
+  };
+
+private:
+  CirclingComputer circling_computer;
+  FlightPhaseDetector flight_phase_detector;
+
+  Trace full_trace, triangle_trace, sprint_trace;
+
+  Result result;
+
+  ContestStatistics olc_plus, dmst;
+
+  /**
+   * The number of fixes which were passed to the traces.
+   */
+  unsigned n_fixes;
+
+public:
+  FlightAnalysis(unsigned full_max_points=512,
+                 unsigned triangle_max_points=1024,
+                 unsigned sprint_max_points=64);
+
+  FlightAnalysis(const FlightAnalysis &) = delete;
+  FlightAnalysis &operator=(const FlightAnalysis &) = delete;
+
+  /**
+   * Replay and score a flight, discarding the results of the
+   * previous one.
+   */
+  void Analyse(DebugReplay &replay);
+
+  unsigned GetFixCount() const {
+    return n_fixes;
+  }
+
+  /**
+   * Write the results as attributes of the given JSON object.
+   */
+  void Write(JSON::ObjectWriter &root) const;
+
+private:
+  void Replay(DebugReplay &replay);
+};
+
+#endif
@@ -0,0 +1,216 @@
+/*
+
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Replay a flight through the #DeviceBlackboard, the #MergeThread
+ * computers and the #GlideComputer as quickly as possible (see
+ * #LockStepReplay), and print a summary of the results.  The summary
+ * is deterministic and can be compared between two runs.
+ */
+
+#include "Replay/LockStepReplay.hpp"
+#include "Replay/IgcReplay.hpp"
+#include "Replay/NmeaReplay.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "MergeThread.hpp"
+#include "Computer/GlideComputer.hpp"
+#include "Computer/GlideComputerInterface.hpp"
+#include "Computer/Settings.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Task/ProtectedTaskManager.hpp"
+#include "Device/Config.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/Args.hpp"
+#include "OS/PathName.hpp"
+#include "OS/Clock.hpp"
+#include "Formatter/TimeFormatter.hpp"
+#include "Util/PrintException.hxx"
+
+#include <memory>
+#include <stdexcept>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* fake symbols: */
+
+#include "Protection.hpp"
+#include "Computer/ConditionMonitor/ConditionMonitors.hpp"
+#include "Input/InputQueue.hpp"
+#include "Logger/Logger.hpp"
+#include "Components.hpp"
+#include "Device/MultipleDevices.hpp"
+#include "FLARM/FlarmDetails.hpp"
+
+MultipleDevices *devices;
+
+void MultipleDevices::PutMacCready(double, OperationEnvironment &) {}
+void MultipleDevices::PutBugs(double, OperationEnvironment &) {}
+void MultipleDevices::PutBallast(double, double, OperationEnvironment &) {}
+void MultipleDevices::PutActiveFrequency(RadioFrequency, const TCHAR *,
+                                         OperationEnvironment &) {}
+void MultipleDevices::PutStandbyFrequency(RadioFrequency, const TCHAR *,
+                                          OperationEnvironment &) {}
+void MultipleDevices::PutQNH(const AtmosphericPressure &,
+                             OperationEnvironment &) {}
+void MultipleDevices::NotifySensorUpdate(const MoreData &) {}
+
+const TCHAR *
+FlarmDetails::LookupCallsign(FlarmId id)
+{
+  return nullptr;
+}
+
+void TriggerMergeThread() {}
+void TriggerGPSUpdate() {}
+void TriggerVarioUpdate() {}
+void TriggerCalculatedUpdate() {}
+
+void
+ConditionMonitorsUpdate(const NMEAInfo &basic, const DerivedInfo &calculated,
+                        const ComputerSettings &settings)
+{
+}
+
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+
+void Logger::LogStartEvent(const NMEAInfo &gps_info) {}
+void Logger::LogFinishEvent(const NMEAInfo &gps_info) {}
+void Logger::LogPoint(const NMEAInfo &gps_info) {}
+
+/* done with fake symbols. */
+
+static std::unique_ptr<AbstractReplay>
+CreateReplay(Args &args)
+{
+  if (!args.IsEmpty() && MatchesExtension(args.PeekNext(), ".igc"))
+    return std::make_unique<IgcReplay>
+      (std::make_unique<FileLineReaderA>(args.ExpectNextPath()));
+
+  DeviceConfig config;
+  config.Clear();
+  config.driver_name = args.ExpectNextT().c_str();
+
+  const auto path = args.ExpectNextPath();
+  return std::make_unique<NmeaReplay>(std::make_unique<FileLineReaderA>(path),
+                                      config);
+}
+
+static void
+PrintTime(const char *name, double time)
+{
+  if (time < 0) {
+    printf("%s: -\n", name);
+    return;
+  }
+
+  TCHAR buffer[32];
+  FormatTime(buffer, time);
+  _tprintf(_T("%s: %s\n"), name, buffer);
+}
+
+static void
+PrintSummary(const MoreData &basic, const DerivedInfo &calculated)
+{
+  PrintTime("last fix", basic.time_available ? basic.time : -1);
+
+  const FlyingState &flight = calculated.flight;
+  PrintTime("takeoff", flight.takeoff_time);
+  PrintTime("landing", flight.landing_time);
+  printf("flight time: %.0f s\n", flight.flight_time);
+
+  const ContestResult &result = calculated.contest_stats.GetResult();
+  printf("contest score: %.2f\n", result.score);
+  printf("contest distance: %.0f m\n", result.distance);
+  printf("contest time: %.0f s\n", result.time);
+
+  printf("max height gain: %.0f m\n", calculated.max_height_gain);
+  printf("circling: %.0f%%\n", calculated.time_circling > 0
+         ? calculated.time_circling /
+           (calculated.time_circling + calculated.time_cruise) * 100
+         : 0.);
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "{DRIVER FILE.nmea | FILE.igc}");
+  std::unique_ptr<AbstractReplay> replay = CreateReplay(args);
+  args.ExpectEnd();
+
+  ComputerSettings settings;
+  settings.SetDefaults();
+  settings.polar.glide_polar_task = GlidePolar(1);
+
+  const Waypoints way_points;
+  Airspaces airspace_database;
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  TaskManager task_manager(task_behaviour, way_points);
+  task_manager.SetGlidePolar(settings.polar.glide_polar_task);
+
+  GlideComputerTaskEvents task_events;
+  task_manager.SetTaskEvents(task_events);
+
+  ProtectedTaskManager protected_task_manager(task_manager, settings.task);
+
+  GlideComputer glide_computer(settings, way_points, airspace_database,
+                               protected_task_manager, task_events);
+  glide_computer.SetContestIncremental(false);
+  glide_computer.Initialise();
+
+  DeviceBlackboard device_blackboard;
+  device_blackboard.ReadComputerSettings(settings);
+
+  MergeThread merge_thread(device_blackboard);
+
+  const uint64_t start_us = MonotonicClockUS();
+
+  unsigned n_records;
+  {
+    LockStepReplay lock_step(std::move(replay), device_blackboard,
+                             merge_thread, glide_computer);
+    lock_step.Run();
+    n_records = lock_step.GetRecordCount();
+  }
+
+  const double duration =
+    std::max(double(MonotonicClockUS() - start_us) / 1000000, 1e-6);
+
+  glide_computer.ProcessExhaustive();
+
+  PrintSummary(glide_computer.Basic(), glide_computer.Calculated());
+
+  fprintf(stderr, "# %u records, %.3f s, %.0f records/s\n",
+          n_records, duration, n_records / duration);
+
+  return EXIT_SUCCESS;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
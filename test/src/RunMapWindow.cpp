@@ -27,6 +27,8 @@ Copyright_License {
 #define ENABLE_MAIN_WINDOW
 #define ENABLE_CLOSE_BUTTON
 #define ENABLE_LOOK
+#define ENABLE_CMDLINE
+#define USAGE "[-WxH] [--benchmark FRAMES]"
 #include "Main.hpp"
 #include "MapWindow/MapWindow.hpp"
 #include "Terrain/RasterTerrain.hpp"
@@ -47,6 +49,9 @@ Copyright_License {
 #include "IO/LineReader.hpp"
 #include "Operation/Operation.hpp"
 #include "Thread/Debug.hpp"
+#include "Time/PeriodClock.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Util/StringAPI.hxx"
 
 void
 DeviceBlackboard::SetStartupLocation(const GeoPoint &loc, const double alt) {}
@@ -68,6 +73,12 @@ static Airspaces airspace_database;
 static TopographyStore *topography;
 static RasterTerrain *terrain;
 
+/**
+ * If non-zero, then the map is redrawn this number of times and the
+ * average frame time is printed instead of running the event loop.
+ */
+static unsigned benchmark_frames;
+
 class DrawThread {
 public:
 #ifndef ENABLE_OPENGL
@@ -109,6 +120,21 @@ public:
   }
 };
 
+static void
+ParseCommandLine(Args &args)
+{
+  const char *a = args.PeekNext();
+  if (a != nullptr && StringIsEqual(a, "--benchmark")) {
+    args.GetNext();
+    a = args.ExpectNext();
+
+    char *endptr;
+    benchmark_frames = ParseUnsigned(a, &endptr);
+    if (endptr == a || *endptr != '\0' || benchmark_frames == 0)
+      args.UsageError();
+  }
+}
+
 static void
 LoadFiles(PlacesOfInterestSettings &poi_settings,
           TeamCodeSettings &team_code_settings)
@@ -172,6 +198,34 @@ GenerateBlackboard(MapWindow &map, const ComputerSettings &settings_computer,
   map.UpdateScreenBounds();
 }
 
+/**
+ * Redraw the map repeatedly while moving it on a small circle around
+ * the given location, and print the average time per frame.
+ */
+static void
+RunBenchmark(TestMapWindow &map, const GeoPoint center)
+{
+  PeriodClock clock;
+  clock.Update();
+
+  for (unsigned i = 0; i < benchmark_frames; ++i) {
+    const Angle bearing = Angle::FullCircle() * i / benchmark_frames;
+    map.SetLocation(GeoVector(2000, bearing).EndPoint(center));
+    map.UpdateScreenBounds();
+
+#ifdef ENABLE_OPENGL
+    map.Invalidate();
+    main_window.Refresh();
+#else
+    map.Repaint();
+#endif
+  }
+
+  const int elapsed = clock.Elapsed();
+  printf("%u frames in %d ms, %.2f ms per frame\n",
+         benchmark_frames, elapsed, double(elapsed) / benchmark_frames);
+}
+
 void
 Main()
 {
@@ -203,7 +257,10 @@ Main()
   map.initialised = true;
 #endif
 
-  main_window.RunEventLoop();
+  if (benchmark_frames > 0)
+    RunBenchmark(map, map.VisibleProjection().GetGeoLocation());
+  else
+    main_window.RunEventLoop();
 
   delete terrain;
   delete topography;
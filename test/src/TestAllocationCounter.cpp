@@ -0,0 +1,159 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "OS/AllocationCounter.hpp"
+#include "Computer/Wind/WindEKF.hpp"
+#include "TestUtil.hpp"
+
+#include <memory>
+#include <thread>
+
+#include <string.h>
+
+using namespace AllocationCounter;
+
+static AllocationCounter::Statistics statistics[MAX_SECTIONS];
+
+/**
+ * Look up the statistics of a code section.
+ */
+static const AllocationCounter::Statistics *
+Find(const char *name)
+{
+  const unsigned n = Summarise(statistics, MAX_SECTIONS);
+  for (unsigned i = 0; i < n; ++i)
+    if (strcmp(statistics[i].name, name) == 0)
+      return &statistics[i];
+
+  return nullptr;
+}
+
+static void
+TestCount()
+{
+  const uint64_t thread_start = GetThreadCount();
+  const uint64_t total_start = GetTotalCount();
+
+  delete new int(42);
+  delete[] new char[16];
+  std::unique_ptr<int> p(new (std::nothrow) int(1));
+  p.reset();
+
+  ok1(GetThreadCount() - thread_start == 3);
+  ok1(GetTotalCount() - total_start >= 3);
+
+  /* allocations by other threads are not counted for this thread,
+     but they appear in the total */
+  const uint64_t thread_start2 = GetThreadCount();
+  const uint64_t total_start2 = GetTotalCount();
+  std::thread t([](){
+      for (unsigned i = 0; i < 10; ++i)
+        delete new int(i);
+    });
+  t.join();
+
+  const uint64_t thread_delta = GetThreadCount() - thread_start2;
+  ok1(GetTotalCount() - total_start2 >= 10 + thread_delta);
+}
+
+static void
+TestRecord()
+{
+  Clear();
+  ok1(Find("a") == nullptr);
+
+  Record("a", 3);
+  Record("b", 0);
+  Record("a", 7);
+
+  const auto *a = Find("a");
+  ok1(a != nullptr);
+  ok1(a->count == 2);
+  ok1(a->total == 10);
+  ok1(a->max == 7);
+
+  const auto *b = Find("b");
+  ok1(b != nullptr);
+  ok1(b->count == 1);
+  ok1(b->total == 0);
+
+  /* the sections are kept, but their statistics are reset */
+  Clear();
+  a = Find("a");
+  ok1(a != nullptr);
+  ok1(a->count == 0 && a->total == 0 && a->max == 0);
+}
+
+static void
+TestScope()
+{
+  Clear();
+
+  for (unsigned i = 0; i < 4; ++i) {
+    const ScopeAllocationCounter counter("scope");
+    std::unique_ptr<int[]> p(new int[i + 1]);
+    if (i == 3)
+      p.reset(new int[8]);
+  }
+
+  const auto *s = Find("scope");
+  ok1(s != nullptr);
+  ok1(s->count == 4);
+  ok1(s->total == 5);
+  ok1(s->max == 2);
+}
+
+/**
+ * The wind estimator runs for every GPS fix; once initialised, it
+ * must not touch the heap.
+ */
+static void
+TestSteadyState()
+{
+  WindEKF ekf;
+  ekf.Init();
+
+  const float gps_vel[2] = { 20, 5 };
+
+  Clear();
+  for (unsigned i = 0; i < 1000; ++i) {
+    const ScopeAllocationCounter counter("WindEKF");
+    ekf.Update(25, gps_vel);
+  }
+
+  const auto *s = Find("WindEKF");
+  ok1(s != nullptr);
+  ok1(s->count == 1000);
+  ok1(s->total == 0);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(20);
+
+  TestCount();
+  TestRecord();
+  TestScope();
+  TestSteadyState();
+
+  return exit_status();
+}
@@ -0,0 +1,145 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Logger/AsyncLogWriter.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "TestUtil.hpp"
+#include "Util/PrintException.hxx"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const Path path(_T("output/test/async.log"));
+
+/**
+ * Queue many more records than fit into the buffers, forcing the
+ * producer to wait for the thread, and verify that nothing got lost
+ * or reordered.
+ */
+static void
+TestWrite()
+{
+  static constexpr unsigned n = 20000;
+
+  AsyncLogWriter::Stats stats;
+
+  {
+    AsyncLogWriter writer(path, FileOutputStream::Mode::CREATE,
+                          "TestAsyncLogWriter", 256);
+
+    char buffer[32];
+    for (unsigned i = 0; i < n; ++i) {
+      int length = sprintf(buffer, "record %u\n", i);
+      writer.Write(buffer, length);
+
+      if (i % 100 == 0)
+        writer.Flush();
+    }
+
+    writer.Sync();
+    stats = writer.GetStats();
+    ok1(!writer.HasFailed());
+  }
+
+  ok1(stats.n_dropped == 0);
+  ok1(stats.n_syncs >= 1);
+  ok1(stats.n_writes >= 1);
+  ok1(stats.max_pending <= 256);
+  ok1(stats.written_bytes == File::GetSize(path));
+
+  FileLineReaderA reader(path);
+  unsigned i = 0;
+  const char *line;
+  bool match = true;
+  char expected[32];
+  while ((line = reader.ReadLine()) != nullptr) {
+    sprintf(expected, "record %u", i++);
+    if (strcmp(line, expected) != 0)
+      match = false;
+  }
+
+  ok1(match);
+  ok1(i == n);
+}
+
+static void
+TestTryWrite()
+{
+  {
+    AsyncLogWriter writer(path, FileOutputStream::Mode::CREATE_VISIBLE,
+                          "TestAsyncLogWriter", 16);
+
+    /* too large for the buffer */
+    ok1(!writer.TryWrite("0123456789abcdefg", 17));
+    ok1(!writer.TryWriteLine("0123456789abcdef"));
+    ok1(writer.GetStats().n_dropped == 2);
+
+    ok1(writer.TryWriteLine("foo"));
+    ok1(writer.TryWriteLine("bar"));
+    writer.Sync();
+
+    const auto stats = writer.GetStats();
+    ok1(stats.n_dropped == 2);
+    ok1(stats.written_bytes == File::GetSize(path));
+  }
+
+  FileLineReaderA reader(path);
+  const char *line = reader.ReadLine();
+  ok1(line != nullptr && strcmp(line, "foo") == 0);
+  line = reader.ReadLine();
+  ok1(line != nullptr && strcmp(line, "bar") == 0);
+  ok1(reader.ReadLine() == nullptr);
+}
+
+static void
+TestEmpty()
+{
+  {
+    AsyncLogWriter writer(path, FileOutputStream::Mode::CREATE,
+                          "TestAsyncLogWriter");
+  }
+
+  ok1(File::Exists(path));
+  ok1(File::GetSize(path) == 0);
+}
+
+int main(int argc, char **argv)
+try {
+  plan_tests(20);
+
+  Directory::Create(Path(_T("output")));
+  Directory::Create(Path(_T("output/test")));
+
+  TestWrite();
+  TestTryWrite();
+  TestEmpty();
+
+  File::Delete(path);
+
+  return exit_status();
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,108 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Engine/Contest/Solvers/OLCClassic.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/Path.hpp"
+#include "TestUtil.hpp"
+#include "Util/PrintException.hxx"
+
+#include <cstdio>
+
+/**
+ * Replay the IGC file into a small (heavily thinned) trace, and solve
+ * it after each fix with two incremental OLC Classic solvers: one
+ * which repairs its search after thinning
+ * (ContestDijkstra::RepairEdges()), and one which restarts.  Both
+ * must find the same results.
+ */
+static void
+TestRepair(Path path)
+{
+  Trace trace(0, Trace::null_time, 128);
+
+  OLCClassic repair(trace), restart(trace);
+  repair.Reset();
+  restart.Reset();
+  repair.SetIncremental(true);
+  restart.SetIncremental(true);
+  repair.SetRepair(true);
+
+  FileLineReaderA reader(path);
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  unsigned n_thinned = 0, n_solved = 0, n_different = 0;
+  Serial modify_serial = trace.GetModifySerial();
+
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    IGCFix fix;
+    if (!IGCParseFix(line, extensions, fix) || !fix.gps_valid)
+      continue;
+
+    const unsigned t = fix.time.GetSecondOfDay();
+    if (t <= 1)
+      continue;
+
+    trace.push_back(TracePoint(fix.location, t, fix.gps_altitude, 0, 0));
+
+    if (trace.GetModifySerial() != modify_serial) {
+      modify_serial = trace.GetModifySerial();
+      ++n_thinned;
+    }
+
+    const SolverResult a = repair.Solve(true);
+    const SolverResult b = restart.Solve(true);
+    if (b == SolverResult::VALID)
+      ++n_solved;
+
+    if (a != b ||
+        repair.GetBestResult().score != restart.GetBestResult().score)
+      ++n_different;
+  }
+
+  printf("# thinned %u solved %u different %u score %.3f\n",
+         n_thinned, n_solved, n_different, restart.GetBestResult().score);
+
+  ok1(n_thinned > 10);
+  ok1(n_solved > 0);
+  ok1(n_different == 0);
+  ok1(repair.GetBestResult().score == restart.GetBestResult().score);
+}
+
+int main(int argc, char **argv)
+try {
+  plan_tests(4);
+
+  TestRepair(Path(_T("test/data/9crx3101.igc")));
+
+  return exit_status();
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
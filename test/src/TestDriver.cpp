@@ -183,7 +183,7 @@ TestFLARM()
 
   FlarmId id = FlarmId::Parse("DDA85C", NULL);
 
-  FlarmTraffic *traffic = nmea_info.flarm.traffic.FindTraffic(id);
+  const FlarmTraffic *traffic = nmea_info.flarm.traffic.FindTraffic(id);
   if (ok1(traffic != NULL)) {
     ok1(traffic->valid);
     ok1(traffic->alarm_level == FlarmTraffic::AlarmType::NONE);
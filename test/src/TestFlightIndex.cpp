@@ -0,0 +1,218 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Logger/FlightIndex.hpp"
+#include "Logger/FlightParser.hpp"
+#include "FlightInfo.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/FileUtil.hpp"
+#include "Time/BrokenDateTime.hpp"
+#include "Util/StringAPI.hxx"
+#include "Util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static const Path log_path(_T("output/test/flights.log"));
+
+/**
+ * The number of FlightIndex::Add() calls which left an index which
+ * does not match the flight log.
+ */
+static unsigned n_stale;
+
+/**
+ * Does the index header refer to the current flight log size,
+ * i.e. would #FlightIndex use it without rebuilding?
+ */
+static bool
+IsIndexCurrent()
+{
+  FILE *file = _tfopen(FlightIndex::GetIndexPath(log_path).c_str(),
+                       _T("rb"));
+  if (file == nullptr)
+    return false;
+
+  /* the header: magic, reserved, log size */
+  uint32_t magic_reserved[2];
+  uint64_t log_size;
+  const bool success =
+    fread(magic_reserved, sizeof(magic_reserved), 1, file) == 1 &&
+    fread(&log_size, sizeof(log_size), 1, file) == 1;
+  fclose(file);
+
+  return success && log_size == File::GetSize(log_path);
+}
+
+/**
+ * Append an event to the flight log and update the index, just like
+ * #FlightLogger does.
+ */
+static void
+LogEvent(const BrokenDateTime &dt, const char *type, bool update_index=true)
+{
+  const uint64_t old_size = File::GetSize(log_path);
+
+  FILE *file = _tfopen(log_path.c_str(), _T("ab"));
+  fprintf(file, "%04u-%02u-%02uT%02u:%02u:%02u %s\n",
+          dt.year, dt.month, dt.day, dt.hour, dt.minute, dt.second, type);
+  fclose(file);
+
+  if (update_index) {
+    FlightIndex::Add(log_path, old_size, File::GetSize(log_path), dt,
+                     StringIsEqual(type, "landing"));
+    if (!IsIndexCurrent())
+      ++n_stale;
+  }
+}
+
+static bool
+operator==(const FlightInfo &a, const FlightInfo &b)
+{
+  return a.date == b.date && a.start_time == b.start_time &&
+    a.end_time == b.end_time;
+}
+
+/**
+ * Compare the index with the result of #FlightParser.
+ */
+static bool
+Compare(unsigned expected_size)
+{
+  std::vector<FlightInfo> expected;
+
+  {
+    FileLineReaderA reader(log_path);
+    FlightParser parser(reader);
+    FlightInfo flight;
+    while (parser.Read(flight))
+      expected.push_back(flight);
+  }
+
+  const FlightIndex index(log_path);
+  if (index.size() != expected.size() || index.size() != expected_size)
+    return false;
+
+  /* walk backwards, like the flight list does */
+  for (unsigned i = index.size(); i-- > 0;)
+    if (!(index[i] == expected[i]))
+      return false;
+
+  return true;
+}
+
+static void
+TestIncremental()
+{
+  /* a normal flight */
+  LogEvent(BrokenDateTime(2016, 5, 1, 10, 0, 0), "start");
+  ok1(Compare(1));
+  LogEvent(BrokenDateTime(2016, 5, 1, 12, 30, 0), "landing");
+  ok1(Compare(1));
+
+  /* two starts in a row */
+  LogEvent(BrokenDateTime(2016, 5, 2, 9, 0, 0), "start");
+  LogEvent(BrokenDateTime(2016, 5, 2, 11, 0, 0), "start");
+  ok1(Compare(3));
+  LogEvent(BrokenDateTime(2016, 5, 2, 13, 0, 0), "landing");
+  ok1(Compare(3));
+
+  /* a landing without start */
+  LogEvent(BrokenDateTime(2016, 5, 3, 15, 0, 0), "landing");
+  ok1(Compare(4));
+
+  /* an improbable duration */
+  LogEvent(BrokenDateTime(2016, 5, 4, 8, 0, 0), "start");
+  LogEvent(BrokenDateTime(2016, 5, 5, 8, 0, 0), "landing");
+  ok1(Compare(6));
+
+  /* across midnight */
+  LogEvent(BrokenDateTime(2016, 5, 6, 23, 30, 0), "start");
+  LogEvent(BrokenDateTime(2016, 5, 7, 1, 0, 0), "landing");
+  ok1(Compare(7));
+
+  /* no landing yet */
+  LogEvent(BrokenDateTime(2016, 5, 8, 10, 0, 0), "start");
+  ok1(Compare(8));
+
+  const FlightIndex index(log_path);
+  ok1(index[0].end_time == BrokenTime(12, 30, 0));
+  ok1(index[1].start_time == BrokenTime(9, 0, 0) &&
+      !index[1].end_time.IsPlausible());
+  ok1(!index[3].start_time.IsPlausible() &&
+      index[3].end_time == BrokenTime(15, 0, 0));
+  ok1(index[6].Duration() == 90 * 60);
+  ok1(index[7].Duration() < 0);
+
+  ok1(n_stale == 0);
+}
+
+static void
+TestRebuild()
+{
+  const auto index_path = FlightIndex::GetIndexPath(log_path);
+
+  /* the flight log was modified behind the index' back */
+  LogEvent(BrokenDateTime(2016, 5, 8, 12, 0, 0), "landing", false);
+  ok1(Compare(8));
+
+  LogEvent(BrokenDateTime(2016, 5, 9, 12, 0, 0), "start", false);
+  LogEvent(BrokenDateTime(2016, 5, 9, 14, 0, 0), "landing");
+  ok1(Compare(9));
+
+  /* the index is missing */
+  File::Delete(index_path);
+  ok1(Compare(9));
+  ok1(File::Exists(index_path));
+
+  File::Delete(index_path);
+  LogEvent(BrokenDateTime(2016, 5, 10, 12, 0, 0), "start");
+  ok1(Compare(10));
+
+  /* the flight log is missing */
+  File::Delete(log_path);
+  const FlightIndex index(log_path);
+  ok1(index.empty());
+
+  File::Delete(index_path);
+}
+
+int main(int argc, char **argv)
+try {
+  plan_tests(20);
+
+  Directory::Create(Path(_T("output")));
+  Directory::Create(Path(_T("output/test")));
+  File::Delete(log_path);
+  File::Delete(FlightIndex::GetIndexPath(log_path));
+
+  TestIncremental();
+  TestRebuild();
+
+  return exit_status();
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
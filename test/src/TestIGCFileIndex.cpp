@@ -0,0 +1,161 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Logger/IGCFileIndex.hpp"
+#include "OS/FileUtil.hpp"
+#include "Util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static const Path directory(_T("output/test/igc-index"));
+
+static AllocatedPath
+MakePath(const TCHAR *name)
+{
+  return AllocatedPath::Build(directory, name);
+}
+
+static void
+WriteFile(Path path, size_t size)
+{
+  FILE *file = _tfopen(path.c_str(), _T("wb"));
+  for (size_t i = 0; i < size; ++i)
+    fputc('B', file);
+  fclose(file);
+}
+
+static uint64_t
+GetSize(const IGCFileIndex &index, Path path)
+{
+  auto i = index.Find(path);
+  return i != index.end() ? i->size : uint64_t(-1);
+}
+
+static void
+TestScan()
+{
+  Directory::Create(Path(_T("output/test")));
+  Directory::Create(directory);
+  Directory::Create(MakePath(_T("sub")));
+
+  WriteFile(MakePath(_T("2016-05-01-XCS-AAA-01.igc")), 100);
+  WriteFile(MakePath(_T("2016-05-02-XCS-AAA-01.igc")), 200);
+  WriteFile(MakePath(_T("sub/2016-05-03-XCS-AAA-01.igc")), 300);
+  WriteFile(MakePath(_T("flights.log")), 50);
+
+  IGCFileIndex index;
+  index.Scan(directory);
+  ok1(index.size() == 3);
+  ok1(index.GetTotalSize() == 600);
+  ok1(GetSize(index, MakePath(_T("sub/2016-05-03-XCS-AAA-01.igc"))) == 300);
+  ok1(index.Find(MakePath(_T("flights.log"))) == index.end());
+
+  /* update an existing entry */
+  index.Add(MakePath(_T("2016-05-01-XCS-AAA-01.igc")), 150);
+  ok1(index.size() == 3);
+  ok1(index.GetTotalSize() == 650);
+
+  /* add a new one */
+  index.Add(MakePath(_T("2016-05-04-XCS-AAA-01.igc")), 400);
+  ok1(index.size() == 4);
+  ok1(index.GetTotalSize() == 1050);
+
+  ok1(index.Remove(index.Find(MakePath(_T("2016-05-02-XCS-AAA-01.igc"))))
+      == 200);
+  ok1(index.size() == 3);
+  ok1(index.GetTotalSize() == 850);
+  ok1(index.Find(MakePath(_T("2016-05-02-XCS-AAA-01.igc"))) == index.end());
+}
+
+static void
+TestSaveLoad()
+{
+  const auto index_path = MakePath(_T("igc.idx"));
+  File::Delete(index_path);
+
+  IGCFileIndex index;
+  ok1(!index.Load(index_path));
+  ok1(index.empty());
+
+  index.Scan(directory);
+  index.Add(MakePath(_T("name with spaces.igc")), 12345678901ull);
+  index.Save(index_path);
+
+  IGCFileIndex loaded;
+  ok1(loaded.Load(index_path));
+  ok1(loaded.size() == index.size());
+  ok1(loaded.GetTotalSize() == index.GetTotalSize());
+  ok1(GetSize(loaded, MakePath(_T("name with spaces.igc"))) == 12345678901ull);
+  ok1(GetSize(loaded, MakePath(_T("sub/2016-05-03-XCS-AAA-01.igc"))) == 300);
+
+  /* a malformed file is rejected */
+  FILE *file = _tfopen(index_path.c_str(), _T("ab"));
+  fputs("garbage\n", file);
+  fclose(file);
+
+  ok1(!loaded.Load(index_path));
+  ok1(loaded.empty());
+  ok1(loaded.GetTotalSize() == 0);
+}
+
+static void
+TestUpdate()
+{
+  ok1(Directory::GetLastModification(directory) > 0);
+  ok1(Directory::GetLastModification(MakePath(_T("flights.log"))) == 0);
+
+  IGCFileIndex index;
+  index.Scan(directory);
+  const unsigned old_size = index.size();
+  index.Add(MakePath(_T("deleted.igc")), 10);
+
+  WriteFile(MakePath(_T("2016-05-05-XCS-AAA-01.igc")), 500);
+  WriteFile(MakePath(_T("sub/2016-05-06-XCS-AAA-01.igc")), 600);
+
+  /* only the given directory is visited, and existing entries are
+     kept */
+  index.Update(directory);
+  ok1(index.size() == old_size + 2);
+  ok1(GetSize(index, MakePath(_T("2016-05-05-XCS-AAA-01.igc"))) == 500);
+  ok1(index.Find(MakePath(_T("sub/2016-05-06-XCS-AAA-01.igc"))) ==
+      index.end());
+  ok1(GetSize(index, MakePath(_T("deleted.igc"))) == 10);
+
+  File::Delete(MakePath(_T("2016-05-05-XCS-AAA-01.igc")));
+  File::Delete(MakePath(_T("sub/2016-05-06-XCS-AAA-01.igc")));
+}
+
+int main(int argc, char **argv)
+try {
+  plan_tests(28);
+
+  TestScan();
+  TestSaveLoad();
+  TestUpdate();
+
+  return exit_status();
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
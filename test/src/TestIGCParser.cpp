@@ -172,6 +172,22 @@ TestFix()
   ok1(fix.gps_altitude == 7);
 }
 
+static void
+TestFixExtensions()
+{
+  IGCExtensions extensions;
+  ok1(IGCParseExtensions("I033640GSP4142IAS4345ENL", extensions));
+
+  /* GSP has two decimal places which are ignored; IAS is too short
+     for three digits and must not borrow from the ENL column */
+  IGCFix fix;
+  ok1(IGCParseFix("B1122385103117N00742367EA0049000487" "12345" "67" "089",
+                  extensions, fix));
+  ok1(fix.gsp == 123);
+  ok1(fix.ias == -1);
+  ok1(fix.enl == 89);
+}
+
 static void
 TestFixTime()
 {
@@ -252,13 +268,14 @@ TestDeclarationTurnpoint()
 
 int main(int argc, char **argv)
 {
-  plan_tests(136);
+  plan_tests(141);
 
   TestHeader();
   TestDate();
   TestLocation();
   TestExtensions();
   TestFix();
+  TestFixExtensions();
   TestFixTime();
   TestDeclarationHeader();
   TestDeclarationTurnpoint();
@@ -0,0 +1,184 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Replay a flight twice with #LockStepReplay and verify that both
+ * runs yield exactly the same results, i.e. that nothing in the
+ * calculation depends on the wall clock.
+ */
+
+#include "Replay/LockStepReplay.hpp"
+#include "Replay/IgcReplay.hpp"
+#include "Blackboard/DeviceBlackboard.hpp"
+#include "MergeThread.hpp"
+#include "Computer/GlideComputer.hpp"
+#include "Computer/GlideComputerInterface.hpp"
+#include "Computer/Settings.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Task/ProtectedTaskManager.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/Path.hpp"
+#include "TestUtil.hpp"
+
+#include <memory>
+
+/* fake symbols: */
+
+#include "Protection.hpp"
+#include "Computer/ConditionMonitor/ConditionMonitors.hpp"
+#include "Input/InputQueue.hpp"
+#include "Logger/Logger.hpp"
+#include "Components.hpp"
+#include "Device/MultipleDevices.hpp"
+#include "FLARM/FlarmDetails.hpp"
+
+MultipleDevices *devices;
+
+void MultipleDevices::PutMacCready(double, OperationEnvironment &) {}
+void MultipleDevices::PutBugs(double, OperationEnvironment &) {}
+void MultipleDevices::PutBallast(double, double, OperationEnvironment &) {}
+void MultipleDevices::PutActiveFrequency(RadioFrequency, const TCHAR *,
+                                         OperationEnvironment &) {}
+void MultipleDevices::PutStandbyFrequency(RadioFrequency, const TCHAR *,
+                                          OperationEnvironment &) {}
+void MultipleDevices::PutQNH(const AtmosphericPressure &,
+                             OperationEnvironment &) {}
+void MultipleDevices::NotifySensorUpdate(const MoreData &) {}
+
+const TCHAR *
+FlarmDetails::LookupCallsign(FlarmId id)
+{
+  return nullptr;
+}
+
+void TriggerMergeThread() {}
+void TriggerGPSUpdate() {}
+void TriggerVarioUpdate() {}
+void TriggerCalculatedUpdate() {}
+
+void
+ConditionMonitorsUpdate(const NMEAInfo &basic, const DerivedInfo &calculated,
+                        const ComputerSettings &settings)
+{
+}
+
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+
+void Logger::LogStartEvent(const NMEAInfo &gps_info) {}
+void Logger::LogFinishEvent(const NMEAInfo &gps_info) {}
+void Logger::LogPoint(const NMEAInfo &gps_info) {}
+
+/* done with fake symbols. */
+
+struct ReplayResult {
+  unsigned n_records;
+
+  double last_fix;
+  double takeoff_time, landing_time;
+  double max_height_gain;
+  double time_circling;
+
+  ContestResult contest;
+};
+
+static ReplayResult
+Replay(const char *path)
+{
+  ComputerSettings settings;
+  settings.SetDefaults();
+  settings.polar.glide_polar_task = GlidePolar(1);
+
+  const Waypoints way_points;
+  Airspaces airspace_database;
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  TaskManager task_manager(task_behaviour, way_points);
+  task_manager.SetGlidePolar(settings.polar.glide_polar_task);
+
+  GlideComputerTaskEvents task_events;
+  task_manager.SetTaskEvents(task_events);
+
+  ProtectedTaskManager protected_task_manager(task_manager, settings.task);
+
+  GlideComputer glide_computer(settings, way_points, airspace_database,
+                               protected_task_manager, task_events);
+  glide_computer.SetContestIncremental(false);
+  glide_computer.Initialise();
+
+  DeviceBlackboard device_blackboard;
+  device_blackboard.ReadComputerSettings(settings);
+
+  MergeThread merge_thread(device_blackboard);
+
+  ReplayResult result;
+
+  {
+    LockStepReplay lock_step(std::make_unique<IgcReplay>
+                             (std::make_unique<FileLineReaderA>(Path(path))),
+                             device_blackboard, merge_thread,
+                             glide_computer);
+    lock_step.Run();
+    result.n_records = lock_step.GetRecordCount();
+  }
+
+  glide_computer.ProcessExhaustive();
+
+  const MoreData &basic = glide_computer.Basic();
+  const DerivedInfo &calculated = glide_computer.Calculated();
+
+  result.last_fix = basic.time;
+  result.takeoff_time = calculated.flight.takeoff_time;
+  result.landing_time = calculated.flight.landing_time;
+  result.max_height_gain = calculated.max_height_gain;
+  result.time_circling = calculated.time_circling;
+  result.contest = calculated.contest_stats.GetResult();
+  return result;
+}
+
+int
+main(int argc, char **argv)
+{
+  plan_tests(11);
+
+  const char *path = "test/data/01lz1hq1.igc";
+  const ReplayResult a = Replay(path);
+  const ReplayResult b = Replay(path);
+
+  ok1(a.n_records > 0);
+  ok1(a.contest.score > 0);
+
+  ok1(a.n_records == b.n_records);
+  ok1(a.last_fix == b.last_fix);
+  ok1(a.takeoff_time == b.takeoff_time);
+  ok1(a.landing_time == b.landing_time);
+  ok1(a.max_height_gain == b.max_height_gain);
+  ok1(a.time_circling == b.time_circling);
+  ok1(a.contest.score == b.contest.score);
+  ok1(a.contest.distance == b.contest.distance);
+  ok1(a.contest.time == b.contest.time);
+
+  return exit_status();
+}
@@ -0,0 +1,99 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Logger/MD5.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#include <string.h>
+
+static constexpr struct {
+  const char *input;
+  const char *digest;
+} rfc1321[] = {
+  { "", "d41d8cd98f00b204e9800998ecf8427e" },
+  { "a", "0cc175b9c0f1b6a831c399e269772661" },
+  { "abc", "900150983cd24fb0d6963f7d28e17f72" },
+  { "message digest", "f96b697d7cb7938d525a2f31aaf161d0" },
+  { "abcdefghijklmnopqrstuvwxyz", "c3fcd3d76192e4007dfb496cca67e13b" },
+  { "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+    "d174ab98d277d9f5a5611c2c9f419d9f" },
+  { "1234567890123456789012345678901234567890"
+    "1234567890123456789012345678901234567890",
+    "57edf4a22be3c955ac49da2e2107b67a" },
+};
+
+static bool
+CheckDigest(const MD5 &md5, const char *expected)
+{
+  char digest[MD5::DIGEST_LENGTH + 1];
+  md5.GetDigest(digest);
+  return strcmp(digest, expected) == 0;
+}
+
+/**
+ * Append the input in chunks of the given size.
+ */
+static bool
+CheckChunked(const char *input, const char *expected, size_t chunk_size)
+{
+  MD5 md5;
+  md5.Initialise();
+
+  for (size_t length = strlen(input); length > 0;) {
+    const size_t n = chunk_size < length ? chunk_size : length;
+    md5.Append(input, n);
+    input += n;
+    length -= n;
+  }
+
+  md5.Finalize();
+  return CheckDigest(md5, expected);
+}
+
+static bool
+CheckBytes(const char *input, const char *expected)
+{
+  MD5 md5;
+  md5.Initialise();
+
+  while (*input != 0)
+    md5.Append((uint8_t)*input++);
+
+  md5.Finalize();
+  return CheckDigest(md5, expected);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(ARRAY_SIZE(rfc1321) * 5);
+
+  for (const auto &i : rfc1321) {
+    ok1(CheckBytes(i.input, i.digest));
+    ok1(CheckChunked(i.input, i.digest, 1));
+    ok1(CheckChunked(i.input, i.digest, 7));
+    ok1(CheckChunked(i.input, i.digest, 64));
+    ok1(CheckChunked(i.input, i.digest, 1000));
+  }
+
+  return exit_status();
+}
@@ -139,25 +139,77 @@ TestAll()
   TestWind(SpeedVector(Angle::Zero(), 30));
 }
 
+/**
+ * Compare GlidePolar::SolveStraightBatch() with
+ * MacCready::SolveStraight().
+ */
+static void
+TestBatch(const SpeedVector wind)
+{
+  static constexpr unsigned N = 48;
+  double distance[N], altitude_difference[N], arrival[N];
+  Angle bearing[N];
+
+  for (unsigned i = 0; i < N; ++i) {
+    distance[i] = 2000 + 3000 * (i % 7);
+    bearing[i] = Angle::Degrees(i * 360. / N);
+    altitude_difference[i] = -300 + 100 * (i % 11);
+  }
+
+  glide_polar.SolveStraightBatch(wind, N, distance, bearing,
+                                 altitude_difference, arrival);
+
+  const MacCready mac_cready(glide_settings, glide_polar);
+  bool success = true;
+  for (unsigned i = 0; i < N; ++i) {
+    const GlideState state(GeoVector(distance[i], bearing[i]),
+                           0, altitude_difference[i], wind);
+    const GlideResult result = mac_cready.SolveStraight(state);
+    if (!result.IsOk()) {
+      success &= arrival[i] <= GlidePolar::UNREACHABLE;
+      continue;
+    }
+
+    success &= fabs(arrival[i] - result.pure_glide_altitude_difference) <=
+      1e-6 * distance[i];
+  }
+
+  ok(success, "batch wind=%f", wind.norm);
+}
+
+static void
+TestBatchAll()
+{
+  TestBatch(SpeedVector(Angle::Zero(), 0));
+  TestBatch(SpeedVector(Angle::Degrees(60), 5));
+  TestBatch(SpeedVector(Angle::Degrees(200), 15));
+  TestBatch(SpeedVector(Angle::Degrees(90), 25));
+}
+
 int main(int argc, char **argv)
 {
-  plan_tests(2095);
+  plan_tests(2115);
 
   glide_settings.SetDefaults();
 
   TestAll();
+  TestBatchAll();
 
   glide_polar.SetMC(0.1);
   TestAll();
+  TestBatchAll();
 
   glide_polar.SetMC(1);
   TestAll();
+  TestBatchAll();
 
   glide_polar.SetMC(4);
   TestAll();
+  TestBatchAll();
 
   glide_polar.SetMC(10);
   TestAll();
+  TestBatchAll();
 
   return exit_status();
 }
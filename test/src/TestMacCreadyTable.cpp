@@ -0,0 +1,222 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Geo/SpeedVector.hpp"
+#include "Engine/GlideSolvers/GlideSettings.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Engine/GlideSolvers/GlideState.hpp"
+#include "Engine/GlideSolvers/GlideResult.hpp"
+#include "Engine/GlideSolvers/MacCready.hpp"
+#include "Engine/GlideSolvers/MacCreadyTable.hpp"
+
+#include "TestUtil.hpp"
+
+#include <algorithm>
+
+#include <stdio.h>
+
+static GlideSettings glide_settings;
+static GlidePolar glide_polar(0);
+static MacCreadyTable table;
+
+static double max_error_height, max_error_time;
+
+/**
+ * Compare the interpolated solution with the analytic one.  Heights
+ * may differ by 0.5% of the distance, times by 1%.
+ */
+static bool
+Compare(const GlideState &task)
+{
+  const GlideResult expected =
+    MacCready::Solve(glide_settings, glide_polar, task);
+  const GlideResult actual = table.Solve(glide_settings, glide_polar, task);
+
+  if (actual.validity != expected.validity)
+    return false;
+
+  if (!expected.IsOk())
+    return true;
+
+  const double distance = task.vector.distance;
+  const double error_height =
+    std::max({fabs(actual.height_glide - expected.height_glide),
+              fabs(actual.height_climb - expected.height_climb),
+              fabs(actual.pure_glide_height - expected.pure_glide_height),
+              fabs(actual.altitude_difference -
+                   expected.altitude_difference)}) / distance;
+  const double error_time =
+    fabs(actual.time_elapsed - expected.time_elapsed) /
+    std::max(expected.time_elapsed, 1.);
+
+  max_error_height = std::max(max_error_height, error_height);
+  max_error_time = std::max(max_error_time, error_time);
+
+  return error_height < 0.005 && error_time < 0.01 &&
+    actual.IsFinalGlide() == expected.IsFinalGlide();
+}
+
+static void
+TestWind(const SpeedVector wind)
+{
+  table.Build(glide_settings, glide_polar, wind);
+  ok1(table.IsValid(glide_polar, wind));
+
+  unsigned n = 0, n_ok = 0, n_hit = 0;
+  for (unsigned bearing = 0; bearing < 360; bearing += 17) {
+    for (const double distance : {1000., 10000., 50000., 150000.}) {
+      for (int altitude = -3000; altitude <= 4000; altitude += 125) {
+        const GlideState task(GeoVector(distance, Angle::Degrees(bearing)),
+                              500, 500 + altitude, wind);
+        ++n;
+        if (Compare(task))
+          ++n_ok;
+
+        GlideResult result;
+        if (table.Lookup(task, result))
+          ++n_hit;
+      }
+    }
+  }
+
+  ok(n_ok == n, "%u of %u solutions match", n_ok, n);
+
+  /* the table must actually be used, not just fall back to the
+     analytic solver; many of the tasks above are deliberately outside
+     of the table's gradient range or close to the final glide
+     boundary */
+  printf("# mc=%.1f wind=%.0f: %u of %u from the table\n",
+         glide_polar.GetMC(), wind.norm, n_hit, n);
+  ok1(n_hit * 3 >= n);
+}
+
+static void
+TestAll()
+{
+  TestWind(SpeedVector(Angle::Zero(), 0));
+  TestWind(SpeedVector(Angle::Zero(), 5));
+  TestWind(SpeedVector(Angle::Degrees(123), 10));
+  TestWind(SpeedVector(Angle::Degrees(250), 20));
+}
+
+/**
+ * Tasks which are outside of the table or not covered by its polar and
+ * wind must not be looked up, and must be solved exactly.
+ */
+static void
+TestFallback()
+{
+  const SpeedVector wind(Angle::Degrees(45), 8);
+  table.Build(glide_settings, glide_polar, wind);
+
+  GlideResult result;
+  const GlideState inside(GeoVector(10000, Angle::Degrees(90)),
+                          500, 800, wind);
+  ok1(table.Lookup(inside, result));
+
+  /* steeper than MIN_GRADIENT */
+  const GlideState below(GeoVector(10000, Angle::Degrees(90)),
+                         500, -1500, wind);
+  ok1(!table.Lookup(below, result));
+
+  const GlideState other_wind(GeoVector(10000, Angle::Degrees(90)),
+                              500, 800, SpeedVector(Angle::Degrees(45), 9));
+  ok1(!table.IsValid(glide_polar, other_wind.wind));
+
+  for (const GlideState *task : {&below, &other_wind}) {
+    const GlideResult expected =
+      MacCready::Solve(glide_settings, glide_polar, *task);
+    const GlideResult actual =
+      table.Solve(glide_settings, glide_polar, *task);
+    ok1(actual.time_elapsed == expected.time_elapsed &&
+        actual.altitude_difference == expected.altitude_difference);
+  }
+}
+
+/**
+ * Update() rebuilds only after as many solutions as the table has
+ * cells were requested for the same polar and wind.
+ */
+static void
+TestPostpone()
+{
+  const SpeedVector wind(Angle::Degrees(200), 6);
+  table.Clear();
+
+  for (unsigned i = 0; i < 12; ++i)
+    table.Update(glide_settings, glide_polar, wind, 100);
+  ok1(!table.IsValid(glide_polar, wind));
+
+  /* a different wind starts counting again */
+  const SpeedVector wind2(Angle::Degrees(201), 6);
+  table.Update(glide_settings, glide_polar, wind2, 100);
+  ok1(!table.IsValid(glide_polar, wind2));
+  table.Update(glide_settings, glide_polar, wind, 1200);
+  ok1(!table.IsValid(glide_polar, wind));
+
+  table.Update(glide_settings, glide_polar, wind, 21);
+  ok1(table.IsValid(glide_polar, wind));
+}
+
+static void
+TestInvalidate()
+{
+  const SpeedVector wind(Angle::Degrees(45), 8);
+  table.Build(glide_settings, glide_polar, wind);
+  ok1(table.IsValid(glide_polar, wind));
+  ok1(!table.IsValid(glide_polar, SpeedVector(Angle::Degrees(46), 8)));
+
+  GlidePolar copy = glide_polar;
+  ok1(table.IsValid(copy, wind));
+
+  copy.SetMC(glide_polar.GetMC());
+  ok1(!table.IsValid(copy, wind));
+
+  copy = glide_polar;
+  copy.SetBugs(0.9);
+  ok1(!table.IsValid(copy, wind));
+
+  copy = glide_polar;
+  copy.SetBallast(0.5);
+  ok1(!table.IsValid(copy, wind));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(75);
+
+  glide_settings.SetDefaults();
+
+  for (const double mc : {0., 0.5, 1., 2., 4.}) {
+    glide_polar.SetMC(mc);
+    TestAll();
+  }
+
+  TestFallback();
+  TestPostpone();
+  TestInvalidate();
+
+  printf("# max height error %f, max time error %f\n",
+         max_error_height, max_error_time);
+
+  return exit_status();
+}
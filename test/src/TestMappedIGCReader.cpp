@@ -0,0 +1,258 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IGC/MappedIGCReader.hpp"
+#include "IGC/IGCFixBatch.hpp"
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IO/FileLineReader.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#include <vector>
+#include <new>
+
+#include <stdio.h>
+#include <string.h>
+
+static const char *const igc_files[] = {
+  "test/data/01lz1hq1.igc",
+  "test/data/0asljd01.igc",
+  "test/data/9crx3101.igc",
+  "test/data/apf-bug554.igc",
+};
+
+/**
+ * Read all fixes with #FileLineReaderA and IGCParseFix().
+ */
+static std::vector<IGCFix>
+ReadReference(Path path)
+{
+  std::vector<IGCFix> fixes;
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  FileLineReaderA reader(path);
+  const char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    IGCFix fix;
+    if (IGCParseFix(line, extensions, fix))
+      fixes.push_back(fix);
+    else if (*line == 'I')
+      IGCParseExtensions(line, extensions);
+  }
+
+  return fixes;
+}
+
+static std::vector<IGCFix>
+ReadMapped(MappedIGCReader &reader)
+{
+  std::vector<IGCFix> fixes;
+
+  IGCFixBatch batch;
+  while (reader.Read(batch)) {
+    for (unsigned i = 0; i < batch.size; ++i) {
+      IGCFix fix;
+      batch.GetFix(i, fix);
+      fixes.push_back(fix);
+    }
+  }
+
+  return fixes;
+}
+
+static bool
+operator==(const IGCFix &a, const IGCFix &b)
+{
+  return a.time == b.time &&
+    a.location.latitude == b.location.latitude &&
+    a.location.longitude == b.location.longitude &&
+    a.gps_valid == b.gps_valid &&
+    a.gps_altitude == b.gps_altitude &&
+    a.pressure_altitude == b.pressure_altitude &&
+    a.enl == b.enl && a.rpm == b.rpm &&
+    a.hdm == b.hdm && a.hdt == b.hdt && a.trm == b.trm && a.trt == b.trt &&
+    a.gsp == b.gsp && a.ias == b.ias && a.tas == b.tas && a.siu == b.siu;
+}
+
+static void
+TestFile(const char *_path)
+{
+  const Path path(_path);
+  const auto expected = ReadReference(path);
+
+  MappedIGCReader reader(path);
+  const auto actual = ReadMapped(reader);
+
+  ok(actual == expected, "%s: %u fixes", _path, unsigned(actual.size()));
+}
+
+static constexpr char synthetic[] =
+  "AXCSfoo\r\n"
+  "HFDTE040910\r\n"
+  "I023638ENL3941GSP\r\n"
+  "B1122385103117N00742367EA0049000487123045\r\n"
+  /* negative pressure altitude */
+  "B1122395103117N00742367EV-001200487123045\r\n"
+  /* blanks instead of leading zeroes */
+  "B1122405103117N00742367EA  490 0487123045\r\n"
+  /* too short */
+  "B1122415103117N00742367EA\r\n"
+  /* invalid time */
+  "B1162425103117N00742367EA0049000487123045\n"
+  /* GSP column is shorter than 3 characters */
+  "I023637ENL3839GSP\n"
+  "B1122435103117N00742367EA0049000487123045\n"
+  "HFDTE050910\n"
+  "B1122445103117S00742367WA0049000487123045";
+
+static void
+TestSynthetic()
+{
+  const Path path(_T("output/test/mapped_igc_reader.igc"));
+
+  Directory::Create(Path(_T("output")));
+  Directory::Create(Path(_T("output/test")));
+
+  FILE *file = fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    skip(14, 0, "Failed to create %s", path.c_str());
+    return;
+  }
+
+  fwrite(synthetic, 1, strlen(synthetic), file);
+  fclose(file);
+
+  const auto expected = ReadReference(path);
+  ok1(expected.size() == 5);
+
+  MappedIGCReader reader(path);
+  IGCFixBatch batch;
+
+  /* the batch ends at the second "I" record */
+  ok1(reader.Read(batch));
+  ok1(batch.size == 3);
+  ok1(reader.GetDate() == BrokenDate(2010, 9, 4));
+  ok1(batch.extensions[IGCFixBatch::ENL][0] == 123);
+  ok1(batch.extensions[IGCFixBatch::GSP][0] == 45);
+  ok1(batch.pressure_altitude[1] == -12);
+  ok1(!batch.gps_valid[1]);
+
+  ok1(reader.Read(batch));
+  ok1(batch.size == 1);
+  ok1(batch.extensions[IGCFixBatch::GSP][0] == -1);
+
+  ok1(reader.Read(batch));
+  ok1(reader.GetDate() == BrokenDate(2010, 9, 5));
+
+  MappedIGCReader reader2(path);
+  ok1(ReadMapped(reader2) == expected);
+}
+
+static void
+TestCapacity()
+{
+  const Path path(_T("output/test/mapped_igc_reader_long.igc"));
+
+  FILE *file = fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    skip(3, 0, "Failed to create %s", path.c_str());
+    return;
+  }
+
+  constexpr unsigned n = IGCFixBatch::CAPACITY * 2 + 7;
+  for (unsigned i = 0; i < n; ++i)
+    fprintf(file, "B%02u%02u%02u5103117N00742367EA%05u00487\n",
+            10 + i / 3600, (i / 60) % 60, i % 60, i);
+  fclose(file);
+
+  MappedIGCReader reader(path);
+  IGCFixBatch batch;
+  unsigned total = 0, n_batches = 0;
+  bool ordered = true;
+  while (reader.Read(batch)) {
+    for (unsigned i = 0; i < batch.size; ++i)
+      ordered &= batch.pressure_altitude[i] == int(total + i);
+    total += batch.size;
+    ++n_batches;
+  }
+
+  ok1(total == n);
+  ok1(n_batches == 3);
+  ok1(ordered);
+}
+
+/**
+ * A file without an "I" record must not read any extension column,
+ * even if the reader's memory was not zeroed before construction.
+ */
+static void
+TestNoExtensions()
+{
+  const Path path(_T("output/test/mapped_igc_reader_no_i.igc"));
+
+  FILE *file = fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    skip(5, 0, "Failed to create %s", path.c_str());
+    return;
+  }
+
+  fputs("AXCSfoo\n"
+        "HFDTE040910\n"
+        "B1122385103117N00742367EA0049000487123045\n"
+        "B1122395103117N00742367EA0049100488123045\n", file);
+  fclose(file);
+
+  alignas(MappedIGCReader) char buffer[sizeof(MappedIGCReader)];
+  memset(buffer, 0x5a, sizeof(buffer));
+  MappedIGCReader *reader = new(buffer) MappedIGCReader(path);
+
+  IGCFixBatch batch;
+  ok1(reader->Read(batch));
+  ok1(batch.size == 2);
+  ok1(batch.extensions[IGCFixBatch::ENL][0] == -1);
+  ok1(batch.extensions[IGCFixBatch::GSP][1] == -1);
+
+  MappedIGCReader reader2(path);
+  ok1(ReadMapped(reader2) == ReadReference(path));
+
+  reader->~MappedIGCReader();
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(ARRAY_SIZE(igc_files) + 14 + 3 + 5);
+
+  for (const char *path : igc_files)
+    TestFile(path);
+
+  TestSynthetic();
+  TestCapacity();
+  TestNoExtensions();
+
+  return exit_status();
+}
@@ -0,0 +1,302 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compares the SIMD pixel operations and export kernels with their
+ * portable versions, byte by byte.  All widths up to MAX_WIDTH and
+ * all alignments are covered, so every vector loop is combined with
+ * every possible remainder.
+ */
+
+#include "Screen/Memory/Export.hpp"
+#include "Screen/Memory/Buffer.hpp"
+#include "Screen/Memory/PixelOperations.hpp"
+#include "Screen/Memory/Optimised.hpp"
+#include "Screen/Memory/AVX2.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+
+#include <stdint.h>
+#include <string.h>
+
+static constexpr unsigned MAX_WIDTH = 67;
+static constexpr unsigned MAX_OFFSET = 4;
+
+/* room for MAX_WIDTH pixels of 4 bytes at any offset */
+static constexpr size_t BUFFER_SIZE = (MAX_WIDTH + MAX_OFFSET) * 4;
+
+static unsigned random_state = 1;
+
+static void
+FillRandom(void *_p, size_t size)
+{
+  uint8_t *p = (uint8_t *)_p;
+  for (size_t i = 0; i < size; ++i) {
+    random_state = random_state * 1103515245 + 12345;
+    p[i] = random_state >> 16;
+  }
+}
+
+/**
+ * Call f(width, offset) for all widths and source/destination
+ * alignments, and check that it returns true each time.
+ */
+template<typename F>
+static bool
+ForAllWidths(F &&f)
+{
+  for (unsigned width = 0; width <= MAX_WIDTH; ++width)
+    for (unsigned offset = 0; offset < MAX_OFFSET; ++offset)
+      if (!f(width, offset)) {
+        printf("# mismatch at width=%u offset=%u\n", width, offset);
+        return false;
+      }
+
+  return true;
+}
+
+/**
+ * Run a conversion kernel the way Export.cpp combines them: the
+ * vector kernel returns how many pixels it did, and the portable
+ * function converts the rest.  The bytes after the last pixel must
+ * stay untouched.
+ */
+template<typename D, typename S, typename Kernel, typename Portable>
+static bool
+CheckConversion(Kernel &&kernel, Portable &&portable)
+{
+  return ForAllWidths([&](unsigned width, unsigned offset){
+      alignas(32) uint8_t src[BUFFER_SIZE];
+      alignas(32) uint8_t expected[BUFFER_SIZE], actual[BUFFER_SIZE];
+      FillRandom(src, sizeof(src));
+      FillRandom(expected, sizeof(expected));
+      std::copy_n(expected, sizeof(expected), actual);
+
+      const S *s = (const S *)(src + offset);
+      D *e = (D *)(expected + offset);
+      D *a = (D *)(actual + offset);
+
+      portable(e, s, width);
+
+      const unsigned done = kernel(a, s, width);
+      if (done > width)
+        return false;
+
+      portable(a + done, s + done, width - done);
+
+      return memcmp(expected, actual, sizeof(expected)) == 0;
+    });
+}
+
+#ifdef __SSE2__
+
+static unsigned
+SSE2GreyscaleToRGB565Loop(RGB565Color *dest, const Luminosity8 *src,
+                          unsigned width)
+{
+  unsigned done = 0;
+  for (; done + 16 <= width; done += 16)
+    SSE2GreyscaleToRGB565((uint8_t *)(dest + done),
+                          (const uint8_t *)(src + done));
+  return done;
+}
+
+static unsigned
+SSE2GreyscaleToRGB8Loop(uint32_t *dest, const Luminosity8 *src,
+                        unsigned width)
+{
+  unsigned done = 0;
+  for (; done + 16 <= width; done += 16)
+    SSE2GreyscaleToRGB8((uint8_t *)(dest + done),
+                        (const uint8_t *)(src + done));
+  return done;
+}
+
+static unsigned
+SSE2BGRAToRGB565Loop(RGB565Color *dest, const BGRA8Color *src,
+                     unsigned width)
+{
+  unsigned done = 0;
+  for (; done + 8 <= width; done += 8)
+    SSE2BGRAToRGB565((uint8_t *)(dest + done),
+                     (const uint8_t *)(src + done));
+  return done;
+}
+
+#endif
+
+static void
+TestExportKernels()
+{
+#ifdef __SSE2__
+  ok1((CheckConversion<RGB565Color, Luminosity8>(SSE2GreyscaleToRGB565Loop,
+                                                 CopyGreyscaleToRGB565)));
+  ok1((CheckConversion<uint32_t, Luminosity8>(SSE2GreyscaleToRGB8Loop,
+                                              CopyGreyscaleToRGB8)));
+  ok1((CheckConversion<RGB565Color, BGRA8Color>(SSE2BGRAToRGB565Loop,
+                                                BGRAToRGB565)));
+#else
+  skip(3, 0, "no SSE2");
+#endif
+
+#ifdef HAVE_AVX2_DISPATCH
+  if (HaveAVX2()) {
+    ok1((CheckConversion<RGB565Color, Luminosity8>(AVX2GreyscaleToRGB565,
+                                                   CopyGreyscaleToRGB565)));
+    ok1((CheckConversion<uint32_t, Luminosity8>(AVX2GreyscaleToRGB8,
+                                                CopyGreyscaleToRGB8)));
+    ok1((CheckConversion<RGB565Color, BGRA8Color>(AVX2BGRAToRGB565,
+                                                  BGRAToRGB565)));
+  } else
+    skip(3, 0, "CPU does not support AVX2");
+#else
+  skip(3, 0, "no AVX2");
+#endif
+}
+
+#ifndef GREYSCALE
+
+/**
+ * Check CopyFromBGRA(), which picks the kernels at run time, on a
+ * few rows with a pitch that is not a multiple of the vector size.
+ */
+static bool
+CheckCopyFromBGRA()
+{
+  return ForAllWidths([](unsigned width, unsigned offset){
+      static constexpr unsigned HEIGHT = 3;
+      const unsigned src_pitch = (width + offset) * sizeof(BGRA8Color);
+      const unsigned dest_pitch = (width + 1) * sizeof(RGB565Color);
+
+      BGRA8Color src[HEIGHT * (MAX_WIDTH + MAX_OFFSET)];
+      RGB565Color expected[HEIGHT * (MAX_WIDTH + 1)];
+      RGB565Color actual[HEIGHT * (MAX_WIDTH + 1)];
+      FillRandom(src, sizeof(src));
+      FillRandom(expected, sizeof(expected));
+      std::copy_n(expected, HEIGHT * (MAX_WIDTH + 1), actual);
+
+      for (unsigned y = 0; y < HEIGHT; ++y)
+        BGRAToRGB565(expected + y * (width + 1), src + y * (width + offset),
+                     width);
+
+      CopyFromBGRA(actual, dest_pitch, sizeof(RGB565Color),
+                   ConstImageBuffer<BGRAPixelTraits>(src, src_pitch,
+                                                     width, HEIGHT));
+
+      return memcmp(expected, actual, sizeof(expected)) == 0;
+    });
+}
+
+#endif
+
+/**
+ * Compare one pixel operation class with its portable version.
+ *
+ * @param key every third source pixel is set to this color
+ * @param f a function which applies the given operation to a row
+ * of pixels
+ */
+template<typename PixelTraits, typename Optimised, typename Portable,
+         typename F>
+static bool
+CheckPixelOperation(const Optimised &optimised, const Portable &portable,
+                    typename PixelTraits::color_type key, F &&f)
+{
+  typedef typename PixelTraits::color_type color_type;
+
+  return ForAllWidths([&](unsigned width, unsigned offset){
+      alignas(16) uint8_t src[BUFFER_SIZE];
+      alignas(16) uint8_t expected[BUFFER_SIZE], actual[BUFFER_SIZE];
+      FillRandom(src, sizeof(src));
+      FillRandom(expected, sizeof(expected));
+      std::copy_n(expected, sizeof(expected), actual);
+
+      color_type *s = (color_type *)(src + offset * sizeof(color_type));
+      for (unsigned i = 0; i < width; i += 3)
+        s[i] = key;
+
+      f(optimised, (color_type *)(actual + offset * sizeof(color_type)),
+        s, width);
+      f(portable, (color_type *)(expected + offset * sizeof(color_type)),
+        s, width);
+
+      return memcmp(expected, actual, sizeof(expected)) == 0;
+    });
+}
+
+template<typename PixelTraits>
+static void
+TestPixelOperations(typename PixelTraits::color_type key)
+{
+  typedef typename PixelTraits::color_type color_type;
+
+  const auto copy = [](const auto &op, color_type *p, const color_type *q,
+                       unsigned n){
+    op.CopyPixels(p, q, n);
+  };
+
+  const auto fill = [](const auto &op, color_type *p, const color_type *q,
+                       unsigned n){
+    if (n > 0)
+      op.FillPixels(p, n, q[1 % n]);
+  };
+
+  bool alpha_copy = true, alpha_fill = true;
+  for (unsigned alpha : {0u, 1u, 0x7fu, 0x80u, 0xfeu, 0xffu}) {
+    const AlphaPixelOperations<PixelTraits> optimised(alpha);
+    const PortableAlphaPixelOperations<PixelTraits> portable(alpha);
+    alpha_copy = alpha_copy &&
+      CheckPixelOperation<PixelTraits>(optimised, portable, key, copy);
+    alpha_fill = alpha_fill &&
+      CheckPixelOperation<PixelTraits>(optimised, portable, key, fill);
+  }
+
+  ok1(alpha_copy);
+  ok1(alpha_fill);
+
+  ok1(CheckPixelOperation<PixelTraits>(TransparentPixelOperations<PixelTraits>(key),
+                                       PortableTransparentPixelOperations<PixelTraits>(key),
+                                       key, copy));
+
+  ok1(CheckPixelOperation<PixelTraits>(BitOrPixelOperations<PixelTraits>(),
+                                       PortableBitOrPixelOperations<PixelTraits>(),
+                                       key, copy));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(6 + 1 + 4 + 4);
+
+  TestExportKernels();
+
+#ifndef GREYSCALE
+  ok1(CheckCopyFromBGRA());
+#else
+  skip(1, 0, "GREYSCALE");
+#endif
+
+  TestPixelOperations<GreyscalePixelTraits>(Luminosity8(0xa5));
+  TestPixelOperations<BGRAPixelTraits>(BGRA8Color(0x12, 0x34, 0x56, 0x78));
+
+  return exit_status();
+}
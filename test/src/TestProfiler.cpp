@@ -0,0 +1,140 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "OS/Profiler.hpp"
+#include "TestUtil.hpp"
+
+#include <string.h>
+
+using namespace Profiler;
+
+static Sample samples[CAPACITY];
+
+static void
+TestRecord()
+{
+  Clear();
+  ok1(Snapshot(samples, CAPACITY) == 0);
+
+  Record(Track::DRAW, "a", 100, 150);
+  Record(Track::TERRAIN, "b", 200, 300);
+
+  ok1(Snapshot(samples, CAPACITY) == 2);
+  ok1(strcmp(samples[0].name, "a") == 0);
+  ok1(samples[0].track == Track::DRAW);
+  ok1(samples[0].start_us == 100);
+  ok1(samples[0].duration_us == 50);
+  ok1(strcmp(samples[1].name, "b") == 0);
+  ok1(samples[1].track == Track::TERRAIN);
+  ok1(samples[1].duration_us == 100);
+
+  /* only the most recent samples fit into a small buffer */
+  ok1(Snapshot(samples, 1) == 1);
+  ok1(strcmp(samples[0].name, "b") == 0);
+
+  Clear();
+  ok1(Snapshot(samples, CAPACITY) == 0);
+}
+
+static void
+TestOverflow()
+{
+  Clear();
+
+  for (unsigned i = 0; i < CAPACITY + 10; ++i)
+    Record(Track::CALCULATION, "x", i, i + 1);
+
+  ok1(Snapshot(samples, CAPACITY) == CAPACITY);
+  ok1(samples[0].start_us == 10);
+  ok1(samples[CAPACITY - 1].start_us == CAPACITY + 9);
+}
+
+static void
+TestSummarise()
+{
+  Clear();
+
+  static const char *const a = "a", *const b = "b";
+  Record(Track::DRAW, a, 0, 10);
+  Record(Track::DRAW, b, 0, 100);
+  Record(Track::DRAW, a, 0, 30);
+  Record(Track::CALCULATION, a, 0, 5);
+
+  Statistics statistics[8];
+  ok1(Summarise(statistics, 8) == 3);
+  ok1(statistics[0].name == a);
+  ok1(statistics[0].track == Track::DRAW);
+  ok1(statistics[0].count == 2);
+  ok1(statistics[0].GetAverage() == 20);
+  ok1(statistics[0].max_us == 30);
+  ok1(statistics[0].last_us == 30);
+  ok1(statistics[1].name == b);
+  ok1(statistics[1].count == 1);
+  ok1(statistics[2].name == a);
+  ok1(statistics[2].track == Track::CALCULATION);
+
+  /* sections which don't fit are omitted */
+  ok1(Summarise(statistics, 1) == 1);
+  ok1(statistics[0].count == 2);
+}
+
+static void
+TestScope()
+{
+  Clear();
+
+  SetEnabled(false);
+  {
+    const ScopeProfiler profile(Track::DRAW, "disabled");
+    ProfilerMarks marks(Track::DRAW);
+    marks.Mark("disabled");
+  }
+  ok1(Snapshot(samples, CAPACITY) == 0);
+
+  SetEnabled(true);
+  {
+    const ScopeProfiler profile(Track::DRAW, "scope");
+    ProfilerMarks marks(Track::CALCULATION);
+    marks.Mark("first");
+    marks.Mark("second");
+  }
+  SetEnabled(false);
+
+  ok1(Snapshot(samples, CAPACITY) == 3);
+  ok1(strcmp(samples[0].name, "first") == 0);
+  ok1(samples[0].track == Track::CALCULATION);
+  ok1(strcmp(samples[1].name, "second") == 0);
+  ok1(strcmp(samples[2].name, "scope") == 0);
+  ok1(samples[2].track == Track::DRAW);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(35);
+
+  TestRecord();
+  TestOverflow();
+  TestSummarise();
+  TestScope();
+
+  return exit_status();
+}
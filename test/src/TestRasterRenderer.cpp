@@ -0,0 +1,154 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Verifies that the parallel (banded) terrain renderer produces
+ * exactly the same image as a single sequential pass.
+ */
+
+#include "Terrain/RasterRenderer.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/Loader.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Screen/Ramp.hpp"
+#include "Screen/RawBitmap.hpp"
+#include "Math/Angle.hpp"
+#include "IO/ZipArchive.hpp"
+#include "OS/Path.hpp"
+#include "Operation/Operation.hpp"
+#include "TestUtil.hpp"
+
+#include <string.h>
+
+static constexpr ColorRamp ramp[NUM_COLOR_RAMP_LEVELS] = {
+  {0, { 0x70, 0xc0, 0xa7 }},
+  {250, { 0xca, 0xe7, 0xb9 }},
+  {500, { 0xf4, 0xea, 0xaf }},
+  {750, { 0xdc, 0xb2, 0x82 }},
+  {1000, { 0xca, 0x8e, 0x72 }},
+  {1250, { 0xde, 0xc8, 0xbd }},
+  {1500, { 0xe3, 0xe4, 0xe9 }},
+  {1750, { 0xdb, 0xd9, 0xef }},
+  {2000, { 0xce, 0xcd, 0xf5 }},
+  {2250, { 0xc2, 0xc1, 0xfa }},
+  {2500, { 0xb7, 0xb9, 0xff }},
+  {5000, { 0xb7, 0xb9, 0xff }},
+  {6000, { 0xb7, 0xb9, 0xff }}
+};
+
+/**
+ * The height scale determines the contour interval; a small value
+ * produces many contour lines, which carry state from one row to the
+ * next.
+ */
+static constexpr unsigned HEIGHT_SCALE = 2;
+
+static void
+Render(RasterRenderer &renderer, unsigned n_workers,
+       bool do_shading, bool do_contour)
+{
+  renderer.SetWorkers(n_workers);
+  renderer.GenerateImage(do_shading, HEIGHT_SCALE, 64, 128,
+                         Angle::Degrees(45), do_contour);
+}
+
+static bool
+CompareImages(const RasterRenderer &a, const RasterRenderer &b)
+{
+  if (a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight())
+    return false;
+
+  for (unsigned y = 0; y < a.GetHeight(); ++y)
+    if (memcmp(a.GetImage().GetRow(y), b.GetImage().GetRow(y),
+               a.GetWidth() * sizeof(RawColor)) != 0)
+      return false;
+
+  return true;
+}
+
+static void
+TestRadius(const RasterMap &map, double radius, unsigned width,
+           unsigned height)
+{
+  WindowProjection projection;
+  projection.SetScreenSize({width, height});
+  projection.SetScaleFromRadius(radius);
+  projection.SetGeoLocation(map.GetMapCenter());
+  projection.SetScreenOrigin(width / 2, height / 2);
+  projection.UpdateScreenBounds();
+
+  RasterRenderer sequential, banded;
+  sequential.ScanMap(map, projection);
+  banded.ScanMap(map, projection);
+  sequential.PrepareColorTable(ramp, true, HEIGHT_SCALE, 6);
+  banded.PrepareColorTable(ramp, true, HEIGHT_SCALE, 6);
+
+  for (const bool do_shading : {false, true}) {
+    for (const bool do_contour : {false, true}) {
+      Render(sequential, 0, do_shading, do_contour);
+
+      bool equal = true;
+      for (const unsigned n_workers : {1u, 3u, 7u}) {
+        Render(banded, n_workers, do_shading, do_contour);
+        equal &= CompareImages(sequential, banded);
+      }
+
+      ok(equal, "radius=%.0f shading=%d contour=%d",
+         radius, do_shading, do_contour);
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(12);
+
+  ZipArchive archive(Path(_T("test/data/benalla9.xcm")));
+
+  RasterMap map;
+
+  NullOperationEnvironment operation;
+  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(),
+                           operation)) {
+    skip(12, 0, "failed to load map");
+    return exit_status();
+  }
+
+  map.UpdateProjection();
+
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(archive.get(), map.GetTileCache(), mutex,
+                       map.GetProjection(),
+                       map.GetMapCenter(), 50000);
+  } while (map.IsDirty());
+
+  /* zoomed in: slope shading and contours are active; odd sizes make
+     the bands uneven */
+  TestRadius(map, 5000, 321, 243);
+  TestRadius(map, 20000, 640, 480);
+
+  /* zoomed out: the renderer disables slope shading */
+  TestRadius(map, 200000, 200, 150);
+
+  return exit_status();
+}
@@ -0,0 +1,280 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compares the GLSL terrain shader (class TerrainTexture) with the
+ * CPU renderer (RasterRenderer::GenerateImage()).  The shader
+ * calculates in floating point and detects contour lines by looking
+ * at the neighbouring pixels, therefore the images are not
+ * identical; only a tolerance is checked.
+ */
+
+#include "Terrain/TerrainTexture.hpp"
+#include "Terrain/RasterRenderer.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/Loader.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Screen/Ramp.hpp"
+#include "Screen/RawBitmap.hpp"
+#include "Screen/Point.hpp"
+#include "Screen/OpenGL/Init.hpp"
+#include "Screen/OpenGL/Globals.hpp"
+#include "Screen/OpenGL/Texture.hpp"
+#include "Screen/OpenGL/FrameBuffer.hpp"
+#include "Math/Angle.hpp"
+#include "IO/ZipArchive.hpp"
+#include "OS/Path.hpp"
+#include "Operation/Operation.hpp"
+#include "TestUtil.hpp"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <algorithm>
+#include <memory>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr ColorRamp ramp[NUM_COLOR_RAMP_LEVELS] = {
+  {0, { 0x70, 0xc0, 0xa7 }},
+  {250, { 0xca, 0xe7, 0xb9 }},
+  {500, { 0xf4, 0xea, 0xaf }},
+  {750, { 0xdc, 0xb2, 0x82 }},
+  {1000, { 0xca, 0x8e, 0x72 }},
+  {1250, { 0xde, 0xc8, 0xbd }},
+  {1500, { 0xe3, 0xe4, 0xe9 }},
+  {1750, { 0xdb, 0xd9, 0xef }},
+  {2000, { 0xce, 0xcd, 0xf5 }},
+  {2250, { 0xc2, 0xc1, 0xfa }},
+  {2500, { 0xb7, 0xb9, 0xff }},
+  {5000, { 0xb7, 0xb9, 0xff }},
+  {6000, { 0xb7, 0xb9, 0xff }}
+};
+
+/* the parameters used by TerrainRenderer */
+static constexpr unsigned HEIGHT_SCALE = 4;
+static constexpr int INTERP_LEVELS = 2;
+static constexpr int CONTRAST = 64, BRIGHTNESS = 192;
+
+/**
+ * The maximum difference of one color channel.  The shader blends
+ * the slope shading in floating point; this allows one RGB565 step.
+ */
+static constexpr int MAX_CHANNEL_DIFFERENCE = 8;
+
+/**
+ * The maximum fraction of pixels exceeding #MAX_CHANNEL_DIFFERENCE,
+ * mostly contour lines which were placed one pixel off.
+ */
+static constexpr double MAX_DIFFERENT_PIXELS = 0.01;
+
+/**
+ * Create an OpenGL context without a window, using Mesa's
+ * "surfaceless" EGL platform.
+ */
+static bool
+CreateContext()
+{
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+  const auto get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)
+    eglGetProcAddress("eglGetPlatformDisplayEXT");
+  if (get_platform_display == nullptr)
+    return false;
+
+  EGLDisplay display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA,
+                                            EGL_DEFAULT_DISPLAY, nullptr);
+  if (display == EGL_NO_DISPLAY ||
+      !eglInitialize(display, nullptr, nullptr))
+    return false;
+
+#ifdef HAVE_GLES
+  eglBindAPI(EGL_OPENGL_ES_API);
+  static constexpr EGLint attributes[] = {
+    EGL_CONTEXT_CLIENT_VERSION, 2,
+    EGL_NONE
+  };
+#else
+  eglBindAPI(EGL_OPENGL_API);
+  static constexpr EGLint attributes[] = { EGL_NONE };
+#endif
+
+  EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR,
+                                        EGL_NO_CONTEXT, attributes);
+  return context != EGL_NO_CONTEXT &&
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
+#else
+  return false;
+#endif
+}
+
+/**
+ * Render the height matrix of the given #RasterRenderer with
+ * #TerrainTexture into an offscreen buffer.
+ *
+ * @return RGBA pixels, the bottom row first
+ */
+static std::unique_ptr<uint8_t[]>
+RenderShader(const RasterRenderer &renderer, bool do_shading,
+             bool do_contour)
+{
+  const unsigned width = renderer.GetWidth(), height = renderer.GetHeight();
+
+  TerrainTexture texture;
+  texture.SetColorRamp(ramp, true, HEIGHT_SCALE, INTERP_LEVELS);
+  texture.SetHeights(renderer.GetHeightMatrix(), renderer.GetBounds());
+  texture.SetShading(renderer.GetQuantisationEffective(),
+                     renderer.GetPixelSize(),
+                     do_shading, HEIGHT_SCALE, CONTRAST, BRIGHTNESS,
+                     Angle::Degrees(45), do_contour);
+
+  GLTexture target(PixelSize(width, height));
+  GLFrameBuffer frame_buffer;
+  frame_buffer.Bind();
+  target.AttachFramebuffer(FBO::COLOR_ATTACHMENT0);
+
+  OpenGL::SetupViewport(UnsignedPoint2D(width, height));
+  texture.Draw(PixelRect(0, 0, width, height));
+
+  std::unique_ptr<uint8_t[]> pixels(new uint8_t[width * height * 4]);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+               pixels.get());
+
+  GLFrameBuffer::Unbind();
+  return pixels;
+}
+
+/**
+ * @return the fraction of pixels which differ by more than
+ * #MAX_CHANNEL_DIFFERENCE
+ */
+static double
+Compare(RasterRenderer &renderer, const uint8_t *pixels)
+{
+  const unsigned width = renderer.GetWidth(), height = renderer.GetHeight();
+
+  unsigned n_different = 0;
+  for (unsigned y = 0; y < height; ++y) {
+    const RawColor *row = renderer.GetImage().GetRow(y);
+    const uint8_t *p = pixels + (height - 1 - y) * width * 4;
+
+    for (unsigned x = 0; x < width; ++x, p += 4) {
+      /* convert to the CPU's pixel format */
+      const RawColor gpu(p[0], p[1], p[2]);
+
+      const auto &c = row[x].value;
+      const int d = std::max({abs(c.Red() - gpu.value.Red()),
+                              abs(c.Green() - gpu.value.Green()),
+                              abs(c.Blue() - gpu.value.Blue())});
+      if (d > MAX_CHANNEL_DIFFERENCE)
+        ++n_different;
+    }
+  }
+
+  return double(n_different) / (width * height);
+}
+
+static void
+TestRadius(const RasterMap &map, const GeoPoint &location, double radius,
+           unsigned width, unsigned height)
+{
+  WindowProjection projection;
+  projection.SetScreenSize({width, height});
+  projection.SetScaleFromRadius(radius);
+  projection.SetGeoLocation(location);
+  projection.SetScreenOrigin(width / 2, height / 2);
+  projection.UpdateScreenBounds();
+
+  RasterRenderer renderer;
+  renderer.ScanMap(map, projection);
+  renderer.PrepareColorTable(ramp, true, HEIGHT_SCALE, INTERP_LEVELS);
+
+  for (const bool do_shading : {false, true}) {
+    for (const bool do_contour : {false, true}) {
+      renderer.GenerateImage(do_shading, HEIGHT_SCALE,
+                             CONTRAST, BRIGHTNESS,
+                             Angle::Degrees(45), do_contour);
+
+      const auto pixels = RenderShader(renderer, do_shading, do_contour);
+      const double different = Compare(renderer, pixels.get());
+
+      printf("# radius=%.0f shading=%d contour=%d different=%.4f\n",
+             radius, do_shading, do_contour, different);
+      ok1(different <= MAX_DIFFERENT_PIXELS);
+    }
+  }
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(13);
+
+  ZipArchive archive(Path(_T("test/data/benalla9.xcm")));
+
+  RasterMap map;
+
+  NullOperationEnvironment operation;
+  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(),
+                           operation)) {
+    skip(13, 0, "failed to load map");
+    return exit_status();
+  }
+
+  map.UpdateProjection();
+
+  /* Mount Buffalo: the map center is too flat for slope shading and
+     contour lines */
+  const GeoPoint location(Angle::Degrees(146.78), Angle::Degrees(-36.72));
+
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(archive.get(), map.GetTileCache(), mutex,
+                       map.GetProjection(), location, 50000);
+  } while (map.IsDirty());
+
+  if (!CreateContext()) {
+    skip(13, 0, "no OpenGL context");
+    return exit_status();
+  }
+
+  OpenGL::Initialise();
+  OpenGL::SetupContext();
+
+  /* did the shader compile? */
+  ok1(TerrainTexture::IsAvailable());
+  if (!TerrainTexture::IsAvailable()) {
+    skip(12, 0, "no terrain shader");
+    return exit_status();
+  }
+
+  /* zoomed in: slope shading and contours are active */
+  TestRadius(map, location, 5000, 321, 243);
+  TestRadius(map, location, 20000, 640, 480);
+
+  /* zoomed out: the renderer disables slope shading */
+  TestRadius(map, location, 200000, 200, 150);
+
+  OpenGL::Deinitialise();
+
+  return exit_status();
+}
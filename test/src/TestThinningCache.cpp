@@ -0,0 +1,144 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "Topography/ThinningCache.hpp"
+#include "IO/FileCache.hpp"
+#include "OS/FileMapping.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+
+#include <stdio.h>
+
+static const TCHAR *const cache_name = _T("thinning");
+
+static constexpr unsigned NUM_SHAPES = 3, NUM_LEVELS = 4;
+static constexpr double SCALE_THRESHOLD = 30000;
+
+/* line buffers: one count per line, followed by the indices */
+static constexpr uint16_t line_a[] = { 2, 3, 0, 5, 0, 2, 4 };
+static constexpr uint16_t line_b[] = { 2, 2, 0, 5, 0, 4 };
+static constexpr uint16_t polygon[] = { 4, 0, 1, 3, 2 };
+
+static ConstBuffer<uint16_t>
+GetSource(unsigned shape, unsigned level)
+{
+  switch (shape) {
+  case 0:
+    /* a line without indices on level 0 */
+    if (level == 0)
+      return nullptr;
+    return level == 1
+      ? ConstBuffer<uint16_t>(line_a, ARRAY_SIZE(line_a))
+      : ConstBuffer<uint16_t>(line_b, ARRAY_SIZE(line_b));
+
+  case 1:
+    /* a point shape */
+    return nullptr;
+
+  default:
+    return { polygon, ARRAY_SIZE(polygon) };
+  }
+}
+
+static bool
+Save(FileCache &cache, Path original_path, unsigned num_shapes)
+{
+  FILE *file = cache.Save(cache_name, original_path);
+  if (file == nullptr)
+    return false;
+
+  ThinningCache::Writer writer(file);
+  for (unsigned shape = 0; shape < num_shapes; ++shape)
+    for (unsigned level = 0; level < NUM_LEVELS; ++level)
+      writer.Append(GetSource(shape, level));
+
+  if (!writer.Finish(num_shapes, NUM_LEVELS, SCALE_THRESHOLD)) {
+    cache.Cancel(cache_name, file);
+    return false;
+  }
+
+  return cache.Commit(cache_name, file);
+}
+
+static bool
+Load(FileCache &cache, Path original_path, ThinningCache &thinning_cache,
+     unsigned num_shapes=NUM_SHAPES, double scale_threshold=SCALE_THRESHOLD)
+{
+  size_t offset;
+  auto mapping = cache.Map(cache_name, original_path, offset);
+  return mapping &&
+    thinning_cache.Load(std::move(mapping), offset, num_shapes, NUM_LEVELS,
+                        scale_threshold);
+}
+
+static bool
+Equals(const uint16_t *a, ConstBuffer<uint16_t> b)
+{
+  if (b.IsNull())
+    return a == nullptr;
+
+  return a != nullptr && std::equal(b.begin(), b.end(), a);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(2 + NUM_SHAPES * NUM_LEVELS + 6);
+
+  const Path cache_path(_T("output/test/thinning_cache"));
+  const auto original_path = AllocatedPath::Build(cache_path, _T("original"));
+
+  Directory::Create(Path(_T("output")));
+  Directory::Create(Path(_T("output/test")));
+  Directory::Create(cache_path);
+  ok1(File::CreateExclusive(original_path) || File::Exists(original_path));
+
+  FileCache cache{AllocatedPath(cache_path)};
+  ok1(Save(cache, original_path, NUM_SHAPES));
+
+  ThinningCache thinning_cache;
+  if (!Load(cache, original_path, thinning_cache))
+    skip(NUM_SHAPES * NUM_LEVELS, 0, "cache could not be loaded");
+  else
+    for (unsigned shape = 0; shape < NUM_SHAPES; ++shape)
+      for (unsigned level = 0; level < NUM_LEVELS; ++level)
+        ok1(Equals(thinning_cache.Get(shape, level),
+                   GetSource(shape, level)));
+
+  ok1(thinning_cache.IsDefined());
+  ok1(thinning_cache.Get(NUM_SHAPES, 0) == nullptr);
+  ok1(thinning_cache.Get(0, NUM_LEVELS) == nullptr);
+
+  /* reject a cache which does not match the shapefile */
+  ThinningCache other;
+  ok1(!Load(cache, original_path, other, NUM_SHAPES + 1));
+  ok1(!Load(cache, original_path, other, NUM_SHAPES, SCALE_THRESHOLD * 2));
+  ok1(!other.IsDefined());
+
+  File::Delete(AllocatedPath::Build(cache_path, cache_name));
+
+  return exit_status();
+}
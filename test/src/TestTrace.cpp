@@ -33,8 +33,44 @@
 
 #include <windef.h>
 #include <assert.h>
+#include <algorithm>
 #include <cstdio>
 
+static TracePointVector synced;
+static Serial synced_serial;
+static unsigned sync_errors;
+
+/**
+ * Update #synced incrementally with Trace::SyncPoints() and compare
+ * it with a full copy.
+ */
+static void
+CheckSyncPoints(const Trace &trace)
+{
+  if (trace.empty())
+    return;
+
+  const GeoPoint location = trace.front().GetLocation();
+  const double resolution = 100;
+
+  if (synced.empty() || synced_serial != trace.GetModifySerial()) {
+    synced.clear();
+    trace.GetPoints(synced, 0, location, resolution);
+    synced_serial = trace.GetModifySerial();
+  } else
+    trace.SyncPoints(synced, location, resolution);
+
+  TracePointVector full;
+  trace.GetPoints(full, 0, location, resolution);
+
+  if (full.size() != synced.size() ||
+      !std::equal(full.begin(), full.end(), synced.begin(),
+                  [](const TracePoint &a, const TracePoint &b){
+                    return a.GetTime() == b.GetTime();
+                  }))
+    ++sync_errors;
+}
+
 static void
 OnAdvance(Trace &trace, const GeoPoint &loc, const double alt, const double t)
 {
@@ -48,6 +84,8 @@ OnAdvance(Trace &trace, const GeoPoint &loc, const double alt, const double t)
   if (trace.size()>1) {
 //    assert(abs(v.size()-trace.size())<2);
   }
+
+  CheckSyncPoints(trace);
 }
 
 static bool
@@ -57,6 +95,8 @@ TestTrace(Path filename, unsigned ntrace, bool output=false)
 
   printf("# %d", ntrace);  
   Trace trace(1000, ntrace);
+  synced.clear();
+  sync_errors = 0;
 
   IGCExtensions extensions;
   extensions.clear();
@@ -80,7 +120,8 @@ TestTrace(Path filename, unsigned ntrace, bool output=false)
   }
   putchar('\n');
   printf("# samples %d\n", i);
-  return true;
+  printf("# SyncPoints errors %u\n", sync_errors);
+  return sync_errors == 0;
 }
 
 
@@ -0,0 +1,213 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IGC/TraceArchive.hpp"
+#include "IGC/TraceArchiveWriter.hpp"
+#include "IGC/MappedIGCReader.hpp"
+#include "IGC/IGCFixBatch.hpp"
+#include "IGC/IGCFix.hpp"
+#include "OS/FileUtil.hpp"
+#include "OS/Path.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#include <memory>
+#include <vector>
+
+#include <stdio.h>
+
+static const char *const igc_files[] = {
+  "test/data/01lz1hq1.igc",
+  "test/data/0asljd01.igc",
+  "test/data/9crx3101.igc",
+  "test/data/apf-bug554.igc",
+};
+
+static const Path archive_path(_T("output/test/trace.xta"));
+
+static std::vector<IGCFix>
+ReadReference(Path path)
+{
+  std::vector<IGCFix> fixes;
+
+  MappedIGCReader reader(path);
+  IGCFixBatch batch;
+  while (reader.Read(batch)) {
+    for (unsigned i = 0; i < batch.size; ++i) {
+      IGCFix fix;
+      batch.GetFix(i, fix);
+      fixes.push_back(fix);
+    }
+  }
+
+  return fixes;
+}
+
+static bool
+CompareChunk(const TraceArchive::Chunk &chunk,
+             const std::vector<IGCFix> &expected, unsigned offset)
+{
+  for (unsigned i = 0; i < chunk.size; ++i) {
+    const IGCFix &fix = expected[offset + i];
+    const GeoPoint location = chunk.GetLocation(i);
+
+    if (chunk.time[i] % (24 * 3600) != fix.time.GetSecondOfDay() ||
+        fabs(location.latitude.Degrees() -
+             fix.location.latitude.Degrees()) > 1e-6 ||
+        fabs(location.longitude.Degrees() -
+             fix.location.longitude.Degrees()) > 1e-6 ||
+        chunk.gps_altitude[i] != fix.gps_altitude ||
+        chunk.pressure_altitude[i] != fix.pressure_altitude ||
+        chunk.gps_valid[i] != fix.gps_valid)
+      return false;
+
+    if (i > 0 && chunk.time[i] < chunk.time[i - 1])
+      return false;
+  }
+
+  return true;
+}
+
+static void
+TestFile(const char *igc_file)
+{
+  const Path igc_path(igc_file);
+  const auto expected = ReadReference(igc_path);
+
+  WriteTraceArchive(igc_path, archive_path);
+
+  const TraceArchive archive(archive_path);
+  ok1(archive.GetFixCount() == expected.size());
+
+  printf("# %s: %u fixes, %u bytes IGC, %u bytes archive\n", igc_file,
+         archive.GetFixCount(), (unsigned)File::GetSize(igc_path),
+         (unsigned)File::GetSize(archive_path));
+
+  std::unique_ptr<TraceArchive::Chunk> chunk(new TraceArchive::Chunk());
+
+  bool match = true, ranges = true;
+  unsigned offset = 0;
+  for (unsigned i = 0; i < archive.GetChunkCount(); ++i) {
+    const auto &info = archive.GetChunkInfo(i);
+    archive.Decode(i, *chunk);
+
+    if (chunk->size != info.n_fixes ||
+        offset + chunk->size > expected.size() ||
+        !CompareChunk(*chunk, expected, offset))
+      match = false;
+    else if (chunk->time[0] != info.first_time ||
+             chunk->time[chunk->size - 1] != info.last_time)
+      ranges = false;
+
+    for (unsigned j = 0; j < chunk->size; ++j)
+      if (chunk->latitude[j] < info.min_latitude ||
+          chunk->latitude[j] > info.max_latitude ||
+          chunk->longitude[j] < info.min_longitude ||
+          chunk->longitude[j] > info.max_longitude)
+        ranges = false;
+
+    offset += chunk->size;
+  }
+
+  ok1(match);
+  ok1(ranges);
+  ok1(offset == expected.size());
+}
+
+/**
+ * Check the time lookup, decoding of selected columns and the vario
+ * column with a synthetic flight.
+ */
+static void
+TestSynthetic()
+{
+  static constexpr unsigned N = 1000;
+
+  {
+    TraceArchiveWriter writer(archive_path);
+    writer.SetDate(BrokenDate(2016, 7, 14));
+
+    IGCFix fix;
+    fix.Clear();
+    fix.gps_valid = true;
+    fix.location = GeoPoint(Angle::Degrees(7.5), Angle::Degrees(51.25));
+
+    for (unsigned i = 0; i < N; ++i) {
+      /* start one hour before midnight, 5 seconds per fix */
+      fix.time = BrokenTime::FromSecondOfDay((23 * 3600 + i * 5) %
+                                             (24 * 3600));
+      fix.gps_altitude = 1000 + i;
+      fix.pressure_altitude = 900 + 2 * i;
+      writer.Append(fix);
+    }
+
+    writer.Commit();
+  }
+
+  const TraceArchive archive(archive_path);
+  ok1(archive.GetFixCount() == N);
+  ok1(archive.GetDate() == BrokenDate(2016, 7, 14));
+  ok1(archive.GetChunkCount() ==
+      (N + TraceArchive::Chunk::CAPACITY - 1) / TraceArchive::Chunk::CAPACITY);
+
+  /* the time continues after midnight */
+  const unsigned last_chunk = archive.GetChunkCount() - 1;
+  ok1(archive.GetChunkInfo(last_chunk).last_time == 23 * 3600 + (N - 1) * 5);
+
+  /* skip to the chunk containing the first fix after midnight */
+  const unsigned midnight = 24 * 3600;
+  const unsigned i = archive.FindChunk(midnight);
+  ok1(i < archive.GetChunkCount());
+  ok1(archive.GetChunkInfo(i).first_time <= midnight &&
+      archive.GetChunkInfo(i).last_time >= midnight);
+  ok1(i == 0 || archive.GetChunkInfo(i - 1).last_time < midnight);
+  ok1(archive.FindChunk(midnight * 2) == archive.GetChunkCount());
+
+  std::unique_ptr<TraceArchive::Chunk> chunk(new TraceArchive::Chunk());
+  archive.Decode(i, *chunk, (1u << TraceArchive::TIME) |
+                 (1u << TraceArchive::VARIO));
+
+  bool vario = true;
+  for (unsigned j = 0; j < chunk->size; ++j)
+    /* 2 m per 5 seconds pressure altitude */
+    if (chunk->vario[j] != 40)
+      vario = false;
+
+  ok1(vario);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(4 * ARRAY_SIZE(igc_files) + 9);
+
+  Directory::Create(Path(_T("output")));
+  Directory::Create(Path(_T("output/test")));
+
+  for (const char *igc_file : igc_files)
+    TestFile(igc_file);
+
+  TestSynthetic();
+
+  File::Delete(archive_path);
+
+  return exit_status();
+}
@@ -0,0 +1,95 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Trace/Vector.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include <stdio.h>
+
+/**
+ * Fill a trace with points on a straight line, 10 m apart.
+ */
+static void
+FillTrace(Trace &trace, unsigned n)
+{
+  const GeoPoint start(Angle::Degrees(7.7), Angle::Degrees(51.05));
+  for (unsigned i = 0; i < n; ++i) {
+    const GeoPoint location(start.longitude,
+                            start.latitude + Angle::Degrees(i / 11119.5));
+    trace.push_back(TracePoint(location, 1000 + 2 * i, 500., 0., 0));
+  }
+}
+
+/**
+ * Check that Trace::GetPoints() with a resolution returns points which
+ * are at least that far apart (in the flat projection of the trace).
+ */
+static void
+TestResolution(const Trace &trace, double resolution)
+{
+  const GeoPoint location = trace.front().GetLocation();
+  const unsigned range = trace.ProjectRange(location, resolution);
+  const unsigned sq_range = range * range;
+
+  TracePointVector v;
+  trace.GetPoints(v, 0, location, resolution);
+
+  ok1(!v.empty());
+  ok1(v.front().GetTime() == trace.front().GetTime());
+
+  bool spaced = true;
+  for (auto i = std::next(v.begin()); i != v.end(); ++i)
+    spaced &= i->FlatSquareDistanceTo(*std::prev(i)) >= sq_range;
+  ok1(spaced);
+
+  /* the points are 10 m apart, so about every (resolution/10)th
+     point is returned; allow one step more or less for the rounding
+     of the integer projection */
+  const unsigned step = std::max(unsigned(resolution / 10), 1u);
+  const unsigned max_points = trace.size() / step + 1;
+  const unsigned min_points = trace.size() / (step + (step > 1));
+  printf("# resolution=%.0f points=%u\n", resolution, unsigned(v.size()));
+  ok1(v.size() >= min_points && v.size() <= max_points);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(14);
+
+  Trace trace(0, Trace::null_time, 1024);
+  FillTrace(trace, 1000);
+  ok1(trace.size() == 1000);
+
+  TracePointVector all;
+  trace.GetPoints(all, 0, trace.front().GetLocation(), 0);
+  ok1(all.size() == trace.size());
+
+  TestResolution(trace, 0);
+  TestResolution(trace, 100);
+  TestResolution(trace, 1000);
+
+  return exit_status();
+}
@@ -0,0 +1,308 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "FLARM/List.hpp"
+#include "Device/Driver/FLARM/StaticParser.hpp"
+#include "NMEA/InputLine.hpp"
+#include "NMEA/Checksum.hpp"
+#include "Util/Macros.hpp"
+#include "TestUtil.hpp"
+
+#include <math.h>
+#include <stdio.h>
+
+static constexpr unsigned N_TARGETS = 300;
+static_assert(N_TARGETS <= TrafficList::MAX_COUNT, "Too many targets");
+
+/**
+ * A simple deterministic pseudo random number generator, so the test
+ * results are reproducible.
+ */
+static unsigned
+Random(unsigned &seed)
+{
+  seed = seed * 1103515245u + 12345u;
+  return (seed >> 16) & 0x7fff;
+}
+
+static FlarmId
+MakeId(unsigned i)
+{
+  char buffer[16];
+  snprintf(buffer, ARRAY_SIZE(buffer), "%06X", 0x100000 + i * 7919);
+  return FlarmId::Parse(buffer, nullptr);
+}
+
+/**
+ * Format a PFLAA sentence (with checksum) and feed it to the FLARM
+ * parser.
+ */
+static bool
+FeedPFLAA(TrafficList &list, double clock, unsigned i, int north, int east,
+          unsigned alarm_level=0)
+{
+  char buffer[128];
+  snprintf(buffer, ARRAY_SIZE(buffer),
+           "$PFLAA,%u,%d,%d,%d,2,%06X,%u,,%u,1.5,1",
+           alarm_level, north, east, (int)(i % 200) - 100,
+           0x100000 + i * 7919, (i * 37) % 360, 20 + i % 30);
+  AppendNMEAChecksum(buffer);
+
+  if (!VerifyNMEAChecksum(buffer))
+    return false;
+
+  NMEAInputLine line(buffer);
+  line.Skip();
+  ParsePFLAA(line, list, clock);
+  return true;
+}
+
+static double
+GetDistance(const FlarmTraffic &traffic)
+{
+  return hypot(traffic.relative_north, traffic.relative_east);
+}
+
+/**
+ * Feed #N_TARGETS targets at random positions and check the id
+ * lookup and the order.
+ */
+static void
+TestStress(TrafficList &list)
+{
+  list.Clear();
+
+  unsigned seed = 42;
+  bool feed_ok = true;
+  for (unsigned i = 0; i < N_TARGETS; ++i) {
+    const int north = (int)Random(seed) % 40000 - 20000;
+    const int east = (int)Random(seed) % 40000 - 20000;
+    feed_ok &= FeedPFLAA(list, 1, i, north, east);
+  }
+
+  ok1(feed_ok);
+  ok1(list.GetActiveTrafficCount() == N_TARGETS);
+  ok1(!list.overflow);
+
+  bool found = true, ordered = true;
+  for (unsigned i = 0; i < N_TARGETS; ++i) {
+    const FlarmTraffic *traffic = list.FindTraffic(MakeId(i));
+    found &= traffic != nullptr;
+    ordered &= traffic != nullptr && list.TrafficIndex(traffic) == i;
+  }
+
+  ok1(found);
+  ok1(ordered);
+  ok1(list.FindTraffic(MakeId(N_TARGETS)) == nullptr);
+
+  /* updates do not change the order */
+  for (unsigned i = N_TARGETS; i-- > 0;)
+    FeedPFLAA(list, 2, i, 100 * i, -50 * (int)i);
+
+  ok1(list.GetActiveTrafficCount() == N_TARGETS);
+  ordered = true;
+  for (unsigned i = 0; i < N_TARGETS; ++i)
+    ordered &= list.list[i].id == MakeId(i) &&
+      list.list[i].relative_north == 100 * i;
+  ok1(ordered);
+}
+
+/**
+ * Compare FindNearest() and FindMaximumAlert() with a brute force
+ * search.
+ */
+static void
+TestQueries(TrafficList &list)
+{
+  unsigned seed = 1;
+  bool nearest_ok = true, alert_ok = true;
+
+  for (unsigned round = 0; round < 20; ++round) {
+    list.Clear();
+
+    for (unsigned i = 0; i < N_TARGETS; ++i) {
+      const int north = (int)Random(seed) % 6000 - 3000;
+      const int east = (int)Random(seed) % 6000 - 3000;
+      const unsigned alarm = Random(seed) % 64 == 0 ? 1 + i % 3 : 0;
+      FeedPFLAA(list, 1, i, north, east, alarm);
+    }
+
+    /* emulate FlarmComputer */
+    for (auto &traffic : list.list.Modify())
+      traffic.distance = GetDistance(traffic);
+
+    double min_distance = -1;
+    const FlarmTraffic *alert = nullptr;
+    for (const auto &traffic : list.list) {
+      const double d = GetDistance(traffic);
+      if (min_distance < 0 || d < min_distance)
+        min_distance = d;
+
+      if (traffic.HasAlarm() &&
+          (alert == nullptr || traffic.alarm_level > alert->alarm_level ||
+           (traffic.alarm_level == alert->alarm_level &&
+            traffic.distance < alert->distance)))
+        alert = &traffic;
+    }
+
+    const FlarmTraffic *nearest = list.FindNearest();
+    nearest_ok &= nearest != nullptr && GetDistance(*nearest) == min_distance;
+    alert_ok &= list.FindMaximumAlert() == alert;
+  }
+
+  ok1(nearest_ok);
+  ok1(alert_ok);
+
+  list.Clear();
+  ok1(list.FindNearest() == nullptr);
+}
+
+/**
+ * Copies share the array until one of them is modified.
+ */
+static void
+TestCopyOnWrite(TrafficList &list)
+{
+  list.Clear();
+
+  for (unsigned i = 0; i < N_TARGETS; ++i)
+    FeedPFLAA(list, 1, i, i, i);
+
+  TrafficList copy = list;
+  ok1(copy.list.begin() == list.list.begin());
+
+  /* modifying the copy leaves the original alone */
+  FeedPFLAA(copy, 2, 0, 1000, 1000);
+  FeedPFLAA(copy, 2, N_TARGETS, 0, 0);
+  ok1(copy.list.begin() != list.list.begin());
+  ok1(copy.GetActiveTrafficCount() == N_TARGETS + 1);
+  ok1(list.GetActiveTrafficCount() == N_TARGETS);
+  ok1(copy.list[0].relative_north == 1000);
+  ok1(list.list[0].relative_north == 0);
+
+  /* a copy which is the only reference is modified in place */
+  const FlarmTraffic *before = copy.list.begin();
+  FeedPFLAA(copy, 3, 1, 2000, 2000);
+  ok1(copy.list.begin() == before);
+
+  /* the original survives the destruction of copies */
+  {
+    TrafficList tmp = list;
+    tmp.Clear();
+  }
+  ok1(list.GetActiveTrafficCount() == N_TARGETS &&
+      list.list[N_TARGETS - 1].id == MakeId(N_TARGETS - 1));
+}
+
+static void
+TestExpire(TrafficList &list)
+{
+  list.Clear();
+
+  for (unsigned i = 0; i < N_TARGETS; ++i)
+    FeedPFLAA(list, 1, i, i, i);
+
+  /* nothing has expired yet: the (shared) array is left alone */
+  TrafficList copy = list;
+  list.Expire(2);
+  ok1(list.list.begin() == copy.list.begin());
+
+  /* refresh every third target */
+  for (unsigned i = 0; i < N_TARGETS; i += 3)
+    FeedPFLAA(list, 5, i, i, i);
+
+  list.Expire(5);
+  ok1(list.GetActiveTrafficCount() == N_TARGETS / 3);
+  ok1(copy.GetActiveTrafficCount() == N_TARGETS);
+
+  bool ok = true;
+  for (unsigned i = 0; i < N_TARGETS; ++i) {
+    const FlarmTraffic *traffic = list.FindTraffic(MakeId(i));
+    if (i % 3 == 0)
+      /* the survivors keep their relative order */
+      ok &= traffic != nullptr && list.TrafficIndex(traffic) == i / 3;
+    else
+      ok &= traffic == nullptr;
+  }
+  ok1(ok);
+
+  /* re-adding an expired target appends it */
+  FeedPFLAA(list, 6, 1, 0, 0);
+  const FlarmTraffic *traffic = list.FindTraffic(MakeId(1));
+  ok1(traffic != nullptr &&
+      list.TrafficIndex(traffic) == N_TARGETS / 3);
+}
+
+/**
+ * If the list is full, new targets replace the least critical ones.
+ */
+static void
+TestFull(TrafficList &list)
+{
+  list.Clear();
+
+  /* the distance grows with the index */
+  for (unsigned i = 0; i < TrafficList::MAX_COUNT; ++i)
+    FeedPFLAA(list, 1, i, 1000 + 10 * i, 0);
+
+  ok1(list.GetActiveTrafficCount() == TrafficList::MAX_COUNT);
+  ok1(!list.overflow);
+
+  /* a target farther away than all others is discarded */
+  const unsigned far_id = TrafficList::MAX_COUNT;
+  FeedPFLAA(list, 2, far_id, 100000, 0);
+  ok1(list.GetActiveTrafficCount() == TrafficList::MAX_COUNT);
+  ok1(list.FindTraffic(MakeId(far_id)) == nullptr);
+  ok1(list.overflow);
+
+  /* a near target replaces the farthest one */
+  const unsigned near_id = TrafficList::MAX_COUNT + 1;
+  FeedPFLAA(list, 3, near_id, 100, 0);
+  ok1(list.GetActiveTrafficCount() == TrafficList::MAX_COUNT);
+  ok1(list.FindTraffic(MakeId(near_id)) != nullptr);
+  ok1(list.FindTraffic(MakeId(TrafficList::MAX_COUNT - 1)) == nullptr);
+  ok1(list.FindTraffic(MakeId(TrafficList::MAX_COUNT - 2)) != nullptr);
+
+  /* a far target with an alarm replaces the farthest one without */
+  const unsigned alarm_id = TrafficList::MAX_COUNT + 2;
+  FeedPFLAA(list, 4, alarm_id, 100000, 0, 2);
+  ok1(list.FindTraffic(MakeId(alarm_id)) != nullptr);
+  ok1(list.FindTraffic(MakeId(TrafficList::MAX_COUNT - 2)) == nullptr);
+
+  /* the overflow indicator expires */
+  list.Expire(100);
+  ok1(!list.overflow);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(36);
+
+  TrafficList list;
+  TestStress(list);
+  TestQueries(list);
+  TestCopyOnWrite(list);
+  TestExpire(list);
+  TestFull(list);
+
+  return exit_status();
+}
@@ -0,0 +1,138 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2016 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Thread/WorkerPool.hpp"
+#include "TestUtil.hpp"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include <string.h>
+
+static constexpr unsigned N_JOBS = 100;
+
+/**
+ * Run a batch and check that each job was executed exactly once.
+ */
+static bool
+RunAll(WorkerPool &pool)
+{
+  std::atomic<unsigned> counts[N_JOBS];
+  for (auto &i : counts)
+    i = 0;
+
+  pool.Run(N_JOBS, [&counts](unsigned job){
+      ++counts[job];
+    });
+
+  for (const auto &i : counts)
+    if (i != 1)
+      return false;
+
+  return true;
+}
+
+static void
+TestRun(unsigned n_workers)
+{
+  WorkerPool pool(n_workers);
+  ok1(pool.GetConcurrency() == n_workers + 1);
+  ok1(RunAll(pool));
+
+  /* the worker index is in range, and a worker's jobs never overlap */
+  std::unique_ptr<std::atomic<unsigned>[]>
+    busy(new std::atomic<unsigned>[pool.GetConcurrency()]);
+  for (unsigned i = 0; i < pool.GetConcurrency(); ++i)
+    busy[i] = 0;
+
+  std::atomic<bool> valid(true);
+  pool.RunPerWorker(N_JOBS, [&](unsigned, unsigned worker){
+      if (worker >= pool.GetConcurrency() || busy[worker]++ != 0)
+        valid = false;
+      --busy[worker];
+    });
+  ok1(valid);
+}
+
+static void
+TestException(unsigned n_workers)
+{
+  WorkerPool pool(n_workers);
+
+  std::atomic<unsigned> n_started(0);
+  bool caught = false;
+  try {
+    pool.Run(N_JOBS, [&n_started](unsigned job){
+        ++n_started;
+        if (job == 3)
+          throw std::runtime_error("job 3");
+      });
+  } catch (const std::runtime_error &e) {
+    caught = strcmp(e.what(), "job 3") == 0;
+  }
+
+  ok1(caught);
+
+  /* the remaining jobs were skipped (except those which were already
+     running in other threads) */
+  ok1(n_started < N_JOBS);
+
+  /* the pool is still usable */
+  ok1(RunAll(pool));
+}
+
+static void
+TestConcurrentCallers()
+{
+  WorkerPool pool(3);
+
+  std::atomic<bool> a(false), b(false);
+  std::thread t([&pool, &a](){
+      for (unsigned i = 0; i < 20; ++i)
+        a = RunAll(pool);
+    });
+
+  for (unsigned i = 0; i < 20; ++i)
+    b = RunAll(pool);
+
+  t.join();
+
+  ok1(a);
+  ok1(b);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(3 * 3 + 3 * 3 + 2);
+
+  for (unsigned n_workers : {0u, 1u, 3u})
+    TestRun(n_workers);
+
+  for (unsigned n_workers : {0u, 1u, 3u})
+    TestException(n_workers);
+
+  TestConcurrentCallers();
+
+  return exit_status();
+}